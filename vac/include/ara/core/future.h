@@ -25,12 +25,14 @@
  *  INCLUDES
  *********************************************************************************************************************/
 #include <chrono>
-#include <future>
 #include <memory>
 #include <utility>
 #include "ara/core/error_code.h"
 #include "ara/core/future_error_domain.h"
+#include "ara/core/internal/future_shared_state.h"
 #include "ara/core/result.h"
+#include "vac/language/throw_or_terminate.h"
+#include "vac/threadpool/executor.h"
 
 namespace ara {
 namespace core {
@@ -259,6 +261,22 @@ enum class future_status : uint8_t {
   timeout = 1
 };
 
+/*!
+ * \brief Policy for continuations attached with an executor by Future::then().
+ * \vpublic
+ */
+enum class continuation_policy : uint8_t {
+  /*!
+   * \brief The continuation is always dispatched to the executor.
+   */
+  dispatch = 0,
+  /*!
+   * \brief The continuation is called in the context of then() if the Future is already ready, avoiding the hop to
+   *        the executor. Otherwise it is dispatched to the executor.
+   */
+  inline_if_ready = 1
+};
+
 /*!
  * \brief  Provides ara::core specific Future operations to collect the results of an asynchronous call.
  * \tparam T Value type
@@ -274,12 +292,12 @@ class Future final {
    */
   using R = Result<T, E>;
 
- public:
   /*!
-   * \brief The future continuation pointer type.
+   * \brief Pointer type of the shared state.
    */
-  using FutureContinuationPtr = std::shared_ptr<ara::core::internal::FutureContinuation<T, E>>;
+  using SharedStatePtr = typename internal::FutureSharedState<T, E>::Ptr;
 
+ public:
   /*!
    * \brief Default constructor.
    * \trace SPEC-7552465
@@ -324,11 +342,16 @@ class Future final {
    * \trace  SPEC-7552470
    * \vpublic
    */
-  Future& operator=(Future&& other) & noexcept = default;
+  Future& operator=(Future&& other) & noexcept {
+    if (this != &other) {
+      shared_state_ = std::move(other.shared_state_);
+      // The move assignment of the pointer swaps, so release the state handed over to other.
+      other.shared_state_.reset();
+    }
+    return *this;
+  }
 
   /* VECTOR Next Construct VectorC++-V6-6-1: MD_VAC_V6-6-1_multipleExit */
-  /* VECTOR Next Construct AutosarC++17_10-M0.3.1: MD_VAC_M0.3.1_deadExceptionHandler */
-  /* VECTOR Next Construct AutosarC++17_10-A15.3.1: MD_VAC_A15.3.1_uncheckedExecptionsShouldBeHandledOnlyInMain */
   /*!
    * \brief  Get the result (does not throw exceptions).
    * \return The value stored in the shared state.
@@ -337,19 +360,14 @@ class Future final {
    * \vpublic
    */
   R GetResult() noexcept {
-    try {
+    if (!shared_state_) {
       /* VECTOR Next Line AutosarC++17_10-M6.6.5: MD_VAC_M6.6.5_multipleExit */
-      return delegate_future_.get();
-    } catch (std::future_error const& ex) {
-      std::error_code const& ec{ex.code()};
-      // std::future::get() can only throw no_state or broken_promise.
-      future_errc err{future_errc::no_state};
-      if (ec == std::future_errc::broken_promise) {
-        err = future_errc::broken_promise;
-      }
-      /* VECTOR Next Line AutosarC++17_10-M6.6.5: MD_VAC_M6.6.5_multipleExit */
-      return R::FromError(err);
+      return R::FromError(future_errc::no_state);
     }
+    // Release the shared state together with the Result, which invalidates this Future like std::future::get().
+    SharedStatePtr shared_state{std::move(shared_state_)};
+    shared_state->Wait();
+    return shared_state->TakeResult();
   }
 
   /*!
@@ -377,7 +395,7 @@ class Future final {
    * \trace  CREQ-200637
    * \vpublic
    */
-  bool valid() const noexcept { return delegate_future_.valid(); }
+  bool valid() const noexcept { return static_cast<bool>(shared_state_); }
 
   /*!
    * \brief Block until the shared state is ready.
@@ -385,7 +403,10 @@ class Future final {
    * \trace CREQ-200639
    * \vpublic
    */
-  void wait() const noexcept(false) { delegate_future_.wait(); }
+  void wait() const noexcept(false) {
+    ThrowIfNoState();
+    shared_state_->Wait();
+  }
 
   /*!
    * \brief  Wait for a specified relative time.
@@ -399,14 +420,7 @@ class Future final {
    */
   template <typename Rep, typename Period>
   future_status wait_for(std::chrono::duration<Rep, Period> const& timeout_duration) const noexcept(false) {
-    future_status retval;
-    std::future_status f_stat{delegate_future_.wait_for(timeout_duration)};
-    if (std::future_status::ready == f_stat) {
-      retval = future_status::ready;
-    } else {
-      retval = future_status::timeout;
-    }
-    return retval;
+    return wait_until(std::chrono::steady_clock::now() + timeout_duration);
   }
 
   /*!
@@ -421,12 +435,10 @@ class Future final {
    */
   template <typename Clock, typename Duration>
   future_status wait_until(std::chrono::time_point<Clock, Duration> const& abs_time) const noexcept(false) {
-    future_status retval;
-    std::future_status f_stat{delegate_future_.wait_until(abs_time)};
-    if (std::future_status::ready == f_stat) {
+    ThrowIfNoState();
+    future_status retval{future_status::timeout};
+    if (shared_state_->WaitUntil(abs_time)) {
       retval = future_status::ready;
-    } else {
-      retval = future_status::timeout;
     }
     return retval;
   }
@@ -458,15 +470,50 @@ class Future final {
 
     Future<T2, E2> future;
 
+    ThrowIfNoState();
     // Call the function if future state is ready.
     if (is_ready()) {
       future = internal::GetFuture<T, E, F, U, T2, E2>()(std::forward<F>(func), std::move(*this));
 
       // Save the call back function in continuation to be called later when promise is set.
     } else {
-      // Move the future_continuation pointer to f_continuation to be used after this future object gets invalidated.
-      FutureContinuationPtr f_continuation{std::move(future_continuation_)};
-      future = f_continuation->SetCallBackHandler(std::forward<F>(func), std::move(*this));
+      // Keep the shared state alive while this future object is moved into the continuation.
+      SharedStatePtr shared_state{shared_state_};
+      future = internal::FutureContinuation<T, E>{*shared_state}.SetCallBackHandler(std::forward<F>(func),
+                                                                                    std::move(*this));
+    }
+
+    return future;
+  }
+
+  /*!
+   * \brief   Register a callable that gets called on the given executor when the Future becomes ready.
+   * \details When func is called, it is guaranteed that get() and GetResult() will not block.
+   * \remark  Warning: This function might use dynamic memory allocation. Use with caution!
+   * \tparam  F Type of continuation function.
+   * \param   executor The executor func is dispatched to. Must outlive the call of func.
+   * \param   func A continuation function to be attached.
+   * \param   policy Whether func may be called in the context of this call if the Future is already ready.
+   * \return  A new Future instance for the result of the continuation.
+   * \vpublic
+   */
+  template <typename F>
+  auto then(vac::threadpool::Executor& executor, F&& func,
+            continuation_policy policy = continuation_policy::dispatch) noexcept(false) ->
+      typename internal::TypeUnwrapping<decltype(func(std::move(*this))), E>::type {
+    /*! \brief Alias for the type of the future returned from this function. */
+    using FutureType = typename internal::TypeUnwrapping<decltype(func(std::move(*this))), E>::type;
+
+    FutureType future;
+
+    ThrowIfNoState();
+    if ((policy == continuation_policy::inline_if_ready) && is_ready()) {
+      future = then(std::forward<F>(func));
+    } else {
+      // Keep the shared state alive while this future object is moved into the continuation.
+      SharedStatePtr shared_state{shared_state_};
+      future = internal::FutureContinuation<T, E>{*shared_state}.SetCallBackHandler(std::forward<F>(func),
+                                                                                    std::move(*this), &executor);
     }
 
     return future;
@@ -475,33 +522,47 @@ class Future final {
   /*!
    * \brief  Return true only when the shared state is ready. This method will return immediately and shall not do a
    *         blocking wait.
-   * \remark Because the std::future has no future::get_state, we will use the
-   *         capabilities we have and use future::wait_for to check for the current status.
+   * \remark Lock-free, only the state word of the shared state is read.
    * \return True if the future contains a value (or exception), false if not.
    * \trace  SPEC-7552478
    * \trace  CREQ-200642
    * \vpublic
    */
-  bool is_ready() const { return std::future_status::ready == delegate_future_.wait_for(std::chrono::seconds::zero()); }
+  bool is_ready() const { return shared_state_ && shared_state_->IsReady(); }
+
+  /*!
+   * \brief   Registers a continuation directly on the shared state, without creating a new Future.
+   * \details Used by the Future combinators. This Future stays valid, the continuation is executed once it is ready.
+   * \param   continuation The continuation to register.
+   * \throws  ara::core::FutureException with future_errc::no_state if this Future has no shared state.
+   * \vprivate
+   */
+  void SetContinuation(internal::ContinuationPtr continuation) noexcept(false) {
+    ThrowIfNoState();
+    shared_state_->SetContinuation(std::move(continuation));
+  }
 
  private:
   /*!
    * \brief Parameterized constructor.
-   * \param delegate_future object to std::future.
-   * \param future_continuation Future continuation pointer to manage the call back function.
+   * \param shared_state The shared state with the Promise.
    */
-  Future(std::future<R>&& delegate_future, FutureContinuationPtr future_continuation) noexcept
-      : delegate_future_(std::move(delegate_future)), future_continuation_(future_continuation) {}
+  explicit Future(SharedStatePtr shared_state) noexcept : shared_state_(std::move(shared_state)) {}
 
   /*!
-   * \brief Delegation object to std::future.
+   * \brief  Throws if this Future has no shared state.
+   * \throws ara::core::FutureException with future_errc::no_state.
    */
-  std::future<R> delegate_future_;
+  void ThrowIfNoState() const {
+    if (!shared_state_) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+    }
+  }
 
   /*!
-   * \brief Future continuation pointer to manage the call back function.
+   * \brief The shared state with the Promise.
    */
-  FutureContinuationPtr future_continuation_;
+  SharedStatePtr shared_state_;
 
   /* VECTOR Next Line AutosarC++17_10-A11.3.1: MD_VAC_A11.3.1_doNotUseFriend */
   friend class Promise<T, E>;
@@ -520,12 +581,12 @@ class Future<void, E> final {
    */
   using R = Result<void, E>;
 
- public:
   /*!
-   * \brief The future continuation pointer type.
+   * \brief Pointer type of the shared state.
    */
-  using FutureContinuationPtr = std::shared_ptr<ara::core::internal::FutureContinuation<void, E>>;
+  using SharedStatePtr = typename internal::FutureSharedState<void, E>::Ptr;
 
+ public:
   /*!
    * \brief Default constructor
    * \trace SPEC-7552465
@@ -570,10 +631,15 @@ class Future<void, E> final {
    * \trace  SPEC-7552470
    * \vpublic
    */
-  Future& operator=(Future&& other) & noexcept = default;
+  Future& operator=(Future&& other) & noexcept {
+    if (this != &other) {
+      shared_state_ = std::move(other.shared_state_);
+      // The move assignment of the pointer swaps, so release the state handed over to other.
+      other.shared_state_.reset();
+    }
+    return *this;
+  }
 
-  /* VECTOR Next Construct AutosarC++17_10-M0.3.1: MD_VAC_M0.3.1_deadExceptionHandler */
-  /* VECTOR Next Construct AutosarC++17_10-A15.3.1: MD_VAC_A15.3.1_uncheckedExecptionsShouldBeHandledOnlyInMain */
   /* VECTOR Next Construct AutosarC++17_10-V6-6-1: MD_VAC_V6-6-1_multipleExit */
   /*!
    * \brief  Get the result (does not throw exceptions).
@@ -583,20 +649,14 @@ class Future<void, E> final {
    * \vpublic
    */
   R GetResult() noexcept {
-    try {
+    if (!shared_state_) {
       /* VECTOR Next Line AutosarC++17_10-M6.6.5: MD_VAC_M6.6.5_multipleExit */
-      return delegate_future_.get();
-    } catch (std::future_error const& ex) {
-      // TODO(vsarcsesu): Considering removing this and let delegate_future_ throw all the way instead of catching here.
-      std::error_code const& ec{ex.code()};
-      // std::future::get() can only throw no_state or broken_promise.
-      future_errc err{future_errc::no_state};
-      if (ec == std::future_errc::broken_promise) {
-        err = future_errc::broken_promise;
-      }
-      /* VECTOR Next Line AutosarC++17_10-M6.6.5: MD_VAC_M6.6.5_multipleExit */
-      return R::FromError(err);
+      return R::FromError(future_errc::no_state);
     }
+    // Release the shared state together with the Result, which invalidates this Future like std::future::get().
+    SharedStatePtr shared_state{std::move(shared_state_)};
+    shared_state->Wait();
+    return shared_state->TakeResult();
   }
 
   /*!
@@ -624,7 +684,7 @@ class Future<void, E> final {
    * \trace  CREQ-200637
    * \vpublic
    */
-  bool valid() const noexcept { return delegate_future_.valid(); }
+  bool valid() const noexcept { return static_cast<bool>(shared_state_); }
 
   /*!
    * \brief Block until the shared state is ready.
@@ -632,7 +692,10 @@ class Future<void, E> final {
    * \trace CREQ-200639
    * \vpublic
    */
-  void wait() const noexcept(false) { delegate_future_.wait(); }
+  void wait() const noexcept(false) {
+    ThrowIfNoState();
+    shared_state_->Wait();
+  }
 
   /*!
    * \brief  Wait for a specified relative time.
@@ -646,14 +709,7 @@ class Future<void, E> final {
    */
   template <typename Rep, typename Period>
   future_status wait_for(std::chrono::duration<Rep, Period> const& timeout_duration) const noexcept(false) {
-    future_status retval;
-    std::future_status f_stat{delegate_future_.wait_for(timeout_duration)};
-    if (std::future_status::ready == f_stat) {
-      retval = future_status::ready;
-    } else {
-      retval = future_status::timeout;
-    }
-    return retval;
+    return wait_until(std::chrono::steady_clock::now() + timeout_duration);
   }
 
   /*!
@@ -668,12 +724,10 @@ class Future<void, E> final {
    */
   template <typename Clock, typename Duration>
   future_status wait_until(std::chrono::time_point<Clock, Duration> const& abs_time) const noexcept(false) {
-    future_status retval;
-    std::future_status f_stat{delegate_future_.wait_until(abs_time)};
-    if (std::future_status::ready == f_stat) {
+    ThrowIfNoState();
+    future_status retval{future_status::timeout};
+    if (shared_state_->WaitUntil(abs_time)) {
       retval = future_status::ready;
-    } else {
-      retval = future_status::timeout;
     }
     return retval;
   }
@@ -704,15 +758,50 @@ class Future<void, E> final {
 
     Future<T2, E2> future;
 
+    ThrowIfNoState();
     // Call the function if future state is ready.
     if (is_ready()) {
       future = internal::GetFuture<void, E, F, U, T2, E2>()(std::forward<F>(func), std::move(*this));
 
       // Save the call back function in continuation to be called later when promise is set.
     } else {
-      // Move the future_continuation pointer to f_continuation to be used after this future object gets invalidated.
-      FutureContinuationPtr f_continuation{std::move(future_continuation_)};
-      future = f_continuation->SetCallBackHandler(std::forward<F>(func), std::move(*this));
+      // Keep the shared state alive while this future object is moved into the continuation.
+      SharedStatePtr shared_state{shared_state_};
+      future = internal::FutureContinuation<void, E>{*shared_state}.SetCallBackHandler(std::forward<F>(func),
+                                                                                    std::move(*this));
+    }
+
+    return future;
+  }
+
+  /*!
+   * \brief   Register a callable that gets called on the given executor when the Future becomes ready.
+   * \details When func is called, it is guaranteed that get() and GetResult() will not block.
+   * \remark  Warning: This function might use dynamic memory allocation. Use with caution!
+   * \tparam  F Type of continuation function.
+   * \param   executor The executor func is dispatched to. Must outlive the call of func.
+   * \param   func A continuation function to be attached.
+   * \param   policy Whether func may be called in the context of this call if the Future is already ready.
+   * \return  A new Future instance for the result of the continuation.
+   * \vpublic
+   */
+  template <typename F>
+  auto then(vac::threadpool::Executor& executor, F&& func,
+            continuation_policy policy = continuation_policy::dispatch) noexcept(false) ->
+      typename internal::TypeUnwrapping<decltype(func(std::move(*this))), E>::type {
+    /*! \brief Alias for the type of the future returned from this function. */
+    using FutureType = typename internal::TypeUnwrapping<decltype(func(std::move(*this))), E>::type;
+
+    FutureType future;
+
+    ThrowIfNoState();
+    if ((policy == continuation_policy::inline_if_ready) && is_ready()) {
+      future = then(std::forward<F>(func));
+    } else {
+      // Keep the shared state alive while this future object is moved into the continuation.
+      SharedStatePtr shared_state{shared_state_};
+      future = internal::FutureContinuation<void, E>{*shared_state}.SetCallBackHandler(std::forward<F>(func),
+                                                                                    std::move(*this), &executor);
     }
 
     return future;
@@ -721,33 +810,47 @@ class Future<void, E> final {
   /*!
    * \brief  Return true only when the shared state is ready. This method will return immediately and shall not do a
    *         blocking wait.
-   * \remark Because the std::future has no future::get_state, we will use the
-   *         capabilities we have and use future::wait_for to check for the current status.
+   * \remark Lock-free, only the state word of the shared state is read.
    * \return True if the future contains a value (or exception), false if not.
    * \trace  SPEC-7552478
    * \trace  CREQ-200642
    * \vpublic
    */
-  bool is_ready() const { return std::future_status::ready == delegate_future_.wait_for(std::chrono::seconds::zero()); }
+  bool is_ready() const { return shared_state_ && shared_state_->IsReady(); }
+
+  /*!
+   * \brief   Registers a continuation directly on the shared state, without creating a new Future.
+   * \details Used by the Future combinators. This Future stays valid, the continuation is executed once it is ready.
+   * \param   continuation The continuation to register.
+   * \throws  ara::core::FutureException with future_errc::no_state if this Future has no shared state.
+   * \vprivate
+   */
+  void SetContinuation(internal::ContinuationPtr continuation) noexcept(false) {
+    ThrowIfNoState();
+    shared_state_->SetContinuation(std::move(continuation));
+  }
 
  private:
   /*!
-   * \brief Parameterized constructor
-   * \param delegate_future object to std::future.
-   * \param future_continuation Future continuation pointer to manage the call back function.
+   * \brief Parameterized constructor.
+   * \param shared_state The shared state with the Promise.
    */
-  Future(std::future<R>&& delegate_future, FutureContinuationPtr future_continuation) noexcept
-      : delegate_future_(std::move(delegate_future)), future_continuation_(future_continuation) {}
+  explicit Future(SharedStatePtr shared_state) noexcept : shared_state_(std::move(shared_state)) {}
 
   /*!
-   * \brief Delegation object to std::future.
+   * \brief  Throws if this Future has no shared state.
+   * \throws ara::core::FutureException with future_errc::no_state.
    */
-  std::future<R> delegate_future_;
+  void ThrowIfNoState() const {
+    if (!shared_state_) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+    }
+  }
 
   /*!
-   * \brief Future continuation pointer to manage the call back function.
+   * \brief The shared state with the Promise.
    */
-  FutureContinuationPtr future_continuation_;
+  SharedStatePtr shared_state_;
 
   /* VECTOR Next Line AutosarC++17_10-A11.3.1: MD_VAC_A11.3.1_doNotUseFriend */
   friend class Promise<void, E>;
@@ -0,0 +1,640 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  ara/core/future_combinators.h
+ *        \brief  WhenAll and WhenAny combinators for ara::core::Future.
+ *
+ *      \details  The combinators do not block. A single combined state is allocated per call; it owns the input
+ *                Futures, a continuation slot per input and an atomic countdown. Every slot is registered directly on
+ *                the shared state of its input, the last (WhenAll) or first (WhenAny) input that becomes ready sets
+ *                the resulting Future.
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COMBINATORS_H_
+#define LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COMBINATORS_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ara/core/error_code.h"
+#include "ara/core/future.h"
+#include "ara/core/future_error_domain.h"
+#include "ara/core/internal/future_shared_state.h"
+#include "ara/core/promise.h"
+#include "ara/core/result.h"
+#include "ara/core/vector.h"
+#include "vac/language/throw_or_terminate.h"
+
+namespace ara {
+namespace core {
+
+/*!
+ * \brief  Value of the Future returned by WhenAny().
+ * \tparam T Value type of the input Futures.
+ * \tparam E Error type of the input Futures.
+ * \vpublic
+ */
+template <typename T, typename E>
+struct WhenAnyResult {
+  /*!
+   * \brief Position of the first ready input Future in the input range.
+   */
+  std::size_t index;
+
+  /*!
+   * \brief The Result of the first ready input Future.
+   */
+  Result<T, E> result;
+};
+
+namespace internal {
+
+/*!
+ * \brief  Type trait to detect ara::core::Future types.
+ * \tparam F The type to check.
+ * \vprivate
+ */
+template <typename F>
+struct IsFuture : std::false_type {};
+
+/*!
+ * \brief  Type trait to detect ara::core::Future types, specialization for Futures.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename T, typename E>
+struct IsFuture<Future<T, E>> : std::true_type {};
+
+/*!
+ * \brief  Value and error type of an ara::core::Future.
+ * \tparam F The Future type.
+ * \vprivate
+ */
+template <typename F>
+struct FutureTraits;
+
+/*!
+ * \brief  Value and error type of an ara::core::Future, specialization for Futures.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename T, typename E>
+struct FutureTraits<Future<T, E>> {
+  /*! \brief Type alias. */
+  using value_type = T;
+
+  /*! \brief Type alias. */
+  using error_type = E;
+};
+
+/*!
+ * \brief  Enables a template for iterators over ara::core::Future.
+ * \tparam InputIt The iterator type.
+ * \vprivate
+ */
+template <typename InputIt>
+using EnableIfFutureIterator =
+    typename std::enable_if<IsFuture<typename std::iterator_traits<InputIt>::value_type>::value>::type;
+
+/*!
+ * \brief  Continuation registered on one input Future of a combinator.
+ * \tparam Owner The combined state the slot belongs to.
+ * \vprivate
+ */
+template <typename Owner>
+class CombinatorSlot final : public CallBackHolderInterface {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param owner The combined state.
+   * \param index The position of the input Future.
+   */
+  CombinatorSlot(Owner& owner, std::size_t index) noexcept : CallBackHolderInterface(), owner_(owner), index_(index) {}
+
+  /*!
+   * \brief Notifies the combined state that the input Future is ready.
+   */
+  void ExecuteCallBack() override { owner_.OnInputReady(index_); }
+
+  /*!
+   * \brief  A slot is always executable.
+   * \return true.
+   */
+  bool IsExecutable() override { return true; }
+
+  /*!
+   * \brief The slot is part of the combined state, only the reference to the combined state is released.
+   */
+  void Dispose() noexcept override { owner_.Release(); }
+
+ private:
+  /*!
+   * \brief The combined state.
+   */
+  Owner& owner_;
+
+  /*!
+   * \brief The position of the input Future.
+   */
+  std::size_t index_;
+};
+
+/* VECTOR Next Construct AutosarC++17_10-A12.4.1: MD_VAC_A12.4.1_destructorOfABaseClassShallBePublicVirtual */
+/*!
+ * \brief   Common part of the combined states.
+ * \details The combined state is referenced by every registered slot and, while the slots are registered, by the
+ *          combinator itself. It deletes itself once the last reference is released.
+ * \tparam  Derived The combined state type.
+ * \tparam  Output The value type of the resulting Future.
+ * \vprivate
+ */
+template <typename Derived, typename Output>
+class CombinatorState {
+ public:
+  /*!
+   * \brief  Returns the resulting Future.
+   * \return The resulting Future.
+   */
+  Future<Output> GetFuture() { return promise_.get_future(); }
+
+  /*!
+   * \brief Releases one reference to the combined state.
+   */
+  void Release() noexcept {
+    if (references_.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+      delete static_cast<Derived*>(this);
+    }
+  }
+
+  /*!
+   * \brief Copy constructor deleted.
+   */
+  CombinatorState(CombinatorState const&) = delete;
+
+  /*!
+   * \brief Move constructor deleted.
+   */
+  CombinatorState(CombinatorState&&) = delete;
+
+  /*!
+   * \brief Copy assignment deleted.
+   */
+  CombinatorState& operator=(CombinatorState const&) & = delete;
+
+  /*!
+   * \brief Move assignment deleted.
+   */
+  CombinatorState& operator=(CombinatorState&&) & = delete;
+
+ protected:
+  /*!
+   * \brief Constructor. The combinator holds the initial reference.
+   */
+  CombinatorState() : promise_(), references_(1U) {}
+
+  /*!
+   * \brief Destructor.
+   */
+  ~CombinatorState() noexcept = default;
+
+  /*!
+   * \brief Takes one reference per input Future.
+   * \param count The number of input Futures.
+   */
+  void AddReferences(std::size_t count) noexcept {
+    static_cast<void>(references_.fetch_add(count, std::memory_order_relaxed));
+  }
+
+  /*!
+   * \brief The Promise of the resulting Future.
+   */
+  Promise<Output> promise_;
+
+ private:
+  /*!
+   * \brief Number of references to the combined state.
+   */
+  std::atomic<std::size_t> references_;
+};
+
+/*!
+ * \brief  Combined state of WhenAll() for a fixed set of Futures.
+ * \tparam Futures The input Future types.
+ * \vprivate
+ */
+template <typename... Futures>
+class WhenAllTupleState;
+
+/*!
+ * \brief  Combined state of WhenAll() for a fixed set of Futures.
+ * \tparam Ts The value types of the input Futures.
+ * \tparam Es The error types of the input Futures.
+ * \vprivate
+ */
+template <typename... Ts, typename... Es>
+class WhenAllTupleState<Future<Ts, Es>...> final
+    : public CombinatorState<WhenAllTupleState<Future<Ts, Es>...>, std::tuple<Result<Ts, Es>...>> {
+  /*!
+   * \brief Type of the continuation slots.
+   */
+  using Slot = CombinatorSlot<WhenAllTupleState>;
+
+  /*!
+   * \brief Index sequence over the input Futures.
+   */
+  using Indices = std::index_sequence_for<Ts...>;
+
+ public:
+  /*!
+   * \brief Constructor.
+   * \param futures The input Futures.
+   */
+  explicit WhenAllTupleState(Future<Ts, Es>&&... futures)
+      : CombinatorState<WhenAllTupleState, std::tuple<Result<Ts, Es>...>>(),
+        futures_(std::move(futures)...),
+        slots_(MakeSlots(Indices{})),
+        pending_(sizeof...(Ts)) {}
+
+  /*!
+   * \brief Throws if one of the input Futures has no shared state.
+   */
+  void ThrowIfAnyInvalid() const {
+    if (!AllValid(Indices{})) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+    }
+  }
+
+  /*!
+   * \brief Registers the slots on the input Futures and drops the reference held by the combinator.
+   */
+  void Start() {
+    this->AddReferences(sizeof...(Ts));
+    Register(Indices{});
+    this->Release();
+  }
+
+  /*!
+   * \brief Counts down the ready inputs and sets the resulting Future once all are ready.
+   */
+  void OnInputReady(std::size_t) {
+    if (pending_.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+      this->promise_.set_value(Collect(Indices{}));
+    }
+  }
+
+ private:
+  /*!
+   * \brief  Creates one slot per input Future.
+   * \return The slots.
+   */
+  template <std::size_t... Is>
+  std::array<Slot, sizeof...(Ts)> MakeSlots(std::index_sequence<Is...>) noexcept {
+    return {{Slot(*this, Is)...}};
+  }
+
+  /*!
+   * \brief  Checks the input Futures.
+   * \return true if all input Futures have a shared state.
+   */
+  template <std::size_t... Is>
+  bool AllValid(std::index_sequence<Is...>) const noexcept {
+    bool valid{true};
+    for (bool const input_valid : {std::get<Is>(futures_).valid()...}) {
+      valid = valid && input_valid;
+    }
+    return valid;
+  }
+
+  /*!
+   * \brief Registers the slots on the input Futures.
+   */
+  template <std::size_t... Is>
+  void Register(std::index_sequence<Is...>) {
+    using Expander = int[];
+    static_cast<void>(Expander{(std::get<Is>(futures_).SetContinuation(ContinuationPtr{&slots_[Is]}), 0)...});
+  }
+
+  /*!
+   * \brief  Takes the Results of all input Futures.
+   * \return The Results.
+   */
+  template <std::size_t... Is>
+  std::tuple<Result<Ts, Es>...> Collect(std::index_sequence<Is...>) {
+    return std::tuple<Result<Ts, Es>...>{std::get<Is>(futures_).GetResult()...};
+  }
+
+  /*!
+   * \brief The input Futures.
+   */
+  std::tuple<Future<Ts, Es>...> futures_;
+
+  /*!
+   * \brief One continuation slot per input Future.
+   */
+  std::array<Slot, sizeof...(Ts)> slots_;
+
+  /*!
+   * \brief Number of input Futures that are not ready yet.
+   */
+  std::atomic<std::size_t> pending_;
+};
+
+/*!
+ * \brief  Input entry of the range combinators.
+ * \tparam T The value type of the input Futures.
+ * \tparam E The error type of the input Futures.
+ * \tparam Owner The combined state.
+ * \vprivate
+ */
+template <typename T, typename E, typename Owner>
+struct CombinatorInput {
+  /*!
+   * \brief The input Future.
+   */
+  Future<T, E> future;
+
+  /*!
+   * \brief The continuation slot registered on the input Future.
+   */
+  CombinatorSlot<Owner> slot;
+};
+
+/*!
+ * \brief   Common part of the range combinators.
+ * \tparam  Derived The combined state type.
+ * \tparam  T The value type of the input Futures.
+ * \tparam  E The error type of the input Futures.
+ * \tparam  Output The value type of the resulting Future.
+ * \vprivate
+ */
+template <typename Derived, typename T, typename E, typename Output>
+class RangeCombinatorState : public CombinatorState<Derived, Output> {
+ public:
+  /*!
+   * \brief Throws if one of the input Futures has no shared state.
+   */
+  void ThrowIfAnyInvalid() const {
+    for (Input const& input : inputs_) {
+      if (!input.future.valid()) {
+        vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+      }
+    }
+  }
+
+  /*!
+   * \brief Registers the slots on the input Futures and drops the reference held by the combinator.
+   */
+  void Start() {
+    this->AddReferences(inputs_.size());
+    for (Input& input : inputs_) {
+      input.future.SetContinuation(ContinuationPtr{&input.slot});
+    }
+    this->Release();
+  }
+
+ protected:
+  /*!
+   * \brief Input entry type.
+   */
+  using Input = CombinatorInput<T, E, Derived>;
+
+  /*!
+   * \brief Constructor.
+   */
+  RangeCombinatorState() : CombinatorState<Derived, Output>(), inputs_() {}
+
+  /*!
+   * \brief  Moves the input Futures into the combined state.
+   * \tparam InputIt Iterator over the input Futures.
+   * \param  owner The combined state, the slots refer to.
+   * \param  first Begin of the input range.
+   * \param  last End of the input range.
+   */
+  template <typename InputIt>
+  void AddInputs(Derived& owner, InputIt first, InputIt last) {
+    ReserveInputs(first, last, typename std::iterator_traits<InputIt>::iterator_category{});
+    std::size_t index{0U};
+    for (InputIt it{first}; it != last; ++it) {
+      inputs_.push_back(Input{std::move(*it), CombinatorSlot<Derived>{owner, index}});
+      ++index;
+    }
+  }
+
+  /*!
+   * \brief Destructor.
+   */
+  ~RangeCombinatorState() noexcept = default;
+
+  /*!
+   * \brief The input Futures and their slots. Not resized once the slots are registered.
+   */
+  Vector<Input> inputs_;
+
+ private:
+  /*!
+   * \brief  Allocates the inputs once if the size of the range is known up front.
+   * \tparam ForwardIt Iterator over the input Futures.
+   * \param  first Begin of the input range.
+   * \param  last End of the input range.
+   */
+  template <typename ForwardIt>
+  void ReserveInputs(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    inputs_.reserve(static_cast<std::size_t>(std::distance(first, last)));
+  }
+
+  /*!
+   * \brief  Single pass ranges cannot be measured without consuming them, so the inputs grow while they are added.
+   * \tparam InputIt Iterator over the input Futures.
+   */
+  template <typename InputIt>
+  void ReserveInputs(InputIt, InputIt, std::input_iterator_tag) {}
+};
+
+/*!
+ * \brief  Combined state of WhenAll() for a range of Futures.
+ * \tparam T The value type of the input Futures.
+ * \tparam E The error type of the input Futures.
+ * \vprivate
+ */
+template <typename T, typename E>
+class WhenAllRangeState final : public RangeCombinatorState<WhenAllRangeState<T, E>, T, E, Vector<Result<T, E>>> {
+ public:
+  /*!
+   * \brief  Constructor.
+   * \tparam InputIt Iterator over the input Futures.
+   * \param  first Begin of the input range.
+   * \param  last End of the input range.
+   */
+  template <typename InputIt>
+  WhenAllRangeState(InputIt first, InputIt last)
+      : RangeCombinatorState<WhenAllRangeState, T, E, Vector<Result<T, E>>>(), pending_(0U) {
+    this->AddInputs(*this, first, last);
+    pending_.store(this->inputs_.size(), std::memory_order_relaxed);
+    if (this->inputs_.empty()) {
+      this->promise_.set_value(Vector<Result<T, E>>{});
+    }
+  }
+
+  /*!
+   * \brief Counts down the ready inputs and sets the resulting Future once all are ready.
+   */
+  void OnInputReady(std::size_t) {
+    if (pending_.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+      Vector<Result<T, E>> results;
+      results.reserve(this->inputs_.size());
+      for (typename WhenAllRangeState::Input& input : this->inputs_) {
+        results.push_back(input.future.GetResult());
+      }
+      this->promise_.set_value(std::move(results));
+    }
+  }
+
+ private:
+  /*!
+   * \brief Number of input Futures that are not ready yet.
+   */
+  std::atomic<std::size_t> pending_;
+};
+
+/*!
+ * \brief  Combined state of WhenAny() for a range of Futures.
+ * \tparam T The value type of the input Futures.
+ * \tparam E The error type of the input Futures.
+ * \vprivate
+ */
+template <typename T, typename E>
+class WhenAnyRangeState final : public RangeCombinatorState<WhenAnyRangeState<T, E>, T, E, WhenAnyResult<T, E>> {
+ public:
+  /*!
+   * \brief  Constructor.
+   * \tparam InputIt Iterator over the input Futures.
+   * \param  first Begin of the input range.
+   * \param  last End of the input range.
+   */
+  template <typename InputIt>
+  WhenAnyRangeState(InputIt first, InputIt last)
+      : RangeCombinatorState<WhenAnyRangeState, T, E, WhenAnyResult<T, E>>(), completed_(false) {
+    this->AddInputs(*this, first, last);
+    if (this->inputs_.empty()) {
+      this->promise_.SetError(ErrorCode{future_errc::no_state});
+    }
+  }
+
+  /*!
+   * \brief Sets the resulting Future with the Result of the first ready input.
+   * \param index The position of the ready input Future.
+   */
+  void OnInputReady(std::size_t index) {
+    if (!completed_.exchange(true, std::memory_order_acq_rel)) {
+      this->promise_.set_value(WhenAnyResult<T, E>{index, this->inputs_[index].future.GetResult()});
+    }
+  }
+
+ private:
+  /*!
+   * \brief Set by the first ready input Future.
+   */
+  std::atomic<bool> completed_;
+};
+
+/*!
+ * \brief  Creates a combined state, registers it on its inputs and returns the resulting Future.
+ * \tparam State The combined state type.
+ * \tparam Args The constructor argument types of State.
+ * \param  args The constructor arguments of State.
+ * \return The resulting Future.
+ * \throws ara::core::FutureException with future_errc::no_state if an input Future has no shared state.
+ * \vprivate
+ */
+template <typename State, typename... Args>
+auto StartCombinator(Args&&... args) -> decltype(std::declval<State&>().GetFuture()) {
+  std::unique_ptr<State> state{new State(std::forward<Args>(args)...)};
+  state->ThrowIfAnyInvalid();
+  auto future = state->GetFuture();
+  state.release()->Start();
+  return future;
+}
+
+}  // namespace internal
+
+/*!
+ * \brief   Combines Futures into one Future that becomes ready once all of them are ready.
+ * \details No thread is blocked. The input Futures are consumed.
+ * \tparam  Ts The value types of the input Futures.
+ * \tparam  Es The error types of the input Futures.
+ * \param   futures The input Futures.
+ * \return  Future holding the Results of all input Futures in the order of the arguments.
+ * \throws  ara::core::FutureException with future_errc::no_state if an input Future has no shared state.
+ * \vpublic
+ */
+template <typename... Ts, typename... Es>
+auto WhenAll(Future<Ts, Es>... futures) -> Future<std::tuple<Result<Ts, Es>...>> {
+  static_assert(sizeof...(Ts) > 0U, "WhenAll needs at least one Future");
+  return internal::StartCombinator<internal::WhenAllTupleState<Future<Ts, Es>...>>(std::move(futures)...);
+}
+
+/*!
+ * \brief   Combines a range of Futures into one Future that becomes ready once all of them are ready.
+ * \details No thread is blocked. The input Futures are moved out of the range. An empty range results in a ready
+ *          Future holding an empty Vector.
+ * \tparam  InputIt Iterator over ara::core::Future<T, E>.
+ * \param   first Begin of the input range.
+ * \param   last End of the input range.
+ * \return  Future holding the Results of all input Futures in the order of the range.
+ * \throws  ara::core::FutureException with future_errc::no_state if an input Future has no shared state.
+ * \vpublic
+ */
+template <typename InputIt, typename = internal::EnableIfFutureIterator<InputIt>>
+auto WhenAll(InputIt first, InputIt last) {
+  /*! \brief Alias for the value and error type of the input Futures. */
+  using Traits = internal::FutureTraits<typename std::iterator_traits<InputIt>::value_type>;
+  /*! \brief Alias for the combined state type. */
+  using State = internal::WhenAllRangeState<typename Traits::value_type, typename Traits::error_type>;
+  return internal::StartCombinator<State>(first, last);
+}
+
+/*!
+ * \brief   Combines a range of Futures into one Future that becomes ready once any of them is ready.
+ * \details No thread is blocked. The input Futures are moved out of the range. An empty range results in a ready
+ *          Future holding the error future_errc::no_state.
+ * \tparam  InputIt Iterator over ara::core::Future<T, E>.
+ * \param   first Begin of the input range.
+ * \param   last End of the input range.
+ * \return  Future holding the position and Result of the first ready input Future.
+ * \throws  ara::core::FutureException with future_errc::no_state if an input Future has no shared state.
+ * \vpublic
+ */
+template <typename InputIt, typename = internal::EnableIfFutureIterator<InputIt>>
+auto WhenAny(InputIt first, InputIt last) {
+  /*! \brief Alias for the value and error type of the input Futures. */
+  using Traits = internal::FutureTraits<typename std::iterator_traits<InputIt>::value_type>;
+  /*! \brief Alias for the combined state type. */
+  using State = internal::WhenAnyRangeState<typename Traits::value_type, typename Traits::error_type>;
+  return internal::StartCombinator<State>(first, last);
+}
+
+}  // namespace core
+}  // namespace ara
+
+#endif  // LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COMBINATORS_H_
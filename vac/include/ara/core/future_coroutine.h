@@ -0,0 +1,554 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  ara/core/future_coroutine.h
+ *        \brief  C++20 coroutine support for ara::core::Future.
+ *
+ *      \details  ara::core::Future can be used as coroutine return type and can be awaited with co_await. Awaiting
+ *                yields the Result of the Future. Coroutine frames are allocated from thread local block pools. The
+ *                awaiting coroutine is resumed in the context that makes the Future ready, or on an executor if the
+ *                Future is awaited through ResumeOn(). A coroutine that completes the Future another coroutine waits
+ *                for transfers control to it symmetrically instead of resuming it on a nested stack frame.
+ *                Only available if the compiler supports coroutines, otherwise this header is empty.
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COROUTINE_H_
+#define LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COROUTINE_H_
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "ara/core/error_code.h"
+#include "ara/core/future.h"
+#include "ara/core/internal/future_shared_state.h"
+#include "ara/core/promise.h"
+#include "ara/core/result.h"
+#include "vac/memory/thread_local_block_pool.h"
+#include "vac/threadpool/executor.h"
+
+namespace ara {
+namespace core {
+namespace internal {
+
+/*!
+ * \brief Allocator for coroutine frames. Frames up to 1 KiB are taken from thread local block pools.
+ * \vprivate
+ */
+class CoroutineFrameAllocator final {
+ public:
+  /*!
+   * \brief  Allocates a coroutine frame.
+   * \param  size The size of the frame.
+   * \return Pointer to uninitialized memory.
+   */
+  static void* Allocate(std::size_t size) {
+    void* frame{nullptr};
+    if (size <= 128U) {
+      frame = Pool<128U>::Allocate();
+    } else if (size <= 256U) {
+      frame = Pool<256U>::Allocate();
+    } else if (size <= 512U) {
+      frame = Pool<512U>::Allocate();
+    } else if (size <= 1024U) {
+      frame = Pool<1024U>::Allocate();
+    } else {
+      frame = ::operator new(size);
+    }
+    return frame;
+  }
+
+  /*!
+   * \brief Releases a coroutine frame.
+   * \param frame The frame, obtained from Allocate().
+   * \param size The size passed to Allocate().
+   */
+  static void Deallocate(void* frame, std::size_t size) noexcept {
+    if (size <= 128U) {
+      Pool<128U>::Deallocate(frame);
+    } else if (size <= 256U) {
+      Pool<256U>::Deallocate(frame);
+    } else if (size <= 512U) {
+      Pool<512U>::Deallocate(frame);
+    } else if (size <= 1024U) {
+      Pool<1024U>::Deallocate(frame);
+    } else {
+      ::operator delete(frame);
+    }
+  }
+
+ private:
+  /*!
+   * \brief  Pool for one frame size class.
+   * \tparam block_size The size class.
+   */
+  template <std::size_t block_size>
+  using Pool = vac::memory::ThreadLocalBlockPool<block_size>;
+};
+
+/*!
+ * \brief  Returns the slot of the calling thread in which a completing coroutine collects the coroutine to transfer
+ *         control to.
+ * \return Reference to the slot pointer, nullptr if no coroutine is completing.
+ * \vprivate
+ */
+inline std::coroutine_handle<>*& SymmetricTransferTarget() noexcept {
+  static thread_local std::coroutine_handle<>* target{nullptr};
+  return target;
+}
+
+/*!
+ * \brief Scope during which coroutines made resumable are collected in a slot instead of being resumed.
+ * \vprivate
+ */
+class SymmetricTransferScope final {
+ public:
+  /*!
+   * \brief Constructor. Installs the slot for the calling thread.
+   * \param target The slot.
+   */
+  explicit SymmetricTransferScope(std::coroutine_handle<>& target) noexcept
+      : previous_(std::exchange(SymmetricTransferTarget(), &target)) {}
+
+  /*!
+   * \brief Destructor. Restores the previous slot.
+   */
+  ~SymmetricTransferScope() noexcept { SymmetricTransferTarget() = previous_; }
+
+  /*!
+   * \brief Copy constructor deleted.
+   */
+  SymmetricTransferScope(SymmetricTransferScope const&) = delete;
+
+  /*!
+   * \brief Move constructor deleted.
+   */
+  SymmetricTransferScope(SymmetricTransferScope&&) = delete;
+
+  /*!
+   * \brief Copy assignment deleted.
+   */
+  SymmetricTransferScope& operator=(SymmetricTransferScope const&) & = delete;
+
+  /*!
+   * \brief Move assignment deleted.
+   */
+  SymmetricTransferScope& operator=(SymmetricTransferScope&&) & = delete;
+
+ private:
+  /*!
+   * \brief The slot that was installed before.
+   */
+  std::coroutine_handle<>* previous_;
+};
+
+/*!
+ * \brief   Continuation that resumes an awaiting coroutine.
+ * \details Lives in the coroutine frame, so it is never accessed once the coroutine has been resumed.
+ * \vprivate
+ */
+class CoroutineResumer final : public CallBackHolderInterface {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param executor The executor to resume on, or nullptr to resume in the context that makes the Future ready.
+   */
+  explicit CoroutineResumer(vac::threadpool::Executor* executor) noexcept
+      : CallBackHolderInterface(), executor_(executor), handle_(), arrived_(false) {}
+
+  /*!
+   * \brief Copy constructor deleted.
+   */
+  CoroutineResumer(CoroutineResumer const&) = delete;
+
+  /*!
+   * \brief Move constructor deleted.
+   */
+  CoroutineResumer(CoroutineResumer&&) = delete;
+
+  /*!
+   * \brief Copy assignment deleted.
+   */
+  CoroutineResumer& operator=(CoroutineResumer const&) & = delete;
+
+  /*!
+   * \brief Move assignment deleted.
+   */
+  CoroutineResumer& operator=(CoroutineResumer&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~CoroutineResumer() noexcept final = default;
+
+  /*!
+   * \brief Sets the coroutine to resume. Must be called before the resumer is registered.
+   * \param handle The awaiting coroutine.
+   */
+  void SetHandle(std::coroutine_handle<> handle) noexcept { handle_ = handle; }
+
+  /*!
+   * \brief  Marks the arrival of one of the two parties, the suspending coroutine and the ready Future.
+   * \return true if the other party has arrived already.
+   */
+  bool Arrive() noexcept { return arrived_.exchange(true, std::memory_order_acq_rel); }
+
+  /*!
+   * \brief  Whether the coroutine is resumed on an executor.
+   * \return true if an executor is set.
+   */
+  bool HasExecutor() const noexcept { return executor_ != nullptr; }
+
+  /*!
+   * \brief Resumes the coroutine, see ExecuteAndDispose().
+   */
+  void ExecuteCallBack() override { ExecuteAndDispose(); }
+
+  /*!
+   * \brief  The resumer is always executable.
+   * \return true.
+   */
+  bool IsExecutable() override { return true; }
+
+  /*!
+   * \brief The resumer is owned by the coroutine frame.
+   */
+  void Dispose() noexcept override {}
+
+  /*!
+   * \brief Dispatches the coroutine to the executor, or resumes it once the coroutine is suspended.
+   */
+  void ExecuteAndDispose() override {
+    std::coroutine_handle<> const handle{handle_};
+    if (executor_ != nullptr) {
+      executor_->Execute([handle]() { handle.resume(); });
+    } else if (Arrive()) {
+      std::coroutine_handle<>* const target{SymmetricTransferTarget()};
+      if ((target != nullptr) && (!(*target))) {
+        *target = handle;
+      } else {
+        handle.resume();
+      }
+    }
+  }
+
+ private:
+  /*!
+   * \brief The executor to resume on.
+   */
+  vac::threadpool::Executor* executor_;
+
+  /*!
+   * \brief The awaiting coroutine.
+   */
+  std::coroutine_handle<> handle_;
+
+  /*!
+   * \brief Set by the first of the suspending coroutine and the ready Future.
+   */
+  std::atomic<bool> arrived_;
+};
+
+/*!
+ * \brief  Awaiter for ara::core::Future.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename T, typename E>
+class FutureAwaiter final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param future The awaited Future.
+   * \param executor The executor to resume on, or nullptr.
+   * \param policy Whether a ready Future is consumed without a hop to the executor.
+   */
+  FutureAwaiter(Future<T, E>&& future, vac::threadpool::Executor* executor, continuation_policy policy) noexcept
+      : future_(std::move(future)), resumer_(executor), policy_(policy) {}
+
+  /*!
+   * \brief Copy constructor deleted.
+   */
+  FutureAwaiter(FutureAwaiter const&) = delete;
+
+  /*!
+   * \brief Move constructor deleted.
+   */
+  FutureAwaiter(FutureAwaiter&&) = delete;
+
+  /*!
+   * \brief Copy assignment deleted.
+   */
+  FutureAwaiter& operator=(FutureAwaiter const&) & = delete;
+
+  /*!
+   * \brief Move assignment deleted.
+   */
+  FutureAwaiter& operator=(FutureAwaiter&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~FutureAwaiter() noexcept = default;
+
+  /*!
+   * \brief  Checks whether the coroutine can continue without suspending.
+   * \return true if the Future is invalid or ready and no hop to an executor is requested.
+   */
+  bool await_ready() const noexcept {
+    bool const inline_allowed{(!resumer_.HasExecutor()) || (policy_ == continuation_policy::inline_if_ready)};
+    return (!future_.valid()) || (inline_allowed && future_.is_ready());
+  }
+
+  /*!
+   * \brief  Registers the resumer on the Future.
+   * \param  handle The awaiting coroutine.
+   * \return false if the Future became ready meanwhile and the coroutine continues immediately.
+   */
+  bool await_suspend(std::coroutine_handle<> handle) {
+    resumer_.SetHandle(handle);
+    bool const resume_on_executor{resumer_.HasExecutor()};
+    bool suspend{true};
+    future_.SetContinuation(ContinuationPtr{&resumer_});
+    // With an executor the coroutine may already run once the resumer is registered, so the frame is not touched.
+    if (!resume_on_executor) {
+      suspend = !resumer_.Arrive();
+    }
+    return suspend;
+  }
+
+  /*!
+   * \brief  Takes the Result of the Future.
+   * \return The Result, or future_errc::no_state if the Future was invalid.
+   */
+  Result<T, E> await_resume() noexcept { return future_.GetResult(); }
+
+ private:
+  /*!
+   * \brief The awaited Future.
+   */
+  Future<T, E> future_;
+
+  /*!
+   * \brief The continuation resuming the coroutine.
+   */
+  CoroutineResumer resumer_;
+
+  /*!
+   * \brief Whether a ready Future is consumed without a hop to the executor.
+   */
+  continuation_policy policy_;
+};
+
+/*!
+ * \brief Awaiter for the final suspend point of a coroutine returning ara::core::Future.
+ * \vprivate
+ */
+class FinalAwaiter final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param next The coroutine to transfer control to, or a null handle.
+   */
+  explicit FinalAwaiter(std::coroutine_handle<> next) noexcept : next_(next) {}
+
+  /*!
+   * \brief  Always suspends.
+   * \return false.
+   */
+  bool await_ready() const noexcept { return false; }
+
+  /*!
+   * \brief  Destroys the completed coroutine and transfers control to the next one.
+   * \param  self The completed coroutine.
+   * \return The coroutine to continue with.
+   */
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> self) const noexcept {
+    // The awaiter is part of the frame, so it must not be accessed after the frame is destroyed.
+    std::coroutine_handle<> const next{next_ ? next_ : std::noop_coroutine()};
+    self.destroy();
+    return next;
+  }
+
+  /*!
+   * \brief Never called, the coroutine is destroyed while suspended.
+   */
+  void await_resume() const noexcept {}
+
+ private:
+  /*!
+   * \brief The coroutine to continue with.
+   */
+  std::coroutine_handle<> next_;
+};
+
+/*!
+ * \brief  Common part of the promise types of coroutines returning ara::core::Future.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename T, typename E>
+class FuturePromiseBase {
+ public:
+  /*!
+   * \brief  Creates the Future returned to the caller of the coroutine.
+   * \return The Future.
+   */
+  Future<T, E> get_return_object() { return promise_.get_future(); }
+
+  /*!
+   * \brief  Coroutines start eagerly.
+   * \return An awaiter that does not suspend.
+   */
+  std::suspend_never initial_suspend() const noexcept { return {}; }
+
+  /*!
+   * \brief  Destroys the coroutine once completed and continues with the coroutine waiting for its Future.
+   * \return The final awaiter.
+   */
+  FinalAwaiter final_suspend() const noexcept { return FinalAwaiter{next_}; }
+
+  /*!
+   * \brief Errors are returned as Result. An exception leaving the coroutine body terminates.
+   */
+  void unhandled_exception() const noexcept { std::terminate(); }
+
+  /*!
+   * \brief  Allocates the coroutine frame from a pool.
+   * \param  size The size of the frame.
+   * \return The frame.
+   */
+  static void* operator new(std::size_t size) { return CoroutineFrameAllocator::Allocate(size); }
+
+  /*!
+   * \brief Returns the coroutine frame to its pool.
+   * \param frame The frame.
+   * \param size The size of the frame.
+   */
+  static void operator delete(void* frame, std::size_t size) noexcept {
+    CoroutineFrameAllocator::Deallocate(frame, size);
+  }
+
+ protected:
+  /*!
+   * \brief Sets the Future, collecting an awaiting coroutine for symmetric transfer.
+   * \param result The Result to set.
+   */
+  void Complete(Result<T, E>&& result) {
+    SymmetricTransferScope const scope{next_};
+    SetValueOrError(promise_, std::move(result));
+  }
+
+ private:
+  /*!
+   * \brief The Promise of the returned Future.
+   */
+  Promise<T, E> promise_;
+
+  /*!
+   * \brief The coroutine that waits for the returned Future, if it became resumable on completion.
+   */
+  std::coroutine_handle<> next_;
+};
+
+/*!
+ * \brief  Promise type of coroutines returning ara::core::Future.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename T, typename E>
+class FuturePromise final : public FuturePromiseBase<T, E> {
+ public:
+  /*!
+   * \brief Handles co_return with a value or a Result.
+   * \param result The Result to set.
+   */
+  void return_value(Result<T, E> result) { this->Complete(std::move(result)); }
+};
+
+/*!
+ * \brief  Promise type of coroutines returning ara::core::Future, specialization for void.
+ * \tparam E The error type of the Future.
+ * \vprivate
+ */
+template <typename E>
+class FuturePromise<void, E> final : public FuturePromiseBase<void, E> {
+ public:
+  /*!
+   * \brief Handles co_return without value.
+   */
+  void return_void() { this->Complete(Result<void, E>{}); }
+};
+
+}  // namespace internal
+
+/*!
+ * \brief  Awaits a Future. The coroutine is resumed in the context that makes the Future ready.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \param  future The Future to await.
+ * \return The awaiter, yielding the Result of the Future.
+ * \vpublic
+ */
+template <typename T, typename E>
+internal::FutureAwaiter<T, E> operator co_await(Future<T, E>&& future) noexcept {
+  return internal::FutureAwaiter<T, E>{std::move(future), nullptr, continuation_policy::dispatch};
+}
+
+/*!
+ * \brief  Awaits a Future and resumes the coroutine on the given executor.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \param  future The Future to await.
+ * \param  executor The executor to resume on. Must outlive the suspension.
+ * \param  policy Whether a ready Future is consumed without a hop to the executor.
+ * \return The awaiter, yielding the Result of the Future.
+ * \vpublic
+ */
+template <typename T, typename E>
+internal::FutureAwaiter<T, E> ResumeOn(Future<T, E>&& future, vac::threadpool::Executor& executor,
+                                       continuation_policy policy = continuation_policy::dispatch) noexcept {
+  return internal::FutureAwaiter<T, E>{std::move(future), &executor, policy};
+}
+
+}  // namespace core
+}  // namespace ara
+
+/*!
+ * \brief  Makes ara::core::Future usable as coroutine return type.
+ * \tparam T The value type of the Future.
+ * \tparam E The error type of the Future.
+ * \tparam Args The parameter types of the coroutine.
+ */
+template <typename T, typename E, typename... Args>
+struct std::coroutine_traits<ara::core::Future<T, E>, Args...> {
+  /*! \brief Type alias. */
+  using promise_type = ara::core::internal::FuturePromise<T, E>;
+};
+
+#endif  // __has_include(<coroutine>)
+#endif  // defined(__cpp_impl_coroutine) && defined(__has_include)
+
+#endif  // LIB_VAC_INCLUDE_ARA_CORE_FUTURE_COROUTINE_H_
@@ -22,109 +22,62 @@
 /**********************************************************************************************************************
  *  INCLUDES
  *********************************************************************************************************************/
-#include <functional>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include "ara/core/future.h"
+#include "ara/core/internal/future_shared_state.h"
 #include "ara/core/promise.h"
+#include "vac/threadpool/executor.h"
 
 namespace ara {
 namespace core {
 namespace internal {
 
-/* VECTOR Next Construct AutosarC++17_10-A12.8.6: MD_VAC_A12.8.6_definedDeletedInBassClass */
-/*!
- * \brief CallBackHolder interface.
- * \vprivate
- */
-class CallBackHolderInterface {
- public:
-  /*!
-   * \brief Default constructor.
-   */
-  CallBackHolderInterface() = default;
-
-  /*!
-   * \brief Default copy constructor.
-   */
-  CallBackHolderInterface(CallBackHolderInterface const& other) = default;
-
-  /*!
-   * \brief Default move constructor.
-   */
-  CallBackHolderInterface(CallBackHolderInterface&& other) noexcept = default;
-
-  /*!
-   * \brief Deleted copy assignment operator.
-   */
-  CallBackHolderInterface& operator=(CallBackHolderInterface const& other) & = delete;
-
-  /*!
-   * \brief Deleted move assignment operator.
-   */
-  CallBackHolderInterface& operator=(CallBackHolderInterface&& other) & = delete;
-
-  /*!
-   * \brief Destructor.
-   */
-  virtual ~CallBackHolderInterface() noexcept {}
-
-  /*!
-   * \brief Executes the callback.
-   */
-  virtual void ExecuteCallBack() = 0;
-
-  /*!
-   * \brief Checks if callback is not nullptr.
-   */
-  virtual bool IsExecutable() = 0;
-};
-
-/* VECTOR Next Construct VectorC++-V11-0-2: MD_VAC_V11-0-2_mutableUnionMemberShallBePrivate */
 /* VECTOR Next Construct AutosarC++17_10-A12.4.1: MD_VAC_A12.4.1_destructorOfABaseClassShallBePublicVirtual */
 /*!
- * \brief  Callback holder base class to perform the callback execution.
- * \tparam T is type for the calling Future.
- * \tparam E is the error type for the calling Future.
- * \tparam U is the type returned back from the registered call back function.
- * \tparam T2 The unwrapped value type returned back from the registered call back function.
- * \tparam E2 The unwrapped error type returned back from the registered call back function.
+ * \brief   Callback holder base class to perform the callback execution.
+ * \details Holds the callable, the calling Future and the Promise of the chained Future by value, so that the whole
+ *          continuation fits into one block.
+ * \tparam  T is type for the calling Future.
+ * \tparam  E is the error type for the calling Future.
+ * \tparam  F The type of the registered call back function.
+ * \tparam  U is the type returned back from the registered call back function.
+ * \tparam  T2 The unwrapped value type returned back from the registered call back function.
+ * \tparam  E2 The unwrapped error type returned back from the registered call back function.
  * \vprivate
  */
-template <typename T, typename E, typename U, typename T2, typename E2>
+template <typename T, typename E, typename F, typename U, typename T2, typename E2>
 class CallBackHolderBase : public CallBackHolderInterface {
  public:
   /*!
-   * \brief Callback handler type.
-   */
-  using CallBackHandler = std::function<U(ara::core::Future<T, E>)>;
-
-  /*!
-   * \brief Constructor.
-   * \param new_promise New promise to be set when the callback is called (it needs to be set with the return value
-   *        from the callback).
-   * \param calling_future The future on which the then function is called (calling future needs to be passed as a
-   *        parameter to the call back function and it gets invalidated once then() is called).
-   * \param handler The handler to the callback function.
+   * \brief  Constructor.
+   * \param  new_promise New promise to be set when the callback is called (it needs to be set with the return value
+   *         from the callback).
+   * \param  calling_future The future on which the then function is called (calling future needs to be passed as a
+   *         parameter to the call back function and it gets invalidated once then() is called).
+   * \param  handler The handler to the callback function.
+   * \tparam Handler Type from which the callback function is constructed.
    */
+  template <typename Handler>
   CallBackHolderBase(ara::core::Promise<T2, E2>&& new_promise, ara::core::Future<T, E>&& calling_future,
-                     CallBackHandler handler)
+                     Handler&& handler)
       : CallBackHolderInterface(),
-        new_promise_(std::make_unique<ara::core::Promise<T2, E2>>(std::move(new_promise))),
+        new_promise_(std::move(new_promise)),
         future_(std::move(calling_future)),
-        callback_handler_(std::move(handler)) {}
+        callback_handler_(std::forward<Handler>(handler)) {}
 
   /*!
-   * \brief  Checks if callback is not nullptr.
-   * \return true if callback_handler_ is not nullptr.
+   * \brief  The callback is held by value and therefore always executable.
+   * \return true.
    */
-  bool IsExecutable() override { return (callback_handler_ != nullptr); }
+  bool IsExecutable() override { return true; }
 
  protected:
   /*!
    * \brief New promise to be set when the callback is called.
    */
-  std::unique_ptr<ara::core::Promise<T2, E2>> new_promise_;
+  ara::core::Promise<T2, E2> new_promise_;
 
   /*!
    * \brief Future on which the function is called.
@@ -134,7 +87,7 @@ class CallBackHolderBase : public CallBackHolderInterface {
   /*!
    * \brief Callback handler.
    */
-  CallBackHandler callback_handler_;
+  F callback_handler_;
 };
 
 /* VECTOR Next Construct AutosarC++17_10-A12.8.3: MD_VAC_A12.8.3_dontReadAccessAMovedFromObject */
@@ -142,15 +95,16 @@ class CallBackHolderBase : public CallBackHolderInterface {
  * \brief  Callback holder class to perform the callback execution.
  * \tparam T The type for the calling Future.
  * \tparam E The error type for the calling Future.
+ * \tparam F The type of the registered call back function.
  * \tparam U The type returned back from the registered call back function.
  * \tparam T2 The unwrapped value type returned back from the registered call back function.
  * \tparam E2 The unwrapped error type returned back from the registered call back function.
  * \vprivate
  */
-template <typename T, typename E, typename U, typename T2, typename E2>
-class CallBackHolder : public CallBackHolderBase<T, E, U, T2, E2> {
+template <typename T, typename E, typename F, typename U, typename T2, typename E2>
+class CallBackHolder : public CallBackHolderBase<T, E, F, U, T2, E2> {
  public:
-  using CallBackHolderBase<T, E, U, T2, E2>::CallBackHolderBase;
+  using CallBackHolderBase<T, E, F, U, T2, E2>::CallBackHolderBase;
 
   /*!
    * \brief   Function to execute the registered call back.
@@ -158,7 +112,7 @@ class CallBackHolder : public CallBackHolderBase<T, E, U, T2, E2> {
    */
   void ExecuteCallBack() override {
     U ret_val{this->callback_handler_(std::move(this->future_))};
-    this->new_promise_->set_value(ret_val);
+    this->new_promise_.set_value(ret_val);
   }
 };
 
@@ -167,14 +121,15 @@ class CallBackHolder : public CallBackHolderBase<T, E, U, T2, E2> {
  * \brief  Specialization callback holder class to perform the callback execution for when U is void.
  * \tparam T is type for the calling future.
  * \tparam E is the error type for the calling Future.
+ * \tparam F The type of the registered call back function.
  * \tparam T2 The unwrapped value type returned back from the registered call back function.
  * \tparam E2 The unwrapped error type returned back from the registered call back function.
  * \vprivate
  */
-template <typename T, typename E, typename T2, typename E2>
-class CallBackHolder<T, E, void, T2, E2> : public CallBackHolderBase<T, E, void, T2, E2> {
+template <typename T, typename E, typename F, typename T2, typename E2>
+class CallBackHolder<T, E, F, void, T2, E2> : public CallBackHolderBase<T, E, F, void, T2, E2> {
  public:
-  using CallBackHolderBase<T, E, void, T2, E2>::CallBackHolderBase;
+  using CallBackHolderBase<T, E, F, void, T2, E2>::CallBackHolderBase;
 
   /*!
    * \brief   Function to execute the registered call back.
@@ -182,7 +137,7 @@ class CallBackHolder<T, E, void, T2, E2> : public CallBackHolderBase<T, E, void,
    */
   void ExecuteCallBack() override {
     this->callback_handler_(std::move(this->future_));
-    this->new_promise_->set_value();
+    this->new_promise_.set_value();
   }
 };
 
@@ -191,14 +146,15 @@ class CallBackHolder<T, E, void, T2, E2> : public CallBackHolderBase<T, E, void,
  * \brief  Specialization callback holder class to perform the callback execution for when U is Future<T2, E2>.
  * \tparam T is type for the calling future.
  * \tparam E is the error type for the calling Future.
+ * \tparam F The type of the registered call back function.
  * \tparam T2 The unwrapped value type returned back from the registered call back function.
  * \tparam E2 The unwrapped error type returned back from the registered call back function.
  * \vprivate
  */
-template <typename T, typename E, typename T2, typename E2>
-class CallBackHolder<T, E, Future<T2, E2>, T2, E2> : public CallBackHolderBase<T, E, Future<T2, E2>, T2, E2> {
+template <typename T, typename E, typename F, typename T2, typename E2>
+class CallBackHolder<T, E, F, Future<T2, E2>, T2, E2> : public CallBackHolderBase<T, E, F, Future<T2, E2>, T2, E2> {
  public:
-  using CallBackHolderBase<T, E, Future<T2, E2>, T2, E2>::CallBackHolderBase;
+  using CallBackHolderBase<T, E, F, Future<T2, E2>, T2, E2>::CallBackHolderBase;
 
   /*!
    * \brief   Function to execute the registered call back.
@@ -206,10 +162,12 @@ class CallBackHolder<T, E, Future<T2, E2>, T2, E2> : public CallBackHolderBase<T
    */
   void ExecuteCallBack() override {
     Future<T2, E2> chain_future = this->callback_handler_(std::move(this->future_));
-    static_cast<void>(chain_future.then([&](Future<T2, E2> unwrapped_future) {
-      Result<T2, E2> res = unwrapped_future.GetResult();
-      SetValueOrError(*(this->new_promise_), res);
-    }));
+    // The holder is released after this call, so the chained callback takes over the new promise.
+    static_cast<void>(chain_future.then(
+        [new_promise = std::move(this->new_promise_)](Future<T2, E2> unwrapped_future) mutable {
+          Result<T2, E2> res = unwrapped_future.GetResult();
+          SetValueOrError(new_promise, res);
+        }));
   }
 };
 
@@ -218,14 +176,15 @@ class CallBackHolder<T, E, Future<T2, E2>, T2, E2> : public CallBackHolderBase<T
  * \brief  Specialization callback holder class to perform the callback execution for when U is Result<T2, E2>.
  * \tparam T is type for the calling future.
  * \tparam E is the error type for the calling Future.
+ * \tparam F The type of the registered call back function.
  * \tparam T2 The unwrapped value type returned back from the registered call back function.
  * \tparam E2 The unwrapped error type returned back from the registered call back function.
  * \vprivate
  */
-template <typename T, typename E, typename T2, typename E2>
-class CallBackHolder<T, E, Result<T2, E2>, T2, E2> : public CallBackHolderBase<T, E, Result<T2, E2>, T2, E2> {
+template <typename T, typename E, typename F, typename T2, typename E2>
+class CallBackHolder<T, E, F, Result<T2, E2>, T2, E2> : public CallBackHolderBase<T, E, F, Result<T2, E2>, T2, E2> {
  public:
-  using CallBackHolderBase<T, E, Result<T2, E2>, T2, E2>::CallBackHolderBase;
+  using CallBackHolderBase<T, E, F, Result<T2, E2>, T2, E2>::CallBackHolderBase;
 
   /*!
    * \brief   Function to execute the registered call back.
@@ -233,14 +192,59 @@ class CallBackHolder<T, E, Result<T2, E2>, T2, E2> : public CallBackHolderBase<T
    */
   void ExecuteCallBack() override {
     Result<T2, E2> ret_val{this->callback_handler_(std::move(this->future_))};
-    SetValueOrError(*(this->new_promise_), ret_val);
+    SetValueOrError(this->new_promise_, ret_val);
+  }
+};
+
+/*!
+ * \brief   Callback holder that dispatches the execution of another callback holder to an executor.
+ * \vprivate
+ */
+class DispatchingCallBackHolder final : public CallBackHolderInterface {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param callback The callback holder to execute.
+   * \param executor The executor the callback is dispatched to. Must outlive the callback.
+   */
+  DispatchingCallBackHolder(ContinuationPtr callback, vac::threadpool::Executor& executor)
+      : CallBackHolderInterface(), callback_(std::move(callback)), executor_(executor) {}
+
+  /*!
+   * \brief Hands the callback over to the executor.
+   */
+  void ExecuteCallBack() override {
+    // Executor::Task must be copyable, so the callback is shared with the task.
+    std::shared_ptr<CallBackHolderInterface> callback{std::move(callback_)};
+    executor_.Execute([callback]() {
+      if (callback->IsExecutable()) {
+        callback->ExecuteCallBack();
+      }
+    });
   }
+
+  /*!
+   * \brief  Checks if a callback is held.
+   * \return true if the callback has not been handed over yet.
+   */
+  bool IsExecutable() override { return (callback_ != nullptr); }
+
+ private:
+  /*!
+   * \brief The callback to execute.
+   */
+  ContinuationPtr callback_;
+
+  /*!
+   * \brief The executor the callback is dispatched to.
+   */
+  vac::threadpool::Executor& executor_;
 };
 
 /*!
- * \brief   Future continuation class accessible to the Future and Promise.
- * \details Promise creates object of FutureContinuation and passes it to the Future to be able to store and access the
- *          callback function.
+ * \brief   Future continuation class used by Future::then() to register a callback.
+ * \details Wraps the callback into a CallBackHolder and hands it over to the shared state, which executes it as soon
+ *          as the Promise stores the Result.
  * \tparam  T The type for the calling Future.
  * \tparam  E The error type for the calling Future.
  * \vprivate
@@ -250,19 +254,20 @@ class FutureContinuation final {
   // TODO(STORY-12266) Analyze the need for FutureContinuation
  public:
   /*!
-   * \brief Default constructor.
+   * \brief Constructor.
+   * \param shared_state The shared state of the calling Future.
    */
-  FutureContinuation() = default;
+  explicit FutureContinuation(FutureSharedState<T, E>& shared_state) noexcept : shared_state_(shared_state) {}
 
   /*!
-   * \brief Move constructor.
+   * \brief Default move constructor.
    */
   FutureContinuation(FutureContinuation&& other_object) noexcept = default;
 
   /*!
-   * \brief Move assignment operator.
+   * \brief Move assignment operator deleted.
    */
-  FutureContinuation& operator=(FutureContinuation&& other_object) & noexcept = default;
+  FutureContinuation& operator=(FutureContinuation&& other_object) & = delete;
 
   /*!
    * \brief Destructor.
@@ -280,46 +285,43 @@ class FutureContinuation final {
   FutureContinuation& operator=(FutureContinuation const&) = delete;
 
   /*!
-   * \brief  Registers a callback handler to be called when the Promise is set and the state is ready.
-   * \param  handler A callback handler.
-   * \param  fut The calling Future.
-   * \tparam Func The type for the callback function.
-   * \return new future.
+   * \brief   Registers a callback handler to be called when the Promise is set and the state is ready.
+   * \details Without executor the continuation is constructed inside the shared state of the calling Future.
+   * \param   handler A callback handler.
+   * \param   fut The calling Future.
+   * \param   executor The executor the handler is dispatched to, or nullptr to call it in the context that makes the
+   *          state ready.
+   * \tparam  Func The type for the callback function.
+   * \return  new future.
    */
   template <typename Func>
-  auto SetCallBackHandler(Func handler, ara::core::Future<T, E>&& fut) ->
+  auto SetCallBackHandler(Func&& handler, ara::core::Future<T, E>&& fut,
+                          vac::threadpool::Executor* executor = nullptr) ->
       typename TypeUnwrapping<decltype(handler(std::move(fut))), E>::type {
     /*! \brief Alias for the return type of the callable */
     using U = decltype(handler(std::move(fut)));
     using T2 = typename TypeUnwrapping<U, E>::value_type;
     using E2 = typename TypeUnwrapping<U, E>::error_type;
+    using Holder = CallBackHolder<T, E, typename std::decay<Func>::type, U, T2, E2>;
 
     ara::core::Promise<T2, E2> new_promise;
     ara::core::Future<T2, E2> new_future{new_promise.get_future()};
-    call_back_ = std::make_unique<CallBackHolder<T, E, U, T2, E2>>(std::move(new_promise), std::move(fut), handler);
-    return new_future;
-  }
-
-  /*!
-   * \brief Executes the callback.
-   */
-  void ExecuteCallBack() {
-    if (IsCallBackSet() && call_back_->IsExecutable()) {
-      call_back_->ExecuteCallBack();
+    if (executor == nullptr) {
+      shared_state_.template EmplaceContinuation<Holder>(std::move(new_promise), std::move(fut),
+                                                         std::forward<Func>(handler));
+    } else {
+      ContinuationPtr callback{
+          std::make_unique<Holder>(std::move(new_promise), std::move(fut), std::forward<Func>(handler))};
+      shared_state_.SetContinuation(std::make_unique<DispatchingCallBackHolder>(std::move(callback), *executor));
     }
+    return new_future;
   }
 
-  /*!
-   * \brief  Returns the registered state of the call back.
-   * \return True if the callback is registered, false otherwise.
-   */
-  bool IsCallBackSet() noexcept { return (call_back_ != nullptr); }
-
  private:
   /*!
-   * \brief Pointer to CallBackHolderInterface.
+   * \brief The shared state of the calling Future.
    */
-  std::unique_ptr<CallBackHolderInterface> call_back_;
+  FutureSharedState<T, E>& shared_state_;
 };
 
 }  // namespace internal
@@ -0,0 +1,550 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  ara/core/internal/future_shared_state.h
+ *        \brief  Shared state between an ara::core::Promise and its ara::core::Future.
+ *
+ *      \details  The shared state is a single pooled allocation holding the Result, the registered continuation and one
+ *                atomic state word. Readiness checks are lock-free, blocking waits use a futex on the state word.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_ARA_CORE_INTERNAL_FUTURE_SHARED_STATE_H_
+#define LIB_VAC_INCLUDE_ARA_CORE_INTERNAL_FUTURE_SHARED_STATE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ara/core/error_code.h"
+#include "ara/core/future_error_domain.h"
+#include "ara/core/result.h"
+#include "vac/language/throw_or_terminate.h"
+#include "vac/memory/generated_memory_config.h"
+#include "vac/memory/intrusive_shared_ptr.h"
+#include "vac/memory/thread_local_block_pool.h"
+#include "vac/sync/futex.h"
+
+namespace ara {
+namespace core {
+namespace internal {
+
+/* VECTOR Next Construct AutosarC++17_10-A12.8.6: MD_VAC_A12.8.6_definedDeletedInBassClass */
+/*!
+ * \brief CallBackHolder interface.
+ * \vprivate
+ */
+class CallBackHolderInterface {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  CallBackHolderInterface() = default;
+
+  /*!
+   * \brief Default copy constructor.
+   */
+  CallBackHolderInterface(CallBackHolderInterface const& other) = default;
+
+  /*!
+   * \brief Default move constructor.
+   */
+  CallBackHolderInterface(CallBackHolderInterface&& other) noexcept = default;
+
+  /*!
+   * \brief Deleted copy assignment operator.
+   */
+  CallBackHolderInterface& operator=(CallBackHolderInterface const& other) & = delete;
+
+  /*!
+   * \brief Deleted move assignment operator.
+   */
+  CallBackHolderInterface& operator=(CallBackHolderInterface&& other) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  virtual ~CallBackHolderInterface() noexcept {}
+
+  /*!
+   * \brief Executes the callback.
+   */
+  virtual void ExecuteCallBack() = 0;
+
+  /*!
+   * \brief Checks if callback is not nullptr.
+   */
+  virtual bool IsExecutable() = 0;
+
+  /*!
+   * \brief Releases the callback holder once it is no longer needed. Holders not allocated by new override this.
+   */
+  virtual void Dispose() noexcept { delete this; }
+
+  /*!
+   * \brief   Executes the callback if it is executable and releases the holder afterwards.
+   * \details Holders that may be released by their own callback override this, so that they are not accessed after
+   *          the callback.
+   */
+  virtual void ExecuteAndDispose();
+};
+
+/*!
+ * \brief Deleter of callback holders, forwarding to CallBackHolderInterface::Dispose().
+ * \vprivate
+ */
+class CallBackHolderDeleter final {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  CallBackHolderDeleter() noexcept = default;
+
+  /*!
+   * \brief  Converting constructor, so that holders created by std::make_unique can be passed on.
+   * \tparam U The type of the holder.
+   */
+  template <typename U>
+  CallBackHolderDeleter(std::default_delete<U> const&) noexcept {}  // NOLINT(runtime/explicit)
+
+  /*!
+   * \brief Releases a callback holder.
+   * \param holder The holder to release.
+   */
+  void operator()(CallBackHolderInterface* holder) const noexcept { holder->Dispose(); }
+};
+
+/*!
+ * \brief Owning pointer to a registered continuation.
+ * \vprivate
+ */
+using ContinuationPtr = std::unique_ptr<CallBackHolderInterface, CallBackHolderDeleter>;
+
+inline void CallBackHolderInterface::ExecuteAndDispose() {
+  ContinuationPtr const self{this};
+  if (IsExecutable()) {
+    ExecuteCallBack();
+  }
+}
+
+/*!
+ * \brief  Callback holder constructed in the inline buffer of a shared state.
+ * \tparam Holder The callback holder type.
+ * \vprivate
+ */
+template <typename Holder>
+class InlineCallBackHolder final : public Holder {
+ public:
+  using Holder::Holder;
+
+  /*!
+   * \brief Destroys the holder, the buffer belongs to the shared state.
+   */
+  void Dispose() noexcept final { this->~InlineCallBackHolder(); }
+};
+
+/*!
+ * \brief  Callback holder constructed in a block of a thread local pool.
+ * \tparam Holder The callback holder type.
+ * \vprivate
+ */
+template <typename Holder>
+class PooledCallBackHolder final : public Holder {
+ public:
+  using Holder::Holder;
+
+  /*!
+   * \brief Pool the holders are allocated from.
+   */
+  using Pool = vac::memory::ThreadLocalBlockPool<vac::memory::BlockSizeClass(sizeof(Holder)),
+                                                 vac::memory::kFutureContinuationPoolCacheSize>;
+
+  /*!
+   * \brief Destroys the holder and returns its block to the pool.
+   */
+  void Dispose() noexcept final {
+    this->~PooledCallBackHolder();
+    Pool::Deallocate(this);
+  }
+};
+
+/*!
+ * \brief Bits of the atomic state word of a FutureSharedState.
+ * \vprivate
+ */
+class FutureStateBits final {
+ public:
+  /*!
+   * \brief Type of the state word.
+   */
+  using Type = std::uint32_t;
+
+  /*!
+   * \brief The Result has been stored and may be read.
+   */
+  static constexpr Type kReady{0x01U};
+
+  /*!
+   * \brief A continuation has been registered.
+   */
+  static constexpr Type kContinuation{0x02U};
+
+  /*!
+   * \brief The Result has been moved out by the Future.
+   */
+  static constexpr Type kConsumed{0x04U};
+
+  /*!
+   * \brief At least one thread is blocked in a wait and must be woken up.
+   */
+  static constexpr Type kWaiters{0x08U};
+
+  /*!
+   * \brief A Promise has claimed the right to store the Result.
+   */
+  static constexpr Type kSatisfied{0x10U};
+
+  /*!
+   * \brief The Future has been handed out by the Promise.
+   */
+  static constexpr Type kRetrieved{0x20U};
+};
+
+/* VECTOR Next Construct AutosarC++17_10-A12.4.1: MD_VAC_A12.4.1_destructorOfABaseClassShallBePublicVirtual */
+/*!
+ * \brief   Shared state of a Promise/Future pair.
+ * \details Reference counted by the Promise, the Future and a registered continuation. Memory is taken from a
+ *          ThreadLocalBlockPool, so a Promise/Future pair costs one pooled allocation. A state released on another
+ *          thread than it was created on returns to the creating thread through the depot of the pool.
+ * \tparam  T Value type.
+ * \tparam  E Error type.
+ * \vprivate
+ */
+template <typename T, typename E>
+class FutureSharedState final : public vac::memory::IntrusiveShared<FutureSharedState<T, E>> {
+  /*!
+   * \brief Alias for Result.
+   */
+  using R = Result<T, E>;
+
+  /*!
+   * \brief Alias for the state bits.
+   */
+  using Bits = FutureStateBits;
+
+ public:
+  /*!
+   * \brief Pointer type used by Promise and Future to reference the shared state.
+   */
+  using Ptr = vac::memory::IntrusiveSharedPtr<FutureSharedState>;
+
+  /*!
+   * \brief  Creates a new shared state.
+   * \return Pointer to the new shared state.
+   */
+  static Ptr Create() {
+    static_assert(alignof(FutureSharedState) <= alignof(std::max_align_t), "Over-aligned values are not supported");
+    FutureSharedState* const state{::new (Pool<FutureSharedState>::Allocate()) FutureSharedState()};
+    return Ptr(*state);
+  }
+
+  /*!
+   * \brief Copy constructor deleted.
+   */
+  FutureSharedState(FutureSharedState const&) = delete;
+
+  /*!
+   * \brief Move constructor deleted.
+   */
+  FutureSharedState(FutureSharedState&&) = delete;
+
+  /*!
+   * \brief Copy assignment deleted.
+   */
+  FutureSharedState& operator=(FutureSharedState const&) & = delete;
+
+  /*!
+   * \brief Move assignment deleted.
+   */
+  FutureSharedState& operator=(FutureSharedState&&) & = delete;
+
+  /*!
+   * \brief Destructor. Destroys the stored Result, if any.
+   */
+  ~FutureSharedState() noexcept final {
+    if ((state_.load(std::memory_order_acquire) & Bits::kReady) != 0U) {
+      GetResultStorage()->~R();
+    }
+  }
+
+  /*!
+   * \brief Returns the shared state to its pool once the last reference is dropped.
+   */
+  void CallDeleter() final {
+    this->~FutureSharedState();
+    Pool<FutureSharedState>::Deallocate(this);
+  }
+
+  /*!
+   * \brief  Marks the Future as retrieved.
+   * \throws FutureException with future_errc::future_already_retrieved if it was already retrieved.
+   */
+  void MarkRetrieved() {
+    if ((state_.fetch_or(Bits::kRetrieved, std::memory_order_relaxed) & Bits::kRetrieved) != 0U) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::future_already_retrieved});
+    }
+  }
+
+  /*!
+   * \brief  Stores the Result, wakes up waiters and runs a registered continuation.
+   * \tparam Arg Type from which the Result is constructed.
+   * \param  arg Value from which the Result is constructed.
+   * \throws FutureException with future_errc::promise_already_satisfied if a Result was already stored.
+   */
+  template <typename Arg>
+  void SetResult(Arg&& arg) {
+    if (!TryClaim()) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::promise_already_satisfied});
+    }
+    ::new (GetResultStorage()) R(std::forward<Arg>(arg));
+    Publish();
+  }
+
+  /*!
+   * \brief Stores a broken_promise error if no Result has been stored yet.
+   */
+  void Abandon() {
+    if (TryClaim()) {
+      ::new (GetResultStorage()) R(R::FromError(future_errc::broken_promise));
+      Publish();
+    }
+  }
+
+  /*!
+   * \brief  Lock-free check whether the Result is available.
+   * \return True if the Result has been stored.
+   */
+  bool IsReady() const noexcept { return (state_.load(std::memory_order_acquire) & Bits::kReady) != 0U; }
+
+  /*!
+   * \brief Blocks until the Result is available.
+   */
+  void Wait() const noexcept {
+    Bits::Type current{state_.load(std::memory_order_acquire)};
+    while ((current & Bits::kReady) == 0U) {
+      current = AnnounceWaiter(current);
+      if ((current & Bits::kReady) == 0U) {
+        vac::sync::FutexWait(state_, current);
+        current = state_.load(std::memory_order_acquire);
+      }
+    }
+  }
+
+  /*!
+   * \brief  Blocks until the Result is available or the given time point on Clock is reached.
+   * \tparam Clock The clock of the time point.
+   * \tparam Duration The duration type of the time point.
+   * \param  abs_time The time point until which to wait.
+   * \return True if the Result is available, false on timeout.
+   */
+  template <typename Clock, typename Duration>
+  bool WaitUntil(std::chrono::time_point<Clock, Duration> const& abs_time) const noexcept {
+    Bits::Type current{state_.load(std::memory_order_acquire)};
+    while ((current & Bits::kReady) == 0U) {
+      typename Clock::time_point const now{Clock::now()};
+      if (now >= abs_time) {
+        break;
+      }
+      current = AnnounceWaiter(current);
+      if ((current & Bits::kReady) == 0U) {
+        vac::sync::FutexWaitFor(state_, current, std::chrono::duration_cast<std::chrono::nanoseconds>(abs_time - now));
+        current = state_.load(std::memory_order_acquire);
+      }
+    }
+    return (current & Bits::kReady) != 0U;
+  }
+
+  /*!
+   * \brief  Moves the stored Result out of the shared state. Must only be called once the state is ready.
+   * \return The stored Result.
+   */
+  R TakeResult() {
+    static_cast<void>(state_.fetch_or(Bits::kConsumed, std::memory_order_relaxed));
+    return std::move(*GetResultStorage());
+  }
+
+  /*!
+   * \brief   Registers a continuation.
+   * \details If the Result is already available, the continuation is executed in the context of this call. Otherwise
+   *          it is executed in the context of the call that stores the Result.
+   * \param   continuation The continuation to register.
+   */
+  void SetContinuation(ContinuationPtr continuation) {
+    continuation_ = std::move(continuation);
+    if ((state_.fetch_or(Bits::kContinuation, std::memory_order_acq_rel) & Bits::kReady) != 0U) {
+      ExecuteContinuation();
+    }
+  }
+
+  /*!
+   * \brief   Constructs a continuation in the inline buffer of this shared state and registers it.
+   * \details Continuations that do not fit into the buffer are constructed in a block of a thread local pool, so
+   *          registering a continuation does not allocate once the pools are warm.
+   * \tparam  Holder The callback holder type.
+   * \tparam  Args The constructor argument types of Holder.
+   * \param   args The constructor arguments of Holder.
+   */
+  template <typename Holder, typename... Args>
+  void EmplaceContinuation(Args&&... args) {
+    static_assert(std::is_base_of<CallBackHolderInterface, Holder>::value, "Holder must be a callback holder");
+    using Inline = InlineCallBackHolder<Holder>;
+    using FitsInline = std::integral_constant<bool, (sizeof(Inline) <= sizeof(ContinuationStorage)) &&
+                                                        (alignof(Inline) <= alignof(ContinuationStorage))>;
+    SetContinuation(ContinuationPtr{ConstructContinuation<Holder>(FitsInline{}, std::forward<Args>(args)...)});
+  }
+
+ private:
+  /*!
+   * \brief  Constructs a continuation in the inline buffer.
+   * \tparam Holder The callback holder type.
+   * \tparam Args The constructor argument types of Holder.
+   * \param  args The constructor arguments of Holder.
+   * \return The constructed continuation.
+   */
+  template <typename Holder, typename... Args>
+  CallBackHolderInterface* ConstructContinuation(std::true_type, Args&&... args) {
+    return ::new (&continuation_storage_) InlineCallBackHolder<Holder>(std::forward<Args>(args)...);
+  }
+
+  /*!
+   * \brief  Constructs a continuation that does not fit into the inline buffer in a pooled block.
+   * \tparam Holder The callback holder type.
+   * \tparam Args The constructor argument types of Holder.
+   * \param  args The constructor arguments of Holder.
+   * \return The constructed continuation.
+   */
+  template <typename Holder, typename... Args>
+  CallBackHolderInterface* ConstructContinuation(std::false_type, Args&&... args) {
+    using Pooled = PooledCallBackHolder<Holder>;
+    static_assert(alignof(Pooled) <= alignof(std::max_align_t), "Over-aligned continuations are not supported");
+    // Returns the block to the pool if the constructor of the holder throws.
+    std::unique_ptr<void, void (*)(void*)> block{Pooled::Pool::Allocate(), &Pooled::Pool::Deallocate};
+    CallBackHolderInterface* const holder{::new (block.get()) Pooled(std::forward<Args>(args)...)};
+    static_cast<void>(block.release());
+    return holder;
+  }
+
+  /*!
+   * \brief  Pool the shared states are allocated from.
+   * \tparam State The complete shared state type.
+   */
+  template <typename State>
+  using Pool = vac::memory::ThreadLocalBlockPool<vac::memory::BlockSizeClass(sizeof(State))>;
+
+  /*!
+   * \brief Constructor. Only used by Create().
+   */
+  FutureSharedState() noexcept : vac::memory::IntrusiveShared<FutureSharedState<T, E>>() {}
+
+  /*!
+   * \brief  Claims the right to store the Result.
+   * \return True if the caller is the first to claim it.
+   */
+  bool TryClaim() noexcept {
+    return (state_.fetch_or(Bits::kSatisfied, std::memory_order_relaxed) & Bits::kSatisfied) == 0U;
+  }
+
+  /*!
+   * \brief Publishes a stored Result to waiters and to a registered continuation.
+   */
+  void Publish() {
+    Bits::Type const previous{state_.fetch_or(Bits::kReady, std::memory_order_acq_rel)};
+    if ((previous & Bits::kWaiters) != 0U) {
+      vac::sync::FutexWakeAll(state_);
+    }
+    if ((previous & Bits::kContinuation) != 0U) {
+      ExecuteContinuation();
+    }
+  }
+
+  /*!
+   * \brief  Sets the waiter bit, so that Publish() issues a wake-up.
+   * \param  current The last observed state.
+   * \return The state including the waiter bit, or the ready state if it became ready meanwhile.
+   */
+  Bits::Type AnnounceWaiter(Bits::Type current) const noexcept {
+    while (((current & Bits::kReady) == 0U) && ((current & Bits::kWaiters) == 0U)) {
+      if (state_.compare_exchange_weak(current, current | Bits::kWaiters, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        current |= Bits::kWaiters;
+      }
+    }
+    return current;
+  }
+
+  /*!
+   * \brief Executes and releases the registered continuation.
+   */
+  void ExecuteContinuation() {
+    CallBackHolderInterface* const continuation{continuation_.release()};
+    if (continuation != nullptr) {
+      continuation->ExecuteAndDispose();
+    }
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
+  /*!
+   * \brief  Returns the storage of the Result.
+   * \return Pointer to the (possibly not yet constructed) Result.
+   */
+  R* GetResultStorage() noexcept { return reinterpret_cast<R*>(&result_storage_); }
+
+  /*!
+   * \brief The state word, a combination of FutureStateBits. Mutable as waiting announces itself in the word.
+   */
+  mutable std::atomic<Bits::Type> state_{0U};
+
+  /*!
+   * \brief Type of the inline buffer for a continuation.
+   */
+  using ContinuationStorage =
+      typename std::aligned_storage<vac::memory::kFutureContinuationInlineSize, alignof(std::max_align_t)>::type;
+
+  /*!
+   * \brief Inline buffer for a continuation. Declared before continuation_, so that it outlives it.
+   */
+  ContinuationStorage continuation_storage_;
+
+  /*!
+   * \brief The registered continuation.
+   */
+  ContinuationPtr continuation_;
+
+  /*!
+   * \brief Storage for the Result.
+   */
+  typename std::aligned_storage<sizeof(R), alignof(R)>::type result_storage_;
+};
+
+}  // namespace internal
+}  // namespace core
+}  // namespace ara
+
+#endif  // LIB_VAC_INCLUDE_ARA_CORE_INTERNAL_FUTURE_SHARED_STATE_H_
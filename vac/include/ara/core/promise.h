@@ -24,12 +24,13 @@
  *  INCLUDES
  *********************************************************************************************************************/
 #include <functional>
-#include <future>
 #include <memory>
 #include <utility>
 
 #include "ara/core/future.h"
 #include "ara/core/internal/future_continuation.h"
+#include "ara/core/internal/future_shared_state.h"
+#include "vac/language/throw_or_terminate.h"
 
 namespace ara {
 namespace core {
@@ -49,23 +50,23 @@ class Promise final {
    */
   using R = Result<T, E>;
 
- public:
   /*!
-   * \brief The promised type.
+   * \brief Alias for the shared state pointer.
    */
-  using ValueType = T;
+  using SharedStatePtr = typename internal::FutureSharedState<T, E>::Ptr;
 
+ public:
   /*!
-   * \brief The future continuation pointer type.
+   * \brief The promised type.
    */
-  using FutureContinuationPtr = std::shared_ptr<ara::core::internal::FutureContinuation<ValueType, E>>;
+  using ValueType = T;
 
   /*!
-   * \brief Default constructor.
+   * \brief Default constructor. Allocates the shared state.
    * \trace SPEC-7552480
    * \vpublic
    */
-  Promise() = default;
+  Promise() : shared_state_(internal::FutureSharedState<ValueType, E>::Create()) {}
 
   /*!
    * \brief Default copy constructor deleted.
@@ -82,11 +83,15 @@ class Promise final {
   Promise(Promise&&) noexcept = default;
 
   /*!
-   * \brief Destructor.
+   * \brief Destructor. Stores a broken_promise error if no Result has been set.
    * \trace SPEC-7552483
    * \vpublic
    */
-  ~Promise() = default;
+  ~Promise() {
+    if (shared_state_) {
+      shared_state_->Abandon();
+    }
+  }
 
   /*!
    * \brief  Default copy assignment operator deleted.
@@ -102,7 +107,12 @@ class Promise final {
    * \trace  SPEC-7552485
    * \vpublic
    */
-  Promise& operator=(Promise&&) & noexcept = default;
+  Promise& operator=(Promise&& other) & noexcept {
+    // The previous shared state is abandoned when the temporary goes out of scope.
+    Promise abandoned{std::move(*this)};
+    swap(other);
+    return *this;
+  }
 
   /*!
    * \brief Exchanges the shared states of this and other.
@@ -113,8 +123,7 @@ class Promise final {
    */
   void swap(Promise& other) noexcept {
     using std::swap;
-    swap(delegate_promise_, other.delegate_promise_);
-    swap(future_continuation_, other.future_continuation_);
+    swap(shared_state_, other.shared_state_);
   }
 
   /*!
@@ -127,8 +136,9 @@ class Promise final {
    * \vpublic
    */
   Future<ValueType, E> get_future() {
-    future_continuation_ = std::make_shared<ara::core::internal::FutureContinuation<ValueType, E>>();
-    return ara::core::Future<ValueType, E>(delegate_promise_.get_future(), future_continuation_);
+    ThrowIfNoState();
+    shared_state_->MarkRetrieved();
+    return ara::core::Future<ValueType, E>(SharedStatePtr{*shared_state_});
   }
 
   /*!
@@ -185,38 +195,36 @@ class Promise final {
 
  private:
   /*!
-   * \brief Delegation object to std::promise.
+   * \brief The shared state with the Future.
    */
-  std::promise<R> delegate_promise_;
+  SharedStatePtr shared_state_;
 
   /*!
-   * \brief Future continuation object to manage the call back function.
+   * \brief  Throws if this Promise has no shared state, i.e. it has been moved from.
+   * \throws ara::core::FutureException with future_errc::no_state.
    */
-  FutureContinuationPtr future_continuation_;
+  void ThrowIfNoState() const {
+    if (!shared_state_) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+    }
+  }
 
   /*!
    * \brief Set value and execute call back if one exist.
    * \param r The Result to set.
    */
   void SetValueAndExecuteCallBack(R const& r) {
-    if ((future_continuation_ != nullptr) && future_continuation_->IsCallBackSet()) {
-      delegate_promise_.set_value(r);
-      future_continuation_->ExecuteCallBack();
-    } else {
-      delegate_promise_.set_value(r);
-    }
+    ThrowIfNoState();
+    shared_state_->SetResult(r);
   }
+
   /*!
    * \brief Set value and execute call back if one exist.
    * \param r The Result to set.
    */
   void SetValueAndExecuteCallBack(R&& r) {
-    if ((future_continuation_ != nullptr) && future_continuation_->IsCallBackSet()) {
-      delegate_promise_.set_value(std::move(r));
-      future_continuation_->ExecuteCallBack();
-    } else {
-      delegate_promise_.set_value(std::move(r));
-    }
+    ThrowIfNoState();
+    shared_state_->SetResult(std::move(r));
   }
 };
 
@@ -233,23 +241,23 @@ class Promise<void, E> final {
    */
   using R = Result<void, E>;
 
- public:
   /*!
-   * \brief The promised type.
+   * \brief Alias for the shared state pointer.
    */
-  using ValueType = void;
+  using SharedStatePtr = typename internal::FutureSharedState<void, E>::Ptr;
 
+ public:
   /*!
-   * \brief The future continuation pointer type.
+   * \brief The promised type.
    */
-  using FutureContinuationPtr = std::shared_ptr<ara::core::internal::FutureContinuation<ValueType, E>>;
+  using ValueType = void;
 
   /*!
-   * \brief Default constructor.
+   * \brief Default constructor. Allocates the shared state.
    * \trace SPEC-7552480
    * \vpublic
    */
-  Promise() = default;
+  Promise() : shared_state_(internal::FutureSharedState<ValueType, E>::Create()) {}
 
   /*!
    * \brief Default copy constructor deleted.
@@ -266,11 +274,15 @@ class Promise<void, E> final {
   Promise(Promise&&) noexcept = default;
 
   /*!
-   * \brief Destructor.
+   * \brief Destructor. Stores a broken_promise error if no Result has been set.
    * \trace SPEC-7552483
    * \vpublic
    */
-  ~Promise() = default;
+  ~Promise() {
+    if (shared_state_) {
+      shared_state_->Abandon();
+    }
+  }
 
   /*!
    * \brief  Default copy assignment operator deleted.
@@ -286,7 +298,12 @@ class Promise<void, E> final {
    * \trace  SPEC-7552485
    * \vpublic
    */
-  Promise& operator=(Promise&&) & noexcept = default;
+  Promise& operator=(Promise&& other) & noexcept {
+    // The previous shared state is abandoned when the temporary goes out of scope.
+    Promise abandoned{std::move(*this)};
+    swap(other);
+    return *this;
+  }
 
   /*!
    * \brief Exchanges the shared states of this and other.
@@ -297,8 +314,7 @@ class Promise<void, E> final {
    */
   void swap(Promise& other) noexcept {
     using std::swap;
-    swap(delegate_promise_, other.delegate_promise_);
-    swap(future_continuation_, other.future_continuation_);
+    swap(shared_state_, other.shared_state_);
   }
 
   /*!
@@ -311,8 +327,9 @@ class Promise<void, E> final {
    * \vpublic
    */
   Future<ValueType, E> get_future() {
-    future_continuation_ = std::make_shared<ara::core::internal::FutureContinuation<ValueType, E>>();
-    return ara::core::Future<ValueType, E>(delegate_promise_.get_future(), future_continuation_);
+    ThrowIfNoState();
+    shared_state_->MarkRetrieved();
+    return ara::core::Future<ValueType, E>(SharedStatePtr{*shared_state_});
   }
 
   /*!
@@ -354,26 +371,27 @@ class Promise<void, E> final {
 
  private:
   /*!
-   * \brief Delegation object to std::promise.
+   * \brief The shared state with the Future.
    */
-  std::promise<R> delegate_promise_;
+  SharedStatePtr shared_state_;
 
   /*!
-   * \brief Future continuation object to manage the call back function.
+   * \brief  Throws if this Promise has no shared state, i.e. it has been moved from.
+   * \throws ara::core::FutureException with future_errc::no_state.
    */
-  FutureContinuationPtr future_continuation_;
+  void ThrowIfNoState() const {
+    if (!shared_state_) {
+      vac::language::ThrowOrTerminate<FutureException>(ErrorCode{future_errc::no_state});
+    }
+  }
 
   /*!
    * \brief Set value and execute call back if one exist.
    * \param r The Result to set.
    */
   void SetValueAndExecuteCallBack(R const& r) {
-    if ((future_continuation_ != nullptr) && future_continuation_->IsCallBackSet()) {
-      delegate_promise_.set_value(r);
-      future_continuation_->ExecuteCallBack();
-    } else {
-      delegate_promise_.set_value(r);
-    }
+    ThrowIfNoState();
+    shared_state_->SetResult(r);
   }
 
   /*!
@@ -381,12 +399,8 @@ class Promise<void, E> final {
    * \param r The Result to set.
    */
   void SetValueAndExecuteCallBack(R&& r) {
-    if ((future_continuation_ != nullptr) && future_continuation_->IsCallBackSet()) {
-      delegate_promise_.set_value(std::move(r));
-      future_continuation_->ExecuteCallBack();
-    } else {
-      delegate_promise_.set_value(std::move(r));
-    }
+    ThrowIfNoState();
+    shared_state_->SetResult(std::move(r));
   }
 };
 
@@ -0,0 +1,333 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  concurrent_static_map.h
+ *        \brief  Thread-safe map partitioned into independently locked StaticMap shards.
+ *
+ *      \details  Keys are distributed over the shards by their hash. Each shard occupies its own cache lines and is
+ *                guarded by its own reader-writer lock, so threads working on different shards do not contend and
+ *                readers of one shard proceed in parallel.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_CONCURRENT_STATIC_MAP_H_
+#define LIB_VAC_INCLUDE_VAC_CONTAINER_CONCURRENT_STATIC_MAP_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <utility>
+
+#include "vac/container/static_map.h"
+#include "vac/language/cache_line.h"
+#include "vac/sync/rw_spin_lock.h"
+
+namespace vac {
+namespace container {
+
+/*!
+ * \brief   Thread-safe map with preallocated capacity, partitioned into shards.
+ * \details All members except reserve() are threadsafe. Elements are only accessible inside the callbacks, which run
+ *          while the lock of their shard is held; a callback must not access the map itself.
+ * \tparam  Key The key type. Must be less-than comparable and hashable with Hash.
+ * \tparam  T The mapped type.
+ * \tparam  ShardCount The number of shards. Must be a power of two.
+ * \tparam  Hash The hash function object.
+ * \tparam  Lock The lock of each shard, meeting the SharedMutex requirements.
+ */
+template <typename Key, typename T, std::size_t ShardCount = 16, typename Hash = std::hash<Key>,
+          typename Lock = vac::sync::RwSpinLock>
+class ConcurrentStaticMap final {
+  static_assert((ShardCount != 0U) && ((ShardCount & (ShardCount - 1U)) == 0U), "ShardCount must be a power of two");
+
+ public:
+  /*!
+   * \brief Typedef for the map of a shard.
+   */
+  using ShardType = StaticMap<Key, T>;
+
+  /*!
+   * \brief Typedef for the size type.
+   */
+  using size_type = std::size_t;
+
+  /*!
+   * \brief Typedef for the key type.
+   */
+  using key_type = Key;
+
+  /*!
+   * \brief Typedef for the mapped type.
+   */
+  using mapped_type = T;
+
+  /*!
+   * \brief Typedef for the element type.
+   */
+  using value_type = typename ShardType::value_type;
+
+  /*!
+   * \brief The number of shards.
+   */
+  static constexpr size_type kShardCount{ShardCount};
+
+  /*!
+   * \brief Constructor for an empty map without capacity.
+   * \param hash The hash function object.
+   */
+  explicit ConcurrentStaticMap(Hash const& hash = Hash()) : hash_(hash), shards_(), trailing_padding_() {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  ConcurrentStaticMap(ConcurrentStaticMap const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  ConcurrentStaticMap& operator=(ConcurrentStaticMap const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  ConcurrentStaticMap(ConcurrentStaticMap&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  ConcurrentStaticMap& operator=(ConcurrentStaticMap&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~ConcurrentStaticMap() = default;
+
+  /*!
+   * \brief   Preallocate the capacity of every shard. Not threadsafe, call before sharing the map.
+   * \details Every shard receives the same capacity. A shard that receives more keys than that is full even though the
+   *          map as a whole is not, so leave headroom for an uneven key distribution.
+   * \param   capacity_per_shard The number of elements each shard can hold.
+   * \throw   std::bad_alloc If a shard already holds memory for fewer elements.
+   */
+  void reserve(size_type capacity_per_shard) {
+    for (Shard& shard : shards_) {
+      shard.map.reserve(capacity_per_shard);
+    }
+  }
+
+  /*!
+   * \brief  Insert an element if the key is not contained yet.
+   * \param  key The key.
+   * \param  args Arguments forwarded to the constructor of the mapped value.
+   * \return True if the element was inserted, false if the key was already contained.
+   * \throw  std::bad_alloc The shard of the key is full.
+   */
+  template <typename... Args>
+  bool emplace(Key const& key, Args&&... args) {
+    Shard& shard{ShardOf(key)};
+    std::lock_guard<Lock> const lock{shard.lock};
+    return shard.map
+        .emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                 std::forward_as_tuple(std::forward<Args>(args)...))
+        .second;
+  }
+
+  /*!
+   * \brief  Remove the element of a key.
+   * \param  key The key.
+   * \return The number of removed elements.
+   */
+  size_type erase(Key const& key) {
+    Shard& shard{ShardOf(key)};
+    std::lock_guard<Lock> const lock{shard.lock};
+    return shard.map.erase(key);
+  }
+
+  /*!
+   * \brief  Read the element of a key under the shared lock of its shard.
+   * \param  key The key.
+   * \param  fn Called with a const reference to the mapped value if the key is contained.
+   * \return True if the key is contained.
+   */
+  template <typename Fn>
+  bool find(Key const& key, Fn&& fn) const {
+    Shard const& shard{ShardOf(key)};
+    std::shared_lock<Lock> const lock{shard.lock};
+    typename ShardType::const_iterator const it{shard.map.find(key)};
+    bool const found{it != shard.map.cend()};
+    if (found) {
+      fn(it->second);
+    }
+    return found;
+  }
+
+  /*!
+   * \brief  Modify the element of a key under the exclusive lock of its shard.
+   * \param  key The key.
+   * \param  fn Called with a reference to the mapped value if the key is contained.
+   * \return True if the key is contained.
+   */
+  template <typename Fn>
+  bool update(Key const& key, Fn&& fn) {
+    Shard& shard{ShardOf(key)};
+    std::lock_guard<Lock> const lock{shard.lock};
+    typename ShardType::iterator it{shard.map.find(key)};
+    bool const found{it != shard.map.end()};
+    if (found) {
+      fn(it->second);
+    }
+    return found;
+  }
+
+  /*!
+   * \brief  Check whether a key is contained.
+   * \param  key The key.
+   * \return True if the key is contained.
+   */
+  bool contains(Key const& key) const { return find(key, [](T const&) {}); }
+
+  /*!
+   * \brief   Visit all elements, one shard at a time under its shared lock.
+   * \details Shards are visited in order, so the visited elements are not a snapshot of the whole map.
+   * \param   fn Called with a const reference to each element.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (size_type i{0}; i < kShardCount; ++i) {
+      for_each_in_shard(i, fn);
+    }
+  }
+
+  /*!
+   * \brief Visit all elements of one shard under its shared lock.
+   * \param shard_index The index of the shard, less than kShardCount.
+   * \param fn Called with a const reference to each element.
+   */
+  template <typename Fn>
+  void for_each_in_shard(size_type shard_index, Fn&& fn) const {
+    Shard const& shard{shards_[shard_index]};
+    std::shared_lock<Lock> const lock{shard.lock};
+    for (value_type const& element : shard.map) {
+      fn(element);
+    }
+  }
+
+  /*!
+   * \brief Remove all elements.
+   */
+  void clear() {
+    for (Shard& shard : shards_) {
+      std::lock_guard<Lock> const lock{shard.lock};
+      shard.map.clear();
+    }
+  }
+
+  /*!
+   * \brief  The number of elements. Shards are counted one after another.
+   * \return The number of elements.
+   */
+  size_type size() const {
+    size_type count{0};
+    for (Shard const& shard : shards_) {
+      std::shared_lock<Lock> const lock{shard.lock};
+      count += shard.map.size();
+    }
+    return count;
+  }
+
+  /*!
+   * \brief  Determine whether the map is empty. Shards are checked one after another.
+   * \return True if no shard holds an element.
+   */
+  bool empty() const { return size() == 0U; }
+
+  /*!
+   * \brief  The shard a key belongs to.
+   * \param  key The key.
+   * \return The index of the shard.
+   */
+  size_type GetShardIndex(Key const& key) const {
+    // Spread identity hashes of small integers over the high bits before masking.
+    std::uint64_t const mixed{static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15U};
+    return static_cast<size_type>(mixed >> 32U) & (kShardCount - 1U);
+  }
+
+ private:
+  /*!
+   * \brief A map and its lock on cache lines of their own.
+   */
+  struct Shard {
+    /*!
+     * \brief Keeps the lock off the cache line of the preceding shard.
+     */
+    std::array<char, vac::language::kCacheLineSize> leading_padding;
+
+    /*!
+     * \brief Guards the map.
+     */
+    mutable Lock lock;
+
+    /*!
+     * \brief The elements of the shard.
+     */
+    ShardType map;
+  };
+
+  /*!
+   * \brief  The shard of a key.
+   * \param  key The key.
+   * \return The shard.
+   */
+  Shard& ShardOf(Key const& key) { return shards_[GetShardIndex(key)]; }
+
+  /*!
+   * \brief  The shard of a key.
+   * \param  key The key.
+   * \return The shard.
+   */
+  Shard const& ShardOf(Key const& key) const { return shards_[GetShardIndex(key)]; }
+
+  /*!
+   * \brief The hash function object.
+   */
+  Hash hash_;
+
+  /*!
+   * \brief The shards.
+   */
+  std::array<Shard, ShardCount> shards_;
+
+  /*!
+   * \brief Keeps the last shard off the cache line of the following object.
+   */
+  std::array<char, vac::language::kCacheLineSize> trailing_padding_;
+};
+
+/*!
+ * \brief The number of shards.
+ */
+template <typename Key, typename T, std::size_t ShardCount, typename Hash, typename Lock>
+constexpr typename ConcurrentStaticMap<Key, T, ShardCount, Hash, Lock>::size_type
+    ConcurrentStaticMap<Key, T, ShardCount, Hash, Lock>::kShardCount;
+
+}  // namespace container
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_CONTAINER_CONCURRENT_STATIC_MAP_H_
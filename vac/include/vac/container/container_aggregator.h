@@ -16,7 +16,8 @@
  *                same type and an iterator for going through the aggregated elements of all containers.
  *
  *      \details  Aggregated container provides iterators for container, element and basic operators.
- *                The Span container is the only container being used now.
+ *                The Span container is the only container being used now. Contiguous containers can also be visited
+ *                as one span per container.
  *
  *********************************************************************************************************************/
 
@@ -57,6 +58,11 @@ class ContainerAggregator final {
    */
   using value_type = typename ContainerType::value_type;
 
+  /*!
+   * \brief View to the elements of one contiguous container.
+   */
+  using Segment = ara::core::Span<value_type const>;
+
   /*!
    * \brief Const iterator type.
    */
@@ -229,6 +235,29 @@ class ContainerAggregator final {
         [](std::size_t si, ContainerPointerType const& container) { return si + container->size(); });
   }
 
+  /*!
+   * \brief  Returns the elements of one registered container as a contiguous view.
+   *         The container type must provide data().
+   * \param  index The index of the container, less than NumberOfRegisteredContainers().
+   * \return View to the elements of the container.
+   */
+  Segment GetSegment(std::size_t index) const { return MakeSegment(*registered_containers_[index]); }
+
+  /*!
+   * \brief   Visit the elements container by container.
+   * \details Calls fn once per non-empty container with a view to its elements, so the inner loop over a segment
+   *          runs over plain contiguous memory. The container type must provide data().
+   * \param   fn Called with a Segment.
+   */
+  template <typename Fn>
+  void ForEachSegment(Fn&& fn) const {
+    for (ContainerPointerType const& container : registered_containers_) {
+      if (container->size() != 0U) {
+        fn(MakeSegment(*container));
+      }
+    }
+  }
+
   /*!
    * \brief       Returns the first container element.
    * \return      The first element of a non-empty container, if no containers were added to the aggregator or all
@@ -272,6 +301,15 @@ class ContainerAggregator final {
   const_iterator end() const { return cend(); }
 
  private:
+  /*!
+   * \brief  View to the elements of a container.
+   * \param  container The container.
+   * \return The view.
+   */
+  static Segment MakeSegment(ContainerType const& container) {
+    return Segment(container.data(), static_cast<typename Segment::index_type>(container.size()));
+  }
+
   /*! \brief View to the registered container pointers. */
   ara::core::Span<ContainerPointer const> registered_containers_;
 };
@@ -0,0 +1,755 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  handle_table.h
+ *        \brief  Preallocated table of objects addressed by generation-tagged integer handles.
+ *
+ *      \details  A handle packs the slot index into its low bits and the generation of the slot into its high bits.
+ *                Releasing an object advances the generation of its slot, so stale handles are detected in O(1).
+ *                Free slots are found through a hierarchical bitmap of 64 bit words: every bit of an upper level
+ *                word marks a lower level word that has free slots, so a search takes one count-trailing-zeros per
+ *                level.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_HANDLE_TABLE_H_
+#define LIB_VAC_INCLUDE_VAC_CONTAINER_HANDLE_TABLE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vac/language/throw_or_terminate.h"
+#include "vac/memory/phase_managed_allocator.h"
+
+namespace vac {
+namespace container {
+
+/*!
+ * \brief   Preallocated table of objects addressed by generation-tagged handles.
+ * \details Handle 0 is never handed out. In concurrent mode Emplace(), TryEmplace() and Release() may be called from
+ *          any number of threads; allocation is lock-free. Access to an object through Get() must still be ordered
+ *          after its Emplace() and before its Release() by the caller, e.g. by passing the handle between threads.
+ *          Of several concurrent Release() calls for the same handle exactly one succeeds.
+ *          Without concurrent mode the table must not be modified concurrently.
+ * \tparam  T The type of the stored objects.
+ * \tparam  HandleType The unsigned integer type of the handles, usually std::uint32_t or std::uint64_t.
+ * \tparam  concurrent True to allow concurrent modification.
+ * \tparam  IndexBits The number of handle bits used for the slot index. The others hold the generation.
+ * \tparam  alloc The allocator of the slots.
+ */
+template <typename T, typename HandleType = std::uint32_t, bool concurrent = false,
+          std::size_t IndexBits = sizeof(HandleType) * 4U, typename alloc = vac::memory::PhaseManagedAllocator<T>>
+class HandleTable final {
+  static_assert(std::is_unsigned<HandleType>::value, "Handles must be unsigned integers");
+  static_assert((IndexBits > 0U) && (IndexBits <= 32U) && (IndexBits < (sizeof(HandleType) * 8U)),
+                "The handle needs at most 32 index bits and at least one generation bit");
+
+ public:
+  /*!
+   * \brief Typedef for the handles.
+   */
+  using Handle = HandleType;
+
+  /*!
+   * \brief Typedef for the size type.
+   */
+  using size_type = std::size_t;
+
+  /*!
+   * \brief Type of contained element.
+   */
+  using value_type = T;
+
+  /*!
+   * \brief Typedef for the allocator type.
+   */
+  using allocator_type = alloc;
+
+  /*!
+   * \brief A handle that never refers to an object.
+   */
+  static constexpr Handle kInvalidHandle{0};
+
+  /*!
+   * \brief The number of handle bits used for the slot index.
+   */
+  static constexpr std::size_t kIndexBits{IndexBits};
+
+  /*!
+   * \brief The maximum capacity addressable by the index bits.
+   */
+  static constexpr size_type kMaxCapacity{size_type{1} << IndexBits};
+
+  /*!
+   * \brief Initialize an empty table. Does not allocate.
+   * \param allocator The allocator to use, default is allocator_type().
+   */
+  explicit HandleTable(allocator_type const& allocator = allocator_type())
+      : slot_allocator_(allocator),
+        word_allocator_(allocator),
+        slots_(nullptr),
+        words_(nullptr),
+        capacity_(0),
+        word_count_(0),
+        level_count_(0),
+        level_offsets_(),
+        size_(0) {}
+
+  /*!
+   * \brief Default copy constructor deleted.
+   */
+  HandleTable(HandleTable const&) = delete;
+
+  /*!
+   * \brief Default copy assignment operator deleted.
+   */
+  HandleTable& operator=(HandleTable const&) & = delete;
+
+  /*!
+   * \brief Default move constructor deleted.
+   */
+  HandleTable(HandleTable&&) = delete;
+
+  /*!
+   * \brief Default move assignment operator deleted.
+   */
+  HandleTable& operator=(HandleTable&&) & = delete;
+
+  /*!
+   * \brief Destructor. Destroys all objects and releases the memory.
+   */
+  ~HandleTable() {
+    clear();
+    Deallocate();
+  }
+
+  /*!
+   * \brief Allocate the slots. Must not be called concurrently with any other member.
+   *        Calls where new_capacity is not greater than the current capacity have no effect.
+   * \param new_capacity The number of slots.
+   * \throw std::bad_alloc The table holds objects and new_capacity exceeds the capacity, or new_capacity exceeds
+   *        kMaxCapacity.
+   */
+  void reserve(size_type new_capacity) {
+    if (new_capacity > capacity_) {
+      if ((!empty()) || (new_capacity > kMaxCapacity)) {
+        vac::language::ThrowOrTerminate<std::bad_alloc>();
+      }
+      Deallocate();
+      // Lay out the levels from the leaves up to a single top word.
+      size_type words_in_level{WordsFor(new_capacity)};
+      size_type word_count{0};
+      level_count_ = 0;
+      while (true) {
+        level_offsets_[level_count_] = word_count;
+        word_count += words_in_level;
+        ++level_count_;
+        if (words_in_level == 1U) {
+          break;
+        }
+        words_in_level = WordsFor(words_in_level);
+      }
+      slots_ = slot_allocator_.allocate(new_capacity);
+      words_ = word_allocator_.allocate(word_count);
+      capacity_ = new_capacity;
+      word_count_ = word_count;
+      for (size_type i{0}; i < capacity_; ++i) {
+        static_cast<void>(new (&slots_[i]) Slot());
+      }
+      for (size_type i{0}; i < word_count_; ++i) {
+        static_cast<void>(new (&words_[i]) Word(0U));
+      }
+      // Mark every slot free, then every lower level word that has free slots.
+      size_type marked{capacity_};
+      for (size_type level{0}; level < level_count_; ++level) {
+        for (size_type i{0}; i < marked; ++i) {
+          WordOf(level, i >> kWordShift).fetch_or(BitOf(i), std::memory_order_relaxed);
+        }
+        marked = WordsFor(marked);
+      }
+    }
+  }
+
+  /*!
+   * \brief  Construct an object in a free slot.
+   * \param  args Arguments forwarded to the constructor of T.
+   * \return The handle of the object.
+   * \throw  std::bad_alloc The table is full.
+   */
+  template <typename... Args>
+  Handle Emplace(Args&&... args) {
+    Handle const handle{TryEmplace(std::forward<Args>(args)...)};
+    if (handle == kInvalidHandle) {
+      vac::language::ThrowOrTerminate<std::bad_alloc>();
+    }
+    return handle;
+  }
+
+  /*!
+   * \brief  Construct an object in a free slot if there is one.
+   *         If the constructor of T throws, the slot is returned and the exception propagates.
+   * \param  args Arguments forwarded to the constructor of T.
+   * \return The handle of the object, kInvalidHandle if the table is full.
+   */
+  template <typename... Args>
+  Handle TryEmplace(Args&&... args) {
+    Handle handle{kInvalidHandle};
+    size_type const index{Claim()};
+    if (index != kNoSlot) {
+      Slot& slot{slots_[index]};
+      SlotReturner returner{this, index};
+      static_cast<void>(new (&slot.storage) T(std::forward<Args>(args)...));
+      returner.Dismiss();
+      Add(size_, 1U);
+      handle = static_cast<Handle>((slot.generation.load(std::memory_order_relaxed) << kIndexBits) | index);
+    }
+    return handle;
+  }
+
+  /*!
+   * \brief  Destroy the object of a handle and free its slot. Invalidates all copies of the handle.
+   * \param  handle The handle.
+   * \return False if the handle is stale or invalid.
+   */
+  bool Release(Handle handle) noexcept {
+    size_type const index{IndexOf(handle)};
+    // Advancing the generation first claims the release, so only one of several concurrent callers destroys.
+    bool const released{(index < capacity_) && AdvanceGeneration(slots_[index].generation, GenerationOf(handle))};
+    if (released) {
+      slots_[index].GetObject()->~T();
+      Add(size_, std::numeric_limits<size_type>::max());
+      Free(index);
+    }
+    return released;
+  }
+
+  /*!
+   * \brief  Look up the object of a handle.
+   * \param  handle The handle.
+   * \return Pointer to the object, nullptr if the handle is stale or invalid.
+   */
+  T* Get(Handle handle) noexcept {
+    T* object{nullptr};
+    size_type const index{IndexOf(handle)};
+    if ((index < capacity_) && (slots_[index].generation.load(std::memory_order_acquire) == GenerationOf(handle))) {
+      object = slots_[index].GetObject();
+    }
+    return object;
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A5.2.3: MD_VAC_A5.2.3_constCastReducesCodeDuplication */
+  /*!
+   * \brief  Look up the object of a handle.
+   * \param  handle The handle.
+   * \return Pointer to the object, nullptr if the handle is stale or invalid.
+   */
+  T const* Get(Handle handle) const noexcept { return const_cast<HandleTable*>(this)->Get(handle); }
+
+  /*!
+   * \brief  Check whether a handle refers to an object.
+   * \param  handle The handle.
+   * \return True if the handle is valid.
+   */
+  bool Contains(Handle handle) const noexcept { return Get(handle) != nullptr; }
+
+  /*!
+   * \brief Call a function for every object. Must not be called concurrently with modifications.
+   * \param fn Function called with the handle and a reference to the object.
+   */
+  template <typename Fn>
+  void ForEach(Fn&& fn) {
+    for (size_type word{0}; word < WordsFor(capacity_); ++word) {
+      std::uint64_t used{~WordOf(0U, word).load(std::memory_order_relaxed)};
+      while (used != 0U) {
+        size_type const index{(word << kWordShift) + static_cast<size_type>(__builtin_ctzll(used))};
+        used &= used - 1U;
+        if (index >= capacity_) {
+          break;
+        }
+        Slot& slot{slots_[index]};
+        fn(static_cast<Handle>((slot.generation.load(std::memory_order_relaxed) << kIndexBits) | index),
+           *slot.GetObject());
+      }
+    }
+  }
+
+  /*!
+   * \brief Destroy all objects. Must not be called concurrently with any other member.
+   */
+  void clear() noexcept {
+    ForEach([this](Handle handle, T&) { static_cast<void>(Release(handle)); });
+  }
+
+  /*!
+   * \brief  The number of objects.
+   * \return The number of objects.
+   */
+  size_type size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief  The number of slots.
+   * \return The number of slots.
+   */
+  size_type capacity() const noexcept { return capacity_; }
+
+  /*!
+   * \brief  Determine whether the table holds no objects.
+   * \return True if the table is empty.
+   */
+  bool empty() const noexcept { return size() == 0U; }
+
+  /*!
+   * \brief  Determine whether all slots are in use.
+   * \return True if the table is full.
+   */
+  bool full() const noexcept { return size() == capacity_; }
+
+ private:
+  /*!
+   * \brief Unit of the bitmap. A set bit marks a free slot or, above the leaves, a word with free slots.
+   */
+  using Word = std::atomic<std::uint64_t>;
+
+  /*!
+   * \brief Typedef for the generation of a slot.
+   */
+  using Generation = Handle;
+
+  /*!
+   * \brief Shift from a bit index to its word index.
+   */
+  static constexpr size_type kWordShift{6};
+
+  /*!
+   * \brief Upper bound of the number of bitmap levels. Each level covers six more index bits.
+   */
+  static constexpr size_type kMaxLevels{(IndexBits + kWordShift - 1U) / kWordShift + 1U};
+
+  /*!
+   * \brief Mask of the generation bits after shifting out the index.
+   */
+  static constexpr Generation kGenerationMask{std::numeric_limits<Handle>::max() >> IndexBits};
+
+  /*!
+   * \brief Result of Claim() if there is no free slot.
+   */
+  static constexpr size_type kNoSlot{std::numeric_limits<size_type>::max()};
+
+  /*!
+   * \brief Storage of one object and the generation of its slot.
+   */
+  struct Slot {
+    /*!
+     * \brief Constructor for a free slot. The first generation is 1 so that handle 0 stays invalid.
+     */
+    Slot() noexcept : storage(), generation(1U) {}
+
+    /* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
+    /*!
+     * \brief  Access the object. The slot must be in use.
+     * \return Pointer to the object.
+     */
+    T* GetObject() noexcept { return reinterpret_cast<T*>(&storage); }
+
+    /*!
+     * \brief Uninitialized storage for the object.
+     */
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    /*!
+     * \brief The generation of the object in the slot, or of the next object while the slot is free.
+     */
+    std::atomic<Generation> generation;
+  };
+
+  /*!
+   * \brief Returns a claimed slot if the constructor of its object throws.
+   */
+  class SlotReturner final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param table The table.
+     * \param index The claimed slot.
+     */
+    SlotReturner(HandleTable* table, size_type index) noexcept : table_(table), index_(index) {}
+
+    /*!
+     * \brief Default copy constructor deleted.
+     */
+    SlotReturner(SlotReturner const&) = delete;
+
+    /*!
+     * \brief Default copy assignment operator deleted.
+     */
+    SlotReturner& operator=(SlotReturner const&) & = delete;
+
+    /*!
+     * \brief Default move constructor deleted.
+     */
+    SlotReturner(SlotReturner&&) = delete;
+
+    /*!
+     * \brief Default move assignment operator deleted.
+     */
+    SlotReturner& operator=(SlotReturner&&) & = delete;
+
+    /*!
+     * \brief Destructor. Frees the slot unless dismissed.
+     */
+    ~SlotReturner() {
+      if (table_ != nullptr) {
+        table_->Free(index_);
+      }
+    }
+
+    /*!
+     * \brief Keep the slot claimed.
+     */
+    void Dismiss() noexcept { table_ = nullptr; }
+
+   private:
+    /*!
+     * \brief The table, nullptr once dismissed.
+     */
+    HandleTable* table_;
+
+    /*!
+     * \brief The claimed slot.
+     */
+    size_type index_;
+  };
+
+  /*!
+   * \brief  The number of words needed for a number of bits.
+   * \param  bits The number of bits.
+   * \return The number of words.
+   */
+  static constexpr size_type WordsFor(size_type bits) noexcept { return (bits + 63U) >> kWordShift; }
+
+  /*!
+   * \brief  The mask of a bit inside its word.
+   * \param  index The bit index.
+   * \return The mask.
+   */
+  static constexpr std::uint64_t BitOf(size_type index) noexcept { return std::uint64_t{1} << (index & 63U); }
+
+  /*!
+   * \brief  The slot index of a handle.
+   * \param  handle The handle.
+   * \return The slot index.
+   */
+  static constexpr size_type IndexOf(Handle handle) noexcept {
+    return static_cast<size_type>(handle & static_cast<Handle>(kMaxCapacity - 1U));
+  }
+
+  /*!
+   * \brief  The generation of a handle.
+   * \param  handle The handle.
+   * \return The generation.
+   */
+  static constexpr Generation GenerationOf(Handle handle) noexcept {
+    return static_cast<Generation>(handle >> IndexBits);
+  }
+
+  /*!
+   * \brief  The generation following another one. Skips 0 so that no handle becomes kInvalidHandle.
+   * \param  generation The generation.
+   * \return The next generation.
+   */
+  static constexpr Generation NextGeneration(Generation generation) noexcept {
+    return (generation == kGenerationMask) ? Generation{1} : static_cast<Generation>(generation + 1U);
+  }
+
+  /*!
+   * \brief  Access a bitmap word.
+   * \param  level The level, 0 for the leaves.
+   * \param  word The word index inside the level.
+   * \return The word.
+   */
+  Word& WordOf(size_type level, size_type word) const noexcept { return words_[level_offsets_[level] + word]; }
+
+  /*!
+   * \brief Add to a counter. Only atomic in concurrent mode, a relaxed load and store otherwise.
+   * \param counter The counter.
+   * \param value The value to add, wrapping around for subtraction.
+   */
+  static void Add(std::atomic<size_type>& counter, size_type value) noexcept {
+    if (concurrent) {
+      static_cast<void>(counter.fetch_add(value, std::memory_order_relaxed));
+    } else {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief  Move a slot to the next generation if it is still at an expected one. Only atomic in concurrent mode.
+   * \param  generation The generation of the slot.
+   * \param  expected The generation of the handle being released.
+   * \return True if the generation was advanced, false if it differed from expected.
+   */
+  static bool AdvanceGeneration(std::atomic<Generation>& generation, Generation expected) noexcept {
+    bool advanced{false};
+    if (concurrent) {
+      advanced = generation.compare_exchange_strong(expected, NextGeneration(expected), std::memory_order_acq_rel,
+                                                    std::memory_order_relaxed);
+    } else {
+      advanced = generation.load(std::memory_order_relaxed) == expected;
+      if (advanced) {
+        generation.store(NextGeneration(expected), std::memory_order_relaxed);
+      }
+    }
+    return advanced;
+  }
+
+  /*!
+   * \brief  Clear bits of a word. Only atomic in concurrent mode.
+   * \param  word The word.
+   * \param  mask The bits to clear.
+   * \return The previous value.
+   */
+  static std::uint64_t ClearBits(Word& word, std::uint64_t mask) noexcept {
+    std::uint64_t previous{0};
+    if (concurrent) {
+      previous = word.fetch_and(~mask, std::memory_order_seq_cst);
+    } else {
+      previous = word.load(std::memory_order_relaxed);
+      word.store(previous & ~mask, std::memory_order_relaxed);
+    }
+    return previous;
+  }
+
+  /*!
+   * \brief  Set bits of a word. Only atomic in concurrent mode.
+   * \param  word The word.
+   * \param  mask The bits to set.
+   * \return The previous value.
+   */
+  static std::uint64_t SetBits(Word& word, std::uint64_t mask) noexcept {
+    std::uint64_t previous{0};
+    if (concurrent) {
+      previous = word.fetch_or(mask, std::memory_order_seq_cst);
+    } else {
+      previous = word.load(std::memory_order_relaxed);
+      word.store(previous | mask, std::memory_order_relaxed);
+    }
+    return previous;
+  }
+
+  /*!
+   * \brief   Take a free slot out of the bitmap.
+   * \details Descends from the top word along the lowest set bits. In concurrent mode an upper level bit may be
+   *          stale for a moment; the descent then repairs it and starts over.
+   * \return  The slot index, kNoSlot if no slot is free.
+   */
+  size_type Claim() noexcept {
+    size_type index{kNoSlot};
+    bool retry{level_count_ != 0U};
+    while (retry) {
+      size_type word{0};
+      size_type level{level_count_ - 1U};
+      std::uint64_t bits{WordOf(level, word).load(std::memory_order_acquire)};
+      retry = false;
+      while ((bits != 0U) && (level != 0U)) {
+        word = (word << kWordShift) + static_cast<size_type>(__builtin_ctzll(bits));
+        --level;
+        bits = WordOf(level, word).load(std::memory_order_acquire);
+        if (bits == 0U) {
+          // Stale hint in the level above.
+          UnmarkEmpty(level + 1U, word);
+          retry = true;
+        }
+      }
+      if ((level == 0U) && (bits != 0U)) {
+        Word& leaf{WordOf(0U, word)};
+        bool claimed{false};
+        while ((!claimed) && (bits != 0U)) {
+          std::uint64_t const lowest{bits & (~bits + 1U)};
+          if (concurrent) {
+            claimed = leaf.compare_exchange_weak(bits, bits & ~lowest, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire);
+          } else {
+            leaf.store(bits & ~lowest, std::memory_order_relaxed);
+            claimed = true;
+          }
+          if (claimed) {
+            index = (word << kWordShift) + static_cast<size_type>(__builtin_ctzll(lowest));
+            if ((bits & ~lowest) == 0U) {
+              UnmarkEmpty(1U, word);
+            }
+          }
+        }
+        retry = !claimed;
+        if (!claimed) {
+          UnmarkEmpty(1U, word);
+        }
+      }
+    }
+    return index;
+  }
+
+  /*!
+   * \brief Return a slot to the bitmap and mark the words above it as having free slots.
+   * \param index The slot index.
+   */
+  void Free(size_type index) noexcept {
+    size_type bit{index};
+    size_type level{0};
+    bool propagate{true};
+    while (propagate && (level < level_count_)) {
+      std::uint64_t const previous{SetBits(WordOf(level, bit >> kWordShift), BitOf(bit))};
+      // The words above already mark this word unless it had no free slot.
+      propagate = previous == 0U;
+      bit >>= kWordShift;
+      ++level;
+    }
+  }
+
+  /*!
+   * \brief   Clear the bit of a lower level word that has become empty, and continue upwards while words empty.
+   * \details In concurrent mode a slot may be freed in the lower word right after it was seen empty. Its Free()
+   *          found the bit still set and stopped there, so the lower word is checked again after the bit was
+   *          cleared and the bit restored if needed.
+   * \param   level The level of the bit, at least 1.
+   * \param   bit The bit index inside the level, equal to the index of the lower level word.
+   */
+  void UnmarkEmpty(size_type level, size_type bit) noexcept {
+    bool propagate{true};
+    while (propagate && (level < level_count_)) {
+      Word& word{WordOf(level, bit >> kWordShift)};
+      std::uint64_t const previous{ClearBits(word, BitOf(bit))};
+      propagate = (previous & ~BitOf(bit)) == 0U;
+      if (concurrent && (WordOf(level - 1U, bit).load(std::memory_order_seq_cst) != 0U)) {
+        Remark(level, bit);
+        propagate = false;
+      }
+      bit >>= kWordShift;
+      ++level;
+    }
+  }
+
+  /*!
+   * \brief Set the bit of a lower level word that has free slots, and continue upwards while words were empty.
+   * \param level The level of the bit, at least 1.
+   * \param bit The bit index inside the level.
+   */
+  void Remark(size_type level, size_type bit) noexcept {
+    bool propagate{true};
+    while (propagate && (level < level_count_)) {
+      propagate = SetBits(WordOf(level, bit >> kWordShift), BitOf(bit)) == 0U;
+      bit >>= kWordShift;
+      ++level;
+    }
+  }
+
+  /*!
+   * \brief Release the slot and bitmap memory. The table must be empty.
+   */
+  void Deallocate() noexcept {
+    if (slots_ != nullptr) {
+      for (size_type i{0}; i < capacity_; ++i) {
+        slots_[i].~Slot();
+      }
+      slot_allocator_.deallocate(slots_, capacity_);
+      for (size_type i{0}; i < word_count_; ++i) {
+        words_[i].~Word();
+      }
+      word_allocator_.deallocate(words_, word_count_);
+      slots_ = nullptr;
+      words_ = nullptr;
+      capacity_ = 0;
+      word_count_ = 0;
+      level_count_ = 0;
+    }
+  }
+
+  /*!
+   * \brief The allocator of the slots.
+   */
+  typename allocator_type::template rebind<Slot>::other slot_allocator_;
+
+  /*!
+   * \brief The allocator of the bitmap.
+   */
+  typename allocator_type::template rebind<Word>::other word_allocator_;
+
+  /*!
+   * \brief The slots.
+   */
+  Slot* slots_;
+
+  /*!
+   * \brief The words of all bitmap levels, leaves first.
+   */
+  Word* words_;
+
+  /*!
+   * \brief The number of slots.
+   */
+  size_type capacity_;
+
+  /*!
+   * \brief The number of bitmap words.
+   */
+  size_type word_count_;
+
+  /*!
+   * \brief The number of bitmap levels. The last level has a single word.
+   */
+  size_type level_count_;
+
+  /*!
+   * \brief The offset of each level in words_.
+   */
+  std::array<size_type, kMaxLevels> level_offsets_;
+
+  /*!
+   * \brief The number of objects.
+   */
+  std::atomic<size_type> size_;
+};
+
+/*!
+ * \brief A handle that never refers to an object.
+ */
+template <typename T, typename HandleType, bool concurrent, std::size_t IndexBits, typename alloc>
+constexpr typename HandleTable<T, HandleType, concurrent, IndexBits, alloc>::Handle
+    HandleTable<T, HandleType, concurrent, IndexBits, alloc>::kInvalidHandle;
+
+/*!
+ * \brief The number of handle bits used for the slot index.
+ */
+template <typename T, typename HandleType, bool concurrent, std::size_t IndexBits, typename alloc>
+constexpr std::size_t HandleTable<T, HandleType, concurrent, IndexBits, alloc>::kIndexBits;
+
+/*!
+ * \brief The maximum capacity addressable by the index bits.
+ */
+template <typename T, typename HandleType, bool concurrent, std::size_t IndexBits, typename alloc>
+constexpr typename HandleTable<T, HandleType, concurrent, IndexBits, alloc>::size_type
+    HandleTable<T, HandleType, concurrent, IndexBits, alloc>::kMaxCapacity;
+
+}  // namespace container
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_CONTAINER_HANDLE_TABLE_H_
@@ -0,0 +1,129 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  parallel_container_aggregator.h
+ *        \brief  Visits the containers of a ContainerAggregator in parallel on an Executor.
+ *
+ *      \details  Kept apart from container_aggregator.h so that users of the aggregator do not pull in the executor
+ *                and futex headers.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_PARALLEL_CONTAINER_AGGREGATOR_H_
+#define LIB_VAC_INCLUDE_VAC_CONTAINER_PARALLEL_CONTAINER_AGGREGATOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "vac/container/container_aggregator.h"
+#include "vac/sync/futex.h"
+#include "vac/threadpool/executor.h"
+
+namespace vac {
+namespace container {
+
+/*!
+ * \brief Default number of segments handed to a task at once by ParallelForEachSegment().
+ */
+constexpr std::size_t kDefaultSegmentsPerChunk{64};
+
+namespace detail {
+
+/*!
+ * \brief Progress of one ParallelForEachSegment() call, shared with its tasks.
+ */
+struct ParallelSegmentState {
+  /*!
+   * \brief Constructor.
+   * \param chunks The number of chunks.
+   */
+  explicit ParallelSegmentState(std::size_t chunks) noexcept
+      : next_chunk{0}, chunk_count{chunks}, remaining_chunks{static_cast<std::uint32_t>(chunks)} {}
+
+  /*! \brief The next chunk to take. */
+  std::atomic<std::size_t> next_chunk;
+  /*! \brief The number of chunks. */
+  std::size_t chunk_count;
+  /*! \brief The number of chunks not completed yet. Futex word the caller waits on. */
+  std::atomic<std::uint32_t> remaining_chunks;
+};
+
+}  // namespace detail
+
+/*!
+ * \brief   Visit the elements of an aggregator container by container, in parallel on an executor.
+ * \details The containers are split into chunks of segments_per_chunk containers. Up to task_count tasks are
+ *          dispatched to the executor; they and the calling thread take chunks until none are left, so the call
+ *          completes even if the executor never runs a task. Returns after fn has returned for every non-empty
+ *          container. Tasks that start after that find no chunk left and return immediately. fn is called
+ *          concurrently and must not throw. The container type must provide data().
+ * \param   aggregator The containers to visit.
+ * \param   executor The executor running the tasks.
+ * \param   task_count The maximum number of tasks dispatched to the executor.
+ * \param   fn Called with a ContainerAggregator::Segment.
+ * \param   segments_per_chunk The number of containers taken at once. Values below 1 are treated as 1.
+ */
+template <typename ContainerPointer, typename Fn>
+void ParallelForEachSegment(ContainerAggregator<ContainerPointer> const& aggregator,
+                            vac::threadpool::Executor& executor, std::size_t task_count, Fn const& fn,
+                            std::size_t segments_per_chunk = kDefaultSegmentsPerChunk) {
+  using Segment = typename ContainerAggregator<ContainerPointer>::Segment;
+  std::size_t const container_count{aggregator.NumberOfRegisteredContainers()};
+  std::size_t const chunk_size{std::max(segments_per_chunk, static_cast<std::size_t>(1))};
+  std::size_t const chunk_count{((container_count + chunk_size) - 1U) / chunk_size};
+  if (chunk_count != 0U) {
+    std::shared_ptr<detail::ParallelSegmentState> const state{
+        std::make_shared<detail::ParallelSegmentState>(chunk_count)};
+    ContainerAggregator<ContainerPointer> const* const containers{&aggregator};
+    Fn const* const function{&fn};
+    // Captures the state by value: a task may still start after this call returned, but then takes no chunk.
+    auto const worker = [state, containers, function, chunk_size, container_count]() {
+      std::size_t chunk{state->next_chunk.fetch_add(1U, std::memory_order_relaxed)};
+      while (chunk < state->chunk_count) {
+        std::size_t const first{chunk * chunk_size};
+        std::size_t const last{std::min(first + chunk_size, container_count)};
+        for (std::size_t i{first}; i < last; ++i) {
+          Segment const segment{containers->GetSegment(i)};
+          if (!segment.empty()) {
+            (*function)(segment);
+          }
+        }
+        if (state->remaining_chunks.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+          vac::sync::FutexWakeAll(state->remaining_chunks);
+        }
+        chunk = state->next_chunk.fetch_add(1U, std::memory_order_relaxed);
+      }
+    };
+    std::size_t const dispatched{std::min(task_count, chunk_count - 1U)};
+    for (std::size_t i{0}; i < dispatched; ++i) {
+      executor.Execute(worker);
+    }
+    worker();
+    std::uint32_t remaining{state->remaining_chunks.load(std::memory_order_acquire)};
+    while (remaining != 0U) {
+      vac::sync::FutexWait(state->remaining_chunks, remaining);
+      remaining = state->remaining_chunks.load(std::memory_order_acquire);
+    }
+  }
+}
+
+}  // namespace container
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_CONTAINER_PARALLEL_CONTAINER_AGGREGATOR_H_
@@ -0,0 +1,706 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  segmented_vector.h
+ *        \brief  Growable vector of fixed-size segments whose elements never move.
+ *
+ *      \details  Elements are stored in segments of a power of two size. Growing allocates a new segment and leaves all
+ *                existing elements in place, so pointers and references stay valid until the element is removed.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_SEGMENTED_VECTOR_H_
+#define LIB_VAC_INCLUDE_VAC_CONTAINER_SEGMENTED_VECTOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vac/language/throw_or_terminate.h"
+#include "vac/memory/phase_managed_allocator.h"
+
+namespace vac {
+namespace container {
+
+namespace internal {
+
+/*!
+ * \brief  Binary logarithm of a power of two.
+ * \param  value The power of two.
+ * \return The exponent.
+ */
+constexpr std::size_t Log2OfPowerOfTwo(std::size_t value) noexcept {
+  return (value <= 1U) ? 0U : (1U + Log2OfPowerOfTwo(value >> 1U));
+}
+
+/*!
+ * \brief Hint the processor to load the cache line of an address for reading.
+ * \param address The address.
+ */
+inline void PrefetchForRead(void const* address) noexcept {
+#if defined(__GNUC__)
+  __builtin_prefetch(address, 0, 3);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+}  // namespace internal
+
+/*!
+ * \brief   Vector with stable element addresses, built from segments of SegmentSize elements.
+ * \details Indexed access is a shift and a mask into the segment table. Growing beyond the capacity allocates one
+ *          segment and possibly grows the segment table, which holds pointers only; elements are never moved. With the
+ *          default PhaseManagedAllocator segments can only be allocated in the allocation phase: reserve() there and
+ *          grow within the reserved capacity later.
+ * \tparam  T The element type.
+ * \tparam  SegmentSize The number of elements per segment, a power of two.
+ * \tparam  alloc The allocator of the segments and of the segment table.
+ */
+template <typename T, std::size_t SegmentSize = 64, typename alloc = vac::memory::PhaseManagedAllocator<T>>
+class SegmentedVector final {
+  static_assert((SegmentSize != 0U) && ((SegmentSize & (SegmentSize - 1U)) == 0U),
+                "SegmentSize must be a power of two");
+
+ public:
+  /*!
+   * \brief Typedef for the size value.
+   */
+  using size_type = std::size_t;
+
+  /*!
+   * \brief Typedef for the contained element.
+   */
+  using value_type = T;
+
+  /*!
+   * \brief Typedef for a reference.
+   */
+  using reference = T&;
+
+  /*!
+   * \brief Typedef for a const reference.
+   */
+  using const_reference = T const&;
+
+  /*!
+   * \brief Typedef for the allocator used.
+   */
+  using allocator_type = alloc;
+
+  /*!
+   * \brief Typedef for the allocator type used after rebinding.
+   */
+  using actual_allocator_type = typename allocator_type::template rebind<T>::other;
+
+  /*!
+   * \brief Number of elements per segment.
+   */
+  static constexpr size_type kSegmentSize{SegmentSize};
+
+  /*!
+   * \brief Random access iterator.
+   * \tparam Value The element type, T or T const.
+   */
+  template <typename Value>
+  class Iterator final {
+   public:
+    /*!
+     * \brief Typedef for the iterator category.
+     */
+    using iterator_category = std::random_access_iterator_tag;
+
+    /*!
+     * \brief Typedef for the element type.
+     */
+    using value_type = typename std::remove_const<Value>::type;
+
+    /*!
+     * \brief Typedef for the distance between iterators.
+     */
+    using difference_type = std::ptrdiff_t;
+
+    /*!
+     * \brief Typedef for a pointer.
+     */
+    using pointer = Value*;
+
+    /*!
+     * \brief Typedef for a reference.
+     */
+    using reference = Value&;
+
+    /*!
+     * \brief Default constructor for a singular iterator.
+     */
+    Iterator() noexcept : segments_(nullptr), index_(0) {}
+
+    /*!
+     * \brief Constructor.
+     * \param segments The segment table.
+     * \param index The index of the element.
+     */
+    Iterator(T* const* segments, size_type index) noexcept : segments_(segments), index_(index) {}
+
+    /*!
+     * \brief Conversion from an iterator to a const iterator.
+     * \param other The iterator.
+     */
+    template <typename Other, typename = typename std::enable_if<std::is_same<Other, T>::value &&
+                                                                 std::is_const<Value>::value>::type>
+    Iterator(Iterator<Other> const& other) noexcept  // NOLINT[runtime/explicit]
+        : segments_(other.segments_), index_(other.index_) {}
+
+    /*!
+     * \brief  Access the element.
+     * \return Reference to the element.
+     */
+    reference operator*() const noexcept { return segments_[index_ >> kShift][index_ & kMask]; }
+
+    /*!
+     * \brief  Access the element.
+     * \return Pointer to the element.
+     */
+    pointer operator->() const noexcept { return &**this; }
+
+    /*!
+     * \brief  Access an element relative to this one.
+     * \param  offset The offset.
+     * \return Reference to the element.
+     */
+    reference operator[](difference_type offset) const noexcept { return *(*this + offset); }
+
+    /*!
+     * \brief  Pre-increment.
+     * \return This iterator.
+     */
+    Iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+
+    /*!
+     * \brief  Post-increment.
+     * \return The previous iterator.
+     */
+    Iterator operator++(int) noexcept {
+      Iterator const previous{*this};
+      ++index_;
+      return previous;
+    }
+
+    /*!
+     * \brief  Pre-decrement.
+     * \return This iterator.
+     */
+    Iterator& operator--() noexcept {
+      --index_;
+      return *this;
+    }
+
+    /*!
+     * \brief  Post-decrement.
+     * \return The previous iterator.
+     */
+    Iterator operator--(int) noexcept {
+      Iterator const previous{*this};
+      --index_;
+      return previous;
+    }
+
+    /*!
+     * \brief  Advance.
+     * \param  offset The offset.
+     * \return This iterator.
+     */
+    Iterator& operator+=(difference_type offset) noexcept {
+      index_ = static_cast<size_type>(static_cast<difference_type>(index_) + offset);
+      return *this;
+    }
+
+    /*!
+     * \brief  Go back.
+     * \param  offset The offset.
+     * \return This iterator.
+     */
+    Iterator& operator-=(difference_type offset) noexcept { return *this += -offset; }
+
+    /*!
+     * \brief  Advanced iterator.
+     * \param  offset The offset.
+     * \return The iterator.
+     */
+    Iterator operator+(difference_type offset) const noexcept {
+      Iterator result{*this};
+      result += offset;
+      return result;
+    }
+
+    /*!
+     * \brief  Advanced iterator.
+     * \param  offset The offset.
+     * \param  it The iterator.
+     * \return The iterator.
+     */
+    friend Iterator operator+(difference_type offset, Iterator const& it) noexcept { return it + offset; }
+
+    /*!
+     * \brief  Iterator moved back.
+     * \param  offset The offset.
+     * \return The iterator.
+     */
+    Iterator operator-(difference_type offset) const noexcept { return *this + (-offset); }
+
+    /*!
+     * \brief  Distance between two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return The number of elements from other to this.
+     */
+    difference_type operator-(Iterator const& other) const noexcept {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    /*!
+     * \brief  Compare two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if both refer to the same index.
+     */
+    bool operator==(Iterator const& other) const noexcept { return index_ == other.index_; }
+
+    /*!
+     * \brief  Compare two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if the indexes differ.
+     */
+    bool operator!=(Iterator const& other) const noexcept { return index_ != other.index_; }
+
+    /*!
+     * \brief  Order two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if this refers to a lower index.
+     */
+    bool operator<(Iterator const& other) const noexcept { return index_ < other.index_; }
+
+    /*!
+     * \brief  Order two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if this refers to a higher index.
+     */
+    bool operator>(Iterator const& other) const noexcept { return index_ > other.index_; }
+
+    /*!
+     * \brief  Order two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if this does not refer to a higher index.
+     */
+    bool operator<=(Iterator const& other) const noexcept { return index_ <= other.index_; }
+
+    /*!
+     * \brief  Order two iterators of the same vector.
+     * \param  other The other iterator.
+     * \return True if this does not refer to a lower index.
+     */
+    bool operator>=(Iterator const& other) const noexcept { return index_ >= other.index_; }
+
+   private:
+    /*!
+     * \brief Const iterators read the members of iterators.
+     */
+    template <typename>
+    friend class Iterator;
+
+    /*!
+     * \brief The segment table.
+     */
+    T* const* segments_;
+
+    /*!
+     * \brief The index of the element.
+     */
+    size_type index_;
+  };
+
+  /*!
+   * \brief Typedef for an iterator.
+   */
+  using iterator = Iterator<T>;
+
+  /*!
+   * \brief Typedef for a const iterator.
+   */
+  using const_iterator = Iterator<T const>;
+
+  /*!
+   * \brief Initialize an empty SegmentedVector. Does not allocate.
+   * \param allocator The allocator to use, default is allocator_type().
+   */
+  explicit SegmentedVector(allocator_type const& allocator = allocator_type())
+      : allocator_(allocator), segments_(SegmentTableAllocator(allocator)), size_(0) {}
+
+  /*!
+   * \brief Default copy constructor deleted.
+   */
+  SegmentedVector(SegmentedVector const&) = delete;
+
+  /*!
+   * \brief  Default copy assignment operator deleted.
+   */
+  SegmentedVector& operator=(SegmentedVector const&) = delete;
+
+  /*!
+   * \brief Move constructor. Element addresses are preserved.
+   * \param other The vector from which to construct the new vector.
+   */
+  SegmentedVector(SegmentedVector&& other) : SegmentedVector(other.allocator_) { this->swap(other); }
+
+  /*!
+   * \brief  Move assignment. Element addresses are preserved.
+   * \param  other The vector from which to construct the new vector.
+   * \return A reference to the assigned-to object.
+   */
+  SegmentedVector& operator=(SegmentedVector&& other) {
+    this->swap(other);
+    return *this;
+  }
+
+  /*!
+   * \brief Destructor.
+   */
+  ~SegmentedVector() {
+    clear();
+    shrink_to_fit();
+  }
+
+  /*!
+   * \brief Allocate segments until num_elements elements fit. Existing elements are not moved.
+   * \param num_elements The number of elements to reserve space for.
+   */
+  void reserve(size_type num_elements) {
+    size_type const needed_segments{(num_elements + kMask) >> kShift};
+    if (needed_segments > segments_.size()) {
+      segments_.reserve(needed_segments);
+    }
+    while (capacity() < num_elements) {
+      AddSegment();
+    }
+  }
+
+  /*!
+   * \brief  Construct an element at the end.
+   * \param  args Arguments to construct the element.
+   * \return Reference to the new element.
+   */
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+      AddSegment();
+    }
+    T* const element{&segments_[size_ >> kShift][size_ & kMask]};
+    std::allocator_traits<actual_allocator_type>::construct(allocator_, element, std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+  }
+
+  /*!
+   * \brief Copy an element to the end.
+   * \param value The element.
+   */
+  void push_back(T const& value) { static_cast<void>(emplace_back(value)); }
+
+  /*!
+   * \brief Move an element to the end.
+   * \param value The element.
+   */
+  void push_back(T&& value) { static_cast<void>(emplace_back(std::move(value))); }
+
+  /*!
+   * \brief Destroy the last element. The vector must not be empty.
+   */
+  void pop_back() {
+    --size_;
+    std::allocator_traits<actual_allocator_type>::destroy(allocator_, &(*this)[size_]);
+  }
+
+  /*!
+   * \brief Destroy all elements. The segments are kept.
+   */
+  void clear() {
+    while (size_ != 0U) {
+      pop_back();
+    }
+  }
+
+  /*!
+   * \brief Deallocate the segments that hold no element.
+   */
+  void shrink_to_fit() {
+    size_type const used_segments{(size_ + kMask) >> kShift};
+    while (segments_.size() > used_segments) {
+      allocator_.deallocate(segments_.back(), kSegmentSize);
+      segments_.pop_back();
+    }
+  }
+
+  /*!
+   * \brief Swap the contents of two SegmentedVector objects including their allocator.
+   * \param other The second vector whose contents are swapped.
+   */
+  void swap(SegmentedVector& other) noexcept {
+    std::swap(allocator_, other.allocator_);
+    segments_.swap(other.segments_);
+    std::swap(size_, other.size_);
+  }
+
+  /*!
+   * \brief  Get the number of contained elements.
+   * \return The number of elements.
+   */
+  size_type size() const noexcept { return size_; }
+
+  /*!
+   * \brief  Get the number of elements that fit into the allocated segments.
+   * \return The capacity.
+   */
+  size_type capacity() const noexcept { return segments_.size() * kSegmentSize; }
+
+  /*!
+   * \brief  Check whether the vector is empty.
+   * \return True if the vector is empty.
+   */
+  bool empty() const noexcept { return size_ == 0U; }
+
+  /*!
+   * \brief  Get the number of allocated segments.
+   * \return The number of segments.
+   */
+  size_type segment_count() const noexcept { return segments_.size(); }
+
+  /*!
+   * \brief  Access an element without bounds check.
+   * \param  index The index of the element.
+   * \return Reference to the element.
+   */
+  reference operator[](size_type index) noexcept { return segments_[index >> kShift][index & kMask]; }
+
+  /*!
+   * \brief  Access an element without bounds check.
+   * \param  index The index of the element.
+   * \return Const reference to the element.
+   */
+  const_reference operator[](size_type index) const noexcept { return segments_[index >> kShift][index & kMask]; }
+
+  /*!
+   * \brief  Access an element with bounds check.
+   * \param  index The index of the element.
+   * \return Reference to the element.
+   * \throws std::out_of_range If index is not smaller than size().
+   */
+  reference at(size_type index) {
+    if (index >= size_) {
+      vac::language::ThrowOrTerminate<std::out_of_range>("SegmentedVector index out of range");
+    }
+    return (*this)[index];
+  }
+
+  /*!
+   * \brief  Access an element with bounds check.
+   * \param  index The index of the element.
+   * \return Const reference to the element.
+   * \throws std::out_of_range If index is not smaller than size().
+   */
+  const_reference at(size_type index) const {
+    if (index >= size_) {
+      vac::language::ThrowOrTerminate<std::out_of_range>("SegmentedVector index out of range");
+    }
+    return (*this)[index];
+  }
+
+  /*!
+   * \brief  Access the first element. The vector must not be empty.
+   * \return Reference to the element.
+   */
+  reference front() noexcept { return (*this)[0]; }
+
+  /*!
+   * \brief  Access the first element. The vector must not be empty.
+   * \return Const reference to the element.
+   */
+  const_reference front() const noexcept { return (*this)[0]; }
+
+  /*!
+   * \brief  Access the last element. The vector must not be empty.
+   * \return Reference to the element.
+   */
+  reference back() noexcept { return (*this)[size_ - 1U]; }
+
+  /*!
+   * \brief  Access the last element. The vector must not be empty.
+   * \return Const reference to the element.
+   */
+  const_reference back() const noexcept { return (*this)[size_ - 1U]; }
+
+  /*!
+   * \brief  Iterator to the first element.
+   * \return The iterator.
+   */
+  iterator begin() noexcept { return iterator{segments_.data(), 0}; }
+
+  /*!
+   * \brief  Past-the-end iterator.
+   * \return The iterator.
+   */
+  iterator end() noexcept { return iterator{segments_.data(), size_}; }
+
+  /*!
+   * \brief  Const iterator to the first element.
+   * \return The iterator.
+   */
+  const_iterator begin() const noexcept { return const_iterator{segments_.data(), 0}; }
+
+  /*!
+   * \brief  Const past-the-end iterator.
+   * \return The iterator.
+   */
+  const_iterator end() const noexcept { return const_iterator{segments_.data(), size_}; }
+
+  /*!
+   * \brief  Const iterator to the first element.
+   * \return The iterator.
+   */
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  /*!
+   * \brief  Const past-the-end iterator.
+   * \return The iterator.
+   */
+  const_iterator cend() const noexcept { return end(); }
+
+  /*!
+   * \brief   Call a function for every element in order.
+   * \details Walks the elements segment by segment as contiguous arrays and prefetches the start of the next segment
+   *          when entering a segment. Faster than iterating with iterator.
+   * \param   fn The function, called with a reference to each element.
+   */
+  template <typename Fn>
+  void ForEach(Fn&& fn) {
+    ForEachImpl(*this, std::forward<Fn>(fn));
+  }
+
+  /*!
+   * \brief Call a function for every element in order, see ForEach().
+   * \param fn The function, called with a const reference to each element.
+   */
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    ForEachImpl(*this, std::forward<Fn>(fn));
+  }
+
+ private:
+  /*!
+   * \brief Shift from an index to its segment.
+   */
+  static constexpr size_type kShift{internal::Log2OfPowerOfTwo(SegmentSize)};
+
+  /*!
+   * \brief Mask from an index to its position in the segment.
+   */
+  static constexpr size_type kMask{SegmentSize - 1U};
+
+  /*!
+   * \brief Allocator of the segment table.
+   */
+  using SegmentTableAllocator = typename allocator_type::template rebind<T*>::other;
+
+  /*!
+   * \brief Allocate one more segment.
+   *        The segment table grows geometrically before the segment is allocated, so push_back() cannot throw and
+   *        leak the segment.
+   */
+  void AddSegment() {
+    if (segments_.size() == segments_.capacity()) {
+      segments_.reserve(std::max(segments_.size() * 2U, static_cast<size_type>(1)));
+    }
+    segments_.push_back(allocator_.allocate(kSegmentSize));
+  }
+
+  /*!
+   * \brief Implementation of ForEach() for const and non-const vectors.
+   * \param self The vector.
+   * \param fn The function.
+   */
+  template <typename Self, typename Fn>
+  static void ForEachImpl(Self& self, Fn&& fn) {
+    size_type remaining{self.size_};
+    for (size_type segment{0}; remaining != 0U; ++segment) {
+      if ((segment + 1U) < self.segments_.size()) {
+        internal::PrefetchForRead(self.segments_[segment + 1U]);
+      }
+      size_type const count{(remaining < kSegmentSize) ? remaining : kSegmentSize};
+      typename std::conditional<std::is_const<Self>::value, T const*, T*>::type const elements{
+          self.segments_[segment]};
+      for (size_type i{0}; i < count; ++i) {
+        fn(elements[i]);
+      }
+      remaining -= count;
+    }
+  }
+
+  /*!
+   * \brief The allocator of the segments.
+   */
+  actual_allocator_type allocator_;
+
+  /*!
+   * \brief The segment table.
+   */
+  std::vector<T*, SegmentTableAllocator> segments_;
+
+  /*!
+   * \brief The number of elements.
+   */
+  size_type size_;
+};
+
+/*!
+ * \brief Number of elements per segment.
+ */
+template <typename T, std::size_t SegmentSize, typename alloc>
+constexpr typename SegmentedVector<T, SegmentSize, alloc>::size_type
+    SegmentedVector<T, SegmentSize, alloc>::kSegmentSize;
+
+/*!
+ * \brief Shift from an index to its segment.
+ */
+template <typename T, std::size_t SegmentSize, typename alloc>
+constexpr typename SegmentedVector<T, SegmentSize, alloc>::size_type
+    SegmentedVector<T, SegmentSize, alloc>::kShift;
+
+/*!
+ * \brief Mask from an index to its position in the segment.
+ */
+template <typename T, std::size_t SegmentSize, typename alloc>
+constexpr typename SegmentedVector<T, SegmentSize, alloc>::size_type
+    SegmentedVector<T, SegmentSize, alloc>::kMask;
+
+}  // namespace container
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_CONTAINER_SEGMENTED_VECTOR_H_
@@ -0,0 +1,198 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  size_caching_container_aggregator.h
+ *        \brief  ContainerAggregator whose size() is cached between changes of the containers.
+ *
+ *      \details  The owner of the containers increments a generation counter after every change of their sizes. The
+ *                total size is recounted only when the counter has moved since the last count.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_SIZE_CACHING_CONTAINER_AGGREGATOR_H_
+#define LIB_VAC_INCLUDE_VAC_CONTAINER_SIZE_CACHING_CONTAINER_AGGREGATOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ara/core/span.h"
+#include "vac/container/container_aggregator.h"
+#include "vac/sync/seq_locked.h"
+
+namespace vac {
+namespace container {
+
+/*!
+ * \brief   ContainerAggregator with a cached total size.
+ * \details size() is threadsafe and reuses the last count as long as the generation counter has the value it had
+ *          when the count was taken. The count is kept in a SeqLocked, refreshed by a single try-acquired writer.
+ * \tparam  ContainerPointer Pointer type to containers (can be raw pointer, unique_ptr, shared_ptr).
+ */
+template <typename ContainerPointer>
+class SizeCachingContainerAggregator final {
+ public:
+  /*!
+   * \brief The aggregator without caching.
+   */
+  using AggregatorType = ContainerAggregator<ContainerPointer>;
+
+  /*!
+   * \brief Pointer type to containers.
+   */
+  using ContainerPointerType = typename AggregatorType::ContainerPointerType;
+
+  /*!
+   * \brief Value type of container elements.
+   */
+  using value_type = typename AggregatorType::value_type;
+
+  /*!
+   * \brief Const iterator type.
+   */
+  using const_iterator = typename AggregatorType::const_iterator;
+
+  /*!
+   * \brief Constructor.
+   * \param container_pointer_buffer View to buffer of container pointers.
+   * \param generation Counter that the owner of the containers increments after every change of their sizes. Must
+   *        outlive the aggregator.
+   */
+  SizeCachingContainerAggregator(ara::core::Span<ContainerPointerType const> container_pointer_buffer,
+                                 std::atomic<std::uint64_t> const& generation)
+      : aggregator_{container_pointer_buffer}, generation_{&generation}, cached_size_{}, cache_writer_active_{false} {}
+
+  /*!
+   * \brief Constructor.
+   * \param container_pointer_buffer View to buffer of container pointers.
+   * \param generation Counter that the owner of the containers increments after every change of their sizes. Must
+   *        outlive the aggregator.
+   */
+  SizeCachingContainerAggregator(ara::core::Span<ContainerPointerType> container_pointer_buffer,
+                                 std::atomic<std::uint64_t> const& generation)
+      : aggregator_{container_pointer_buffer}, generation_{&generation}, cached_size_{}, cache_writer_active_{false} {}
+
+  /*!
+   * \brief Copy constructor. The copy starts without a cached size.
+   * \param other The aggregator to copy.
+   */
+  SizeCachingContainerAggregator(SizeCachingContainerAggregator const& other) noexcept
+      : aggregator_{other.aggregator_},
+        generation_{other.generation_},
+        cached_size_{},
+        cache_writer_active_{false} {}
+
+  /*!
+   * \brief  Copy assignment. Drops the cached size.
+   * \param  other The aggregator to copy.
+   * \return A reference to the assigned-to object.
+   */
+  SizeCachingContainerAggregator& operator=(SizeCachingContainerAggregator const& other) & noexcept {
+    aggregator_ = other.aggregator_;
+    generation_ = other.generation_;
+    cached_size_.Store(CachedSize{});
+    return *this;
+  }
+
+  /*!
+   * \brief Destructor.
+   */
+  ~SizeCachingContainerAggregator() = default;
+
+  /*!
+   * \brief  Returns the aggregator without caching, e.g. for segment iteration.
+   * \return The aggregator.
+   */
+  AggregatorType const& GetAggregator() const noexcept { return aggregator_; }
+
+  /*!
+   * \brief  Returns the current number of containers registered in the aggregator.
+   * \return Number of containers.
+   */
+  std::size_t NumberOfRegisteredContainers() const { return aggregator_.NumberOfRegisteredContainers(); }
+
+  /*!
+   * \brief  Returns the total number of container elements. Threadsafe.
+   * \return Number of container elements.
+   */
+  std::size_t size() const {
+    std::size_t total{0};
+    std::uint64_t const generation{generation_->load(std::memory_order_acquire)};
+    CachedSize cached{};
+    if (cached_size_.TryLoad(cached) && cached.valid && (cached.generation == generation)) {
+      total = cached.size;
+    } else {
+      total = aggregator_.size();
+      // SeqLocked admits a single writer; callers that lose the race just skip updating the cache.
+      if (!cache_writer_active_.exchange(true, std::memory_order_acquire)) {
+        cached_size_.Store(CachedSize{generation, total, true});
+        cache_writer_active_.store(false, std::memory_order_release);
+      }
+    }
+    return total;
+  }
+
+  /*!
+   * \brief  Returns the first container element.
+   * \return The first element of a non-empty container, or cend() if there is none.
+   */
+  const_iterator cbegin() const { return aggregator_.cbegin(); }
+
+  /*!
+   * \brief  Returns an iterator pointing to element after the last element after the last container.
+   * \return An iterator pointing to the sentinel end value.
+   */
+  const_iterator cend() const { return aggregator_.cend(); }
+
+  /*!
+   * \brief  Returns the first container element.
+   * \return The first element of a non-empty container, or cend() if there is none.
+   */
+  const_iterator begin() const { return cbegin(); }
+
+  /*!
+   * \brief  Returns an iterator pointing to element after the last element after the last container.
+   * \return An iterator pointing to the sentinel end value.
+   */
+  const_iterator end() const { return cend(); }
+
+ private:
+  /*!
+   * \brief Total size together with the generation at which it was counted.
+   */
+  struct CachedSize {
+    /*! \brief Value of the generation counter before counting. */
+    std::uint64_t generation;
+    /*! \brief The number of elements. */
+    std::size_t size;
+    /*! \brief False until the first count. */
+    bool valid;
+  };
+
+  /*! \brief The aggregated containers. */
+  AggregatorType aggregator_;
+  /*! \brief Generation counter of the containers. */
+  std::atomic<std::uint64_t> const* generation_;
+  /*! \brief The last counted size. */
+  mutable vac::sync::SeqLocked<CachedSize> cached_size_;
+  /*! \brief Set while a size() call updates cached_size_. */
+  mutable std::atomic<bool> cache_writer_active_;
+};
+
+}  // namespace container
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_CONTAINER_SIZE_CACHING_CONTAINER_AGGREGATOR_H_
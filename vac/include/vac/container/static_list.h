@@ -14,6 +14,8 @@
 /*!        \file  static_list.h
  *        \brief  Implementation of static list.
  *
+ *      \details  Fixed capacity doubly linked list whose elements are linked by slot indices inside one slab.
+ *
  *********************************************************************************************************************/
 
 #ifndef LIB_VAC_INCLUDE_VAC_CONTAINER_STATIC_LIST_H_
@@ -22,44 +24,53 @@
 /**********************************************************************************************************************
  *  INCLUDES
  *********************************************************************************************************************/
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
-#include <vector>
 
-#include "vac/container/intrusive_list.h"
 #include "vac/language/cpp14_backport.h"
-#include "vac/memory/object_pool.h"
+#include "vac/language/throw_or_terminate.h"
+#include "vac/memory/phase_managed_allocator.h"
 
 namespace vac {
 namespace container {
 
 /*!
- * \brief Class to implement a StaticList.
- *        List Nodes must inherit from StaticListNode<T>.
- * \trace CREQ-158594, CREQ-158596
+ * \brief   Class to implement a StaticList.
+ * \details All elements live in one contiguous slab allocated by reserve(). Elements are linked by 32 bit slot indices
+ *          instead of pointers, and released slots are reused in LIFO order so that the most recently touched slot is
+ *          handed out again while it is still cached. The number of elements is maintained, size() is O(1).
+ * \trace   CREQ-158594, CREQ-158596
  */
 template <typename T, typename alloc = vac::memory::PhaseManagedAllocator<T>>
 class StaticList final {
  public:
   /*!
-   * \brief Type for nodes of the static list.
-   *        Derive from this type to create an object that can be a list member.
-   *        T should be the type of your object.
+   * \brief Typedef for the slot indices linking the list.
    */
-  class Node final : public vac::container::IntrusiveListNode<Node> {
-   public:
-    /*!
-     * \brief Constructor for a node with arguments.
-     * \param args Elements which to put into the list.
-     */
-    template <typename... Args>
-    explicit Node(Args&&... args) : vac::container::IntrusiveListNode<Node>(), elem_(std::forward<Args>(args)...) {}
+  using Index = std::uint32_t;
+
+  /*!
+   * \brief Index of no slot. Used for the end of the list and the end of the free list.
+   */
+  static constexpr Index kNoIndex{std::numeric_limits<Index>::max()};
 
+  /*!
+   * \brief   Type for the slots of the static list.
+   * \details A slot holds the storage for one element and the indices of its neighbors. While the slot is free, its
+   *          next index links the free list and the storage holds no object.
+   */
+  class Node final {
+   public:
     /*!
-     * \brief Constructor for a node without argument.
+     * \brief Constructor for an unlinked slot without element.
      */
-    Node() : vac::container::IntrusiveListNode<Node>(), elem_() {}
+    Node() noexcept : storage_(), prev_(kNoIndex), next_(kNoIndex) {}
 
     /*!
      * \brief Default copy constructor deleted.
@@ -79,39 +90,50 @@ class StaticList final {
     Node& operator=(Node&&) & = delete;
 
     /*!
-     * \brief Default destructor.
+     * \brief Default destructor. Does not destroy the element, the list does.
      */
-    ~Node() final = default;
+    ~Node() = default;
 
+    /* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
     /*!
-     * \brief  Getter for stored element.
+     * \brief  Getter for stored element. The slot must be in use.
      * \return A reference to stored element.
      */
-    T& GetElem() { return elem_; }
+    T& GetElem() noexcept { return *reinterpret_cast<T*>(&storage_); }
 
+    /* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
     /*!
-     * \brief  Getter for stored element.
+     * \brief  Getter for stored element. The slot must be in use.
      * \return A reference to stored element.
      */
-    T const& GetElem() const { return elem_; }
+    T const& GetElem() const noexcept { return *reinterpret_cast<T const*>(&storage_); }
 
    private:
     /*!
-     * \brief Object with the business logic type.
+     * \brief The list links the slots.
      */
-    T elem_;
-  };
+    friend class StaticList;
 
-  /*!
-   * \brief The memory management type used to allocate Node objects.
-   *        We use the movable ObjectPoolImpl here to enable moveability of this frontend object.
-   */
-  using StorageType = vac::memory::MoveableObjectPool<Node, alloc>;
+    /*!
+     * \brief Uninitialized storage for the element.
+     */
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+
+    /*!
+     * \brief Index of the previous element, kNoIndex for the first one.
+     */
+    Index prev_;
+
+    /*!
+     * \brief Index of the next element or of the next free slot, kNoIndex for the last one.
+     */
+    Index next_;
+  };
 
   /*!
    * \brief Typedef for the size type.
    */
-  using size_type = typename StorageType::size_type;
+  using size_type = std::size_t;
 
   /*!
    * \brief Type of contained element.
@@ -139,9 +161,14 @@ class StaticList final {
   using const_pointer = const T*;
 
   /*!
-   * \brief The type of the list used to store elements.
+   * \brief Typedef for the allocator type.
+   */
+  using allocator_type = alloc;
+
+  /*!
+   * \brief Typedef for the allocator of the slab.
    */
-  using ListType = vac::container::IntrusiveList<Node>;
+  using NodeAllocator = typename allocator_type::template rebind<Node>::other;
 
   /*!
    * \brief Typedef for the iterator type of this list.
@@ -164,37 +191,27 @@ class StaticList final {
     using const_reference = T const&;
 
     /*!
-     * \brief Typedef for the iterator of the container.
-     */
-    using base_iterator = typename ListType::iterator;
-
-    /*!
-     * \brief Construct an iterator from a base_iterator.
-     * \param it Base iterator from which to create this iterator.
+     * \brief Construct an iterator from a slot index.
+     * \param list The list iterated over.
+     * \param index The slot index, kNoIndex for the past-the-end iterator.
      */
-    explicit iterator(base_iterator const& it) : it_(it) {}
+    iterator(StaticList* list, Index index) noexcept : list_(list), slab_(list->slab_), index_(index) {}
 
     /*!
-     * \brief Construct an iterator from a base_iterator.
-     * \param it Base iterator from which to create this iterator.
-     */
-    explicit iterator(base_iterator&& it) : it_(std::move(it)) {}
-
-    /*!
-     * \brief  Advance the iterator by one element.
-     * \return A copy of the moved iterator.
+     * \brief  Advance the iterator by one element. Must not be called on the past-the-end iterator.
+     * \return A reference to the iterator.
      */
-    iterator& operator++() {
-      ++it_;
+    iterator& operator++() noexcept {
+      index_ = slab_[index_].next_;
       return *this;
     }
 
     /*!
      * \brief  Move the iterator back by one element.
-     * \return A copy of the moved iterator.
+     * \return A reference to the iterator.
      */
-    iterator& operator--() {
-      --it_;
+    iterator& operator--() noexcept {
+      index_ = (index_ == kNoIndex) ? list_->tail_ : slab_[index_].prev_;
       return *this;
     }
 
@@ -202,45 +219,55 @@ class StaticList final {
      * \brief  Get the list node.
      * \return A reference to the list node pointed to by this iterator.
      */
-    reference operator*() { return it_->GetElem(); }
+    reference operator*() { return slab_[index_].GetElem(); }
 
     /*!
      * \brief  Get the list node.
      * \return A reference to the list node pointed to by this iterator.
      */
-    const_reference operator*() const { return it_->GetElem(); }
+    const_reference operator*() const { return slab_[index_].GetElem(); }
 
     /*!
      * \brief  Get the list node.
      * \return A reference to the list node pointed to by this iterator.
      */
-    pointer operator->() { return &it_->GetElem(); }
+    pointer operator->() { return &slab_[index_].GetElem(); }
 
     /*!
      * \brief  Compare two iterators for equality.
      * \param  other Iterator to compare to.
      * \return True if both iterators point to the same list node.
      */
-    bool operator==(iterator const& other) const { return it_ == other.it_; }
+    bool operator==(iterator const& other) const noexcept { return index_ == other.index_; }
 
     /*!
      * \brief  Compare two iterators for inequality.
      * \param  other Iterator to compare to.
      * \return True if both iterators point to different list nodes.
      */
-    bool operator!=(iterator const& other) const { return it_ != other.it_; }
+    bool operator!=(iterator const& other) const noexcept { return index_ != other.index_; }
 
     /*!
-     * \brief  Access to the underlying containers' iterator.
-     * \return A copy of the underlying iterator.
+     * \brief  Access to the slot index.
+     * \return The slot index, kNoIndex for the past-the-end iterator.
      */
-    base_iterator GetBaseIterator() const { return it_; }
+    Index GetIndex() const noexcept { return index_; }
 
    private:
     /*!
-     * \brief The underlying containers' iterator.
+     * \brief The list iterated over.
+     */
+    StaticList* list_;
+
+    /*!
+     * \brief The slab of the list, cached to keep the traversal a single dependent load per element.
+     */
+    Node* slab_;
+
+    /*!
+     * \brief The slot index.
      */
-    base_iterator it_;
+    Index index_;
   };
 
   /*!
@@ -260,28 +287,18 @@ class StaticList final {
     using reference = T const&;
 
     /*!
-     * \brief Typedef for the iterator of the container.
-     */
-    using base_iterator = typename ListType::const_iterator;
-
-    /*!
-     * \brief Construct an iterator from a base_iterator.
-     * \param it The base_iterator from which to construct the iterator.
+     * \brief Construct an iterator from a slot index.
+     * \param list The list iterated over.
+     * \param index The slot index, kNoIndex for the past-the-end iterator.
      */
-    explicit const_iterator(base_iterator const& it) : it_(it) {}
+    const_iterator(StaticList const* list, Index index) noexcept : list_(list), slab_(list->slab_), index_(index) {}
 
     /*!
-     * \brief Construct an iterator from a base_iterator.
-     * \param it The base_iterator from which to construct the iterator.
-     */
-    explicit const_iterator(base_iterator&& it) : it_(std::move(it)) {}
-
-    /*!
-     * \brief  Advance the iterator by one element.
+     * \brief  Advance the iterator by one element. Must not be called on the past-the-end iterator.
      * \return A reference to the iterator.
      */
-    const_iterator& operator++() {
-      ++it_;
+    const_iterator& operator++() noexcept {
+      index_ = slab_[index_].next_;
       return *this;
     }
 
@@ -289,8 +306,8 @@ class StaticList final {
      * \brief  Move the iterator back by one element.
      * \return A reference to the iterator.
      */
-    const_iterator& operator--() {
-      --it_;
+    const_iterator& operator--() noexcept {
+      index_ = (index_ == kNoIndex) ? list_->tail_ : slab_[index_].prev_;
       return *this;
     }
 
@@ -298,45 +315,58 @@ class StaticList final {
      * \brief  Get the list node.
      * \return A reference to the list node pointed to by this iterator.
      */
-    reference operator*() const { return it_->GetElem(); }
+    reference operator*() const { return slab_[index_].GetElem(); }
 
     /*!
      * \brief  Get the list node.
      * \return A reference to the list node pointed to by this iterator.
      */
-    pointer operator->() const { return &it_->GetElem(); }
+    pointer operator->() const { return &slab_[index_].GetElem(); }
 
     /*!
      * \brief  Compare two iterators for equality.
      * \param  other Iterator to compare to.
      * \return True if both iterators point to the same list node.
      */
-    bool operator==(const_iterator const& other) const { return it_ == other.it_; }
+    bool operator==(const_iterator const& other) const noexcept { return index_ == other.index_; }
 
     /*!
      * \brief  Compare two iterators for inequality.
      * \param  other Iterator to compare to.
      * \return True if both iterators point to different list nodes.
      */
-    bool operator!=(const_iterator const& other) const { return it_ != other.it_; }
+    bool operator!=(const_iterator const& other) const noexcept { return index_ != other.index_; }
 
     /*!
-     * \brief  Access to the underlying containers' iterator.
-     * \return The underlying iterator.
+     * \brief  Access to the slot index.
+     * \return The slot index, kNoIndex for the past-the-end iterator.
      */
-    base_iterator GetBaseIterator() const { return it_; }
+    Index GetIndex() const noexcept { return index_; }
 
    private:
     /*!
-     * \brief The underlying containers' iterator.
+     * \brief The list iterated over.
      */
-    base_iterator it_;
+    StaticList const* list_;
+
+    /*!
+     * \brief The slab of the list, cached to keep the traversal a single dependent load per element.
+     */
+    Node const* slab_;
+
+    /*!
+     * \brief The slot index.
+     */
+    Index index_;
   };
 
   /*!
-   * \brief Constructor to create an empty StaticList.
+   * \brief Constructor to create an empty StaticList. Does not allocate.
+   * \param allocator The allocator to use, default is allocator_type().
    */
-  StaticList() = default;
+  explicit StaticList(allocator_type const& allocator = allocator_type())
+      : allocator_(allocator), slab_(nullptr), capacity_(0), size_(0), head_(kNoIndex), tail_(kNoIndex),
+        free_(kNoIndex) {}
 
   /*!
    * \brief Default copy constructor deleted.
@@ -349,50 +379,84 @@ class StaticList final {
   StaticList& operator=(StaticList const&) & = delete;
 
   /*!
-   * \brief Move constructor.
+   * \brief Move constructor. Takes over the slab, element addresses are preserved.
+   * \param other The list to move from.
    */
-  StaticList(StaticList&& other) : storage_(std::move(other.storage_)), queue_() {
-    // splice others' list into this
-    queue_.splice(queue_.end(), other.queue_);
-  }
+  StaticList(StaticList&& other) : StaticList(allocator_type(other.allocator_)) { this->swap(other); }
 
   /*!
-   * \brief   Destructor that clears all elements.
+   * \brief   Destructor that clears all elements and releases the slab.
    */
-  ~StaticList() { clear(); }
+  ~StaticList() {
+    clear();
+    if (slab_ != nullptr) {
+      allocator_.deallocate(slab_, capacity_);
+    }
+  }
 
   /*!
-   * \brief  Move assignment.
+   * \brief  Move assignment. Swaps the contents, element addresses are preserved.
    * \param  other The StaticList to move from.
    * \return A reference to the assigned-to object.
    */
   StaticList& operator=(StaticList&& other) & {
-    swap(storage_, other.storage_);
-
-    swap(queue_, other.queue_);
-
+    this->swap(other);
     return *this;
   }
 
+  /*!
+   * \brief Exchange the contents with another list.
+   * \param other The other list.
+   */
+  void swap(StaticList& other) noexcept {
+    std::swap(allocator_, other.allocator_);
+    std::swap(slab_, other.slab_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(free_, other.free_);
+  }
+
   /*!
    * \brief Update the memory allocation.
-   *        The current implementation only allows a single allocation. All further reservations will only limit the
-   *        visible memory. All subsequent calls to reserve() where new_capacity is greater than the initial
-   *        new_capacity will be rejected with a bad_alloc. \param new_capacity The number of T's to reserve space for.
-   * \throw std::runtime_error Exception is thrown if the list is being reallocated.
+   *        The current implementation only allows a single allocation while the list holds elements. Calls to
+   *        reserve() where new_capacity is not greater than the current capacity have no effect.
+   * \param new_capacity The number of T's to reserve space for.
+   * \throw std::bad_alloc The list holds elements and new_capacity exceeds the capacity, or new_capacity cannot be
+   *        indexed with Index.
    * \trace CREQ-158592
    */
-  void reserve(size_type new_capacity) { storage_.reserve(new_capacity); }
+  void reserve(size_type new_capacity) {
+    if (new_capacity > capacity_) {
+      if ((!empty()) || (new_capacity >= kNoIndex)) {
+        vac::language::ThrowOrTerminate<std::bad_alloc>();
+      }
+      if (slab_ != nullptr) {
+        allocator_.deallocate(slab_, capacity_);
+        slab_ = nullptr;
+        capacity_ = 0;
+      }
+      slab_ = allocator_.allocate(new_capacity);
+      capacity_ = new_capacity;
+      // Chain the free list in reverse so that the first insertions fill the slab from the front.
+      free_ = kNoIndex;
+      for (size_type i{new_capacity}; i > 0; --i) {
+        Node* const node{new (&slab_[i - 1U]) Node()};
+        node->next_ = free_;
+        free_ = static_cast<Index>(i - 1U);
+      }
+    }
+  }
 
   /*!
    * \brief Insert an element at the front of the list.
    * \param args Arguments to instantiate new Object.
-   * \throw std::runtime_error  The list is full and no Object can be pushed.
+   * \throw std::bad_alloc The list is full and no Object can be pushed.
    */
   template <typename... Args>
   void push_front(Args&&... args) {
-    typename StorageType::pointer element_ptr{storage_.create(std::forward<Args>(args)...)};
-    queue_.push_front(*element_ptr);
+    Link(kNoIndex, Create(std::forward<Args>(args)...));
   }
 
   /*!
@@ -400,139 +464,128 @@ class StaticList final {
    */
   void pop_front() {
     if (!empty()) {
-      Node& node_front{*queue_.front().GetSelf()};
-      static_cast<void>(queue_.pop_front());
-      storage_.destroy(&node_front);
+      Destroy(head_);
     }
   }
 
   /*!
    * \brief  Returns a reference to the first element of the static list.
    *         Calling this function on an empty container causes undefined behavior.
-   * \return Reference to a Node.
+   * \return Reference to the element.
    */
   T& front() {
     // undefined behavior on empty list.
-    return queue_.front().GetSelf()->GetElem();
+    return slab_[head_].GetElem();
   }
 
   /*!
    * \brief  Returns a reference to the first element of the static list.
    *         Calling this function on an empty container causes undefined behavior
-   * \return Reference to a Node.
+   * \return Reference to the element.
    */
   T const& front() const {
     // undefined behavior on empty list.
-    return queue_.front().GetSelf()->GetElem();
+    return slab_[head_].GetElem();
   }
 
   /*!
    * \brief Insert an element at the back of the list.
    * \param value Object to copy into the list.
-   * \throw std::runtime_error The list is full and no Object can be pushed.
+   * \throw std::bad_alloc The list is full and no Object can be pushed.
    */
-  void push_back(T const& value) {
-    typename StorageType::pointer element_ptr{storage_.create(value)};
-    queue_.push_back(*element_ptr);
-  }
+  void push_back(T const& value) { Link(tail_, Create(value)); }
 
   /*!
    * \brief Insert an element at the back of the list.
    * \param value Object to move into the list.
-   * \throw std::runtime_error The list is full and no Object can be pushed.
+   * \throw std::bad_alloc The list is full and no Object can be pushed.
    */
-  void push_back(T&& value) {
-    typename StorageType::pointer element_ptr{storage_.create(std::move(value))};
-    queue_.push_back(*element_ptr);
-  }
+  void push_back(T&& value) { Link(tail_, Create(std::move(value))); }
 
   /*!
    * \brief Appends a new element to the end of the container.
    * \param args Arguments to instantiate new Object.
-   * \throw std::runtime_error The list is full and no Object can be pushed.
+   * \throw std::bad_alloc The list is full and no Object can be pushed.
    */
   template <typename... Args>
   void emplace_back(Args&&... args) {
-    typename StorageType::pointer element_ptr{storage_.create(std::forward<Args>(args)...)};
-    queue_.push_back(*element_ptr);
+    Link(tail_, Create(std::forward<Args>(args)...));
   }
   /*!
    * \brief Remove an element from the back of the list.
    */
   void pop_back() {
     if (!empty()) {
-      Node& node_back{*queue_.back().GetSelf()};
-      static_cast<void>(queue_.pop_back());
-      storage_.destroy(&node_back);
+      Destroy(tail_);
     }
   }
   /*!
    * \brief  Returns a reference to the last element of the static list.
    *         Calling this function on an empty container causes undefined behavior.
-   * \return Reference to a Node.
+   * \return Reference to the element.
    */
   T& back() {
     // undefined behavior on empty list.
-    return queue_.back().GetSelf()->GetElem();
+    return slab_[tail_].GetElem();
   }
 
   /*!
    * \brief  Returns a reference to the last element of the static list.
    *         Calling this function on an empty container causes undefined behavior.
-   * \return Reference to a Node.
+   * \return Reference to the element.
    */
   T const& back() const {
     // undefined behavior on empty list.
-    return queue_.back().GetSelf()->GetElem();
+    return slab_[tail_].GetElem();
   }
 
   /*!
    * \brief  Determine whether the list is currently empty.
    * \return True if the static list is empty. False if the list has at least one element.
    */
-  bool empty() const { return queue_.empty(); }
+  bool empty() const noexcept { return size_ == 0; }
 
   /*!
    * \brief  Determine whether the list is currently full.
    * \return True if the static list is full. False if the list has at least one free place.
    */
-  bool full() { return storage_.full(); }
+  bool full() const noexcept { return free_ == kNoIndex; }
 
   /*!
    * \brief  Iterator to the start of the list.
    * \return The iterator at the start of the list.
    */
-  iterator begin() { return iterator(queue_.begin()); }
+  iterator begin() noexcept { return iterator(this, head_); }
 
   /*!
    * \brief  Past-The-End iterator of the list.
    * \return The iterator past-the-end.
    */
-  iterator end() { return iterator(queue_.end()); }
+  iterator end() noexcept { return iterator(this, kNoIndex); }
 
   /*!
    * \brief  Const Iterator to the start of the list.
    * \return The constant iterator at the start of the list.
    */
-  const_iterator begin() const { return const_iterator(queue_.begin()); }
+  const_iterator begin() const noexcept { return const_iterator(this, head_); }
 
   /*!
    * \brief  Const Iterator to the start of the list.
    * \return The constant iterator at the start of the list.
    */
-  const_iterator cbegin() const { return begin(); }
+  const_iterator cbegin() const noexcept { return begin(); }
 
   /*!
    * \brief  Const Past-The-End iterator of the list.
    * \return The constant iterator past-the-end.
    */
-  const_iterator end() const { return const_iterator(queue_.end()); }
+  const_iterator end() const noexcept { return const_iterator(this, kNoIndex); }
 
   /*!
    * \brief  Const Past-The-End iterator of the list.
    * \return The constant iterator past-the-end.
    */
-  const_iterator cend() const { return end(); }
+  const_iterator cend() const noexcept { return end(); }
 
   /*!
    * \brief  Remove an element pointed to by the iterator.
@@ -541,10 +594,9 @@ class StaticList final {
    * \trace  CREQ-158593
    */
   iterator erase(iterator elem) {
-    Node* elem_to_destroy{elem.GetBaseIterator().GetListNode()->GetSelf()};
-    iterator next_iterator{iterator(queue_.erase(elem.GetBaseIterator()))};
-    storage_.destroy(elem_to_destroy);
-    return next_iterator;
+    Index const next{slab_[elem.GetIndex()].next_};
+    Destroy(elem.GetIndex());
+    return iterator(this, next);
   }
 
   /*!
@@ -585,55 +637,154 @@ class StaticList final {
    * \brief Removes all elements from the container.
    */
   void clear() {
-    iterator it{this->begin()};
-    while (it != this->end()) {
-      it = this->erase(it);
+    while (!empty()) {
+      Destroy(head_);
     }
   }
 
   /*!
-   * \brief  Returns the number of elements in the container.
+   * \brief  Returns the number of elements in the container. Constant time.
    * \return The number of elements in the container.
    */
-  size_type size() const {
-    return static_cast<typename std::make_unsigned<typename std::iterator_traits<iterator>::difference_type>::type>(
-        std::distance(this->begin(), this->end()));
-  }
+  size_type size() const noexcept { return size_; }
 
   /*!
    * \brief  Returns the total number of elements that can be allocated in this list.
    * \return The total number of elements that can be allocated in this list.
    */
-  size_type capacity() const noexcept { return storage_.capacity(); }
+  size_type capacity() const noexcept { return capacity_; }
 
   /*!
    * \brief Insert a new element into the list past the element pointed to by the Iterator.
+   *        Inserting past end() inserts at the front.
    * \param where The new object is inserted past the iterator where.
    * \param args Arguments to instantiate new Object.
-   * \throw std::runtime_error  The list is full and no Object can be inserted.
+   * \throw std::bad_alloc The list is full and no Object can be inserted.
    * \trace CREQ-158593
    */
   template <typename... Args>
   void insert(iterator where, Args&&... args) {
-    typename StorageType::pointer element_ptr{storage_.create(std::forward<Args>(args)...)};
-    static_cast<void>(queue_.insert(where.GetBaseIterator(), *element_ptr));
+    Link(where.GetIndex(), Create(std::forward<Args>(args)...));
   }
 
  private:
   /*!
-   * \brief Array of optional Nodes used to store the elements.
+   * \brief  Index of the element following a slot, treating kNoIndex as the position before the first element.
+   * \param  index The slot index or kNoIndex.
+   * \return The index of the next element, kNoIndex past the last one.
+   */
+  Index NextOf(Index index) const noexcept { return (index == kNoIndex) ? head_ : slab_[index].next_; }
+
+  /*!
+   * \brief   Construct an element in the most recently released free slot. The slot is not linked yet.
+   * \details The free list is only modified after the constructor of T returned, so a throwing constructor leaves
+   *          the list unchanged.
+   * \param   args Arguments to instantiate new Object.
+   * \return  The index of the slot.
+   * \throw   std::bad_alloc The list is full.
+   */
+  template <typename... Args>
+  Index Create(Args&&... args) {
+    if (full()) {
+      vac::language::ThrowOrTerminate<std::bad_alloc>();
+    }
+    Index const index{free_};
+    Node& node{slab_[index]};
+    static_cast<void>(new (&node.storage_) T(std::forward<Args>(args)...));
+    free_ = node.next_;
+    return index;
+  }
+
+  /*!
+   * \brief Link a slot into the list past another element.
+   * \param where The element to link past, kNoIndex to link at the front.
+   * \param index The slot to link.
+   */
+  void Link(Index where, Index index) noexcept {
+    Index const next{NextOf(where)};
+    Node& node{slab_[index]};
+    node.prev_ = where;
+    node.next_ = next;
+    if (where == kNoIndex) {
+      head_ = index;
+    } else {
+      slab_[where].next_ = index;
+    }
+    if (next == kNoIndex) {
+      tail_ = index;
+    } else {
+      slab_[next].prev_ = index;
+    }
+    ++size_;
+  }
+
+  /*!
+   * \brief Unlink an element, destroy it and push its slot onto the free list.
+   * \param index The slot of the element.
+   */
+  void Destroy(Index index) noexcept {
+    Node& node{slab_[index]};
+    if (node.prev_ == kNoIndex) {
+      head_ = node.next_;
+    } else {
+      slab_[node.prev_].next_ = node.next_;
+    }
+    if (node.next_ == kNoIndex) {
+      tail_ = node.prev_;
+    } else {
+      slab_[node.next_].prev_ = node.prev_;
+    }
+    --size_;
+    node.GetElem().~T();
+    node.prev_ = kNoIndex;
+    node.next_ = free_;
+    free_ = index;
+  }
+
+  /*!
+   * \brief The allocator of the slab.
    */
-  StorageType storage_;
+  NodeAllocator allocator_;
 
   /*!
-   * \brief List of the elements.
+   * \brief The slab of capacity_ slots.
    */
-  ListType queue_;
+  Node* slab_;
+
+  /*!
+   * \brief The number of slots in the slab.
+   */
+  size_type capacity_;
+
+  /*!
+   * \brief The number of elements.
+   */
+  size_type size_;
+
+  /*!
+   * \brief The slot of the first element, kNoIndex if empty.
+   */
+  Index head_;
+
+  /*!
+   * \brief The slot of the last element, kNoIndex if empty.
+   */
+  Index tail_;
+
+  /*!
+   * \brief The most recently released free slot, kNoIndex if full.
+   */
+  Index free_;
 };
 
 /*!
- * \brief Type for nodes of the static list.
- *        Derive from this type to create an object that can be a list member.
+ * \brief Index of no slot.
+ */
+template <typename T, typename alloc>
+constexpr typename StaticList<T, alloc>::Index StaticList<T, alloc>::kNoIndex;
+
+/*!
+ * \brief Type for the slots of the static list.
  *        T should be the type of your object.
  */
 template <typename T>
@@ -15,7 +15,7 @@
  *        \brief  A static string stream stores a sequence of characters in contiguous memory.
  *
  *      \details  Header file of vac::container::StaticStringStream.
- *                Check the capacity in the storage, reset the storage and append data to the
+ *                Check the capacity in the storage, reset the storage and append data or formatted numbers to the
  *                StaticStringStream.
  *
  *********************************************************************************************************************/
@@ -28,11 +28,17 @@
  *********************************************************************************************************************/
 #include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
+#include "ara/core/error_code.h"
 #include "ara/core/string.h"
 #include "ara/core/string_view.h"
+#include "vac/language/char_conv.h"
+#include "vac/language/cpp14_backport.h"
 #include "vac/language/throw_or_terminate.h"
 
 namespace vac {
@@ -44,7 +50,38 @@ namespace container {
 using StringView = ara::core::StringView;
 
 /*!
- * \brief A static stringstream implementation.
+ * \brief An integer to be appended in hexadecimal notation, see Hex().
+ */
+struct HexValue {
+  /*!
+   * \brief The value. Negative values are represented in two's complement of their original width.
+   */
+  std::uint64_t value;
+
+  /*!
+   * \brief Minimum number of digits, shorter values are padded with leading zeros.
+   */
+  std::size_t min_width;
+};
+
+/*!
+ * \brief  Mark an integer to be appended in lowercase hexadecimal notation without prefix.
+ * \tparam T An integral type.
+ * \param  value The value.
+ * \param  min_width Minimum number of digits, shorter values are padded with leading zeros.
+ * \return The marked value.
+ */
+template <typename T, typename = vac::language::enable_if_t<std::is_integral<T>::value>>
+constexpr HexValue Hex(T value, std::size_t min_width = 0) noexcept {
+  return HexValue{static_cast<std::uint64_t>(static_cast<typename std::make_unsigned<T>::type>(value)), min_width};
+}
+
+/*!
+ * \brief   A static stringstream implementation.
+ * \details The formatting overloads of append() and all overloads of operator<< other than for StaticStringStream
+ *          never throw nor allocate: a value that does not fit into the remaining capacity is discarded completely and
+ *          the stream is marked as failed, see fail(). Numbers are formatted by vac::language::to_chars() on the
+ *          stack and copied into the reserved storage.
  * \trace CREQ-158598
  */
 class StaticStringStream final {
@@ -68,14 +105,14 @@ class StaticStringStream final {
    * \param size The amount of memory to be reserved.
    * \trace CREQ-158592
    */
-  explicit StaticStringStream(size_type size) : data_() { data_.reserve(size); }
+  explicit StaticStringStream(size_type size) : data_(), failed_(false) { data_.reserve(size); }
 
   /* VECTOR Next Construct AutosarC++17_10-A3.9.1: MD_VAC_A3.9.1_useOfBasetypeOutsideTypedef */
   /*!
    * \brief Constructor.
    * \param data Pointer to the character string to store.
    */
-  explicit StaticStringStream(const char* data) : data_(data) {}
+  explicit StaticStringStream(const char* data) : data_(data), failed_(false) {}
 
   /*!
    * \brief Destructor.
@@ -163,6 +200,153 @@ class StaticStringStream final {
     return *this;
   }
 
+  /*!
+   * \brief  Append a single character.
+   * \param  input The character.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(char input) {
+    if (Fits(1U)) {
+      data_.push_back(input);
+    }
+    return *this;
+  }
+
+  /*!
+   * \brief  Append "true" or "false".
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(bool input) { return AppendChecked(input ? StringView{"true"} : StringView{"false"}); }
+
+  /*!
+   * \brief  Append an integer in decimal notation.
+   * \tparam T An integral type other than bool and char.
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  template <typename T, typename = vac::language::enable_if_t<std::is_integral<T>::value &&
+                                                              (!std::is_same<T, bool>::value) &&
+                                                              (!std::is_same<T, char>::value)>>
+  StaticStringStream& append(T input) {
+    // Sign and digits.
+    char buffer[std::numeric_limits<T>::digits10 + 2];
+    vac::language::to_chars_result const result{vac::language::to_chars(std::begin(buffer), std::end(buffer), input)};
+    return AppendChecked(StringView{std::begin(buffer), static_cast<size_type>(result.ptr - std::begin(buffer))});
+  }
+
+  /*!
+   * \brief  Append the shortest representation that reads back to the value, e.g. "0.1" or "1e+100".
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(double input) { return AppendFloat(input); }
+
+  /*!
+   * \brief  Append the shortest representation that reads back to the value.
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(float input) { return AppendFloat(input); }
+
+  /*!
+   * \brief  Append an integer in hexadecimal notation.
+   * \param  input The value, created by Hex().
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(HexValue input) {
+    char buffer[16];
+    vac::language::to_chars_result const result{
+        vac::language::to_chars(std::begin(buffer), std::end(buffer), input.value, 16)};
+    size_type const digits{static_cast<size_type>(result.ptr - std::begin(buffer))};
+    size_type const padding{(input.min_width > digits) ? (input.min_width - digits) : 0U};
+    if (Fits(padding) && Fits(padding + digits)) {
+      static_cast<void>(data_.append(padding, '0').append(std::begin(buffer), digits));
+    }
+    return *this;
+  }
+
+  /*!
+   * \brief  Append the address of an object in hexadecimal notation prefixed with "0x".
+   * \param  input The address.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(void const* input) {
+    char buffer[2 + 16]{'0', 'x'};
+    /* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
+    vac::language::to_chars_result const result{
+        vac::language::to_chars(&buffer[2], std::end(buffer), reinterpret_cast<std::uintptr_t>(input), 16)};
+    return AppendChecked(StringView{std::begin(buffer), static_cast<size_type>(result.ptr - std::begin(buffer))});
+  }
+
+  /*!
+   * \brief  Append an error code as "<domain>:<value> (<message>)", followed by ": <user message>" if there is one.
+   * \param  input The error code.
+   * \return A reference to *this.
+   */
+  StaticStringStream& append(ara::core::ErrorCode const& input) {
+    StringView const domain{input.Domain().Name()};
+    StringView const message{input.Message()};
+    StringView const user_message{input.UserMessage()};
+    char value[std::numeric_limits<ara::core::ErrorDomain::CodeType>::digits10 + 2];
+    vac::language::to_chars_result const result{
+        vac::language::to_chars(std::begin(value), std::end(value), input.Value())};
+    size_type const value_length{static_cast<size_type>(result.ptr - std::begin(value))};
+    size_type const length{domain.size() + 1U + value_length + 2U + message.size() + 1U +
+                           (user_message.empty() ? 0U : (2U + user_message.size()))};
+    if (Fits(length)) {
+      static_cast<void>(data_.append(domain.data(), domain.size())
+                            .append(1U, ':')
+                            .append(std::begin(value), value_length)
+                            .append(" (", 2U)
+                            .append(message.data(), message.size())
+                            .append(1U, ')'));
+      if (!user_message.empty()) {
+        static_cast<void>(data_.append(": ", 2U).append(user_message.data(), user_message.size()));
+      }
+    }
+    return *this;
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A13.2.2: MD_VAC_A13.2.2_bitwiseOperatorShallReturnBasicValue */
+  /*!
+   * \brief  Append a character string. Marks the stream as failed instead of throwing if it does not fit.
+   * \param  input String view to the character string to append.
+   * \return A reference to *this.
+   */
+  StaticStringStream& operator<<(StringView input) { return AppendChecked(input); }
+
+  /* VECTOR Next Construct AutosarC++17_10-A3.9.1: MD_VAC_A3.9.1_useOfBasetypeOutsideTypedef */
+  /* VECTOR Next Construct AutosarC++17_10-A13.2.2: MD_VAC_A13.2.2_bitwiseOperatorShallReturnBasicValue */
+  /*!
+   * \brief  Append a character string. Marks the stream as failed instead of throwing if it does not fit.
+   * \param  input Pointer to the character string to append.
+   * \return A reference to *this.
+   */
+  StaticStringStream& operator<<(const char* input) { return AppendChecked(StringView{input}); }
+
+  /* VECTOR Next Construct AutosarC++17_10-A13.2.2: MD_VAC_A13.2.2_bitwiseOperatorShallReturnBasicValue */
+  /*!
+   * \brief  Append a value with the matching formatting overload of append().
+   * \tparam T char, bool, an integral type, double, float, HexValue, a pointer or ara::core::ErrorCode.
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  template <typename T,
+            typename = vac::language::enable_if_t<(!std::is_convertible<T const&, StringView>::value) &&
+                                                  (!std::is_convertible<T const&, const char*>::value)>,
+            typename = decltype(std::declval<StaticStringStream&>().append(std::declval<T const&>()))>
+  StaticStringStream& operator<<(T const& input) {
+    return append(input);
+  }
+
+  /*!
+   * \brief  Whether a value has been discarded by a formatting append or operator<< because it did not fit into the
+   *         remaining capacity since construction or the last reset().
+   * \return True if a value has been discarded.
+   */
+  bool fail() const noexcept { return failed_; }
+
   /*!
    * \brief  Returns the number of characters that can be held in currently allocated storage.
    * \return The number of characters that can be stored.
@@ -182,9 +366,13 @@ class StaticStringStream final {
   size_type size() const noexcept { return data_.size(); }
 
   /*!
-   * \brief Resets the data position to the beginning, the remaining capacity is then at maximum.
+   * \brief Resets the data position to the beginning, the remaining capacity is then at maximum. Clears the failed
+   *        state.
    */
-  void reset() noexcept { data_.clear(); }
+  void reset() noexcept {
+    data_.clear();
+    failed_ = false;
+  }
 
   /* VECTOR Next Construct AutosarC++17_10-A3.9.1: MD_VAC_A3.9.1_useOfBasetypeOutsideTypedef */
   /*!
@@ -236,10 +424,54 @@ class StaticStringStream final {
   base_type::iterator end() { return data_.end(); }
 
  private:
+  /*!
+   * \brief  Check whether characters fit into the remaining capacity, mark the stream as failed otherwise.
+   * \param  length The number of characters.
+   * \return True if they fit.
+   */
+  bool Fits(size_type length) noexcept {
+    bool const fits{length < capacity_remaining()};
+    if (!fits) {
+      failed_ = true;
+    }
+    return fits;
+  }
+
+  /*!
+   * \brief  Append characters if they fit into the remaining capacity, mark the stream as failed otherwise.
+   * \param  input The characters.
+   * \return A reference to *this.
+   */
+  StaticStringStream& AppendChecked(StringView input) {
+    if (Fits(input.size())) {
+      static_cast<void>(data_.append(input.data(), input.size()));
+    }
+    return *this;
+  }
+
+  /*!
+   * \brief  Append the shortest representation of a floating point value.
+   * \tparam Float float or double.
+   * \param  input The value.
+   * \return A reference to *this.
+   */
+  template <typename Float>
+  StaticStringStream& AppendFloat(Float input) {
+    // Sign, 17 digits, point and exponent "e-308".
+    char buffer[32];
+    vac::language::to_chars_result const result{vac::language::to_chars(std::begin(buffer), std::end(buffer), input)};
+    return AppendChecked(StringView{std::begin(buffer), static_cast<size_type>(result.ptr - std::begin(buffer))});
+  }
+
   /*!
    * \brief Contains data.
    */
   base_type data_;
+
+  /*!
+   * \brief Whether a value has been discarded for lack of capacity.
+   */
+  bool failed_;
 };
 
 }  // namespace container
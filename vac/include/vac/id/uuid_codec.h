@@ -0,0 +1,334 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!     \file     uuid_codec.h
+ *      \brief    Inline conversion of UUIDs from and to bytes and strings, and hashing.
+ *
+ *      \details  Header-only counterparts of UUID::FromString() and UUID::ToString(). On targets with SSE2 the hex
+ *                digits are converted 16 at a time, elsewhere one at a time.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_ID_UUID_CODEC_H_
+#define LIB_VAC_INCLUDE_VAC_ID_UUID_CODEC_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "ara/core/posix_error_domain.h"
+#include "ara/core/result.h"
+#include "ara/core/string_view.h"
+#include "vac/container/static_string_stream.h"
+#include "vac/id/uuid.h"
+
+namespace vac {
+namespace id {
+
+/*!
+ * \brief The binary representation of a UUID.
+ */
+using UuidBytes = std::array<std::uint8_t, 16>;
+
+namespace detail {
+
+static_assert(std::is_trivially_copyable<UUID>::value && (sizeof(UUID) == sizeof(UuidBytes)),
+              "UUID must consist of its bytes only");
+
+/*!
+ * \brief Positions of the separators in the 8-4-4-4-12 representation.
+ */
+constexpr std::array<std::size_t, 4> kUuidSeparators{{8, 13, 18, 23}};
+
+/*!
+ * \brief Length of a UUID string in 8-4-4-4-12 representation.
+ */
+constexpr std::size_t kUuidStringLength{36};
+
+/*!
+ * \brief Insert the separators into 32 hex digits.
+ * \param hex The hex digits.
+ * \param out The 8-4-4-4-12 representation.
+ */
+inline void InsertUuidSeparators(char const* hex, char* out) noexcept {
+  std::memcpy(&out[0], &hex[0], 8);
+  out[8] = '-';
+  std::memcpy(&out[9], &hex[8], 4);
+  out[13] = '-';
+  std::memcpy(&out[14], &hex[12], 4);
+  out[18] = '-';
+  std::memcpy(&out[19], &hex[16], 4);
+  out[23] = '-';
+  std::memcpy(&out[24], &hex[20], 12);
+}
+
+/*!
+ * \brief Remove the separators from the 8-4-4-4-12 representation.
+ * \param in The 8-4-4-4-12 representation.
+ * \param hex The 32 hex digits.
+ */
+inline void RemoveUuidSeparators(char const* in, char* hex) noexcept {
+  std::memcpy(&hex[0], &in[0], 8);
+  std::memcpy(&hex[8], &in[9], 4);
+  std::memcpy(&hex[12], &in[14], 4);
+  std::memcpy(&hex[16], &in[19], 4);
+  std::memcpy(&hex[20], &in[24], 12);
+}
+
+#if defined(__SSE2__)
+
+/*!
+ * \brief  Convert 16 nibbles to lower case hex digits.
+ * \param  nibbles Values 0 to 15.
+ * \return The digits.
+ */
+inline __m128i NibblesToHex(__m128i nibbles) noexcept {
+  __m128i const letters{_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9))};
+  __m128i const digits{_mm_add_epi8(nibbles, _mm_set1_epi8('0'))};
+  return _mm_add_epi8(digits, _mm_and_si128(letters, _mm_set1_epi8(static_cast<char>('a' - '0' - 10))));
+}
+
+/*!
+ * \brief Convert 16 bytes to 32 hex digits.
+ * \param bytes The bytes.
+ * \param hex The digits.
+ */
+inline void BytesToHex(std::uint8_t const* bytes, char* hex) noexcept {
+  __m128i const value{_mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes))};
+  __m128i const mask{_mm_set1_epi8(0x0F)};
+  __m128i const high{_mm_and_si128(_mm_srli_epi16(value, 4), mask)};
+  __m128i const low{_mm_and_si128(value, mask)};
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&hex[0]), NibblesToHex(_mm_unpacklo_epi8(high, low)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&hex[16]), NibblesToHex(_mm_unpackhi_epi8(high, low)));
+}
+
+/*!
+ * \brief  Determine whether each byte lies within a range.
+ * \param  value The bytes, interpreted as signed.
+ * \param  first The first value of the range.
+ * \param  last The last value of the range.
+ * \return 0xFF for each byte within the range, 0 otherwise.
+ */
+inline __m128i InRange(__m128i value, char first, char last) noexcept {
+  return _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8(static_cast<char>(first - 1))),
+                       _mm_cmplt_epi8(value, _mm_set1_epi8(static_cast<char>(last + 1))));
+}
+
+/*!
+ * \brief  Convert 16 hex digits to 8 bytes.
+ * \param  hex The digits, upper or lower case.
+ * \param  valid Set to false if any of the characters is not a hex digit.
+ * \return The bytes in the low 8 lanes of the 16 bit words.
+ */
+inline __m128i HexToWords(char const* hex, bool& valid) noexcept {
+  __m128i const chars{_mm_loadu_si128(reinterpret_cast<__m128i const*>(hex))};
+  __m128i const lower{_mm_or_si128(chars, _mm_set1_epi8(0x20))};
+  __m128i const is_digit{InRange(chars, '0', '9')};
+  __m128i const is_letter{InRange(lower, 'a', 'f')};
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF) {
+    valid = false;
+  }
+  __m128i const nibbles{
+      _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                   _mm_and_si128(is_letter, _mm_sub_epi8(lower, _mm_set1_epi8(static_cast<char>('a' - 10)))))};
+  // Each 16 bit word holds the high nibble in its low byte and the low nibble in its high byte.
+  __m128i const high{_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4)};
+  __m128i const low{_mm_srli_epi16(nibbles, 8)};
+  return _mm_or_si128(high, low);
+}
+
+/*!
+ * \brief  Convert 32 hex digits to 16 bytes.
+ * \param  hex The digits, upper or lower case.
+ * \param  bytes The bytes.
+ * \return True if all characters are hex digits, false otherwise.
+ */
+inline bool HexToBytes(char const* hex, std::uint8_t* bytes) noexcept {
+  bool valid{true};
+  __m128i const first{HexToWords(&hex[0], valid)};
+  __m128i const second{HexToWords(&hex[16], valid)};
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm_packus_epi16(first, second));
+  return valid;
+}
+
+#else  // __SSE2__
+
+/*!
+ * \brief Convert 16 bytes to 32 hex digits.
+ * \param bytes The bytes.
+ * \param hex The digits.
+ */
+inline void BytesToHex(std::uint8_t const* bytes, char* hex) noexcept {
+  constexpr char kDigits[]{"0123456789abcdef"};
+  for (std::size_t index{0}; index < 16; ++index) {
+    hex[2 * index] = kDigits[bytes[index] >> 4];
+    hex[(2 * index) + 1] = kDigits[bytes[index] & 0x0FU];
+  }
+}
+
+/*!
+ * \brief  Convert a hex digit to its value.
+ * \param  digit The digit, upper or lower case.
+ * \return The value, or 0xFF if the character is not a hex digit.
+ */
+inline std::uint8_t HexDigitValue(char digit) noexcept {
+  std::uint8_t value{0xFF};
+  if ((digit >= '0') && (digit <= '9')) {
+    value = static_cast<std::uint8_t>(digit - '0');
+  } else if ((digit >= 'a') && (digit <= 'f')) {
+    value = static_cast<std::uint8_t>((digit - 'a') + 10);
+  } else if ((digit >= 'A') && (digit <= 'F')) {
+    value = static_cast<std::uint8_t>((digit - 'A') + 10);
+  } else {
+    // Not a hex digit.
+  }
+  return value;
+}
+
+/*!
+ * \brief  Convert 32 hex digits to 16 bytes.
+ * \param  hex The digits, upper or lower case.
+ * \param  bytes The bytes.
+ * \return True if all characters are hex digits, false otherwise.
+ */
+inline bool HexToBytes(char const* hex, std::uint8_t* bytes) noexcept {
+  std::uint8_t invalid{0};
+  for (std::size_t index{0}; index < 16; ++index) {
+    std::uint8_t const high{HexDigitValue(hex[2 * index])};
+    std::uint8_t const low{HexDigitValue(hex[(2 * index) + 1])};
+    invalid = static_cast<std::uint8_t>(invalid | high | low);
+    bytes[index] = static_cast<std::uint8_t>((high << 4) | (low & 0x0FU));
+  }
+  return (invalid & 0xF0U) == 0U;
+}
+
+#endif  // __SSE2__
+
+}  // namespace detail
+
+/*!
+ * \brief  Create a UUID from its binary representation.
+ * \param  bytes The bytes in network order.
+ * \return The UUID.
+ */
+inline UUID UuidFromBytes(UuidBytes const& bytes) noexcept {
+  UUID uuid{};
+  std::memcpy(static_cast<void*>(&uuid), bytes.data(), bytes.size());
+  return uuid;
+}
+
+/*!
+ * \brief  Get the binary representation of a UUID without calling UUID::Data().
+ * \param  uuid The UUID.
+ * \return The bytes in network order.
+ */
+inline UuidBytes UuidToBytes(UUID const& uuid) noexcept {
+  UuidBytes bytes{};
+  std::memcpy(bytes.data(), &uuid, bytes.size());
+  return bytes;
+}
+
+/*!
+ * \brief  Converts a UUID to its 8-4-4-4-12 representation. Inline equivalent of UUID::ToString().
+ * \param  uuid The UUID.
+ * \return String representation of the UUID, lower case.
+ */
+inline UUID::UUIDString FormatUuid(UUID const& uuid) noexcept {
+  UuidBytes const bytes{UuidToBytes(uuid)};
+  char hex[32];
+  detail::BytesToHex(bytes.data(), hex);
+  UUID::UUIDString result;
+  detail::InsertUuidSeparators(hex, result.data());
+  return result;
+}
+
+/*!
+ * \brief   Parses the 8-4-4-4-12 representation of a UUID. Inline equivalent of UUID::FromString().
+ * \details Hex digits may be upper or lower case. Unlike UUID::FromString(), the separators must be '-'.
+ * \param   input String representation of the UUID.
+ * \return  Result with UUID if valid format, otherwise PosixErrc::invalid_argument.
+ */
+inline ara::core::Result<UUID> ParseUuid(ara::core::StringView input) {
+  ara::core::Result<UUID> result{
+      ara::core::MakeErrorCode(ara::core::PosixErrc::invalid_argument, 0, "Length of provided UUID is invalid")};
+  if (input.size() == detail::kUuidStringLength) {
+    bool valid{true};
+    for (std::size_t const separator : detail::kUuidSeparators) {
+      valid = valid && (input[separator] == '-');
+    }
+    char hex[32];
+    detail::RemoveUuidSeparators(input.data(), hex);
+    UuidBytes bytes{};
+    valid = detail::HexToBytes(hex, bytes.data()) && valid;
+    if (valid) {
+      result.EmplaceValue(UuidFromBytes(bytes));
+    } else {
+      result.EmplaceError(ara::core::MakeErrorCode(ara::core::PosixErrc::invalid_argument, 0, "Invalid UUID string"));
+    }
+  }
+  return result;
+}
+
+/* VECTOR Next Construct AutosarC++17_10-A13.2.2: MD_VAC_A13.2.2_bitwiseOperatorShallReturnBasicValue */
+/*!
+ * \brief  Append the 8-4-4-4-12 representation of a UUID to a stream without allocation.
+ * \param  stream The stream. Marked as failed if the representation does not fit, see StaticStringStream::fail().
+ * \param  uuid The UUID.
+ * \return The stream.
+ */
+inline vac::container::StaticStringStream& operator<<(vac::container::StaticStringStream& stream, UUID const& uuid) {
+  UUID::UUIDString const text{FormatUuid(uuid)};
+  return stream << ara::core::StringView{text.data(), text.size()};
+}
+
+}  // namespace id
+}  // namespace vac
+
+namespace std {
+
+/*!
+ * \brief Hash of a UUID, mixing both halves so that time-ordered UUIDs spread over all buckets.
+ */
+template <>
+struct hash<vac::id::UUID> {
+  /*!
+   * \brief  Compute the hash.
+   * \param  uuid The UUID.
+   * \return The hash value.
+   */
+  std::size_t operator()(vac::id::UUID const& uuid) const noexcept {
+    std::uint64_t halves[2];
+    std::memcpy(&halves[0], &uuid, sizeof(halves));
+    // Final mixing step of MurmurHash3.
+    std::uint64_t value{halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ULL)};
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return static_cast<std::size_t>(value);
+  }
+};
+
+}  // namespace std
+
+#endif  // LIB_VAC_INCLUDE_VAC_ID_UUID_CODEC_H_
@@ -0,0 +1,405 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!     \file     uuid_generator.h
+ *      \brief    Generation of random (version 4) and time-ordered (version 7) UUIDs.
+ *
+ *      \details  The random bits come from a per-thread ChaCha20 generator that is seeded and periodically reseeded
+ *                from the kernel with getrandom(). Generating a UUID takes no lock and no system call.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_ID_UUID_GENERATOR_H_
+#define LIB_VAC_INCLUDE_VAC_ID_UUID_GENERATOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/random.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "vac/id/uuid.h"
+#include "vac/id/uuid_codec.h"
+#include "vac/language/throw_or_terminate.h"
+
+namespace vac {
+namespace id {
+namespace detail {
+
+/*!
+ * \brief   Cryptographically secure random generator based on the ChaCha20 block function.
+ * \details Output is produced in batches of kBlocksPerBatch blocks. The first 32 bytes of every batch replace the key
+ *          ("fast key erasure"), so that a later compromise of the state does not reveal earlier output. Every
+ *          kReseedBatches batches and after fork() in the child, fresh entropy from the kernel is mixed into the key.
+ *          Not threadsafe; use ThreadRandom().
+ */
+class ChaChaRandom final {
+ public:
+  /*!
+   * \brief Number of ChaCha20 blocks computed at once.
+   */
+  static constexpr std::size_t kBlocksPerBatch{8};
+
+  /*!
+   * \brief Number of batches after which the key is reseeded from the kernel.
+   */
+  static constexpr std::uint64_t kReseedBatches{std::uint64_t{1} << 14};
+
+  /*!
+   * \brief Constructor. Seeds the generator from the kernel.
+   */
+  ChaChaRandom() noexcept(false) : key_(), buffer_(), position_(kBufferSize), batches_(0), fork_generation_(0) {
+    Reseed();
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  ChaChaRandom(ChaChaRandom const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  ChaChaRandom& operator=(ChaChaRandom const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  ChaChaRandom(ChaChaRandom&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  ChaChaRandom& operator=(ChaChaRandom&&) & = delete;
+
+  /*!
+   * \brief Destructor. Wipes the state.
+   */
+  ~ChaChaRandom() noexcept {
+    Wipe(key_.data(), sizeof(key_));
+    Wipe(buffer_.data(), sizeof(buffer_));
+  }
+
+  /*!
+   * \brief  Produce 16 random bytes.
+   * \return The bytes.
+   */
+  UuidBytes NextBytes() {
+    if (fork_generation_ != GetForkGeneration().load(std::memory_order_relaxed)) {
+      // The state has been duplicated into a child process: never repeat the output of the parent.
+      Reseed();
+    }
+    if ((kBufferSize - position_) < sizeof(UuidBytes)) {
+      Refill();
+    }
+    UuidBytes bytes;
+    std::memcpy(bytes.data(), &buffer_[position_], bytes.size());
+    Wipe(&buffer_[position_], bytes.size());
+    position_ += bytes.size();
+    return bytes;
+  }
+
+ private:
+  /*!
+   * \brief Size of a ChaCha20 block in bytes.
+   */
+  static constexpr std::size_t kBlockSize{64};
+
+  /*!
+   * \brief Size of the output buffer, including the part that becomes the next key.
+   */
+  static constexpr std::size_t kBufferSize{kBlocksPerBatch * kBlockSize};
+
+  /*!
+   * \brief Number of 32 bit words of the key.
+   */
+  static constexpr std::size_t kKeyWords{8};
+
+  /*!
+   * \brief  Counter of fork() calls in this process, incremented in the child.
+   * \return The counter.
+   */
+  static std::atomic<std::uint32_t>& GetForkGeneration() noexcept {
+    static std::atomic<std::uint32_t> generation{0};
+    return generation;
+  }
+
+  /*!
+   * \brief Register the fork handler once per process.
+   */
+  static void RegisterForkHandler() noexcept {
+    static bool const registered{
+        pthread_atfork(nullptr, nullptr, []() { GetForkGeneration().fetch_add(1, std::memory_order_relaxed); }) == 0};
+    static_cast<void>(registered);
+  }
+
+  /*!
+   * \brief Read entropy from the kernel.
+   * \param buffer The buffer to fill.
+   * \param size The number of bytes.
+   */
+  static void ReadEntropy(std::uint8_t* buffer, std::size_t size) {
+    std::size_t filled{0};
+    bool failed{false};
+    while ((filled < size) && (!failed)) {
+      ssize_t const result{getrandom(&buffer[filled], size - filled, 0)};
+      if (result > 0) {
+        filled += static_cast<std::size_t>(result);
+      } else if (errno != EINTR) {
+        failed = true;
+      } else {
+        // Interrupted by a signal, retry.
+      }
+    }
+    if (failed) {
+      // Kernels before 3.17 lack getrandom().
+      int const fd{::open("/dev/urandom", O_RDONLY | O_CLOEXEC)};
+      failed = (fd < 0);
+      while ((filled < size) && (!failed)) {
+        ssize_t const result{::read(fd, &buffer[filled], size - filled)};
+        if (result > 0) {
+          filled += static_cast<std::size_t>(result);
+        } else if ((result == 0) || (errno != EINTR)) {
+          failed = true;
+        } else {
+          // Interrupted by a signal, retry.
+        }
+      }
+      if (fd >= 0) {
+        static_cast<void>(::close(fd));
+      }
+    }
+    if (failed) {
+      vac::language::ThrowOrTerminate<std::runtime_error>("ChaChaRandom: No entropy available from the kernel");
+    }
+  }
+
+  /*!
+   * \brief Overwrite memory in a way the compiler does not remove.
+   * \param data The memory.
+   * \param size The number of bytes.
+   */
+  static void Wipe(void* data, std::size_t size) noexcept {
+    volatile std::uint8_t* const bytes{static_cast<volatile std::uint8_t*>(data)};
+    for (std::size_t index{0}; index < size; ++index) {
+      bytes[index] = 0;
+    }
+  }
+
+  /*!
+   * \brief  Rotate a word to the left.
+   * \param  value The word.
+   * \param  bits The number of bits, 1 to 31.
+   * \return The rotated word.
+   */
+  static constexpr std::uint32_t RotateLeft(std::uint32_t value, std::uint32_t bits) noexcept {
+    return (value << bits) | (value >> (32U - bits));
+  }
+
+  /*!
+   * \brief The ChaCha quarter round.
+   * \param x The state.
+   * \param a Index of the first word.
+   * \param b Index of the second word.
+   * \param c Index of the third word.
+   * \param d Index of the fourth word.
+   */
+  static void QuarterRound(std::array<std::uint32_t, 16>& x, std::size_t a, std::size_t b, std::size_t c,
+                           std::size_t d) noexcept {
+    x[a] += x[b];
+    x[d] = RotateLeft(x[d] ^ x[a], 16);
+    x[c] += x[d];
+    x[b] = RotateLeft(x[b] ^ x[c], 12);
+    x[a] += x[b];
+    x[d] = RotateLeft(x[d] ^ x[a], 8);
+    x[c] += x[d];
+    x[b] = RotateLeft(x[b] ^ x[c], 7);
+  }
+
+  /*!
+   * \brief Compute one ChaCha20 block with a zero nonce.
+   * \param counter The block counter.
+   * \param out The 64 output bytes.
+   */
+  void Block(std::uint64_t counter, std::uint8_t* out) const noexcept {
+    std::array<std::uint32_t, 16> const input{{0x61707865U, 0x3320646EU, 0x79622D32U, 0x6B206574U, key_[0], key_[1],
+                                               key_[2], key_[3], key_[4], key_[5], key_[6], key_[7],
+                                               static_cast<std::uint32_t>(counter),
+                                               static_cast<std::uint32_t>(counter >> 32), 0U, 0U}};
+    std::array<std::uint32_t, 16> x(input);
+    for (std::size_t round{0}; round < 10; ++round) {
+      QuarterRound(x, 0, 4, 8, 12);
+      QuarterRound(x, 1, 5, 9, 13);
+      QuarterRound(x, 2, 6, 10, 14);
+      QuarterRound(x, 3, 7, 11, 15);
+      QuarterRound(x, 0, 5, 10, 15);
+      QuarterRound(x, 1, 6, 11, 12);
+      QuarterRound(x, 2, 7, 8, 13);
+      QuarterRound(x, 3, 4, 9, 14);
+    }
+    for (std::size_t word{0}; word < x.size(); ++word) {
+      std::uint32_t const value{x[word] + input[word]};
+      out[(4 * word) + 0] = static_cast<std::uint8_t>(value);
+      out[(4 * word) + 1] = static_cast<std::uint8_t>(value >> 8);
+      out[(4 * word) + 2] = static_cast<std::uint8_t>(value >> 16);
+      out[(4 * word) + 3] = static_cast<std::uint8_t>(value >> 24);
+    }
+  }
+
+  /*!
+   * \brief Compute the next batch and replace the key with its first 32 bytes.
+   */
+  void Refill() {
+    if (batches_ >= kReseedBatches) {
+      Reseed();
+    }
+    for (std::size_t block{0}; block < kBlocksPerBatch; ++block) {
+      Block(block, &buffer_[block * kBlockSize]);
+    }
+    std::memcpy(key_.data(), buffer_.data(), sizeof(key_));
+    Wipe(buffer_.data(), sizeof(key_));
+    position_ = sizeof(key_);
+    ++batches_;
+  }
+
+  /*!
+   * \brief Mix fresh entropy from the kernel into the key and discard buffered output.
+   */
+  void Reseed() {
+    RegisterForkHandler();
+    fork_generation_ = GetForkGeneration().load(std::memory_order_relaxed);
+    std::array<std::uint8_t, sizeof(std::uint32_t) * kKeyWords> entropy;
+    ReadEntropy(entropy.data(), entropy.size());
+    for (std::size_t word{0}; word < kKeyWords; ++word) {
+      std::uint32_t value;
+      std::memcpy(&value, &entropy[word * sizeof(value)], sizeof(value));
+      key_[word] ^= value;
+    }
+    Wipe(entropy.data(), entropy.size());
+    Wipe(buffer_.data(), sizeof(buffer_));
+    position_ = kBufferSize;
+    batches_ = 0;
+  }
+
+  /*!
+   * \brief The key of the next batch.
+   */
+  std::array<std::uint32_t, kKeyWords> key_;
+
+  /*!
+   * \brief The output of the current batch.
+   */
+  std::array<std::uint8_t, kBufferSize> buffer_;
+
+  /*!
+   * \brief Offset of the first unused byte in buffer_.
+   */
+  std::size_t position_;
+
+  /*!
+   * \brief Number of batches since the last reseed.
+   */
+  std::uint64_t batches_;
+
+  /*!
+   * \brief The value of the fork counter at the last reseed.
+   */
+  std::uint32_t fork_generation_;
+};
+
+/*!
+ * \brief  The random generator of the calling thread.
+ * \return The generator.
+ */
+inline ChaChaRandom& ThreadRandom() {
+  static thread_local ChaChaRandom random;
+  return random;
+}
+
+/*!
+ * \brief State of the version 7 generator of a thread.
+ */
+struct UuidV7State {
+  /*!
+   * \brief The timestamp of the last generated UUID in milliseconds since the Unix epoch.
+   */
+  std::uint64_t last_millis{0};
+
+  /*!
+   * \brief The counter of the last generated UUID (12 bits).
+   */
+  std::uint16_t counter{0};
+};
+
+}  // namespace detail
+
+/*!
+ * \brief   Generate a random UUID as specified by RFC 9562, version 4.
+ * \details 122 bits come from the ChaCha20 generator of the calling thread. Threadsafe.
+ * \return  The UUID.
+ */
+inline UUID GenerateUuidV4() {
+  UuidBytes bytes{detail::ThreadRandom().NextBytes()};
+  bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0FU) | 0x40U);
+  bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3FU) | 0x80U);
+  return UuidFromBytes(bytes);
+}
+
+/*!
+ * \brief   Generate a time-ordered UUID as specified by RFC 9562, version 7.
+ * \details The UUID starts with the Unix time in milliseconds, so that consecutive UUIDs are close in a sorted index.
+ *          The 12 bits after the version are a counter that starts at a random value below 2048 in every millisecond,
+ *          making the UUIDs of one thread strictly increasing even within a millisecond and if the system clock goes
+ *          backwards. The remaining 62 bits are random. Threadsafe.
+ * \return  The UUID.
+ */
+inline UUID GenerateUuidV7() {
+  static thread_local detail::UuidV7State state{};
+  UuidBytes bytes{detail::ThreadRandom().NextBytes()};
+  std::uint64_t const now{static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+          .count())};
+  std::uint16_t const seed{static_cast<std::uint16_t>(((bytes[6] << 8) | bytes[7]) & 0x07FFU)};
+  if (now > state.last_millis) {
+    state.last_millis = now;
+    state.counter = seed;
+  } else if (state.counter < 0x0FFFU) {
+    ++state.counter;
+  } else {
+    // Counter exhausted: borrow the next millisecond.
+    ++state.last_millis;
+    state.counter = seed;
+  }
+  for (std::size_t index{0}; index < 6; ++index) {
+    bytes[index] = static_cast<std::uint8_t>(state.last_millis >> (8U * (5U - index)));
+  }
+  bytes[6] = static_cast<std::uint8_t>(0x70U | (state.counter >> 8));
+  bytes[7] = static_cast<std::uint8_t>(state.counter);
+  bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3FU) | 0x80U);
+  return UuidFromBytes(bytes);
+}
+
+}  // namespace id
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_ID_UUID_GENERATOR_H_
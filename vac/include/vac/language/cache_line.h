@@ -0,0 +1,41 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  cache_line.h
+ *        \brief  Cache line size for padding against false sharing.
+ *
+ *      \details  Kept separate from the components that pad their members, so that including the constant does not
+ *                pull in any of them.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_LANGUAGE_CACHE_LINE_H_
+#define LIB_VAC_INCLUDE_VAC_LANGUAGE_CACHE_LINE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <cstddef>
+
+namespace vac {
+namespace language {
+
+/*!
+ * \brief Size of a cache line, the unit of false sharing.
+ */
+constexpr std::size_t kCacheLineSize{64};
+
+}  // namespace language
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_LANGUAGE_CACHE_LINE_H_
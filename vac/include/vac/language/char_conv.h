@@ -0,0 +1,972 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  char_conv.h
+ *        \brief  Backport of the C++17 std::to_chars() number formatting.
+ *
+ *      \details  Converts integers and floating point values to characters in a caller provided buffer without
+ *                allocation, format string parsing or locale dependency. Floating point values are formatted with the
+ *                Grisu3 algorithm by Florian Loitsch, which finds the shortest representation that reads back to the
+ *                same value with 64 bit arithmetic in about 99.5% of the cases and detects the remaining ones. Those
+ *                are formatted with exact big integer arithmetic, so the result is always the shortest one.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_LANGUAGE_CHAR_CONV_H_
+#define LIB_VAC_INCLUDE_VAC_LANGUAGE_CHAR_CONV_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#include "vac/language/cpp14_backport.h"
+
+namespace vac {
+namespace language {
+
+/*!
+ * \brief Equivalent to C++17 std::to_chars_result.
+ */
+struct to_chars_result {
+  /*!
+   * \brief One past the last written character on success, the end of the buffer on failure.
+   */
+  char* ptr;
+
+  /*!
+   * \brief Default constructed on success, std::errc::value_too_large if the buffer is too small.
+   */
+  std::errc ec;
+};
+
+namespace detail {
+
+/*!
+ * \brief Digits of all supported bases.
+ */
+constexpr char kDigits[]{"0123456789abcdefghijklmnopqrstuvwxyz"};
+
+/*!
+ * \brief The decimal digit pairs 00 to 99.
+ */
+constexpr char kDigitPairs[]{
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899"};
+
+/*!
+ * \brief  Number of digits of an unsigned value.
+ * \param  value The value.
+ * \param  base The base, between 2 and 36.
+ * \return The number of digits, at least 1.
+ */
+inline std::size_t CountDigits(std::uint64_t value, std::uint64_t base) noexcept {
+  std::size_t count{1};
+  while (value >= base) {
+    value /= base;
+    ++count;
+  }
+  return count;
+}
+
+/*!
+ * \brief  Write an unsigned value.
+ * \param  first The begin of the buffer.
+ * \param  last The end of the buffer.
+ * \param  value The value.
+ * \param  negative Whether a minus sign is written in front of the digits.
+ * \param  base The base, between 2 and 36.
+ * \return The end of the written characters, or std::errc::value_too_large.
+ */
+inline to_chars_result UnsignedToChars(char* first, char* last, std::uint64_t value, bool negative,
+                                       std::uint64_t base) noexcept {
+  std::size_t const length{CountDigits(value, base) + (negative ? 1U : 0U)};
+  to_chars_result result{last, std::errc::value_too_large};
+  if (length <= static_cast<std::size_t>(last - first)) {
+    result = to_chars_result{first + length, std::errc()};
+    char* out{result.ptr};
+    if (base == 10U) {
+      while (value >= 100U) {
+        std::size_t const pair{static_cast<std::size_t>(value % 100U) * 2U};
+        value /= 100U;
+        out -= 2;
+        out[0] = kDigitPairs[pair];
+        out[1] = kDigitPairs[pair + 1U];
+      }
+      if (value >= 10U) {
+        std::size_t const pair{static_cast<std::size_t>(value) * 2U};
+        out -= 2;
+        out[0] = kDigitPairs[pair];
+        out[1] = kDigitPairs[pair + 1U];
+      } else {
+        --out;
+        *out = kDigits[value];
+      }
+    } else {
+      do {
+        --out;
+        *out = kDigits[value % base];
+        value /= base;
+      } while (value != 0U);
+    }
+    if (negative) {
+      *first = '-';
+    }
+  }
+  return result;
+}
+
+/*!
+ * \brief A floating point number f * 2^e with a 64 bit significand and no sign.
+ */
+class DiyFp final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param f The significand.
+   * \param e The binary exponent.
+   */
+  constexpr DiyFp(std::uint64_t f, std::int32_t e) noexcept : f_(f), e_(e) {}
+
+  /*!
+   * \brief  The significand.
+   * \return The significand.
+   */
+  constexpr std::uint64_t F() const noexcept { return f_; }
+
+  /*!
+   * \brief  The binary exponent.
+   * \return The binary exponent.
+   */
+  constexpr std::int32_t E() const noexcept { return e_; }
+
+  /*!
+   * \brief  Difference of two numbers with the same exponent, the minuend being not smaller.
+   * \param  x The minuend.
+   * \param  y The subtrahend.
+   * \return x - y.
+   */
+  static constexpr DiyFp Sub(DiyFp x, DiyFp y) noexcept { return DiyFp{x.f_ - y.f_, x.e_}; }
+
+  /*!
+   * \brief  Product of two numbers, the significand being rounded to the upper 64 bits.
+   * \param  x A factor.
+   * \param  y A factor.
+   * \return x * y.
+   */
+  static DiyFp Mul(DiyFp x, DiyFp y) noexcept {
+    constexpr std::uint64_t kLow{0xFFFFFFFFU};
+    std::uint64_t const x_lo{x.f_ & kLow};
+    std::uint64_t const x_hi{x.f_ >> 32U};
+    std::uint64_t const y_lo{y.f_ & kLow};
+    std::uint64_t const y_hi{y.f_ >> 32U};
+    std::uint64_t const p0{x_lo * y_lo};
+    std::uint64_t const p1{x_lo * y_hi};
+    std::uint64_t const p2{x_hi * y_lo};
+    std::uint64_t const p3{x_hi * y_hi};
+    // Sum of the middle 32 bits, rounded half up.
+    std::uint64_t const mid{(p0 >> 32U) + (p1 & kLow) + (p2 & kLow) + (std::uint64_t{1} << 31U)};
+    return DiyFp{p3 + (p1 >> 32U) + (p2 >> 32U) + (mid >> 32U), x.e_ + y.e_ + 64};
+  }
+
+  /*!
+   * \brief  Shift the significand so that its most significant bit is set.
+   * \param  x A non-zero number.
+   * \return The normalized number.
+   */
+  static DiyFp Normalize(DiyFp x) noexcept {
+    while ((x.f_ >> 63U) == 0U) {
+      x.f_ <<= 1U;
+      --x.e_;
+    }
+    return x;
+  }
+
+  /*!
+   * \brief  Shift the significand to a smaller exponent.
+   * \param  x The number.
+   * \param  e The exponent, not larger than that of x and not losing bits.
+   * \return The number with exponent e.
+   */
+  static DiyFp NormalizeTo(DiyFp x, std::int32_t e) noexcept {
+    return DiyFp{x.f_ << static_cast<std::uint32_t>(x.e_ - e), e};
+  }
+
+ private:
+  /*!
+   * \brief The significand.
+   */
+  std::uint64_t f_;
+
+  /*!
+   * \brief The binary exponent.
+   */
+  std::int32_t e_;
+};
+
+/*!
+ * \brief A value and the boundaries of the interval of numbers that round to it, all normalized to one exponent.
+ */
+struct Boundaries {
+  /*!
+   * \brief The value.
+   */
+  DiyFp w;
+
+  /*!
+   * \brief The lower boundary.
+   */
+  DiyFp minus;
+
+  /*!
+   * \brief The upper boundary.
+   */
+  DiyFp plus;
+};
+
+/*!
+ * \brief  Decompose a finite positive floating point value into significand and binary exponent.
+ * \tparam Float float or double in IEEE 754 binary format.
+ * \param  value The value.
+ * \param  lower_is_closer Output whether the gap to the next smaller value is half as wide as to the next larger.
+ * \return The value, not normalized.
+ */
+template <typename Float>
+DiyFp Decompose(Float value, bool& lower_is_closer) noexcept {
+  static_assert(std::numeric_limits<Float>::is_iec559, "IEEE 754 floating point format required.");
+  using Bits = typename std::conditional<sizeof(Float) == sizeof(std::uint64_t), std::uint64_t, std::uint32_t>::type;
+  static_assert(sizeof(Bits) == sizeof(Float), "Unsupported floating point type.");
+  constexpr std::int32_t kPrecision{std::numeric_limits<Float>::digits};
+  constexpr std::int32_t kBias{std::numeric_limits<Float>::max_exponent - 1 + (kPrecision - 1)};
+  constexpr std::uint64_t kHiddenBit{std::uint64_t{1} << static_cast<std::uint32_t>(kPrecision - 1)};
+
+  Bits bits{};
+  static_cast<void>(std::memcpy(&bits, &value, sizeof(bits)));
+  std::uint64_t const fraction{static_cast<std::uint64_t>(bits) & (kHiddenBit - 1U)};
+  std::int32_t const exponent{static_cast<std::int32_t>(bits >> static_cast<std::uint32_t>(kPrecision - 1))};
+
+  // The gap to the next smaller value is half as wide at a power of two, except for the smallest normal exponent.
+  lower_is_closer = (fraction == 0U) && (exponent > 1);
+  return (exponent == 0) ? DiyFp{fraction, 1 - kBias} : DiyFp{fraction + kHiddenBit, exponent - kBias};
+}
+
+/*!
+ * \brief  Decompose a finite positive floating point value.
+ * \tparam Float float or double in IEEE 754 binary format.
+ * \param  value The value.
+ * \return The value and its rounding boundaries.
+ */
+template <typename Float>
+Boundaries ComputeBoundaries(Float value) noexcept {
+  bool lower_is_closer{false};
+  DiyFp const v{Decompose(value, lower_is_closer)};
+  DiyFp const plus{DiyFp::Normalize(DiyFp{(v.F() * 2U) + 1U, v.E() - 1})};
+  DiyFp const minus{lower_is_closer ? DiyFp{(v.F() * 4U) - 1U, v.E() - 2} : DiyFp{(v.F() * 2U) - 1U, v.E() - 1}};
+  return Boundaries{DiyFp::Normalize(v), DiyFp::NormalizeTo(minus, plus.E()), plus};
+}
+
+/*!
+ * \brief A normalized power of ten c = f * 2^e = 10^k.
+ */
+struct CachedPower {
+  /*!
+   * \brief The significand.
+   */
+  std::uint64_t f;
+
+  /*!
+   * \brief The binary exponent.
+   */
+  std::int32_t e;
+
+  /*!
+   * \brief The decimal exponent.
+   */
+  std::int32_t k;
+};
+
+/*!
+ * \brief Smallest binary exponent of a scaled number in the digit generation.
+ */
+constexpr std::int32_t kAlpha{-60};
+
+/*!
+ * \brief  Find a power of ten that scales a number with binary exponent e into the range [kAlpha, kAlpha + 28].
+ * \param  e The binary exponent of the upper boundary.
+ * \return The power of ten.
+ */
+inline CachedPower GetCachedPower(std::int32_t e) noexcept {
+  constexpr std::int32_t kMinDecimalExponent{-300};
+  constexpr std::int32_t kDecimalExponentStep{8};
+  // 10^k for k = -300, -292, ..., 324, rounded to 64 bit.
+  static constexpr std::array<CachedPower, 79> kCachedPowers{{
+      {0xAB70FE17C79AC6CAU, -1060, -300},
+      {0xFF77B1FCBEBCDC4FU, -1034, -292},
+      {0xBE5691EF416BD60CU, -1007, -284},
+      {0x8DD01FAD907FFC3CU, -980, -276},
+      {0xD3515C2831559A83U, -954, -268},
+      {0x9D71AC8FADA6C9B5U, -927, -260},
+      {0xEA9C227723EE8BCBU, -901, -252},
+      {0xAECC49914078536DU, -874, -244},
+      {0x823C12795DB6CE57U, -847, -236},
+      {0xC21094364DFB5637U, -821, -228},
+      {0x9096EA6F3848984FU, -794, -220},
+      {0xD77485CB25823AC7U, -768, -212},
+      {0xA086CFCD97BF97F4U, -741, -204},
+      {0xEF340A98172AACE5U, -715, -196},
+      {0xB23867FB2A35B28EU, -688, -188},
+      {0x84C8D4DFD2C63F3BU, -661, -180},
+      {0xC5DD44271AD3CDBAU, -635, -172},
+      {0x936B9FCEBB25C996U, -608, -164},
+      {0xDBAC6C247D62A584U, -582, -156},
+      {0xA3AB66580D5FDAF6U, -555, -148},
+      {0xF3E2F893DEC3F126U, -529, -140},
+      {0xB5B5ADA8AAFF80B8U, -502, -132},
+      {0x87625F056C7C4A8BU, -475, -124},
+      {0xC9BCFF6034C13053U, -449, -116},
+      {0x964E858C91BA2655U, -422, -108},
+      {0xDFF9772470297EBDU, -396, -100},
+      {0xA6DFBD9FB8E5B88FU, -369, -92},
+      {0xF8A95FCF88747D94U, -343, -84},
+      {0xB94470938FA89BCFU, -316, -76},
+      {0x8A08F0F8BF0F156BU, -289, -68},
+      {0xCDB02555653131B6U, -263, -60},
+      {0x993FE2C6D07B7FACU, -236, -52},
+      {0xE45C10C42A2B3B06U, -210, -44},
+      {0xAA242499697392D3U, -183, -36},
+      {0xFD87B5F28300CA0EU, -157, -28},
+      {0xBCE5086492111AEBU, -130, -20},
+      {0x8CBCCC096F5088CCU, -103, -12},
+      {0xD1B71758E219652CU, -77, -4},
+      {0x9C40000000000000U, -50, 4},
+      {0xE8D4A51000000000U, -24, 12},
+      {0xAD78EBC5AC620000U, 3, 20},
+      {0x813F3978F8940984U, 30, 28},
+      {0xC097CE7BC90715B3U, 56, 36},
+      {0x8F7E32CE7BEA5C70U, 83, 44},
+      {0xD5D238A4ABE98068U, 109, 52},
+      {0x9F4F2726179A2245U, 136, 60},
+      {0xED63A231D4C4FB27U, 162, 68},
+      {0xB0DE65388CC8ADA8U, 189, 76},
+      {0x83C7088E1AAB65DBU, 216, 84},
+      {0xC45D1DF942711D9AU, 242, 92},
+      {0x924D692CA61BE758U, 269, 100},
+      {0xDA01EE641A708DEAU, 295, 108},
+      {0xA26DA3999AEF774AU, 322, 116},
+      {0xF209787BB47D6B85U, 348, 124},
+      {0xB454E4A179DD1877U, 375, 132},
+      {0x865B86925B9BC5C2U, 402, 140},
+      {0xC83553C5C8965D3DU, 428, 148},
+      {0x952AB45CFA97A0B3U, 455, 156},
+      {0xDE469FBD99A05FE3U, 481, 164},
+      {0xA59BC234DB398C25U, 508, 172},
+      {0xF6C69A72A3989F5CU, 534, 180},
+      {0xB7DCBF5354E9BECEU, 561, 188},
+      {0x88FCF317F22241E2U, 588, 196},
+      {0xCC20CE9BD35C78A5U, 614, 204},
+      {0x98165AF37B2153DFU, 641, 212},
+      {0xE2A0B5DC971F303AU, 667, 220},
+      {0xA8D9D1535CE3B396U, 694, 228},
+      {0xFB9B7CD9A4A7443CU, 720, 236},
+      {0xBB764C4CA7A44410U, 747, 244},
+      {0x8BAB8EEFB6409C1AU, 774, 252},
+      {0xD01FEF10A657842CU, 800, 260},
+      {0x9B10A4E5E9913129U, 827, 268},
+      {0xE7109BFBA19C0C9DU, 853, 276},
+      {0xAC2820D9623BF429U, 880, 284},
+      {0x80444B5E7AA7CF85U, 907, 292},
+      {0xBF21E44003ACDD2DU, 933, 300},
+      {0x8E679C2F5E44FF8FU, 960, 308},
+      {0xD433179D9C8CB841U, 986, 316},
+      {0x9E19DB92B4E31BA9U, 1013, 324}
+  }};
+  // k = ceil((kAlpha - e - 1) * log10(2))
+  std::int32_t const f{kAlpha - e - 1};
+  std::int32_t const k{((f * 78913) / (1 << 18)) + ((f > 0) ? 1 : 0)};
+  std::int32_t const index{((-kMinDecimalExponent) + k + (kDecimalExponentStep - 1)) / kDecimalExponentStep};
+  return kCachedPowers[static_cast<std::size_t>(index)];
+}
+
+/*!
+ * \brief  Largest power of ten not greater than a number.
+ * \param  n The number, greater than 0.
+ * \param  pow10 Output of the power of ten.
+ * \return The number of decimal digits of n.
+ */
+inline std::int32_t FindLargestPow10(std::uint32_t n, std::uint32_t& pow10) noexcept {
+  std::int32_t digits{10};
+  pow10 = 1000000000U;
+  while (n < pow10) {
+    pow10 /= 10U;
+    --digits;
+  }
+  return digits;
+}
+
+/*!
+ * \brief  Move the last generated digit towards the value as long as the result stays inside the rounding interval,
+ *         and check whether that yields the closest shortest digits despite the error of the scaled numbers.
+ * \param  buffer The digits.
+ * \param  length The number of digits.
+ * \param  dist Distance from the widened upper boundary to the value.
+ * \param  unsafe_interval Width of the rounding interval widened by the error.
+ * \param  rest Distance from the widened upper boundary to the current digits.
+ * \param  ten_k The weight of the last digit.
+ * \param  unit The error of the scaled numbers.
+ * \return True if the digits are the shortest ones and closest to the value, false if that cannot be decided.
+ */
+inline bool Grisu3Round(char* buffer, std::int32_t length, std::uint64_t dist, std::uint64_t unsafe_interval,
+                        std::uint64_t rest, std::uint64_t ten_k, std::uint64_t unit) noexcept {
+  std::uint64_t const small_dist{dist - unit};
+  std::uint64_t const big_dist{dist + unit};
+  while ((rest < small_dist) && ((unsafe_interval - rest) >= ten_k) &&
+         (((rest + ten_k) < small_dist) || ((small_dist - rest) >= ((rest + ten_k) - small_dist)))) {
+    --buffer[length - 1];
+    rest += ten_k;
+  }
+  // If the digits would be moved further for a value that is off by the error, the closest digits are unknown.
+  bool const ambiguous{(rest < big_dist) && ((unsafe_interval - rest) >= ten_k) &&
+                       (((rest + ten_k) < big_dist) || ((big_dist - rest) > ((rest + ten_k) - big_dist)))};
+  // The digits must also lie inside the rounding interval shrunk by the error.
+  return (!ambiguous) && ((2U * unit) <= rest) && (rest <= (unsafe_interval - (4U * unit)));
+}
+
+/*!
+ * \brief  Generate the shortest digits inside the rounding interval (low, high), which is scaled by 10^-k.
+ * \param  buffer Output of the digits.
+ * \param  length Output of the number of digits.
+ * \param  decimal_exponent Input of -k, output of the decimal exponent of the last digit.
+ * \param  low The scaled lower boundary.
+ * \param  w The scaled value.
+ * \param  high The scaled upper boundary.
+ * \return True if the digits are the shortest ones and closest to the value, false if that cannot be decided.
+ */
+inline bool Grisu3DigitGen(char* buffer, std::int32_t& length, std::int32_t& decimal_exponent, DiyFp low, DiyFp w,
+                           DiyFp high) noexcept {
+  // The scaled numbers are off by at most one unit. Digits inside the widened interval may not read back to the value.
+  std::uint64_t unit{1};
+  DiyFp const too_low{low.F() - unit, low.E()};
+  DiyFp const too_high{high.F() + unit, high.E()};
+  std::uint64_t unsafe_interval{DiyFp::Sub(too_high, too_low).F()};
+  std::uint64_t const dist{DiyFp::Sub(too_high, w).F()};
+  // Split the upper boundary into an integral part p1 and a fractional part p2 at the binary point 2^e.
+  std::uint32_t const shift{static_cast<std::uint32_t>(-w.E())};
+  std::uint64_t const one{std::uint64_t{1} << shift};
+  std::uint32_t p1{static_cast<std::uint32_t>(too_high.F() >> shift)};
+  std::uint64_t p2{too_high.F() & (one - 1U)};
+
+  std::uint32_t pow10{0};
+  std::int32_t n{FindLargestPow10(p1, pow10)};
+  bool exact{false};
+  bool done{false};
+  while ((n > 0) && (!done)) {
+    buffer[length] = static_cast<char>('0' + (p1 / pow10));
+    ++length;
+    p1 %= pow10;
+    --n;
+    std::uint64_t const rest{(static_cast<std::uint64_t>(p1) << shift) + p2};
+    if (rest < unsafe_interval) {
+      decimal_exponent += n;
+      exact = Grisu3Round(buffer, length, dist, unsafe_interval, rest, static_cast<std::uint64_t>(pow10) << shift,
+                          unit);
+      done = true;
+    }
+    pow10 /= 10U;
+  }
+  if (!done) {
+    std::int32_t m{0};
+    do {
+      p2 *= 10U;
+      unit *= 10U;
+      unsafe_interval *= 10U;
+      buffer[length] = static_cast<char>('0' + (p2 >> shift));
+      ++length;
+      p2 &= one - 1U;
+      ++m;
+    } while (p2 >= unsafe_interval);
+    decimal_exponent -= m;
+    exact = Grisu3Round(buffer, length, dist * unit, unsafe_interval, p2, one, unit);
+  }
+  return exact;
+}
+
+/*!
+ * \brief  Maximum number of digits generated for a double.
+ */
+constexpr std::size_t kMaxShortestDigits{17};
+
+/*!
+ * \brief  Generate the shortest digits d such that d * 10^decimal_exponent reads back to a value, if the fast
+ *         approximation with 64 bit numbers can decide them.
+ * \tparam Float float or double.
+ * \param  buffer Output of at least kMaxShortestDigits digits.
+ * \param  length Output of the number of digits.
+ * \param  decimal_exponent Output of the decimal exponent.
+ * \param  value A finite positive value.
+ * \return True if the digits have been generated, false in the rare cases that need the exact algorithm.
+ */
+template <typename Float>
+bool Grisu3(char* buffer, std::int32_t& length, std::int32_t& decimal_exponent, Float value) noexcept {
+  Boundaries const b{ComputeBoundaries(value)};
+  CachedPower const cached{GetCachedPower(b.plus.E())};
+  DiyFp const c_minus_k{cached.f, cached.e};
+  length = 0;
+  decimal_exponent = -cached.k;
+  return Grisu3DigitGen(buffer, length, decimal_exponent, DiyFp::Mul(b.minus, c_minus_k), DiyFp::Mul(b.w, c_minus_k),
+                        DiyFp::Mul(b.plus, c_minus_k));
+}
+
+/*!
+ * \brief Unsigned integer with a fixed number of bits, large enough for the exact digit generation of a double.
+ */
+class Bignum final {
+ public:
+  /*!
+   * \brief  Constructor.
+   * \param  value The initial value.
+   */
+  explicit Bignum(std::uint64_t value) noexcept : words_(), size_(0) {
+    while (value != 0U) {
+      words_[size_] = static_cast<std::uint32_t>(value);
+      value >>= 32U;
+      ++size_;
+    }
+  }
+
+  /*!
+   * \brief Multiply by a factor.
+   * \param factor The factor.
+   */
+  void MultiplyBy(std::uint32_t factor) noexcept {
+    std::uint64_t carry{0};
+    for (std::size_t i{0}; i < size_; ++i) {
+      std::uint64_t const product{(static_cast<std::uint64_t>(words_[i]) * factor) + carry};
+      words_[i] = static_cast<std::uint32_t>(product);
+      carry = product >> 32U;
+    }
+    if (carry != 0U) {
+      words_[size_] = static_cast<std::uint32_t>(carry);
+      ++size_;
+    }
+  }
+
+  /*!
+   * \brief Multiply by a power of ten.
+   * \param exponent The non-negative decimal exponent.
+   */
+  void MultiplyByPow10(std::int32_t exponent) noexcept {
+    while (exponent >= 9) {
+      MultiplyBy(1000000000U);
+      exponent -= 9;
+    }
+    std::uint32_t factor{1};
+    for (std::int32_t i{0}; i < exponent; ++i) {
+      factor *= 10U;
+    }
+    MultiplyBy(factor);
+  }
+
+  /*!
+   * \brief Multiply by a power of two.
+   * \param bits The non-negative binary exponent.
+   */
+  void ShiftLeft(std::int32_t bits) noexcept {
+    std::uint32_t const bit_shift{static_cast<std::uint32_t>(bits) % 32U};
+    std::size_t const word_shift{static_cast<std::size_t>(bits) / 32U};
+    if (bit_shift != 0U) {
+      std::uint32_t carry{0};
+      for (std::size_t i{0}; i < size_; ++i) {
+        std::uint32_t const word{words_[i]};
+        words_[i] = (word << bit_shift) | carry;
+        carry = word >> (32U - bit_shift);
+      }
+      if (carry != 0U) {
+        words_[size_] = carry;
+        ++size_;
+      }
+    }
+    if ((word_shift != 0U) && (size_ != 0U)) {
+      for (std::size_t i{size_}; i > 0U; --i) {
+        words_[(i - 1U) + word_shift] = words_[i - 1U];
+      }
+      std::fill_n(words_.begin(), word_shift, std::uint32_t{0});
+      size_ += word_shift;
+    }
+  }
+
+  /*!
+   * \brief Add a number.
+   * \param other The summand.
+   */
+  void Add(Bignum const& other) noexcept {
+    std::size_t const size{(size_ > other.size_) ? size_ : other.size_};
+    std::uint64_t carry{0};
+    for (std::size_t i{0}; i < size; ++i) {
+      std::uint64_t const sum{static_cast<std::uint64_t>(WordAt(i)) + other.WordAt(i) + carry};
+      words_[i] = static_cast<std::uint32_t>(sum);
+      carry = sum >> 32U;
+    }
+    size_ = size;
+    if (carry != 0U) {
+      words_[size_] = static_cast<std::uint32_t>(carry);
+      ++size_;
+    }
+  }
+
+  /*!
+   * \brief Subtract a number that is not larger.
+   * \param other The subtrahend.
+   */
+  void Subtract(Bignum const& other) noexcept {
+    std::uint32_t borrow{0};
+    for (std::size_t i{0}; i < size_; ++i) {
+      std::uint64_t const subtrahend{static_cast<std::uint64_t>(other.WordAt(i)) + borrow};
+      borrow = (words_[i] < subtrahend) ? 1U : 0U;
+      words_[i] = static_cast<std::uint32_t>(words_[i] - subtrahend);
+    }
+    while ((size_ != 0U) && (words_[size_ - 1U] == 0U)) {
+      --size_;
+    }
+  }
+
+  /*!
+   * \brief  Three-way comparison.
+   * \param  x A number.
+   * \param  y A number.
+   * \return A negative value if x < y, 0 if x == y, a positive value if x > y.
+   */
+  static std::int32_t Compare(Bignum const& x, Bignum const& y) noexcept {
+    std::size_t const size{(x.size_ > y.size_) ? x.size_ : y.size_};
+    std::int32_t result{0};
+    for (std::size_t i{size}; (i > 0U) && (result == 0); --i) {
+      std::uint32_t const x_word{x.WordAt(i - 1U)};
+      std::uint32_t const y_word{y.WordAt(i - 1U)};
+      result = (x_word < y_word) ? -1 : ((x_word > y_word) ? 1 : 0);
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Three-way comparison of a sum.
+   * \param  x A summand.
+   * \param  y A summand.
+   * \param  z A number.
+   * \return A negative value if x + y < z, 0 if x + y == z, a positive value if x + y > z.
+   */
+  static std::int32_t PlusCompare(Bignum const& x, Bignum const& y, Bignum const& z) noexcept {
+    Bignum sum{x};
+    sum.Add(y);
+    return Compare(sum, z);
+  }
+
+ private:
+  /*!
+   * \brief  A word, zero above the used words.
+   * \param  index The index of the word.
+   * \return The word.
+   */
+  std::uint32_t WordAt(std::size_t index) const noexcept { return (index < size_) ? words_[index] : 0U; }
+
+  /*!
+   * \brief The words, least significant first. 2^1140 bounds the numbers of the digit generation for a double.
+   */
+  std::array<std::uint32_t, 40> words_;
+
+  /*!
+   * \brief The number of used words.
+   */
+  std::size_t size_;
+};
+
+/*!
+ * \brief  Generate the shortest digits d such that d * 10^decimal_exponent reads back to a value, with exact integer
+ *         arithmetic. Of several shortest candidates the closest one is chosen, ties are broken to the even digit.
+ * \tparam Float float or double.
+ * \param  buffer Output of at least kMaxShortestDigits digits.
+ * \param  length Output of the number of digits.
+ * \param  decimal_exponent Output of the decimal exponent.
+ * \param  value A finite positive value.
+ */
+template <typename Float>
+void ExactShortest(char* buffer, std::int32_t& length, std::int32_t& decimal_exponent, Float value) noexcept {
+  bool lower_is_closer{false};
+  DiyFp const v{Decompose(value, lower_is_closer)};
+  // A boundary itself reads back to the value if the significand is even, because reading rounds ties to even.
+  bool const even{(v.F() & 1U) == 0U};
+  // value = r / s and the boundaries are (r - m_minus) / s and (r + m_plus) / s.
+  Bignum r{v.F()};
+  Bignum s{1};
+  Bignum m_plus{1};
+  if (v.E() >= 0) {
+    r.ShiftLeft(v.E() + 1);
+    s.ShiftLeft(1);
+    m_plus.ShiftLeft(v.E());
+  } else {
+    r.ShiftLeft(1);
+    s.ShiftLeft(1 - v.E());
+  }
+  Bignum m_minus{m_plus};
+  if (lower_is_closer) {
+    r.ShiftLeft(1);
+    s.ShiftLeft(1);
+    m_plus.ShiftLeft(1);
+  }
+
+  // k = ceil(log10(value)) or one less, from the position of the leading bit and log10(2) * 2^32 rounded down.
+  std::int32_t leading_bit{v.E() + 63};
+  for (std::uint64_t f{v.F()}; (f >> 63U) == 0U; f <<= 1U) {
+    --leading_bit;
+  }
+  std::int64_t const scaled{static_cast<std::int64_t>(leading_bit) * 1292913986};
+  std::int64_t const floor_log{(scaled >= 0) ? (scaled / 4294967296) : -(((-scaled) + 4294967295) / 4294967296)};
+  std::int32_t k{static_cast<std::int32_t>(floor_log) + ((leading_bit != 0) ? 1 : 0)};
+  if (k >= 0) {
+    s.MultiplyByPow10(k);
+  } else {
+    r.MultiplyByPow10(-k);
+    m_plus.MultiplyByPow10(-k);
+    m_minus.MultiplyByPow10(-k);
+  }
+  // Scale r / s into [1, 10), unless the estimate of k was one too low.
+  std::int32_t const upper_vs_s{Bignum::PlusCompare(r, m_plus, s)};
+  if ((upper_vs_s > 0) || (even && (upper_vs_s == 0))) {
+    ++k;
+  } else {
+    r.MultiplyBy(10U);
+    m_plus.MultiplyBy(10U);
+    m_minus.MultiplyBy(10U);
+  }
+
+  length = 0;
+  bool done{false};
+  while (!done) {
+    char digit{'0'};
+    while (Bignum::Compare(r, s) >= 0) {
+      r.Subtract(s);
+      ++digit;
+    }
+    buffer[length] = digit;
+    ++length;
+    std::int32_t const rest_vs_minus{Bignum::Compare(r, m_minus)};
+    std::int32_t const upper_vs_next{Bignum::PlusCompare(r, m_plus, s)};
+    // Whether rounding down respectively up stays inside the rounding interval.
+    bool const down{(rest_vs_minus < 0) || (even && (rest_vs_minus == 0))};
+    bool const up{(upper_vs_next > 0) || (even && (upper_vs_next == 0))};
+    if (down && up) {
+      std::int32_t const half{Bignum::PlusCompare(r, r, s)};
+      if ((half > 0) || ((half == 0) && (((digit - '0') % 2) != 0))) {
+        ++buffer[length - 1];
+      }
+      done = true;
+    } else if (down) {
+      done = true;
+    } else if (up) {
+      ++buffer[length - 1];
+      done = true;
+    } else {
+      r.MultiplyBy(10U);
+      m_plus.MultiplyBy(10U);
+      m_minus.MultiplyBy(10U);
+    }
+  }
+  decimal_exponent = k - length;
+}
+
+/*!
+ * \brief  Copy a string.
+ * \param  out The destination.
+ * \param  text The string.
+ * \param  length The length of the string.
+ * \return One past the last written character.
+ */
+inline char* CopyChars(char* out, char const* text, std::size_t length) noexcept {
+  static_cast<void>(std::memcpy(out, text, length));
+  return out + length;
+}
+
+/*!
+ * \brief  Write the digits of a floating point value in fixed or scientific notation, whichever is shorter.
+ * \param  first The begin of the buffer.
+ * \param  last The end of the buffer.
+ * \param  negative Whether a minus sign is written.
+ * \param  digits The significant digits.
+ * \param  length The number of digits.
+ * \param  point The position of the decimal point relative to the first digit.
+ * \return The end of the written characters, or std::errc::value_too_large.
+ */
+inline to_chars_result FormatDigits(char* first, char* last, bool negative, char const* digits, std::int32_t length,
+                                    std::int32_t point) noexcept {
+  std::int32_t const exponent{point - 1};
+  std::int32_t const abs_exponent{(exponent < 0) ? -exponent : exponent};
+  std::int32_t const scientific_length{length + ((length > 1) ? 1 : 0) + 2 + ((abs_exponent >= 100) ? 3 : 2)};
+  std::int32_t fixed_length{point};
+  if (point <= 0) {
+    fixed_length = 2 - point + length;
+  } else if (point < length) {
+    fixed_length = length + 1;
+  } else {
+    // Integral value, digits followed by zeros.
+  }
+  bool const fixed{fixed_length <= scientific_length};
+  std::size_t const total{static_cast<std::size_t>(fixed ? fixed_length : scientific_length) + (negative ? 1U : 0U)};
+  std::size_t const count{static_cast<std::size_t>(length)};
+
+  to_chars_result result{last, std::errc::value_too_large};
+  if (total <= static_cast<std::size_t>(last - first)) {
+    char* out{first};
+    if (negative) {
+      *out = '-';
+      ++out;
+    }
+    if (!fixed) {
+      *out = digits[0];
+      ++out;
+      if (length > 1) {
+        *out = '.';
+        out = CopyChars(out + 1, digits + 1, count - 1U);
+      }
+      *out = 'e';
+      out[1] = (exponent < 0) ? '-' : '+';
+      out = UnsignedToChars(out + 2, last, static_cast<std::uint64_t>(abs_exponent), false, 10U).ptr;
+      if (abs_exponent < 10) {
+        // Two exponent digits at least, like printf.
+        out[0] = out[-1];
+        out[-1] = '0';
+        ++out;
+      }
+    } else if (point <= 0) {
+      out[0] = '0';
+      out[1] = '.';
+      std::size_t const zeros{static_cast<std::size_t>(-point)};
+      static_cast<void>(std::memset(out + 2, '0', zeros));
+      out = CopyChars(out + 2 + zeros, digits, count);
+    } else if (point < length) {
+      std::size_t const integral{static_cast<std::size_t>(point)};
+      out = CopyChars(out, digits, integral);
+      *out = '.';
+      out = CopyChars(out + 1, digits + integral, count - integral);
+    } else {
+      out = CopyChars(out, digits, count);
+      std::size_t const zeros{static_cast<std::size_t>(point - length)};
+      static_cast<void>(std::memset(out, '0', zeros));
+      out += zeros;
+    }
+    result = to_chars_result{out, std::errc()};
+  }
+  return result;
+}
+
+/*!
+ * \brief  Write the shortest representation of a floating point value.
+ * \tparam Float float or double.
+ * \param  first The begin of the buffer.
+ * \param  last The end of the buffer.
+ * \param  value The value.
+ * \return The end of the written characters, or std::errc::value_too_large.
+ */
+template <typename Float>
+to_chars_result FloatToChars(char* first, char* last, Float value) noexcept {
+  bool const negative{std::signbit(value)};
+  to_chars_result result{last, std::errc::value_too_large};
+  if (std::isfinite(value) && (value != Float{0})) {
+    std::array<char, kMaxShortestDigits> digits{};
+    std::int32_t length{0};
+    std::int32_t decimal_exponent{0};
+    Float const magnitude{negative ? -value : value};
+    if (!Grisu3(digits.data(), length, decimal_exponent, magnitude)) {
+      ExactShortest(digits.data(), length, decimal_exponent, magnitude);
+    }
+    result = FormatDigits(first, last, negative, digits.data(), length, length + decimal_exponent);
+  } else {
+    char const* const text{(value == Float{0}) ? "-0" : (std::isnan(value) ? "-nan" : "-inf")};
+    std::size_t const offset{negative ? 0U : 1U};
+    std::size_t const length{std::strlen(text) - offset};
+    if (length <= static_cast<std::size_t>(last - first)) {
+      result = to_chars_result{CopyChars(first, text + offset, length), std::errc()};
+    }
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/*!
+ * \brief   Equivalent to C++17 std::to_chars() for integers.
+ * \details Negative values in a base other than 10 are written as a minus sign followed by the digits of the magnitude,
+ *          digits above 9 as lowercase letters.
+ * \tparam  T An integral type other than bool.
+ * \param   first The begin of the buffer.
+ * \param   last The end of the buffer.
+ * \param   value The value.
+ * \param   base The base, between 2 and 36.
+ * \return  The end of the written characters, or std::errc::value_too_large and last if the buffer is too small, or
+ *          std::errc::invalid_argument and last if the base is not supported.
+ */
+template <typename T, typename = enable_if_t<std::is_integral<T>::value && (!std::is_same<T, bool>::value)>>
+to_chars_result to_chars(char* first, char* last, T value, int base = 10) noexcept {
+  using Unsigned = typename std::make_unsigned<T>::type;
+  to_chars_result result{last, std::errc::invalid_argument};
+  if ((base >= 2) && (base <= 36)) {
+    bool const negative{value < T{0}};
+    Unsigned const magnitude{negative ? static_cast<Unsigned>(Unsigned{0} - static_cast<Unsigned>(value))
+                                      : static_cast<Unsigned>(value)};
+    result = detail::UnsignedToChars(first, last, magnitude, negative, static_cast<std::uint64_t>(base));
+  }
+  return result;
+}
+
+/*!
+ * \brief Equivalent to C++17 std::to_chars() for bool, which is deleted.
+ */
+to_chars_result to_chars(char*, char*, bool, int = 10) = delete;
+
+/*!
+ * \brief   Equivalent to C++17 std::to_chars() for double without format.
+ * \details Writes the shortest characters that read back to the value in fixed or scientific notation, whichever is
+ *          shorter, e.g. "0.1", "1e+100" or "-1.5e-07". Infinity and NaN are written as "inf" and "nan".
+ * \param   first The begin of the buffer.
+ * \param   last The end of the buffer.
+ * \param   value The value.
+ * \return  The end of the written characters, or std::errc::value_too_large and last if the buffer is too small.
+ */
+inline to_chars_result to_chars(char* first, char* last, double value) noexcept {
+  return detail::FloatToChars(first, last, value);
+}
+
+/*!
+ * \brief   Equivalent to C++17 std::to_chars() for float without format.
+ * \details Writes the shortest characters that read back to the float value, see to_chars() for double.
+ * \param   first The begin of the buffer.
+ * \param   last The end of the buffer.
+ * \param   value The value.
+ * \return  The end of the written characters, or std::errc::value_too_large and last if the buffer is too small.
+ */
+inline to_chars_result to_chars(char* first, char* last, float value) noexcept {
+  return detail::FloatToChars(first, last, value);
+}
+
+}  // namespace language
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_LANGUAGE_CHAR_CONV_H_
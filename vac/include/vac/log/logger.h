@@ -0,0 +1,1261 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  logger.h
+ *        \brief  Asynchronous logging with binary capture at the call site.
+ *
+ *      \details  A log statement stores the address of its static call site descriptor, a timestamp and its arguments
+ *                in binary form into a lock-free ring owned by the calling thread. Formatting and output happen on a
+ *                background thread that drains all rings into a LogSink, e.g. vajson::writer::JsonLinesLogSink.
+ *                Statements below VAC_LOG_LEVEL are removed at compile time.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_LOG_LOGGER_H_
+#define LIB_VAC_INCLUDE_VAC_LOG_LOGGER_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "ara/core/string_view.h"
+#include "vac/language/cache_line.h"
+#include "vac/language/char_conv.h"
+#include "vac/language/throw_or_terminate.h"
+#include "vac/metrics/metrics_registry.h"
+
+namespace vac {
+namespace log {
+
+/*!
+ * \brief Severity of a log statement.
+ */
+enum class LogLevel : std::uint8_t { kTrace = 0, kDebug = 1, kInfo = 2, kWarn = 3, kError = 4, kFatal = 5 };
+
+/*!
+ * \brief  The name of a log level.
+ * \param  level The level.
+ * \return The lower case name, e.g. "info".
+ */
+inline char const* GetLevelName(LogLevel level) noexcept {
+  constexpr std::array<char const*, 6> kNames{{"trace", "debug", "info", "warn", "error", "fatal"}};
+  return kNames[static_cast<std::size_t>(level) % kNames.size()];
+}
+
+/*!
+ * \brief What a log statement does when the ring of its thread is full.
+ */
+enum class DropPolicy : std::uint8_t {
+  /*!
+   * \brief Discard the record and count it as dropped. Never blocks.
+   */
+  kDropNewest,
+  /*!
+   * \brief   Yield until the background thread has made room.
+   * \details Only blocks while the background thread started with Start() is running, and never on a thread that is
+   *          draining, e.g. a sink logging from Write(). Otherwise, or once Stop() is called, the record is discarded
+   *          and counted as with kDropNewest.
+   */
+  kBlock
+};
+
+/*!
+ * \brief   Static descriptor of a log statement.
+ * \details The address of the descriptor identifies the format string of a record.
+ */
+struct LogSite final {
+  /*!
+   * \brief The level of the statement.
+   */
+  LogLevel level;
+
+  /*!
+   * \brief The format string, every "{}" is replaced by the next argument.
+   */
+  char const* format;
+
+  /*!
+   * \brief The source file.
+   */
+  char const* file;
+
+  /*!
+   * \brief The source line.
+   */
+  std::uint32_t line;
+};
+
+/*!
+ * \brief Maximum number of arguments of a log statement.
+ */
+constexpr std::size_t kMaxLogArgs{16};
+
+/*!
+ * \brief Maximum size of an encoded record in bytes. Longer string arguments are truncated.
+ */
+constexpr std::size_t kMaxLogRecordSize{512};
+
+/*!
+ * \brief Default capacity of the ring of a thread in bytes.
+ */
+constexpr std::size_t kDefaultLogRingCapacity{64U * 1024U};
+
+namespace detail {
+
+/*!
+ * \brief Type tag preceding an encoded argument.
+ */
+enum class ArgType : std::uint8_t { kBool, kSigned, kUnsigned, kDouble, kString };
+
+/*!
+ * \brief Header preceding the arguments of an encoded record.
+ */
+struct RecordHeader final {
+  /*!
+   * \brief Size of the record including the header in bytes.
+   */
+  std::uint32_t size;
+
+  /*!
+   * \brief The call site.
+   */
+  LogSite const* site;
+
+  /*!
+   * \brief Wall clock time in nanoseconds since the epoch.
+   */
+  std::uint64_t timestamp;
+};
+
+/*!
+ * \brief Writes arguments in binary form into a fixed buffer. Arguments that do not fit are truncated or omitted.
+ */
+class RecordEncoder final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param first The begin of the buffer.
+   * \param last The end of the buffer.
+   */
+  RecordEncoder(char* first, char* last) noexcept : pos_(first), end_(last) {}
+
+  /*!
+   * \brief  The position behind the last encoded argument.
+   * \return The position.
+   */
+  char* GetPosition() const noexcept { return pos_; }
+
+  /*!
+   * \brief Encode a boolean.
+   * \param value The value.
+   */
+  void Put(bool value) noexcept {
+    if ((end_ - pos_) >= 2) {
+      *pos_++ = static_cast<char>(ArgType::kBool);
+      *pos_++ = static_cast<char>(value ? 1 : 0);
+    }
+  }
+
+  /*!
+   * \brief Encode a character as string of length one.
+   * \param value The value.
+   */
+  void Put(char value) noexcept { PutString(&value, 1U); }
+
+  /*!
+   * \brief Encode a signed integer.
+   * \tparam T The integer type.
+   * \param value The value.
+   */
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                                    (!std::is_same<T, char>::value),
+                                                std::int32_t>::type = 0>
+  void Put(T value) noexcept {
+    PutNumber(ArgType::kSigned, static_cast<std::int64_t>(value));
+  }
+
+  /*!
+   * \brief Encode an unsigned integer.
+   * \tparam T The integer type.
+   * \param value The value.
+   */
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                                    (!std::is_same<T, bool>::value) && (!std::is_same<T, char>::value),
+                                                std::int32_t>::type = 0>
+  void Put(T value) noexcept {
+    PutNumber(ArgType::kUnsigned, static_cast<std::uint64_t>(value));
+  }
+
+  /*!
+   * \brief Encode a floating point number.
+   * \tparam T The floating point type.
+   * \param value The value.
+   */
+  template <typename T, typename std::enable_if<std::is_floating_point<T>::value, std::int32_t>::type = 0>
+  void Put(T value) noexcept {
+    PutNumber(ArgType::kDouble, static_cast<double>(value));
+  }
+
+  /*!
+   * \brief Encode a null-terminated string. The characters are copied.
+   * \param value The string, may be nullptr.
+   */
+  void Put(char const* value) noexcept { PutString(value, (value == nullptr) ? 0U : std::strlen(value)); }
+
+  /*!
+   * \brief Encode a string. The characters are copied.
+   * \param value The string.
+   */
+  void Put(ara::core::StringView value) noexcept { PutString(value.data(), value.size()); }
+
+  /*!
+   * \brief Encode a string. The characters are copied.
+   * \param value The string.
+   */
+  void Put(std::string const& value) noexcept { PutString(value.data(), value.size()); }
+
+ private:
+  /*!
+   * \brief Encode an eight byte number.
+   * \tparam T The number type.
+   * \param type The type tag.
+   * \param value The value.
+   */
+  template <typename T>
+  void PutNumber(ArgType type, T value) noexcept {
+    static_assert(sizeof(T) == 8U, "Numbers are encoded with eight bytes");
+    if ((end_ - pos_) >= static_cast<std::ptrdiff_t>(1U + sizeof(T))) {
+      *pos_++ = static_cast<char>(type);
+      static_cast<void>(std::memcpy(pos_, &value, sizeof(T)));
+      pos_ += sizeof(T);
+    }
+  }
+
+  /*!
+   * \brief Encode a string of at most 255 characters.
+   * \param data The characters.
+   * \param size The number of characters.
+   */
+  void PutString(char const* data, std::size_t size) noexcept {
+    std::ptrdiff_t const room{end_ - pos_};
+    if (room >= 2) {
+      std::size_t const length{std::min({size, static_cast<std::size_t>(255U), static_cast<std::size_t>(room - 2)})};
+      *pos_++ = static_cast<char>(ArgType::kString);
+      *pos_++ = static_cast<char>(static_cast<std::uint8_t>(length));
+      if (length != 0U) {
+        static_cast<void>(std::memcpy(pos_, data, length));
+      }
+      pos_ += length;
+    }
+  }
+
+  /*!
+   * \brief The next free position.
+   */
+  char* pos_;
+
+  /*!
+   * \brief The end of the buffer.
+   */
+  char* const end_;
+};
+
+}  // namespace detail
+
+/*!
+ * \brief A decoded log record, valid during LogSink::Write().
+ */
+class LogRecord final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param header The header of the record.
+   * \param thread_id The thread id of the logging thread.
+   * \param args The encoded arguments.
+   * \param args_size The size of the encoded arguments in bytes.
+   */
+  LogRecord(detail::RecordHeader const& header, std::uint32_t thread_id, char const* args,
+            std::size_t args_size) noexcept
+      : site_(*header.site), timestamp_(header.timestamp), thread_id_(thread_id), args_(args), args_size_(args_size) {}
+
+  /*!
+   * \brief  The call site.
+   * \return The site.
+   */
+  LogSite const& GetSite() const noexcept { return site_; }
+
+  /*!
+   * \brief  The wall clock time of the log statement.
+   * \return Nanoseconds since the epoch.
+   */
+  std::uint64_t GetTimestamp() const noexcept { return timestamp_; }
+
+  /*!
+   * \brief  The id of the logging thread.
+   * \return The kernel thread id.
+   */
+  std::uint32_t GetThreadId() const noexcept { return thread_id_; }
+
+  /*!
+   * \brief   Call a visitor for each argument in order.
+   * \details The visitor is called with bool, std::int64_t, std::uint64_t, double or ara::core::StringView.
+   * \param   visitor The visitor.
+   */
+  template <typename Visitor>
+  void ForEachArg(Visitor&& visitor) const {
+    char const* pos{args_};
+    char const* const end{args_ + args_size_};
+    while (pos < end) {
+      detail::ArgType const type{static_cast<detail::ArgType>(*pos++)};
+      switch (type) {
+        case detail::ArgType::kBool:
+          visitor(*pos != '\0');
+          pos += 1;
+          break;
+        case detail::ArgType::kSigned:
+          visitor(Read<std::int64_t>(pos));
+          pos += sizeof(std::int64_t);
+          break;
+        case detail::ArgType::kUnsigned:
+          visitor(Read<std::uint64_t>(pos));
+          pos += sizeof(std::uint64_t);
+          break;
+        case detail::ArgType::kDouble:
+          visitor(Read<double>(pos));
+          pos += sizeof(double);
+          break;
+        default: {
+          std::size_t const length{static_cast<std::uint8_t>(*pos++)};
+          visitor(ara::core::StringView{pos, length});
+          pos += length;
+          break;
+        }
+      }
+    }
+  }
+
+  /*!
+   * \brief   Append the message to a string.
+   * \details Every "{}" in the format string is replaced by the next argument. Surplus placeholders are kept, surplus
+   *          arguments are ignored.
+   * \param   out The string to append to.
+   */
+  void AppendMessage(std::string& out) const {
+    char const* format{site_.format};
+    ArgAppender appender{out, format};
+    ForEachArg(appender);
+    out.append(appender.GetFormat());
+  }
+
+ private:
+  /*!
+   * \brief Appends the format string up to the next placeholder and the argument replacing it.
+   */
+  class ArgAppender final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param out The string to append to.
+     * \param format The format string.
+     */
+    ArgAppender(std::string& out, char const* format) noexcept : out_(out), format_(format) {}
+
+    /*!
+     * \brief  The rest of the format string.
+     * \return The unprocessed part.
+     */
+    char const* GetFormat() const noexcept { return format_; }
+
+    /*!
+     * \brief Append a boolean.
+     * \param value The value.
+     */
+    void operator()(bool value) {
+      if (NextPlaceholder()) {
+        out_.append(value ? "true" : "false");
+      }
+    }
+
+    /*!
+     * \brief Append a number.
+     * \tparam T The number type.
+     * \param value The value.
+     */
+    template <typename T>
+    void operator()(T value) {
+      if (NextPlaceholder()) {
+        std::array<char, 32> buffer{};
+        vac::language::to_chars_result const result{
+            vac::language::to_chars(buffer.data(), buffer.data() + buffer.size(), value)};
+        out_.append(buffer.data(), result.ptr);
+      }
+    }
+
+    /*!
+     * \brief Append a string.
+     * \param value The value.
+     */
+    void operator()(ara::core::StringView value) {
+      if (NextPlaceholder()) {
+        out_.append(value.data(), value.size());
+      }
+    }
+
+   private:
+    /*!
+     * \brief  Append the format string up to the next placeholder and skip it.
+     * \return False if there is no placeholder left.
+     */
+    bool NextPlaceholder() {
+      char const* const placeholder{std::strstr(format_, "{}")};
+      bool const found{placeholder != nullptr};
+      if (found) {
+        out_.append(format_, placeholder);
+        format_ = placeholder + 2;
+      }
+      return found;
+    }
+
+    /*!
+     * \brief The string to append to.
+     */
+    std::string& out_;
+
+    /*!
+     * \brief The unprocessed part of the format string.
+     */
+    char const* format_;
+  };
+
+  /*!
+   * \brief  Read an unaligned number.
+   * \tparam T The number type.
+   * \param  pos The position of the number.
+   * \return The number.
+   */
+  template <typename T>
+  static T Read(char const* pos) noexcept {
+    T value{};
+    static_cast<void>(std::memcpy(&value, pos, sizeof(T)));
+    return value;
+  }
+
+  /*!
+   * \brief The call site.
+   */
+  LogSite const& site_;
+
+  /*!
+   * \brief Nanoseconds since the epoch.
+   */
+  std::uint64_t const timestamp_;
+
+  /*!
+   * \brief The kernel thread id.
+   */
+  std::uint32_t const thread_id_;
+
+  /*!
+   * \brief The encoded arguments.
+   */
+  char const* const args_;
+
+  /*!
+   * \brief The size of the encoded arguments.
+   */
+  std::size_t const args_size_;
+};
+
+/*!
+ * \brief Destination of the records drained by the Logger.
+ */
+class LogSink {
+ public:
+  /*!
+   * \brief Default constructor.
+   */
+  LogSink() = default;
+
+  /*!
+   * \brief Destructor.
+   */
+  virtual ~LogSink() = default;
+
+  /*!
+   * \brief Copy constructor.
+   */
+  LogSink(LogSink const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  LogSink(LogSink&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  LogSink& operator=(LogSink const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  LogSink& operator=(LogSink&&) & = delete;
+
+  /*!
+   * \brief Consume a record.
+   * \param record The record.
+   */
+  virtual void Write(LogRecord const& record) = 0;
+
+  /*!
+   * \brief Report records dropped because the ring of a thread was full.
+   * \param thread_id The kernel thread id.
+   * \param count The number of records dropped since the last report.
+   */
+  virtual void OnDropped(std::uint32_t thread_id, std::uint64_t count) = 0;
+
+  /*!
+   * \brief Output the records consumed so far. Called after every drain of all rings.
+   */
+  virtual void Flush() = 0;
+};
+
+/*!
+ * \brief   Single producer single consumer ring of encoded records.
+ * \details The owning thread writes, the draining thread reads. Each side caches the position of the other side and
+ *          the two positions are kept on different cache lines.
+ */
+class LogRing final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param capacity The capacity in bytes, rounded up to a power of two of at least kMaxLogRecordSize.
+   * \param thread_id The kernel thread id of the owning thread.
+   */
+  LogRing(std::size_t capacity, std::uint32_t thread_id)
+      : capacity_(RoundUpCapacity(capacity)),
+        buffer_(new char[capacity_]),
+        head_(0),
+        cached_tail_(0),
+        dropped_(0),
+        padding_(),
+        tail_(0),
+        thread_id_(thread_id),
+        released_(false) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  LogRing(LogRing const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  LogRing& operator=(LogRing const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  LogRing(LogRing&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  LogRing& operator=(LogRing&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~LogRing() = default;
+
+  /*!
+   * \brief  Append a record. Called by the owning thread only.
+   * \param  data The record.
+   * \param  size The size of the record, at most kMaxLogRecordSize.
+   * \return False if the ring is full.
+   */
+  bool TryWrite(char const* data, std::size_t size) noexcept {
+    std::size_t const head{head_.load(std::memory_order_relaxed)};
+    bool fits{(capacity_ - (head - cached_tail_)) >= size};
+    if (!fits) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      fits = (capacity_ - (head - cached_tail_)) >= size;
+    }
+    if (fits) {
+      std::size_t const offset{head & (capacity_ - 1U)};
+      std::size_t const first{std::min(size, capacity_ - offset)};
+      static_cast<void>(std::memcpy(&buffer_[offset], data, first));
+      static_cast<void>(std::memcpy(&buffer_[0], data + first, size - first));
+      head_.store(head + size, std::memory_order_release);
+    }
+    return fits;
+  }
+
+  /*!
+   * \brief Count a dropped record. Called by the owning thread only.
+   */
+  void AddDropped() noexcept { static_cast<void>(dropped_.fetch_add(1, std::memory_order_relaxed)); }
+
+  /*!
+   * \brief  Take the number of dropped records. Called by the draining thread only.
+   * \return The number of records dropped since the last call.
+   */
+  std::uint64_t TakeDropped() noexcept { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+  /*!
+   * \brief   Read all records. Called by the draining thread only.
+   * \details The space of a record is returned to the writer before the record is handed to the callback.
+   * \param   scratch A buffer of kMaxLogRecordSize bytes the records are copied to.
+   * \param   fn The callback, called with the record and the thread id.
+   */
+  template <typename Fn>
+  void Drain(char* scratch, Fn&& fn) {
+    std::size_t tail{tail_.load(std::memory_order_relaxed)};
+    std::size_t const head{head_.load(std::memory_order_acquire)};
+    std::uint32_t const thread_id{thread_id_.load(std::memory_order_relaxed)};
+    while (tail != head) {
+      std::uint32_t size{0};
+      CopyOut(tail, reinterpret_cast<char*>(&size), sizeof(size));
+      CopyOut(tail, scratch, size);
+      tail += size;
+      tail_.store(tail, std::memory_order_release);
+      fn(static_cast<char const*>(scratch), thread_id);
+    }
+  }
+
+  /*!
+   * \brief  Whether all records have been read.
+   * \return True if the ring is empty.
+   */
+  bool IsEmpty() const noexcept {
+    return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+  }
+
+  /*!
+   * \brief  The kernel thread id of the owning thread.
+   * \return The thread id.
+   */
+  std::uint32_t GetThreadId() const noexcept { return thread_id_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Mark the ring as no longer used by its thread.
+   */
+  void Release() noexcept { released_.store(true, std::memory_order_release); }
+
+  /*!
+   * \brief  Whether the ring is no longer used by its thread.
+   * \return True if released.
+   */
+  bool IsReleased() const noexcept { return released_.load(std::memory_order_acquire); }
+
+  /*!
+   * \brief Hand a released ring to a new thread. It must have been drained.
+   * \param thread_id The kernel thread id of the new owning thread.
+   */
+  void Reuse(std::uint32_t thread_id) noexcept {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    thread_id_.store(thread_id, std::memory_order_relaxed);
+    released_.store(false, std::memory_order_relaxed);
+  }
+
+ private:
+  /*!
+   * \brief  Round a capacity up to a power of two of at least kMaxLogRecordSize.
+   * \param  capacity The requested capacity.
+   * \return The rounded capacity.
+   */
+  static std::size_t RoundUpCapacity(std::size_t capacity) noexcept {
+    std::size_t rounded{kMaxLogRecordSize};
+    while (rounded < capacity) {
+      rounded *= 2U;
+    }
+    return rounded;
+  }
+
+  /*!
+   * \brief Copy bytes out of the ring.
+   * \param position The position of the first byte.
+   * \param out The destination.
+   * \param size The number of bytes.
+   */
+  void CopyOut(std::size_t position, char* out, std::size_t size) const noexcept {
+    std::size_t const offset{position & (capacity_ - 1U)};
+    std::size_t const first{std::min(size, capacity_ - offset)};
+    static_cast<void>(std::memcpy(out, &buffer_[offset], first));
+    static_cast<void>(std::memcpy(out + first, &buffer_[0], size - first));
+  }
+
+  /*!
+   * \brief The capacity in bytes, a power of two.
+   */
+  std::size_t const capacity_;
+
+  /*!
+   * \brief The bytes.
+   */
+  std::unique_ptr<char[]> const buffer_;
+
+  /*!
+   * \brief Total number of bytes written. Written by the owning thread.
+   */
+  std::atomic<std::size_t> head_;
+
+  /*!
+   * \brief Last value of tail_ seen by the owning thread.
+   */
+  std::size_t cached_tail_;
+
+  /*!
+   * \brief Number of records dropped since the last report.
+   */
+  std::atomic<std::uint64_t> dropped_;
+
+  /*!
+   * \brief Keeps the positions of writer and reader on different cache lines.
+   */
+  std::array<char, vac::language::kCacheLineSize> padding_;
+
+  /*!
+   * \brief Total number of bytes read. Written by the draining thread.
+   */
+  std::atomic<std::size_t> tail_;
+
+  /*!
+   * \brief The kernel thread id of the owning thread.
+   */
+  std::atomic<std::uint32_t> thread_id_;
+
+  /*!
+   * \brief Whether the owning thread has exited.
+   */
+  std::atomic<bool> released_;
+};
+
+/*!
+ * \brief   Process-wide asynchronous logger.
+ * \details Every logging thread gets its own LogRing on first use, which is reused by a later thread after the owning
+ *          thread has exited and the ring has been drained. Records are drained into a LogSink by the background thread
+ *          started with Start() or synchronously by Drain().
+ */
+class Logger final {
+ public:
+  /*!
+   * \brief Default interval of the background thread between two drains.
+   */
+  static constexpr std::chrono::milliseconds kDefaultFlushInterval{10};
+
+  /*!
+   * \brief  The process-wide logger.
+   * \return The logger.
+   */
+  static Logger& Instance() {
+    static Logger logger;
+    return logger;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  Logger(Logger const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  Logger& operator=(Logger const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  Logger(Logger&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  Logger& operator=(Logger&&) & = delete;
+
+  /*!
+   * \brief Destructor. Stops the background thread.
+   */
+  ~Logger() { Stop(); }
+
+  /*!
+   * \brief Set the capacity of the rings created afterwards. Threadsafe.
+   * \param capacity The capacity in bytes.
+   */
+  void SetRingCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    ring_capacity_ = capacity;
+  }
+
+  /*!
+   * \brief Set the behavior of log statements on a full ring. Threadsafe.
+   * \param policy The policy.
+   */
+  void SetDropPolicy(DropPolicy policy) noexcept { drop_policy_.store(policy, std::memory_order_relaxed); }
+
+  /*!
+   * \brief  The behavior of log statements on a full ring.
+   * \return The policy.
+   */
+  DropPolicy GetDropPolicy() const noexcept { return drop_policy_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief   Capture a log statement into the ring of the calling thread. Use the VAC_LOG_* macros instead.
+   * \details Only the arguments are encoded; the format string is taken from the site.
+   * \tparam  Args Arguments of type bool, char, integer, floating point, char const*, StringView or std::string.
+   * \param   site The static call site descriptor.
+   * \param   format The format string of the site, not used.
+   * \param   args The arguments.
+   */
+  template <typename... Args>
+  void Log(LogSite const& site, char const* format, Args const&... args) {
+    static_assert(sizeof...(Args) <= kMaxLogArgs, "Too many arguments for a log statement");
+    static_cast<void>(format);
+    std::array<char, kMaxLogRecordSize> record;
+    detail::RecordEncoder encoder{record.data() + sizeof(detail::RecordHeader), record.data() + record.size()};
+    static_cast<void>(std::initializer_list<std::int32_t>{(encoder.Put(args), 0)...});
+    std::chrono::nanoseconds const now{std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())};
+    detail::RecordHeader const header{static_cast<std::uint32_t>(encoder.GetPosition() - record.data()), &site,
+                                      static_cast<std::uint64_t>(now.count())};
+    static_cast<void>(std::memcpy(record.data(), &header, sizeof(header)));
+    LogRing& ring{GetThreadRing()};
+    if (!ring.TryWrite(record.data(), header.size)) {
+      bool written{false};
+      // Without a running consumer, or on the draining thread itself, nobody would ever make room.
+      if ((GetDropPolicy() == DropPolicy::kBlock) && (!IsDrainingThread())) {
+        while ((!written) && worker_running_.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+          written = ring.TryWrite(record.data(), header.size);
+        }
+      }
+      if (!written) {
+        ring.AddDropped();
+        VAC_METRICS_COUNTER_ADD("vac.log.dropped", 1U);
+      }
+    }
+  }
+
+  /*!
+   * \brief Read the records of all rings into a sink and flush it. Threadsafe, drains are serialized.
+   * \param sink The sink.
+   */
+  void Drain(LogSink& sink) {
+    std::lock_guard<std::mutex> const drain_lock{drain_mutex_};
+    DrainingScope const draining{};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      drain_rings_.clear();
+      for (std::unique_ptr<LogRing> const& ring : rings_) {
+        drain_rings_.push_back(ring.get());
+      }
+    }
+    for (LogRing* const ring : drain_rings_) {
+      ring->Drain(scratch_.data(), [&sink](char const* data, std::uint32_t thread_id) {
+        detail::RecordHeader header{};
+        static_cast<void>(std::memcpy(&header, data, sizeof(header)));
+        LogRecord const record{header, thread_id, data + sizeof(header), header.size - sizeof(header)};
+        sink.Write(record);
+      });
+      std::uint64_t const dropped{ring->TakeDropped()};
+      if (dropped != 0U) {
+        sink.OnDropped(ring->GetThreadId(), dropped);
+      }
+    }
+    sink.Flush();
+  }
+
+  /*!
+   * \brief  Start the background thread draining into a sink.
+   * \param  sink The sink. Must stay valid until Stop() has returned.
+   * \param  interval The time between two drains.
+   * \throws std::logic_error If the background thread is running already.
+   */
+  void Start(LogSink& sink, std::chrono::milliseconds interval = kDefaultFlushInterval) {
+    std::lock_guard<std::mutex> const lock{worker_mutex_};
+    if (worker_.joinable()) {
+      vac::language::ThrowOrTerminate<std::logic_error>("Logger is started already");
+    }
+    stopping_ = false;
+    worker_ = std::thread{&Logger::Run, this, std::ref(sink), interval};
+    worker_running_.store(true, std::memory_order_release);
+  }
+
+  /*!
+   * \brief Stop the background thread after a final drain. Does nothing if it is not running.
+   *        Log statements blocked by DropPolicy::kBlock drop their record from now on.
+   */
+  void Stop() {
+    std::thread worker{};
+    {
+      std::lock_guard<std::mutex> const lock{worker_mutex_};
+      worker_running_.store(false, std::memory_order_release);
+      stopping_ = true;
+      worker = std::move(worker_);
+    }
+    worker_condvar_.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+ private:
+  /*!
+   * \brief Releases the ring of a thread when the thread exits.
+   */
+  class RingReleaser final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param ring The ring of the calling thread.
+     */
+    explicit RingReleaser(LogRing& ring) noexcept : ring_(ring) {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    RingReleaser(RingReleaser const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    RingReleaser& operator=(RingReleaser const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    RingReleaser(RingReleaser&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    RingReleaser& operator=(RingReleaser&&) & = delete;
+
+    /*!
+     * \brief Destructor. Releases the ring.
+     */
+    ~RingReleaser() noexcept {
+      ThreadRing() = nullptr;
+      ring_.Release();
+    }
+
+   private:
+    /*!
+     * \brief The ring of the thread.
+     */
+    LogRing& ring_;
+  };
+
+  /*!
+   * \brief Marks the calling thread as draining for the lifetime of the object.
+   */
+  class DrainingScope final {
+   public:
+    /*!
+     * \brief Constructor. Marks the calling thread as draining.
+     */
+    DrainingScope() noexcept { IsDrainingThread() = true; }
+
+    /*!
+     * \brief Copy constructor.
+     */
+    DrainingScope(DrainingScope const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    DrainingScope& operator=(DrainingScope const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    DrainingScope(DrainingScope&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    DrainingScope& operator=(DrainingScope&&) & = delete;
+
+    /*!
+     * \brief Destructor. Clears the mark.
+     */
+    ~DrainingScope() noexcept { IsDrainingThread() = false; }
+  };
+
+  /*!
+   * \brief Constructor.
+   */
+  Logger()
+      : mutex_(),
+        rings_(),
+        ring_capacity_(kDefaultLogRingCapacity),
+        drop_policy_(DropPolicy::kDropNewest),
+        drain_mutex_(),
+        drain_rings_(),
+        scratch_(),
+        worker_mutex_(),
+        worker_condvar_(),
+        stopping_(false),
+        worker_running_(false),
+        worker_() {}
+
+  /*!
+   * \brief  Whether the calling thread is inside Drain().
+   * \return Reference to the flag of the calling thread.
+   */
+  static bool& IsDrainingThread() noexcept {
+    thread_local bool draining{false};
+    return draining;
+  }
+
+  /*!
+   * \brief  The cached ring pointer of the calling thread.
+   * \return Reference to the pointer, nullptr if the thread has no ring.
+   */
+  static LogRing*& ThreadRing() noexcept {
+    thread_local LogRing* ring{nullptr};
+    return ring;
+  }
+
+  /*!
+   * \brief  The ring of the calling thread, acquired on first use.
+   * \return The ring.
+   */
+  LogRing& GetThreadRing() {
+    LogRing*& ring{ThreadRing()};
+    if (ring == nullptr) {
+      ring = &AcquireRing();
+    }
+    return *ring;
+  }
+
+  /*!
+   * \brief  Reuse a drained ring of an exited thread or create a new one.
+   * \return The ring of the calling thread.
+   */
+  LogRing& AcquireRing() {
+    std::uint32_t const thread_id{static_cast<std::uint32_t>(::syscall(SYS_gettid))};
+    LogRing* ring{nullptr};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      std::vector<std::unique_ptr<LogRing>>::iterator const it{
+          std::find_if(rings_.begin(), rings_.end(), [](std::unique_ptr<LogRing> const& candidate) {
+            return candidate->IsReleased() && candidate->IsEmpty();
+          })};
+      if (it != rings_.end()) {
+        ring = it->get();
+        ring->Reuse(thread_id);
+      } else {
+        rings_.emplace_back(new LogRing(ring_capacity_, thread_id));
+        ring = rings_.back().get();
+      }
+    }
+    thread_local RingReleaser const releaser{*ring};
+    static_cast<void>(releaser);
+    return *ring;
+  }
+
+  /*!
+   * \brief Body of the background thread.
+   * \param sink The sink.
+   * \param interval The time between two drains.
+   */
+  void Run(LogSink& sink, std::chrono::milliseconds interval) {
+    bool stopping{false};
+    while (!stopping) {
+      Drain(sink);
+      std::unique_lock<std::mutex> lock{worker_mutex_};
+      stopping = worker_condvar_.wait_for(lock, interval, [this]() { return stopping_; });
+    }
+    Drain(sink);
+  }
+
+  /*!
+   * \brief Protects rings_ and ring_capacity_.
+   */
+  std::mutex mutex_;
+
+  /*!
+   * \brief The rings of all threads that ever logged.
+   */
+  std::vector<std::unique_ptr<LogRing>> rings_;
+
+  /*!
+   * \brief Capacity of new rings in bytes.
+   */
+  std::size_t ring_capacity_;
+
+  /*!
+   * \brief Behavior on a full ring.
+   */
+  std::atomic<DropPolicy> drop_policy_;
+
+  /*!
+   * \brief Serializes the readers of the rings.
+   */
+  std::mutex drain_mutex_;
+
+  /*!
+   * \brief The rings to drain, reused between drains. Guarded by drain_mutex_.
+   */
+  std::vector<LogRing*> drain_rings_;
+
+  /*!
+   * \brief The record being decoded. Guarded by drain_mutex_.
+   */
+  std::array<char, kMaxLogRecordSize> scratch_;
+
+  /*!
+   * \brief Protects stopping_ and worker_.
+   */
+  std::mutex worker_mutex_;
+
+  /*!
+   * \brief Wakes the background thread on Stop().
+   */
+  std::condition_variable worker_condvar_;
+
+  /*!
+   * \brief Whether the background thread shall exit.
+   */
+  bool stopping_;
+
+  /*!
+   * \brief Whether the background thread is running and not being stopped. Read by blocked log statements.
+   */
+  std::atomic<bool> worker_running_;
+
+  /*!
+   * \brief The background thread.
+   */
+  std::thread worker_;
+};
+
+constexpr std::chrono::milliseconds Logger::kDefaultFlushInterval;
+
+}  // namespace log
+}  // namespace vac
+
+#ifndef VAC_LOG_LEVEL
+/*!
+ * \brief Numeric value of the lowest LogLevel that is compiled in, kInfo by default.
+ */
+#define VAC_LOG_LEVEL 2
+#endif
+
+/*!
+ * \brief The first of the arguments, the format string of a log statement.
+ */
+#define VAC_LOG_FORMAT_OF(format, ...) format
+
+/*!
+ * \brief Capture a log statement. The first argument must be a string literal.
+ */
+#define VAC_LOG_AT(level, ...)                                                                             \
+  do {                                                                                                     \
+    static constexpr ::vac::log::LogSite vac_log_site{level, VAC_LOG_FORMAT_OF(__VA_ARGS__, 0), __FILE__, \
+                                                      static_cast<std::uint32_t>(__LINE__)};              \
+    ::vac::log::Logger::Instance().Log(vac_log_site, __VA_ARGS__);                                          \
+  } while (false)
+
+#if VAC_LOG_LEVEL <= 0
+/*!
+ * \brief Log at level trace, e.g. VAC_LOG_TRACE("queue depth {}", depth).
+ */
+#define VAC_LOG_TRACE(...) VAC_LOG_AT(::vac::log::LogLevel::kTrace, __VA_ARGS__)
+#else
+/*!
+ * \brief Level trace disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_TRACE(...) static_cast<void>(0)
+#endif
+
+#if VAC_LOG_LEVEL <= 1
+/*!
+ * \brief Log at level debug.
+ */
+#define VAC_LOG_DEBUG(...) VAC_LOG_AT(::vac::log::LogLevel::kDebug, __VA_ARGS__)
+#else
+/*!
+ * \brief Level debug disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_DEBUG(...) static_cast<void>(0)
+#endif
+
+#if VAC_LOG_LEVEL <= 2
+/*!
+ * \brief Log at level info.
+ */
+#define VAC_LOG_INFO(...) VAC_LOG_AT(::vac::log::LogLevel::kInfo, __VA_ARGS__)
+#else
+/*!
+ * \brief Level info disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_INFO(...) static_cast<void>(0)
+#endif
+
+#if VAC_LOG_LEVEL <= 3
+/*!
+ * \brief Log at level warn.
+ */
+#define VAC_LOG_WARN(...) VAC_LOG_AT(::vac::log::LogLevel::kWarn, __VA_ARGS__)
+#else
+/*!
+ * \brief Level warn disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_WARN(...) static_cast<void>(0)
+#endif
+
+#if VAC_LOG_LEVEL <= 4
+/*!
+ * \brief Log at level error.
+ */
+#define VAC_LOG_ERROR(...) VAC_LOG_AT(::vac::log::LogLevel::kError, __VA_ARGS__)
+#else
+/*!
+ * \brief Level error disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_ERROR(...) static_cast<void>(0)
+#endif
+
+#if VAC_LOG_LEVEL <= 5
+/*!
+ * \brief Log at level fatal.
+ */
+#define VAC_LOG_FATAL(...) VAC_LOG_AT(::vac::log::LogLevel::kFatal, __VA_ARGS__)
+#else
+/*!
+ * \brief Level fatal disabled, see VAC_LOG_LEVEL. The arguments are not evaluated.
+ */
+#define VAC_LOG_FATAL(...) static_cast<void>(0)
+#endif
+
+#endif  // LIB_VAC_INCLUDE_VAC_LOG_LOGGER_H_
@@ -34,15 +34,17 @@
 
 #include "vac/container/static_map.h"
 #include "vac/language/throw_or_terminate.h"
+#include "vac/sync/profiled_mutex.h"
 #include "vac/testing/test_adapter.h"
 
 namespace vac {
 namespace memory {
 /*!
- * \brief BufferProvider Class to manage buffers of objects of a specific type.
- * \trace CREQ-158631
+ * \brief  BufferProvider Class to manage buffers of objects of a specific type.
+ * \tparam Mutex The mutex protecting the buffers, e.g. vac::sync::ProfiledMutex to profile its contention.
+ * \trace  CREQ-158631
  */
-template <class T>
+template <class T, typename Mutex = vac::sync::DefaultMutex>
 class BufferProvider final {
   FRIEND_TEST(BufferProvider, Capacity);
   FRIEND_TEST(BufferProvider, AllocateOnlyOnce);
@@ -96,7 +98,7 @@ class BufferProvider final {
    * \trace  CREQ-158632
    */
   void reserve(size_type number_buffer, size_type number_elements) {
-    std::lock_guard<std::mutex> lock{buffer_mutex_};
+    std::lock_guard<Mutex> lock{buffer_mutex_};
     if ((number_buffer * number_elements) > (reserved_number_buffer_ * reserved_number_elements_)) {
       // We need to allocate additional memory. Current implementation can only allocate once initially.
       if (buffer_storage_) {
@@ -124,7 +126,7 @@ class BufferProvider final {
    */
   pointer allocate(size_type number_elements) {
     pointer ret_value{nullptr};
-    std::lock_guard<std::mutex> lock{buffer_mutex_};
+    std::lock_guard<Mutex> lock{buffer_mutex_};
     if (number_elements <= reserved_number_elements_) {
       typename FreeBufferMap::iterator it{std::find_if(free_buffer_map_.begin(), free_buffer_map_.end(),
                                                        [](PairRawPtrBool const pair) { return pair.second; })};
@@ -143,7 +145,7 @@ class BufferProvider final {
    * \throws std::bad_alloc if \a ptr does not exist in free_buffer_map_.
    */
   void deallocate(pointer ptr) {
-    std::lock_guard<std::mutex> lock{buffer_mutex_};
+    std::lock_guard<Mutex> lock{buffer_mutex_};
     if (ptr == nullptr) {
       vac::language::ThrowOrTerminate<std::logic_error>("Attempting to deallocate a nullptr");
     } else {
@@ -197,7 +199,7 @@ class BufferProvider final {
   /*!
    * \brief Mutex to synchronize access to the buffers.
    */
-  std::mutex buffer_mutex_{};
+  vac::sync::NamedMutex<Mutex> buffer_mutex_{"vac::memory::BufferProvider"};
 };
 
 /*!
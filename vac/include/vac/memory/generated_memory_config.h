@@ -25,6 +25,7 @@
 /**********************************************************************************************************************
  *  INCLUDES
  *********************************************************************************************************************/
+#include <cstddef>
 
 namespace vac {
 namespace memory {
@@ -34,6 +35,23 @@ namespace memory {
  */
 constexpr const bool kIsDeterministicMode{false};
 
+/*!
+ * \brief Size of the buffer inside a Future shared state that holds the continuation registered by Future::then().
+ *        Larger continuations are taken from a thread local pool.
+ */
+constexpr const std::size_t kFutureContinuationInlineSize{64};
+
+/*!
+ * \brief Number of free continuation blocks a thread keeps per size class when continuations exceed the inline size.
+ */
+constexpr const std::size_t kFutureContinuationPoolCacheSize{64};
+
+/*!
+ * \brief Number of free command blocks a thread keeps for the ThreadSafeTimingWheelTimerManager. Posting threads
+ *        allocate commands in bursts that the reactor thread frees in one go, so the cache covers a whole burst.
+ */
+constexpr const std::size_t kTimerCommandPoolCacheSize{256};
+
 }  // namespace memory
 }  // namespace vac
 
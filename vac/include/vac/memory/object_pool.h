@@ -33,6 +33,8 @@
 
 #include "vac/container/static_vector.h"
 #include "vac/language/throw_or_terminate.h"
+#include "vac/metrics/metrics_registry.h"
+#include "vac/sync/profiled_mutex.h"
 #include "vac/testing/test_adapter.h"
 
 namespace vac {
@@ -50,8 +52,9 @@ namespace memory {
  *          (returning memory to the wrong pool) or a misconfiguration (an insufficient amount of resources was
  *          configured). For both cases, it must be ensured prior to production that the error conditions do not occur.
  *          TODO(PAASR-1154): Make all methods noexcept.
+ * \tparam  Mutex The mutex protecting the free list, e.g. vac::sync::ProfiledMutex to profile its contention.
  */
-template <class T, bool moveable, typename alloc = std::allocator<T>>
+template <class T, bool moveable, typename alloc = std::allocator<T>, typename Mutex = vac::sync::DefaultMutex>
 class ObjectPoolImpl {
   friend class ObjectPoolTestFixture;
   friend class SmartBaseTypeObjectPoolTestFixture;
@@ -105,8 +108,8 @@ class ObjectPoolImpl {
   template <typename U = T, typename = typename std::enable_if<moveable, U>::type>
   ObjectPoolImpl(ObjectPoolImpl&& other) noexcept(false) {
     std::lock(other.free_list_mutex_, free_list_mutex_);
-    std::lock_guard<std::mutex> other_lock{{other.free_list_mutex_}, {std::adopt_lock}};
-    std::lock_guard<std::mutex> this_lock{{free_list_mutex_}, {std::adopt_lock}};
+    std::lock_guard<Mutex> other_lock{{other.free_list_mutex_}, {std::adopt_lock}};
+    std::lock_guard<Mutex> this_lock{{free_list_mutex_}, {std::adopt_lock}};
 
     storage_ = std::move(other.storage_);
     std::swap(free_list_, other.free_list_);
@@ -122,8 +125,8 @@ class ObjectPoolImpl {
   template <typename U = T, typename = typename std::enable_if<moveable, U>::type>
       ObjectPoolImpl& operator=(ObjectPoolImpl&& other) & noexcept {
     std::lock(other.free_list_mutex_, free_list_mutex_);
-    std::lock_guard<std::mutex> other_lock{{other.free_list_mutex_}, {std::adopt_lock}};
-    std::lock_guard<std::mutex> this_lock{{free_list_mutex_}, {std::adopt_lock}};
+    std::lock_guard<Mutex> other_lock{{other.free_list_mutex_}, {std::adopt_lock}};
+    std::lock_guard<Mutex> this_lock{{free_list_mutex_}, {std::adopt_lock}};
 
     storage_.swap(other.storage_);
     std::swap(free_list_, other.free_list_);
@@ -141,7 +144,7 @@ class ObjectPoolImpl {
    * \trace   CREQ-158622
    */
   void reserve(size_type new_capacity) {
-    std::lock_guard<std::mutex> lock{free_list_mutex_};
+    std::lock_guard<Mutex> lock{free_list_mutex_};
     if (new_capacity > storage_.size()) {
       // Resize default-constructs all StoredType unions. Their default constructor activates the StoredType* member.
       storage_.resize(new_capacity);
@@ -326,13 +329,15 @@ class ObjectPoolImpl {
   T* allocate() {
     if (free_list_ == nullptr) {
       // Out of memory.
+      VAC_METRICS_COUNTER_ADD("vac.object_pool.exhausted", 1U);
       vac::language::ThrowOrTerminate<std::bad_alloc>();
     }
-    std::unique_lock<std::mutex> lock{free_list_mutex_};
+    std::unique_lock<Mutex> lock{free_list_mutex_};
     StoredType* element{free_list_};
     free_list_ = element->free;
     ++allocation_count_;
     lock.unlock();
+    VAC_METRICS_GAUGE_ADD("vac.object_pool.objects_in_use", 1);
     // Deactivate free list member.
     element->free = nullptr;
     return &element->data;
@@ -348,13 +353,14 @@ class ObjectPoolImpl {
   void deallocate(T* ptr) {
     if (ptr != nullptr) {
       if (this->IsManaged(ptr)) {
-        std::lock_guard<std::mutex> lock{free_list_mutex_};
+        std::lock_guard<Mutex> lock{free_list_mutex_};
         // Convert from data member back to union.
         StoredType* element{reinterpret_cast<StoredType*>(ptr)};
         // Activate free list member.
         element->free = free_list_;
         free_list_ = element;
         --allocation_count_;
+        VAC_METRICS_GAUGE_ADD("vac.object_pool.objects_in_use", -1);
       } else {
         vac::language::ThrowOrTerminate<std::bad_alloc>();
       }
@@ -374,7 +380,7 @@ class ObjectPoolImpl {
   /*!
    * \brief Mutex to synchronize access to the free_list_.
    */
-  std::mutex free_list_mutex_{};
+  vac::sync::NamedMutex<Mutex> free_list_mutex_{"vac::memory::ObjectPool"};
 
   /*!
    * \brief Number of elements the ObjectPool has handed out and that have not been returned.
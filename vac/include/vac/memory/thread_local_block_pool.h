@@ -0,0 +1,304 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  thread_local_block_pool.h
+ *        \brief  Pool of fixed size memory blocks that are recycled through a per-thread free list.
+ *
+ *      \details  Blocks are taken from the free list of the calling thread and only requested from the global heap
+ *                when that list is empty. Returned blocks are put on the free list of the returning thread. When
+ *                blocks are allocated on one thread and returned on another, the returning thread hands its surplus
+ *                to a shared depot in batches and the allocating thread refills its list from there, so blocks keep
+ *                circulating without touching the global heap. The depot is guarded by a lock that is taken once
+ *                per batch; blocks that stay on one thread involve no locks or atomic operations.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_MEMORY_THREAD_LOCAL_BLOCK_POOL_H_
+#define LIB_VAC_INCLUDE_VAC_MEMORY_THREAD_LOCAL_BLOCK_POOL_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace vac {
+namespace memory {
+
+/*!
+ * \brief Granularity in which block sizes are rounded up, so that similar sized types share one pool.
+ */
+constexpr std::size_t kBlockSizeGranularity{64};
+
+/*!
+ * \brief Maximum number of batches the shared depot of a ThreadLocalBlockPool holds.
+ */
+constexpr std::size_t kBlockPoolDepotBatches{16};
+
+/*!
+ * \brief  Rounds a requested object size up to the next block size class.
+ * \param  size The requested size in bytes.
+ * \return The size of the block class that fits size.
+ */
+constexpr std::size_t BlockSizeClass(std::size_t size) noexcept {
+  return ((size + kBlockSizeGranularity) - 1U) & ~(kBlockSizeGranularity - 1U);
+}
+
+/*!
+ * \brief   Pool of fixed size memory blocks with a per-thread free list.
+ * \details Blocks may be returned by a different thread than the one that allocated them. At most
+ *          max_cached_blocks blocks are kept per thread. When a thread returns more, it moves a batch of half that
+ *          many blocks to a depot shared by all threads, from which threads with an empty list take a whole batch.
+ *          The depot holds at most kBlockPoolDepotBatches batches, further surplus goes back to the global heap.
+ *          Blocks are aligned to alignof(std::max_align_t).
+ * \tparam  block_size The size of each block in bytes.
+ * \tparam  max_cached_blocks The maximum number of free blocks kept per thread.
+ */
+template <std::size_t block_size, std::size_t max_cached_blocks = 64>
+class ThreadLocalBlockPool final {
+  /*!
+   * \brief Node type of the free list, placed inside unused blocks.
+   */
+  struct FreeBlock {
+    /*!
+     * \brief Next free block.
+     */
+    FreeBlock* next;
+
+    /*!
+     * \brief Next batch in the depot. Only valid for the first block of a batch stored there.
+     */
+    FreeBlock* next_batch;
+  };
+
+  static_assert(block_size >= sizeof(FreeBlock), "Blocks must be large enough to hold a free list node");
+
+ public:
+  /*!
+   * \brief The size of each block.
+   */
+  static constexpr std::size_t kBlockSize{block_size};
+
+  /*!
+   * \brief The number of blocks moved between a thread and the depot at once.
+   */
+  static constexpr std::size_t kBatchSize{(max_cached_blocks > 1U) ? (max_cached_blocks / 2U) : 1U};
+
+  /*!
+   * \brief  Hands out a block of kBlockSize bytes.
+   * \return Pointer to uninitialized memory.
+   * \throws std::bad_alloc if the global heap is exhausted.
+   */
+  static void* Allocate() {
+    FreeList& free_list{GetFreeList()};
+    if ((free_list.head == nullptr) && (!free_list.drained)) {
+      free_list.head = TakeBatch();
+      free_list.count = (free_list.head != nullptr) ? kBatchSize : 0U;
+    }
+    void* block{nullptr};
+    if (free_list.head != nullptr) {
+      FreeBlock* const head{free_list.head};
+      free_list.head = head->next;
+      --free_list.count;
+      block = head;
+    } else {
+      block = ::operator new(kBlockSize);
+    }
+    return block;
+  }
+
+  /*!
+   * \brief Returns a block to the pool.
+   * \param block A block previously obtained from Allocate(), possibly on another thread.
+   */
+  static void Deallocate(void* block) noexcept {
+    FreeList& free_list{GetFreeList()};
+    if (free_list.drained) {
+      ::operator delete(block);
+    } else {
+      FreeBlock* const node{::new (block) FreeBlock{free_list.head, nullptr}};
+      free_list.head = node;
+      ++free_list.count;
+      if (free_list.count > max_cached_blocks) {
+        GiveBatch(free_list);
+      }
+    }
+  }
+
+ private:
+  /*!
+   * \brief   Per-thread free list.
+   * \details Trivially destructible, so it stays accessible from other thread_local destructors.
+   */
+  struct FreeList {
+    /*!
+     * \brief First free block.
+     */
+    FreeBlock* head;
+    /*!
+     * \brief Number of free blocks.
+     */
+    std::size_t count;
+    /*!
+     * \brief Set once the owning thread exits; further blocks are released to the heap directly.
+     */
+    bool drained;
+  };
+
+  /*!
+   * \brief Batches of free blocks shared by all threads.
+   */
+  struct Depot {
+    /*!
+     * \brief Guards the batches.
+     */
+    std::mutex mutex;
+    /*!
+     * \brief First block of the first batch.
+     */
+    FreeBlock* batches;
+    /*!
+     * \brief Number of batches.
+     */
+    std::size_t batch_count;
+  };
+
+  /*!
+   * \brief Releases the cached blocks of a thread to the global heap on thread exit.
+   */
+  class Drainer final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param free_list The free list of the current thread.
+     */
+    explicit Drainer(FreeList& free_list) noexcept : free_list_(free_list) {}
+
+    Drainer(Drainer const&) = delete;
+    Drainer(Drainer&&) = delete;
+    Drainer& operator=(Drainer const&) & = delete;
+    Drainer& operator=(Drainer&&) & = delete;
+
+    /*!
+     * \brief Destructor. Releases all cached blocks.
+     */
+    ~Drainer() noexcept {
+      free_list_.drained = true;
+      ReleaseChain(free_list_.head);
+      free_list_.head = nullptr;
+      free_list_.count = 0;
+    }
+
+   private:
+    /*!
+     * \brief The free list to drain.
+     */
+    FreeList& free_list_;
+  };
+
+  /*!
+   * \brief  Takes a batch of kBatchSize blocks from the depot.
+   * \return The first block of the batch, or nullptr if the depot is empty.
+   */
+  static FreeBlock* TakeBatch() noexcept {
+    Depot& depot{GetDepot()};
+    std::lock_guard<std::mutex> const lock{depot.mutex};
+    FreeBlock* const batch{depot.batches};
+    if (batch != nullptr) {
+      depot.batches = batch->next_batch;
+      --depot.batch_count;
+    }
+    return batch;
+  }
+
+  /*!
+   * \brief Moves kBatchSize blocks from the front of a free list to the depot, or to the heap if the depot is full.
+   * \param free_list The free list of the calling thread, holding more than kBatchSize blocks.
+   */
+  static void GiveBatch(FreeList& free_list) noexcept {
+    FreeBlock* const batch{free_list.head};
+    FreeBlock* last{batch};
+    for (std::size_t i{1}; i < kBatchSize; ++i) {
+      last = last->next;
+    }
+    free_list.head = last->next;
+    free_list.count -= kBatchSize;
+    last->next = nullptr;
+
+    Depot& depot{GetDepot()};
+    bool stored{false};
+    {
+      std::lock_guard<std::mutex> const lock{depot.mutex};
+      if (depot.batch_count < kBlockPoolDepotBatches) {
+        batch->next_batch = depot.batches;
+        depot.batches = batch;
+        ++depot.batch_count;
+        stored = true;
+      }
+    }
+    if (!stored) {
+      ReleaseChain(batch);
+    }
+  }
+
+  /*!
+   * \brief Returns a chain of free blocks to the global heap.
+   * \param head The first block of the chain, may be nullptr.
+   */
+  static void ReleaseChain(FreeBlock* head) noexcept {
+    while (head != nullptr) {
+      FreeBlock* const next{head->next};
+      ::operator delete(head);
+      head = next;
+    }
+  }
+
+  /*!
+   * \brief  Returns the free list of the calling thread.
+   * \return The free list.
+   */
+  static FreeList& GetFreeList() noexcept {
+    static thread_local FreeList free_list{nullptr, 0, false};
+    static thread_local Drainer const drainer{free_list};
+    static_cast<void>(drainer);
+    return free_list;
+  }
+
+  /*!
+   * \brief   Returns the depot shared by all threads.
+   * \details Never destroyed, so threads exiting after the end of main() can still use it.
+   * \return  The depot.
+   */
+  static Depot& GetDepot() noexcept {
+    static Depot* const depot{new Depot{{}, nullptr, 0}};
+    return *depot;
+  }
+};
+
+/*!
+ * \brief The size of each block.
+ */
+template <std::size_t block_size, std::size_t max_cached_blocks>
+constexpr std::size_t ThreadLocalBlockPool<block_size, max_cached_blocks>::kBlockSize;
+
+/*!
+ * \brief The number of blocks moved between a thread and the depot at once.
+ */
+template <std::size_t block_size, std::size_t max_cached_blocks>
+constexpr std::size_t ThreadLocalBlockPool<block_size, max_cached_blocks>::kBatchSize;
+
+}  // namespace memory
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_MEMORY_THREAD_LOCAL_BLOCK_POOL_H_
@@ -0,0 +1,118 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  log_linear_buckets.h
+ *        \brief  Bucket layout of log-linear histograms.
+ *
+ *      \details  Shared by the metrics histograms and the latency histogram of the timer test harness, so that both
+ *                report the same percentiles for the same values.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_METRICS_LOG_LINEAR_BUCKETS_H_
+#define LIB_VAC_INCLUDE_VAC_METRICS_LOG_LINEAR_BUCKETS_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vac {
+namespace metrics {
+
+/*!
+ * \brief   Mapping of 64 bit values to log-linear buckets.
+ * \details Values below kSubBuckets are counted exactly, larger values in kSubBuckets buckets per power of two, i.e.
+ *          with a relative error below 1/kSubBuckets.
+ */
+class LogLinearBuckets final {
+ public:
+  /*!
+   * \brief Number of buckets per power of two.
+   */
+  static constexpr std::size_t kSubBuckets{16};
+
+  /*!
+   * \brief Number of bits to index a sub-bucket.
+   */
+  static constexpr std::uint64_t kSubBucketBits{4};
+
+  static_assert((std::uint64_t{1} << kSubBucketBits) == kSubBuckets, "kSubBucketBits must match kSubBuckets");
+
+  /*!
+   * \brief Total number of buckets.
+   */
+  static constexpr std::size_t kBuckets{(64 - kSubBucketBits + 1) * kSubBuckets};
+
+  /*!
+   * \brief  Determine the bucket of a value.
+   * \param  value The value.
+   * \return The bucket index.
+   */
+  static std::size_t ToBucket(std::uint64_t value) noexcept {
+    std::size_t index{static_cast<std::size_t>(value)};
+    if (value >= kSubBuckets) {
+      std::uint64_t const magnitude{static_cast<std::uint64_t>(63 - __builtin_clzll(value))};
+      std::uint64_t const shift{magnitude - kSubBucketBits};
+      std::uint64_t const sub{(value >> shift) & (kSubBuckets - 1)};
+      index = static_cast<std::size_t>(((shift + 1) * kSubBuckets) + sub);
+    }
+    return index;
+  }
+
+  /*!
+   * \brief  Determine the largest value counted in a bucket.
+   * \param  index The bucket index.
+   * \return The upper bound.
+   */
+  static std::uint64_t ToUpperBound(std::size_t index) noexcept {
+    std::uint64_t bound{static_cast<std::uint64_t>(index)};
+    if (index >= kSubBuckets) {
+      std::uint64_t const shift{(static_cast<std::uint64_t>(index) / kSubBuckets) - 1};
+      std::uint64_t const sub{static_cast<std::uint64_t>(index) % kSubBuckets};
+      std::uint64_t const lower{(kSubBuckets + sub) << shift};
+      bound = lower + ((std::uint64_t{1} << shift) - 1);
+    }
+    return bound;
+  }
+
+  /*!
+   * \brief  Determine the bucket below or at which the given fraction of the counted values lies.
+   * \tparam Buckets Indexable sequence of kBuckets counts.
+   * \param  buckets The number of values per bucket.
+   * \param  count The total number of values, not zero.
+   * \param  fraction The fraction in [0, 1], e.g. 0.99 for the 99th percentile.
+   * \return The upper bound of the bucket containing the percentile.
+   */
+  template <typename Buckets>
+  static std::uint64_t Percentile(Buckets const& buckets, std::uint64_t count, double fraction) noexcept {
+    double const clamped{std::min(std::max(fraction, 0.0), 1.0)};
+    std::uint64_t rank{static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count)))};
+    rank = std::max(rank, std::uint64_t{1});
+    std::uint64_t seen{0};
+    std::size_t index{0};
+    while ((index < kBuckets) && ((seen + buckets[index]) < rank)) {
+      seen += buckets[index];
+      ++index;
+    }
+    return ToUpperBound(index);
+  }
+};
+
+}  // namespace metrics
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_METRICS_LOG_LINEAR_BUCKETS_H_
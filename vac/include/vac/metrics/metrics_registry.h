@@ -0,0 +1,944 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  metrics_registry.h
+ *        \brief  Sharded per-thread counters, gauges and histograms.
+ *
+ *      \details  Every thread updates its own cache-line padded shard with plain loads and stores, so hot loops on
+ *                different cores never write to the same cache line. The shards are aggregated only when a snapshot is
+ *                taken, e.g. for export with vajson::writer::WriteMetrics().
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_METRICS_METRICS_REGISTRY_H_
+#define LIB_VAC_INCLUDE_VAC_METRICS_METRICS_REGISTRY_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "vac/language/cache_line.h"
+#include "vac/language/throw_or_terminate.h"
+#include "vac/metrics/log_linear_buckets.h"
+
+namespace vac {
+namespace metrics {
+
+/*!
+ * \brief Size of a cache line, the unit of false sharing.
+ */
+using vac::language::kCacheLineSize;
+
+/*!
+ * \brief Maximum number of counters in the registry.
+ */
+constexpr std::size_t kMaxCounters{256};
+
+/*!
+ * \brief Maximum number of gauges in the registry.
+ */
+constexpr std::size_t kMaxGauges{64};
+
+/*!
+ * \brief Maximum number of histograms in the registry.
+ */
+constexpr std::size_t kMaxHistograms{32};
+
+/*!
+ * \brief   Aggregated values of a log-linear histogram.
+ * \details The values are counted in the buckets of LogLinearBuckets.
+ */
+class HistogramSnapshot final {
+ public:
+  /*!
+   * \brief Constructor for an empty histogram.
+   */
+  HistogramSnapshot()
+      : buckets_(LogLinearBuckets::kBuckets, 0U),
+        count_(0),
+        sum_(0),
+        min_(std::numeric_limits<std::uint64_t>::max()),
+        max_(0) {}
+
+  /*!
+   * \brief Add values to a bucket.
+   * \param index The bucket index.
+   * \param count The number of values.
+   */
+  void AddBucket(std::size_t index, std::uint64_t count) noexcept { buckets_[index] += count; }
+
+  /*!
+   * \brief Add the summary of values recorded elsewhere.
+   * \param count The number of values.
+   * \param sum The sum of the values.
+   * \param min The smallest value.
+   * \param max The largest value.
+   */
+  void AddSummary(std::uint64_t count, std::uint64_t sum, std::uint64_t min, std::uint64_t max) noexcept {
+    if (count != 0U) {
+      count_ += count;
+      sum_ += sum;
+      min_ = std::min(min_, min);
+      max_ = std::max(max_, max);
+    }
+  }
+
+  /*!
+   * \brief Add all values of another histogram.
+   * \param other The other histogram.
+   */
+  void Merge(HistogramSnapshot const& other) noexcept {
+    for (std::size_t index{0}; index < LogLinearBuckets::kBuckets; ++index) {
+      buckets_[index] += other.buckets_[index];
+    }
+    AddSummary(other.count_, other.sum_, other.min_, other.max_);
+  }
+
+  /*!
+   * \brief  Number of recorded values.
+   * \return The count.
+   */
+  std::uint64_t Count() const noexcept { return count_; }
+
+  /*!
+   * \brief  Sum of the recorded values.
+   * \return The sum, wrapping around on overflow.
+   */
+  std::uint64_t Sum() const noexcept { return sum_; }
+
+  /*!
+   * \brief  Smallest recorded value.
+   * \return The minimum, or zero if the histogram is empty.
+   */
+  std::uint64_t Min() const noexcept { return (count_ == 0U) ? 0U : min_; }
+
+  /*!
+   * \brief  Largest recorded value.
+   * \return The maximum, or zero if the histogram is empty.
+   */
+  std::uint64_t Max() const noexcept { return max_; }
+
+  /*!
+   * \brief  Arithmetic mean of the recorded values.
+   * \return The mean, or zero if the histogram is empty.
+   */
+  std::uint64_t Mean() const noexcept { return (count_ == 0U) ? 0U : (sum_ / count_); }
+
+  /*!
+   * \brief  Determine the value below or at which the given fraction of the recorded values lies.
+   * \param  fraction The fraction in [0, 1], e.g. 0.99 for the 99th percentile.
+   * \return The upper bound of the bucket containing the percentile, limited to Max(). Zero if the histogram is empty.
+   */
+  std::uint64_t Percentile(double fraction) const noexcept {
+    std::uint64_t result{0};
+    if (count_ != 0U) {
+      result = std::min(LogLinearBuckets::Percentile(buckets_, count_, fraction), max_);
+    }
+    return result;
+  }
+
+ private:
+  /*!
+   * \brief Number of values per bucket.
+   */
+  std::vector<std::uint64_t> buckets_;
+
+  /*!
+   * \brief Number of values.
+   */
+  std::uint64_t count_;
+
+  /*!
+   * \brief Sum of the values.
+   */
+  std::uint64_t sum_;
+
+  /*!
+   * \brief Smallest value.
+   */
+  std::uint64_t min_;
+
+  /*!
+   * \brief Largest value.
+   */
+  std::uint64_t max_;
+};
+
+/*!
+ * \brief Aggregated value of a counter.
+ */
+struct CounterSample {
+  /*!
+   * \brief The name of the counter.
+   */
+  char const* name;
+
+  /*!
+   * \brief The sum over all threads.
+   */
+  std::uint64_t value;
+};
+
+/*!
+ * \brief Aggregated value of a gauge.
+ */
+struct GaugeSample {
+  /*!
+   * \brief The name of the gauge.
+   */
+  char const* name;
+
+  /*!
+   * \brief The sum of the changes over all threads.
+   */
+  std::int64_t value;
+};
+
+/*!
+ * \brief Aggregated values of a histogram.
+ */
+struct HistogramSample {
+  /*!
+   * \brief The name of the histogram.
+   */
+  char const* name;
+
+  /*!
+   * \brief The values of all threads.
+   */
+  HistogramSnapshot value;
+};
+
+/*!
+ * \brief All metrics aggregated at one point in time, each kind in order of registration.
+ */
+struct MetricsSnapshot {
+  /*!
+   * \brief The counters.
+   */
+  std::vector<CounterSample> counters;
+
+  /*!
+   * \brief The gauges.
+   */
+  std::vector<GaugeSample> gauges;
+
+  /*!
+   * \brief The histograms.
+   */
+  std::vector<HistogramSample> histograms;
+};
+
+namespace detail {
+
+/*!
+ * \brief Add to a value that is written by one thread only, without a read-modify-write operation.
+ * \param value The value.
+ * \param delta The summand.
+ */
+template <typename T>
+void AddOwned(std::atomic<T>& value, T delta) noexcept {
+  value.store(static_cast<T>(value.load(std::memory_order_relaxed) + delta), std::memory_order_relaxed);
+}
+
+/*!
+ * \brief The values one thread has recorded into a histogram. Written by that thread only.
+ */
+class HistogramShard final {
+ public:
+  /*!
+   * \brief Constructor.
+   */
+  HistogramShard() noexcept : buckets_(), count_(0), sum_(0), min_(std::numeric_limits<std::uint64_t>::max()), max_(0) {
+    for (std::atomic<std::uint64_t>& bucket : buckets_) {
+      bucket.store(0U, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Record a value. Must only be called by the owning thread.
+   * \param value The value.
+   */
+  void Record(std::uint64_t value) noexcept {
+    AddOwned(buckets_[LogLinearBuckets::ToBucket(value)], std::uint64_t{1});
+    AddOwned(count_, std::uint64_t{1});
+    AddOwned(sum_, value);
+    if (value < min_.load(std::memory_order_relaxed)) {
+      min_.store(value, std::memory_order_relaxed);
+    }
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Add the recorded values to a snapshot. Threadsafe.
+   * \param snapshot The snapshot.
+   */
+  void AddTo(HistogramSnapshot& snapshot) const noexcept {
+    for (std::size_t index{0}; index < LogLinearBuckets::kBuckets; ++index) {
+      std::uint64_t const count{buckets_[index].load(std::memory_order_relaxed)};
+      if (count != 0U) {
+        snapshot.AddBucket(index, count);
+      }
+    }
+    snapshot.AddSummary(count_.load(std::memory_order_relaxed), sum_.load(std::memory_order_relaxed),
+                        min_.load(std::memory_order_relaxed), max_.load(std::memory_order_relaxed));
+  }
+
+ private:
+  /*!
+   * \brief Number of values per bucket.
+   */
+  std::array<std::atomic<std::uint64_t>, LogLinearBuckets::kBuckets> buckets_;
+
+  /*!
+   * \brief Number of values.
+   */
+  std::atomic<std::uint64_t> count_;
+
+  /*!
+   * \brief Sum of the values.
+   */
+  std::atomic<std::uint64_t> sum_;
+
+  /*!
+   * \brief Smallest value.
+   */
+  std::atomic<std::uint64_t> min_;
+
+  /*!
+   * \brief Largest value.
+   */
+  std::atomic<std::uint64_t> max_;
+};
+
+/*!
+ * \brief   The metric values of one thread. Written by that thread only, read by snapshots.
+ * \details Padded by a cache line on both ends instead of over-aligned, which operator new does not support before
+ *          C++17, so that no other allocation shares a cache line with the values.
+ */
+class Shard final {
+ public:
+  /*!
+   * \brief Constructor for zero values.
+   */
+  Shard() noexcept : leading_padding_(), counters_(), gauges_(), histograms_(), trailing_padding_() { Reset(); }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  Shard(Shard const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  Shard& operator=(Shard const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  Shard(Shard&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  Shard& operator=(Shard&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~Shard() noexcept {
+    for (std::atomic<HistogramShard*>& histogram : histograms_) {
+      delete histogram.load(std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Add to a counter. Must only be called by the owning thread.
+   * \param index The index of the counter.
+   * \param value The summand.
+   */
+  void AddCounter(std::size_t index, std::uint64_t value) noexcept { AddOwned(counters_[index], value); }
+
+  /*!
+   * \brief Add to a gauge. Must only be called by the owning thread.
+   * \param index The index of the gauge.
+   * \param delta The summand.
+   */
+  void AddGauge(std::size_t index, std::int64_t delta) noexcept { AddOwned(gauges_[index], delta); }
+
+  /*!
+   * \brief Record a value into a histogram, allocating its storage on first use. Must only be called by the owning
+   *        thread.
+   * \param index The index of the histogram.
+   * \param value The value.
+   */
+  void RecordHistogram(std::size_t index, std::uint64_t value) {
+    HistogramShard* histogram{histograms_[index].load(std::memory_order_relaxed)};
+    if (histogram == nullptr) {
+      histogram = new HistogramShard();
+      histograms_[index].store(histogram, std::memory_order_release);
+    }
+    histogram->Record(value);
+  }
+
+  /*!
+   * \brief  Value of a counter. Threadsafe.
+   * \param  index The index of the counter.
+   * \return The value.
+   */
+  std::uint64_t GetCounter(std::size_t index) const noexcept {
+    return counters_[index].load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief  Value of a gauge. Threadsafe.
+   * \param  index The index of the gauge.
+   * \return The value.
+   */
+  std::int64_t GetGauge(std::size_t index) const noexcept { return gauges_[index].load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Add the values of a histogram to a snapshot. Threadsafe.
+   * \param index The index of the histogram.
+   * \param snapshot The snapshot.
+   */
+  void AddHistogramTo(std::size_t index, HistogramSnapshot& snapshot) const noexcept {
+    HistogramShard const* const histogram{histograms_[index].load(std::memory_order_acquire)};
+    if (histogram != nullptr) {
+      histogram->AddTo(snapshot);
+    }
+  }
+
+  /*!
+   * \brief Set all values to zero. Must not be called while the shard is owned by a thread.
+   */
+  void Reset() noexcept {
+    for (std::atomic<std::uint64_t>& counter : counters_) {
+      counter.store(0U, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::int64_t>& gauge : gauges_) {
+      gauge.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<HistogramShard*>& histogram : histograms_) {
+      delete histogram.exchange(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  /*!
+   * \brief Separates the values from the preceding allocation.
+   */
+  std::array<char, kCacheLineSize> leading_padding_;
+
+  /*!
+   * \brief The counter values of this thread.
+   */
+  std::array<std::atomic<std::uint64_t>, kMaxCounters> counters_;
+
+  /*!
+   * \brief The gauge changes of this thread.
+   */
+  std::array<std::atomic<std::int64_t>, kMaxGauges> gauges_;
+
+  /*!
+   * \brief The histograms of this thread, allocated on first use.
+   */
+  std::array<std::atomic<HistogramShard*>, kMaxHistograms> histograms_;
+
+  /*!
+   * \brief Separates the values from the following allocation.
+   */
+  std::array<char, kCacheLineSize> trailing_padding_;
+};
+
+}  // namespace detail
+
+/*!
+ * \brief Handle of a monotonic counter, summed over all threads.
+ */
+class Counter final {
+ public:
+  /*!
+   * \brief Constructor. Use MetricsRegistry::RegisterCounter() instead.
+   * \param index The index of the counter.
+   */
+  constexpr explicit Counter(std::uint32_t index) noexcept : index_(index) {}
+
+  /*!
+   * \brief Add to the counter of the calling thread.
+   * \param value The summand.
+   */
+  void Increment(std::uint64_t value = 1U) const;
+
+ private:
+  /*!
+   * \brief The index of the counter.
+   */
+  std::uint32_t index_;
+};
+
+/*!
+ * \brief   Handle of a gauge, e.g. a number of objects in use.
+ * \details The gauge is the sum of the changes made by all threads, so that e.g. an allocation in one thread and the
+ *          deallocation in another thread cancel out.
+ */
+class Gauge final {
+ public:
+  /*!
+   * \brief Constructor. Use MetricsRegistry::RegisterGauge() instead.
+   * \param index The index of the gauge.
+   */
+  constexpr explicit Gauge(std::uint32_t index) noexcept : index_(index) {}
+
+  /*!
+   * \brief Change the gauge.
+   * \param delta The change.
+   */
+  void Add(std::int64_t delta) const;
+
+ private:
+  /*!
+   * \brief The index of the gauge.
+   */
+  std::uint32_t index_;
+};
+
+/*!
+ * \brief Handle of a log-linear histogram, e.g. of durations in nanoseconds.
+ */
+class Histogram final {
+ public:
+  /*!
+   * \brief Constructor. Use MetricsRegistry::RegisterHistogram() instead.
+   * \param index The index of the histogram.
+   */
+  constexpr explicit Histogram(std::uint32_t index) noexcept : index_(index) {}
+
+  /*!
+   * \brief Record a value into the histogram of the calling thread.
+   * \param value The value.
+   */
+  void Record(std::uint64_t value) const;
+
+ private:
+  /*!
+   * \brief The index of the histogram.
+   */
+  std::uint32_t index_;
+};
+
+/*!
+ * \brief   Process-wide registry of named metrics.
+ * \details Registration takes a lock and is meant to happen once per call site, e.g. into a function-local static
+ *          handle as done by the VAC_METRICS_* macros. Updates through a handle touch only the shard of the calling
+ *          thread. The shard of an exiting thread is folded into the retired totals and reused by the next new thread.
+ */
+class MetricsRegistry final {
+ public:
+  /*!
+   * \brief  The process-wide registry.
+   * \return The registry.
+   */
+  static MetricsRegistry& Instance() {
+    static MetricsRegistry registry;
+    return registry;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  MetricsRegistry(MetricsRegistry const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  MetricsRegistry& operator=(MetricsRegistry const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  MetricsRegistry(MetricsRegistry&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  MetricsRegistry& operator=(MetricsRegistry&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~MetricsRegistry() = default;
+
+  /*!
+   * \brief  Register a counter, or look up the counter already registered under the name. Threadsafe.
+   * \param  name The name, a string with static storage duration.
+   * \return The handle.
+   * \throws std::length_error If kMaxCounters counters are registered already.
+   * \throws std::invalid_argument If the name is registered for another kind of metric.
+   */
+  Counter RegisterCounter(char const* name) { return Counter{Register(name, Kind::kCounter)}; }
+
+  /*!
+   * \brief  Register a gauge, or look up the gauge already registered under the name. Threadsafe.
+   * \param  name The name, a string with static storage duration.
+   * \return The handle.
+   * \throws std::length_error If kMaxGauges gauges are registered already.
+   * \throws std::invalid_argument If the name is registered for another kind of metric.
+   */
+  Gauge RegisterGauge(char const* name) { return Gauge{Register(name, Kind::kGauge)}; }
+
+  /*!
+   * \brief  Register a histogram, or look up the histogram already registered under the name. Threadsafe.
+   * \param  name The name, a string with static storage duration.
+   * \return The handle.
+   * \throws std::length_error If kMaxHistograms histograms are registered already.
+   * \throws std::invalid_argument If the name is registered for another kind of metric.
+   */
+  Histogram RegisterHistogram(char const* name) { return Histogram{Register(name, Kind::kHistogram)}; }
+
+  /*!
+   * \brief  Aggregate the values of all threads. Threadsafe.
+   * \details Values recorded concurrently may or may not be included.
+   * \return The snapshot.
+   */
+  MetricsSnapshot Snapshot() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    MetricsSnapshot snapshot{};
+    for (Descriptor const& descriptor : descriptors_) {
+      std::size_t const index{descriptor.index};
+      if (descriptor.kind == Kind::kCounter) {
+        std::uint64_t value{retired_.GetCounter(index)};
+        for (detail::Shard const* const shard : active_) {
+          value += shard->GetCounter(index);
+        }
+        snapshot.counters.push_back(CounterSample{descriptor.name, value});
+      } else if (descriptor.kind == Kind::kGauge) {
+        std::int64_t value{retired_.GetGauge(index)};
+        for (detail::Shard const* const shard : active_) {
+          value += shard->GetGauge(index);
+        }
+        snapshot.gauges.push_back(GaugeSample{descriptor.name, value});
+      } else {
+        HistogramSample sample{descriptor.name, retired_histograms_[index]};
+        for (detail::Shard const* const shard : active_) {
+          shard->AddHistogramTo(index, sample.value);
+        }
+        snapshot.histograms.push_back(std::move(sample));
+      }
+    }
+    return snapshot;
+  }
+
+  /*!
+   * \brief  The shard of the calling thread, acquired on first use.
+   * \return The shard.
+   */
+  detail::Shard& GetThreadShard() {
+    detail::Shard*& shard{ThreadShard()};
+    if (shard == nullptr) {
+      shard = &AcquireShard();
+    }
+    return *shard;
+  }
+
+ private:
+  /*!
+   * \brief Kinds of metrics.
+   */
+  enum class Kind : std::uint8_t { kCounter, kGauge, kHistogram };
+
+  /*!
+   * \brief A registered metric.
+   */
+  struct Descriptor {
+    /*!
+     * \brief The name.
+     */
+    char const* name;
+
+    /*!
+     * \brief The kind.
+     */
+    Kind kind;
+
+    /*!
+     * \brief The index among the metrics of its kind.
+     */
+    std::uint32_t index;
+  };
+
+  /*!
+   * \brief Returns the shard of the calling thread to the registry when the thread exits.
+   */
+  class ShardReleaser final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param registry The registry.
+     * \param shard The shard of the calling thread.
+     */
+    ShardReleaser(MetricsRegistry& registry, detail::Shard& shard) noexcept : registry_(registry), shard_(shard) {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    ShardReleaser(ShardReleaser const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    ShardReleaser& operator=(ShardReleaser const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    ShardReleaser(ShardReleaser&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    ShardReleaser& operator=(ShardReleaser&&) & = delete;
+
+    /*!
+     * \brief Destructor. Releases the shard.
+     */
+    ~ShardReleaser() noexcept {
+      ThreadShard() = nullptr;
+      registry_.ReleaseShard(shard_);
+    }
+
+   private:
+    /*!
+     * \brief The registry.
+     */
+    MetricsRegistry& registry_;
+
+    /*!
+     * \brief The shard of the thread.
+     */
+    detail::Shard& shard_;
+  };
+
+  /*!
+   * \brief Constructor.
+   */
+  MetricsRegistry()
+      : mutex_(),
+        descriptors_(),
+        sizes_(),
+        shards_(),
+        active_(),
+        free_(),
+        retired_(),
+        retired_histograms_(kMaxHistograms) {}
+
+  /*!
+   * \brief  The cached shard pointer of the calling thread.
+   * \return Reference to the pointer, nullptr if the thread has no shard.
+   */
+  static detail::Shard*& ThreadShard() noexcept {
+    thread_local detail::Shard* shard{nullptr};
+    return shard;
+  }
+
+  /*!
+   * \brief  Register a metric.
+   * \param  name The name.
+   * \param  kind The kind.
+   * \return The index among the metrics of the kind.
+   */
+  std::uint32_t Register(char const* name, Kind kind) {
+    constexpr std::array<std::size_t, 3> kLimits{{kMaxCounters, kMaxGauges, kMaxHistograms}};
+    std::size_t const kind_index{static_cast<std::size_t>(kind)};
+    std::lock_guard<std::mutex> const lock{mutex_};
+    std::vector<Descriptor>::const_iterator const it{
+        std::find_if(descriptors_.cbegin(), descriptors_.cend(),
+                     [name](Descriptor const& descriptor) { return std::strcmp(descriptor.name, name) == 0; })};
+    std::uint32_t index{0};
+    if (it != descriptors_.cend()) {
+      if (it->kind != kind) {
+        vac::language::ThrowOrTerminate<std::invalid_argument>("Metric name registered for another kind of metric");
+      }
+      index = it->index;
+    } else {
+      if (sizes_[kind_index] == kLimits[kind_index]) {
+        vac::language::ThrowOrTerminate<std::length_error>("Maximum number of metrics of this kind reached");
+      }
+      index = static_cast<std::uint32_t>(sizes_[kind_index]);
+      ++sizes_[kind_index];
+      descriptors_.push_back(Descriptor{name, kind, index});
+    }
+    return index;
+  }
+
+  /*!
+   * \brief  Assign a shard to the calling thread.
+   * \return The shard.
+   */
+  detail::Shard& AcquireShard() {
+    detail::Shard* shard{nullptr};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      if (free_.empty()) {
+        shards_.emplace_back(new detail::Shard());
+        shard = shards_.back().get();
+      } else {
+        shard = free_.back();
+        free_.pop_back();
+      }
+      active_.push_back(shard);
+    }
+    thread_local ShardReleaser const releaser{*this, *shard};
+    static_cast<void>(releaser);
+    return *shard;
+  }
+
+  /*!
+   * \brief Fold the values of an exiting thread into the retired totals and make its shard reusable.
+   * \param shard The shard of the thread.
+   */
+  void ReleaseShard(detail::Shard& shard) noexcept {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    for (Descriptor const& descriptor : descriptors_) {
+      std::size_t const index{descriptor.index};
+      if (descriptor.kind == Kind::kCounter) {
+        retired_.AddCounter(index, shard.GetCounter(index));
+      } else if (descriptor.kind == Kind::kGauge) {
+        retired_.AddGauge(index, shard.GetGauge(index));
+      } else {
+        shard.AddHistogramTo(index, retired_histograms_[index]);
+      }
+    }
+    shard.Reset();
+    active_.erase(std::find(active_.begin(), active_.end(), &shard));
+    free_.push_back(&shard);
+  }
+
+  /*!
+   * \brief Protects all members.
+   */
+  mutable std::mutex mutex_;
+
+  /*!
+   * \brief The registered metrics in order of registration.
+   */
+  std::vector<Descriptor> descriptors_;
+
+  /*!
+   * \brief Number of registered metrics per kind.
+   */
+  std::array<std::size_t, 3> sizes_;
+
+  /*!
+   * \brief All shards ever created.
+   */
+  std::vector<std::unique_ptr<detail::Shard>> shards_;
+
+  /*!
+   * \brief The shards owned by running threads.
+   */
+  std::vector<detail::Shard*> active_;
+
+  /*!
+   * \brief The shards of exited threads, reset to zero.
+   */
+  std::vector<detail::Shard*> free_;
+
+  /*!
+   * \brief Counter and gauge values of exited threads. Only written under the lock.
+   */
+  detail::Shard retired_;
+
+  /*!
+   * \brief Histogram values of exited threads.
+   */
+  std::vector<HistogramSnapshot> retired_histograms_;
+};
+
+inline void Counter::Increment(std::uint64_t value) const {
+  MetricsRegistry::Instance().GetThreadShard().AddCounter(index_, value);
+}
+
+inline void Gauge::Add(std::int64_t delta) const {
+  MetricsRegistry::Instance().GetThreadShard().AddGauge(index_, delta);
+}
+
+inline void Histogram::Record(std::uint64_t value) const {
+  MetricsRegistry::Instance().GetThreadShard().RecordHistogram(index_, value);
+}
+
+}  // namespace metrics
+}  // namespace vac
+
+#if defined(VAC_METRICS_ENABLED) && (VAC_METRICS_ENABLED != 0)
+/*!
+ * \brief Add to a counter registered once per call site. The name must be a string literal.
+ */
+#define VAC_METRICS_COUNTER_ADD(name, value)                                \
+  do {                                                                      \
+    static ::vac::metrics::Counter const vac_metrics_counter{               \
+        ::vac::metrics::MetricsRegistry::Instance().RegisterCounter(name)}; \
+    vac_metrics_counter.Increment(value);                                   \
+  } while (false)
+
+/*!
+ * \brief Change a gauge registered once per call site. The name must be a string literal.
+ */
+#define VAC_METRICS_GAUGE_ADD(name, delta)                                \
+  do {                                                                    \
+    static ::vac::metrics::Gauge const vac_metrics_gauge{                 \
+        ::vac::metrics::MetricsRegistry::Instance().RegisterGauge(name)}; \
+    vac_metrics_gauge.Add(delta);                                         \
+  } while (false)
+
+/*!
+ * \brief Record into a histogram registered once per call site. The name must be a string literal.
+ */
+#define VAC_METRICS_HISTOGRAM_RECORD(name, value)                             \
+  do {                                                                        \
+    static ::vac::metrics::Histogram const vac_metrics_histogram{             \
+        ::vac::metrics::MetricsRegistry::Instance().RegisterHistogram(name)}; \
+    vac_metrics_histogram.Record(value);                                      \
+  } while (false)
+#else
+/*!
+ * \brief Metrics disabled, see VAC_METRICS_ENABLED. The arguments are not evaluated.
+ */
+#define VAC_METRICS_COUNTER_ADD(name, value) static_cast<void>(0)
+
+/*!
+ * \brief Metrics disabled, see VAC_METRICS_ENABLED. The arguments are not evaluated.
+ */
+#define VAC_METRICS_GAUGE_ADD(name, delta) static_cast<void>(0)
+
+/*!
+ * \brief Metrics disabled, see VAC_METRICS_ENABLED. The arguments are not evaluated.
+ */
+#define VAC_METRICS_HISTOGRAM_RECORD(name, value) static_cast<void>(0)
+#endif
+
+#endif  // LIB_VAC_INCLUDE_VAC_METRICS_METRICS_REGISTRY_H_
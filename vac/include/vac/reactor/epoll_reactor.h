@@ -0,0 +1,590 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  epoll_reactor.h
+ *        \brief  Event loop based on epoll, timerfd and eventfd.
+ *
+ *      \details  Dispatches file descriptor events to registered handlers, drives a TimerManager through a timerfd
+ *                armed with absolute steady_clock deadlines and runs tasks posted from other threads.
+ *                Linux only.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_REACTOR_EPOLL_REACTOR_H_
+#define LIB_VAC_INCLUDE_VAC_REACTOR_EPOLL_REACTOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ara/core/posix_error_domain.h"
+#include "ara/core/result.h"
+#include "vac/sync/mpsc_queue.h"
+#include "vac/timer/timer_manager.h"
+#include "vac/timer/timer_reactor_interface.h"
+#include "vac/trace/trace.h"
+
+namespace vac {
+namespace reactor {
+
+/*!
+ * \brief   Single-threaded event loop on top of epoll.
+ * \details The thread that calls HandleEvents() or Run() is the reactor thread. Register(), Modify(), Unregister()
+ *          and SetTimerManager() must be called from the reactor thread, e.g. from a handler or a posted task.
+ *          Post(), Unblock() and Stop() may be called from any thread.
+ *          All file descriptor events returned by one epoll_wait() call are dispatched as one batch.
+ */
+class EpollReactor final : public vac::timer::TimerReactorInterface {
+ public:
+  /*!
+   * \brief Clock used for all deadlines. Matches the clock of vac::timer::Timer and CLOCK_MONOTONIC.
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /*!
+   * \brief Handler for file descriptor events. Called with the epoll event mask that occurred.
+   */
+  using EventHandler = std::function<void(std::uint32_t)>;
+
+  /*!
+   * \brief Task posted to the reactor thread.
+   */
+  using Task = std::function<void()>;
+
+  /*!
+   * \brief Default maximum number of events dispatched per epoll_wait() call.
+   */
+  static constexpr std::size_t kDefaultMaxEvents{64};
+
+  /*!
+   * \brief  Create a reactor.
+   * \param  max_events The maximum number of events dispatched per epoll_wait() call. Must be greater than 0.
+   * \return The reactor, or the PosixErrorDomain error of the failed system call.
+   */
+  static ara::core::Result<std::unique_ptr<EpollReactor>> Create(std::size_t max_events = kDefaultMaxEvents) {
+    using R = ara::core::Result<std::unique_ptr<EpollReactor>>;
+    R result{R::FromError(MakeError(EINVAL, "EpollReactor: max_events must not be 0"))};
+    if (max_events > 0) {
+      FileDescriptor epoll_fd{::epoll_create1(EPOLL_CLOEXEC)};
+      FileDescriptor event_fd{::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+      FileDescriptor timer_fd{::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)};
+      if ((!epoll_fd.IsValid()) || (!event_fd.IsValid()) || (!timer_fd.IsValid())) {
+        result = R::FromError(MakeError(errno, "EpollReactor: Creating file descriptors failed"));
+      } else if ((!AddInternal(epoll_fd.Get(), event_fd.Get(), kEventFdTag)) ||
+                 (!AddInternal(epoll_fd.Get(), timer_fd.Get(), kTimerFdTag))) {
+        result = R::FromError(MakeError(errno, "EpollReactor: epoll_ctl failed"));
+      } else {
+        result = R::FromValue(std::unique_ptr<EpollReactor>{
+            new EpollReactor(std::move(epoll_fd), std::move(event_fd), std::move(timer_fd), max_events)});
+      }
+    }
+    return result;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  EpollReactor(EpollReactor const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  EpollReactor(EpollReactor&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  EpollReactor& operator=(EpollReactor const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  EpollReactor& operator=(EpollReactor&&) & = delete;
+
+  /*!
+   * \brief Destructor. Posted tasks that have not been run are discarded.
+   */
+  ~EpollReactor() override {
+    for (TaskNode* node{tasks_.Pop()}; node != nullptr; node = tasks_.Pop()) {
+      delete node;
+    }
+  }
+
+  /*!
+   * \brief Set the timer manager driven by this reactor.
+   * \param timer_manager The timer manager, or nullptr. It must have been constructed with this reactor.
+   */
+  void SetTimerManager(vac::timer::TimerManager* timer_manager) noexcept {
+    timer_manager_ = timer_manager;
+    armed_deadline_ = Clock::time_point::max();
+  }
+
+  /*!
+   * \brief  Register a handler for events on a file descriptor.
+   * \param  fd The file descriptor. It is not owned by the reactor.
+   * \param  events The epoll event mask to wait for, e.g. EPOLLIN.
+   * \param  handler The handler. It may register, modify or unregister any file descriptor, including its own.
+   * \return Nothing, or the PosixErrorDomain error of epoll_ctl.
+   */
+  ara::core::Result<void> Register(int fd, std::uint32_t events, EventHandler handler) {
+    std::uint32_t const generation{++generation_};
+    ara::core::Result<void> result{Control(EPOLL_CTL_ADD, fd, events, generation)};
+    if (result.HasValue()) {
+      registrations_[fd] = std::unique_ptr<Registration>{new Registration{std::move(handler), generation}};
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Change the events waited for on a registered file descriptor.
+   * \param  fd The file descriptor.
+   * \param  events The new epoll event mask.
+   * \return Nothing, or the PosixErrorDomain error of epoll_ctl.
+   */
+  ara::core::Result<void> Modify(int fd, std::uint32_t events) {
+    ara::core::Result<void> result{ara::core::Result<void>::FromError(MakeError(ENOENT, "EpollReactor: Unknown fd"))};
+    RegistrationMap::iterator const it{registrations_.find(fd)};
+    if (it != registrations_.end()) {
+      result = Control(EPOLL_CTL_MOD, fd, events, it->second->generation);
+    }
+    return result;
+  }
+
+  /*!
+   * \brief   Unregister a file descriptor.
+   * \details Pending events of the current batch are no longer dispatched for it. Must be called before the file
+   *          descriptor is closed.
+   * \param   fd The file descriptor.
+   * \return  Nothing, or the PosixErrorDomain error of epoll_ctl.
+   */
+  ara::core::Result<void> Unregister(int fd) {
+    ara::core::Result<void> result{ara::core::Result<void>::FromError(MakeError(ENOENT, "EpollReactor: Unknown fd"))};
+    RegistrationMap::iterator const it{registrations_.find(fd)};
+    if (it != registrations_.end()) {
+      result = Control(EPOLL_CTL_DEL, fd, 0, 0);
+      // The handler may be running; it is destroyed after the current batch.
+      retired_.push_back(std::move(it->second));
+      static_cast<void>(registrations_.erase(it));
+    }
+    return result;
+  }
+
+  /*!
+   * \brief   Run a task on the reactor thread.
+   * \details Threadsafe and lock-free apart from the allocation of the task. The task is run in the next iteration of
+   *          the event loop, in the order of posting per thread.
+   * \param   task The task.
+   */
+  void Post(Task task) {
+    tasks_.Push(*new TaskNode{std::move(task)});
+    Unblock();
+  }
+
+  /*!
+   * \brief   Wake up the reactor thread so that it recomputes the timer deadline and runs posted tasks.
+   * \details Threadsafe. Wake-ups are coalesced until the reactor thread has observed them.
+   */
+  void Unblock() override {
+    if (!wakeup_pending_.exchange(true, std::memory_order_seq_cst)) {
+      std::uint64_t const one{1};
+      static_cast<void>(::write(event_fd_.Get(), &one, sizeof(one)));
+    }
+  }
+
+  /*!
+   * \brief   Make Run() return after the current iteration. Threadsafe.
+   * \details If Run() is not running, the next call of Run() returns after its first iteration.
+   */
+  void Stop() {
+    stopped_.store(true, std::memory_order_release);
+    Unblock();
+  }
+
+  /*!
+   * \brief  Run the event loop until Stop() is called.
+   * \return Nothing, or the PosixErrorDomain error of a failed system call.
+   */
+  ara::core::Result<void> Run() {
+    ara::core::Result<void> result{ara::core::Result<void>::FromValue()};
+    bool stopped{false};
+    while (result.HasValue() && (!stopped)) {
+      result = HandleEvents(Clock::time_point::max());
+      stopped = stopped_.exchange(false, std::memory_order_acq_rel);
+    }
+    return result;
+  }
+
+  /*!
+   * \brief   Run one iteration of the event loop.
+   * \details Runs the posted tasks, arms the timerfd with the earlier of the next timer expiry and wait_until, waits
+   *          for events and dispatches them, and fires expired timers.
+   * \param   wait_until The latest point in time to return at if no event occurs. Clock::time_point::max() waits
+   *          without limit.
+   * \return  Nothing, or the PosixErrorDomain error of a failed system call.
+   */
+  ara::core::Result<void> HandleEvents(Clock::time_point wait_until) {
+    RunTasks();
+    ara::core::Result<void> result{ArmTimer(wait_until)};
+    if (result.HasValue()) {
+      int const count{::epoll_wait(epoll_fd_.Get(), events_.data(), static_cast<int>(events_.size()), -1)};
+      if (count < 0) {
+        if (errno != EINTR) {
+          result = ara::core::Result<void>::FromError(MakeError(errno, "EpollReactor: epoll_wait failed"));
+        }
+      } else {
+        Dispatch(static_cast<std::size_t>(count));
+      }
+    }
+    return result;
+  }
+
+ private:
+  /*!
+   * \brief Owner of a file descriptor.
+   */
+  class FileDescriptor final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param fd The file descriptor to own, or a negative value.
+     */
+    explicit FileDescriptor(int fd) noexcept : fd_(fd) {}
+
+    /*!
+     * \brief Move constructor.
+     * \param other The owner to take the file descriptor from.
+     */
+    FileDescriptor(FileDescriptor&& other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+
+    /*!
+     * \brief Copy constructor.
+     */
+    FileDescriptor(FileDescriptor const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    FileDescriptor& operator=(FileDescriptor const&) & = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    FileDescriptor& operator=(FileDescriptor&&) & = delete;
+
+    /*!
+     * \brief Destructor. Closes the file descriptor.
+     */
+    ~FileDescriptor() {
+      if (IsValid()) {
+        static_cast<void>(::close(fd_));
+      }
+    }
+
+    /*!
+     * \brief  Get the file descriptor.
+     * \return The file descriptor.
+     */
+    int Get() const noexcept { return fd_; }
+
+    /*!
+     * \brief  Determine whether a file descriptor is owned.
+     * \return True if the file descriptor is valid, false otherwise.
+     */
+    bool IsValid() const noexcept { return fd_ >= 0; }
+
+   private:
+    /*!
+     * \brief The file descriptor.
+     */
+    int fd_;
+  };
+
+  /*!
+   * \brief A registered file descriptor.
+   */
+  struct Registration {
+    /*!
+     * \brief The handler.
+     */
+    EventHandler handler;
+
+    /*!
+     * \brief Distinguishes registrations of reused file descriptor numbers.
+     */
+    std::uint32_t generation;
+  };
+
+  /*!
+   * \brief A posted task.
+   */
+  class TaskNode final : public vac::sync::MpscQueueNode {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param task The task.
+     */
+    explicit TaskNode(Task&& task) : vac::sync::MpscQueueNode(), task_(std::move(task)) {}
+
+    /*!
+     * \brief The task.
+     */
+    Task task_;
+  };
+
+  /*!
+   * \brief Type of the map of registered file descriptors.
+   */
+  using RegistrationMap = std::unordered_map<int, std::unique_ptr<Registration>>;
+
+  /*!
+   * \brief Event tag of the eventfd.
+   */
+  static constexpr std::uint64_t kEventFdTag{0xFFFFFFFFFFFFFFFFU};
+
+  /*!
+   * \brief Event tag of the timerfd.
+   */
+  static constexpr std::uint64_t kTimerFdTag{0xFFFFFFFFFFFFFFFEU};
+
+  /*!
+   * \brief Constructor.
+   * \param epoll_fd The epoll instance.
+   * \param event_fd The eventfd used for wake-ups, registered with epoll_fd.
+   * \param timer_fd The timerfd used for deadlines, registered with epoll_fd.
+   * \param max_events The maximum number of events dispatched per epoll_wait() call.
+   */
+  EpollReactor(FileDescriptor&& epoll_fd, FileDescriptor&& event_fd, FileDescriptor&& timer_fd,
+               std::size_t max_events)
+      : vac::timer::TimerReactorInterface(),
+        epoll_fd_(std::move(epoll_fd)),
+        event_fd_(std::move(event_fd)),
+        timer_fd_(std::move(timer_fd)),
+        events_(max_events),
+        registrations_(),
+        retired_(),
+        generation_(0),
+        timer_manager_(nullptr),
+        armed_deadline_(Clock::time_point::max()),
+        tasks_(),
+        wakeup_pending_(false),
+        stopped_(false) {}
+
+  /*!
+   * \brief  Create a PosixErrorDomain error code.
+   * \param  error The errno value.
+   * \param  message The user message.
+   * \return The error code.
+   */
+  static ara::core::ErrorCode MakeError(int error, char const* message) noexcept {
+    return ara::core::MakeErrorCode(static_cast<ara::core::PosixErrc>(error), 0, message);
+  }
+
+  /*!
+   * \brief  Add an internal file descriptor to an epoll instance.
+   * \param  epoll_fd The epoll instance.
+   * \param  fd The file descriptor.
+   * \param  tag The event tag.
+   * \return True on success, false otherwise.
+   */
+  static bool AddInternal(int epoll_fd, int fd, std::uint64_t tag) noexcept {
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = tag;
+    return ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+  }
+
+  /*!
+   * \brief  Issue epoll_ctl for a registered file descriptor.
+   * \param  op The epoll_ctl operation.
+   * \param  fd The file descriptor.
+   * \param  events The event mask.
+   * \param  generation The generation of the registration.
+   * \return Nothing, or the PosixErrorDomain error of epoll_ctl.
+   */
+  ara::core::Result<void> Control(int op, int fd, std::uint32_t events, std::uint32_t generation) noexcept {
+    struct epoll_event event {};
+    event.events = events;
+    event.data.u64 = (static_cast<std::uint64_t>(generation) << 32U) | static_cast<std::uint32_t>(fd);
+    ara::core::Result<void> result{ara::core::Result<void>::FromValue()};
+    if (::epoll_ctl(epoll_fd_.Get(), op, fd, &event) != 0) {
+      result = ara::core::Result<void>::FromError(MakeError(errno, "EpollReactor: epoll_ctl failed"));
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Arm the timerfd with the earlier of the next timer expiry and the given point in time.
+   * \param  wait_until The latest point in time to wake up at.
+   * \return Nothing, or the PosixErrorDomain error of timerfd_settime.
+   */
+  ara::core::Result<void> ArmTimer(Clock::time_point wait_until) {
+    Clock::time_point deadline{wait_until};
+    if (timer_manager_ != nullptr) {
+      std::pair<bool, struct timeval> const next{timer_manager_->GetNextExpiry()};
+      if (next.first) {
+        Clock::time_point const expiry{Clock::now() + std::chrono::seconds{next.second.tv_sec} +
+                                       std::chrono::microseconds{next.second.tv_usec}};
+        if (expiry < deadline) {
+          deadline = expiry;
+        }
+      }
+    }
+    ara::core::Result<void> result{ara::core::Result<void>::FromValue()};
+    if (deadline != armed_deadline_) {
+      struct itimerspec spec {};
+      if (deadline != Clock::time_point::max()) {
+        std::chrono::nanoseconds const since_epoch{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch())};
+        std::chrono::seconds const seconds{std::chrono::duration_cast<std::chrono::seconds>(since_epoch)};
+        spec.it_value.tv_sec = static_cast<std::time_t>(seconds.count());
+        spec.it_value.tv_nsec = static_cast<long>((since_epoch - seconds).count());
+        if ((spec.it_value.tv_sec == 0) && (spec.it_value.tv_nsec == 0)) {
+          // A zero value would disarm the timer.
+          spec.it_value.tv_nsec = 1;
+        }
+      }
+      if (::timerfd_settime(timer_fd_.Get(), TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+        armed_deadline_ = deadline;
+      } else {
+        result = ara::core::Result<void>::FromError(MakeError(errno, "EpollReactor: timerfd_settime failed"));
+      }
+    }
+    return result;
+  }
+
+  /*!
+   * \brief Dispatch a batch of events.
+   * \param count The number of events returned by epoll_wait().
+   */
+  void Dispatch(std::size_t count) {
+    bool timer_expired{false};
+    for (std::size_t index{0}; index < count; ++index) {
+      struct epoll_event const& event{events_[index]};
+      if (event.data.u64 == kEventFdTag) {
+        std::uint64_t value{0};
+        wakeup_pending_.store(false, std::memory_order_seq_cst);
+        static_cast<void>(::read(event_fd_.Get(), &value, sizeof(value)));
+      } else if (event.data.u64 == kTimerFdTag) {
+        std::uint64_t expirations{0};
+        static_cast<void>(::read(timer_fd_.Get(), &expirations, sizeof(expirations)));
+        armed_deadline_ = Clock::time_point::max();
+        timer_expired = true;
+      } else {
+        int const fd{static_cast<int>(static_cast<std::uint32_t>(event.data.u64))};
+        std::uint32_t const generation{static_cast<std::uint32_t>(event.data.u64 >> 32U)};
+        RegistrationMap::iterator const it{registrations_.find(fd)};
+        if ((it != registrations_.end()) && (it->second->generation == generation)) {
+          Registration& registration{*it->second};
+          registration.handler(event.events);
+        }
+      }
+    }
+    retired_.clear();
+    if (timer_expired && (timer_manager_ != nullptr)) {
+      VAC_TRACE_SCOPE("vac::timer::TimerManager::HandleTimerExpiry");
+      timer_manager_->HandleTimerExpiry();
+    }
+    RunTasks();
+  }
+
+  /*!
+   * \brief Run all posted tasks in the order they have been posted.
+   */
+  void RunTasks() {
+    for (TaskNode* node{tasks_.Pop()}; node != nullptr; node = tasks_.Pop()) {
+      std::unique_ptr<TaskNode> const owner{node};
+      owner->task_();
+    }
+  }
+
+  /*!
+   * \brief The epoll instance.
+   */
+  FileDescriptor epoll_fd_;
+
+  /*!
+   * \brief The eventfd used for wake-ups.
+   */
+  FileDescriptor event_fd_;
+
+  /*!
+   * \brief The timerfd used for deadlines.
+   */
+  FileDescriptor timer_fd_;
+
+  /*!
+   * \brief Buffer for the events of one epoll_wait() call.
+   */
+  std::vector<struct epoll_event> events_;
+
+  /*!
+   * \brief The registered file descriptors.
+   */
+  RegistrationMap registrations_;
+
+  /*!
+   * \brief Registrations removed during the current batch.
+   */
+  std::vector<std::unique_ptr<Registration>> retired_;
+
+  /*!
+   * \brief Generation of the most recent registration.
+   */
+  std::uint32_t generation_;
+
+  /*!
+   * \brief The timer manager driven by this reactor.
+   */
+  vac::timer::TimerManager* timer_manager_;
+
+  /*!
+   * \brief The deadline the timerfd is armed with, Clock::time_point::max() if disarmed.
+   */
+  Clock::time_point armed_deadline_;
+
+  /*!
+   * \brief Tasks posted to the reactor thread.
+   */
+  vac::sync::MpscQueue<TaskNode> tasks_;
+
+  /*!
+   * \brief Set while a wake-up has been signaled that the reactor thread has not observed yet.
+   */
+  std::atomic<bool> wakeup_pending_;
+
+  /*!
+   * \brief Set by Stop().
+   */
+  std::atomic<bool> stopped_;
+};
+
+}  // namespace reactor
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_REACTOR_EPOLL_REACTOR_H_
@@ -0,0 +1,402 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  state_machine_driver.h
+ *        \brief  Run-to-completion driver for many state machine instances.
+ *
+ *      \details  Events are posted to per-instance lock-free mailboxes from any thread and handled on an Executor,
+ *                e.g. a ThreadPoolExecutor. The events of one instance are handled one at a time in posting order,
+ *                the events of different instances in parallel.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATE_MACHINE_DRIVER_H_
+#define LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATE_MACHINE_DRIVER_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "vac/memory/thread_local_block_pool.h"
+#include "vac/sync/mpsc_queue.h"
+#include "vac/threadpool/executor.h"
+
+namespace vac {
+namespace statemachine {
+
+/*!
+ * \brief   Owns state machine instances and feeds them with events on an Executor.
+ * \details An instance is scheduled on the executor when the first event arrives in its empty mailbox, and then handles
+ *          events until the mailbox is empty or batch_size events have been handled, after which it is rescheduled
+ *          to give other instances a turn. Serialization per instance is achieved with one atomic flag, no lock is
+ *          taken. The handler of an event may post further events, also to its own instance.
+ *          If HandleEvent() throws, the event is discarded, the instance is rescheduled if further events are queued,
+ *          and the exception propagates out of the task into the executor. Tasks run by a ThreadPoolExecutor must not
+ *          throw, so handlers used with it must not throw either.
+ * \tparam  Instance The state machine instance, e.g. a class owning a StateOwner or StaticStateMachine. It must provide
+ *          void HandleEvent(Event& event).
+ * \tparam  Event The event type. Must be move constructible.
+ */
+template <typename Instance, typename Event>
+class StateMachineDriver final {
+ public:
+  /*!
+   * \brief Identifier of an instance, assigned in order of creation starting with 0.
+   */
+  using InstanceId = std::size_t;
+
+  /*!
+   * \brief Default number of events an instance handles before it is rescheduled.
+   */
+  static constexpr std::size_t kDefaultBatchSize{32};
+
+  /*!
+   * \brief Constructor.
+   * \param executor The executor the events are handled on. Must outlive the driver and run every task it accepts.
+   * \param batch_size The number of events an instance handles before it is rescheduled. At least 1.
+   */
+  explicit StateMachineDriver(vac::threadpool::Executor& executor, std::size_t batch_size = kDefaultBatchSize)
+      : executor_(executor), batch_size_((batch_size > 0U) ? batch_size : 1U), slots_(), scheduled_tasks_(0) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  StateMachineDriver(StateMachineDriver const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  StateMachineDriver& operator=(StateMachineDriver const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  StateMachineDriver(StateMachineDriver&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  StateMachineDriver& operator=(StateMachineDriver&&) & = delete;
+
+  /*!
+   * \brief   Destructor.
+   * \details Blocks until all scheduled instances have run, then discards the events that are still queued. No event
+   *          must be posted concurrently.
+   */
+  ~StateMachineDriver() {
+    while (scheduled_tasks_.load(std::memory_order_acquire) != 0U) {
+      std::this_thread::yield();
+    }
+    for (Slot& slot : slots_) {
+      for (EventNode* node{slot.mailbox_.Pop()}; node != nullptr; node = slot.mailbox_.Pop()) {
+        Dispose(node);
+      }
+    }
+  }
+
+  /*!
+   * \brief   Create a new instance.
+   * \details Not threadsafe: must not be called concurrently with any other method.
+   * \param   args Arguments to construct the instance.
+   * \return  The identifier of the new instance.
+   */
+  template <typename... Args>
+  InstanceId EmplaceInstance(Args&&... args) {
+    slots_.emplace_back(std::forward<Args>(args)...);
+    return slots_.size() - 1U;
+  }
+
+  /*!
+   * \brief  Number of instances.
+   * \return The number of instances.
+   */
+  std::size_t size() const noexcept { return slots_.size(); }
+
+  /*!
+   * \brief   Post an event to an instance.
+   * \details Threadsafe and lock-free, except for the allocation of the event from a per-thread pool and the call of
+   *          Executor::Execute() if the instance was idle. Handled events are returned to the pool of the posting
+   *          thread through the depot of the pool, so steady posting does not allocate from the heap.
+   * \param   id The identifier of the instance.
+   * \param   event The event.
+   */
+  void Post(InstanceId id, Event event) {
+    Slot& slot{slots_[id]};
+    EventNode* const node{CreateNode(std::move(event))};
+    std::size_t const depth{slot.depth_.fetch_add(1, std::memory_order_seq_cst) + 1U};
+    std::size_t max_depth{slot.max_depth_.load(std::memory_order_relaxed)};
+    while ((depth > max_depth) &&
+           (!slot.max_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed))) {
+    }
+    slot.mailbox_.Push(*node);
+    if (!slot.scheduled_.exchange(true, std::memory_order_acq_rel)) {
+      Schedule(slot);
+    }
+  }
+
+  /*!
+   * \brief   Number of events posted to an instance and not yet handled completely. Threadsafe.
+   * \param   id The identifier of the instance.
+   * \return  The queue depth.
+   */
+  std::size_t GetQueueDepth(InstanceId id) const noexcept {
+    return slots_[id].depth_.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief  Highest queue depth an instance has reached. Threadsafe.
+   * \param  id The identifier of the instance.
+   * \return The high-water mark of the queue depth.
+   */
+  std::size_t GetMaxQueueDepth(InstanceId id) const noexcept {
+    return slots_[id].max_depth_.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief   Access an instance.
+   * \details The instance may be handling an event concurrently. Access must be synchronized by the caller, e.g. by
+   *          posting an event instead.
+   * \param   id The identifier of the instance.
+   * \return  The instance.
+   */
+  Instance& GetInstance(InstanceId id) noexcept { return slots_[id].instance_; }
+
+ private:
+  /*!
+   * \brief A queued event.
+   */
+  class EventNode final : public vac::sync::MpscQueueNode {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param event The event.
+     */
+    explicit EventNode(Event&& event) : vac::sync::MpscQueueNode(), event_(std::move(event)) {}
+
+    /*!
+     * \brief Destructor.
+     */
+    ~EventNode() = default;
+
+    /*!
+     * \brief Copy constructor.
+     */
+    EventNode(EventNode const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    EventNode& operator=(EventNode const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    EventNode(EventNode&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    EventNode& operator=(EventNode&&) & = delete;
+
+    /*!
+     * \brief The event.
+     */
+    Event event_;
+  };
+
+  /*!
+   * \brief Pool the events are allocated from.
+   */
+  using EventPool = vac::memory::ThreadLocalBlockPool<vac::memory::BlockSizeClass(sizeof(EventNode))>;
+
+  /*!
+   * \brief An instance with its mailbox.
+   */
+  class Slot final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param args Arguments to construct the instance.
+     */
+    template <typename... Args>
+    explicit Slot(Args&&... args)
+        : instance_(std::forward<Args>(args)...), mailbox_(), depth_(0), max_depth_(0), scheduled_(false) {}
+
+    /*!
+     * \brief The instance.
+     */
+    Instance instance_;
+
+    /*!
+     * \brief The queued events.
+     */
+    vac::sync::MpscQueue<EventNode> mailbox_;
+
+    /*!
+     * \brief Number of events posted and not yet handled completely.
+     */
+    std::atomic<std::size_t> depth_;
+
+    /*!
+     * \brief Highest value depth_ has reached.
+     */
+    std::atomic<std::size_t> max_depth_;
+
+    /*!
+     * \brief Whether the instance is scheduled on the executor. Only the scheduled task consumes the mailbox.
+     */
+    std::atomic<bool> scheduled_;
+  };
+
+  /* VECTOR Next Construct AutosarC++17_10-A15.3.4: MD_VAC_A15.3.4_useOfCatch */
+  /*!
+   * \brief  Create a queued event from the pool.
+   * \param  event The event.
+   * \return The queued event.
+   */
+  static EventNode* CreateNode(Event&& event) {
+    void* const block{EventPool::Allocate()};
+    EventNode* node{nullptr};
+    try {
+      node = ::new (block) EventNode(std::move(event));
+    } catch (...) {
+      EventPool::Deallocate(block);
+      throw;
+    }
+    return node;
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A15.3.4: MD_VAC_A15.3.4_useOfCatch */
+  /*!
+   * \brief Schedule an instance on the executor. The caller has set its scheduled_ flag.
+   * \param slot The instance.
+   */
+  void Schedule(Slot& slot) {
+    static_cast<void>(scheduled_tasks_.fetch_add(1, std::memory_order_relaxed));
+    executor_.Execute([this, &slot]() {
+      try {
+        Drain(slot);
+      } catch (...) {
+        static_cast<void>(scheduled_tasks_.fetch_sub(1, std::memory_order_release));
+        throw;
+      }
+      static_cast<void>(scheduled_tasks_.fetch_sub(1, std::memory_order_release));
+    });
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A15.3.4: MD_VAC_A15.3.4_useOfCatch */
+  /*!
+   * \brief   Handle the queued events of a scheduled instance.
+   * \details If a handler throws, the event is discarded and the instance is released before the exception
+   *          propagates, so that the remaining events are handled by a new task.
+   * \param   slot The instance.
+   */
+  void Drain(Slot& slot) {
+    std::size_t handled{0};
+    bool reschedule{false};
+    bool done{false};
+    while (!done) {
+      EventNode* const node{slot.mailbox_.Pop()};
+      if (node != nullptr) {
+        try {
+          slot.instance_.HandleEvent(node->event_);
+        } catch (...) {
+          Complete(slot, node);
+          if (Release(slot)) {
+            Schedule(slot);
+          }
+          throw;
+        }
+        Complete(slot, node);
+        ++handled;
+        if (handled == batch_size_) {
+          reschedule = true;
+          done = true;
+        }
+      } else {
+        reschedule = Release(slot);
+        done = true;
+      }
+    }
+    if (reschedule) {
+      Schedule(slot);
+    }
+  }
+
+  /*!
+   * \brief Discard a handled event and account for it in the queue depth.
+   * \param slot The instance.
+   * \param node The event.
+   */
+  static void Complete(Slot& slot, EventNode* node) noexcept {
+    Dispose(node);
+    static_cast<void>(slot.depth_.fetch_sub(1, std::memory_order_seq_cst));
+  }
+
+  /*!
+   * \brief   Clear the scheduled_ flag of an instance whose task stops handling events.
+   * \details Pairs with Post(): either the posting thread sees the cleared scheduled_ flag and schedules the instance,
+   *          or this task sees the event in the mailbox and keeps the instance scheduled. The mailbox is checked
+   *          rather than depth_, which is incremented before the event is pushed: a task that found the mailbox
+   *          empty would otherwise reschedule itself until the posting thread has pushed the event.
+   * \param   slot The instance.
+   * \return  True if events are queued and the caller has set the scheduled_ flag again, so it must schedule the
+   *          instance.
+   */
+  static bool Release(Slot& slot) noexcept {
+    slot.scheduled_.store(false, std::memory_order_seq_cst);
+    // An event posted after the mailbox has been found empty may not have seen the cleared flag.
+    return slot.mailbox_.MaybeNonEmpty() &&
+           (!slot.scheduled_.exchange(true, std::memory_order_acq_rel));
+  }
+
+  /*!
+   * \brief Destroy an event and return its memory to the pool.
+   * \param node The event.
+   */
+  static void Dispose(EventNode* node) noexcept {
+    node->~EventNode();
+    EventPool::Deallocate(node);
+  }
+
+  /*!
+   * \brief The executor the events are handled on.
+   */
+  vac::threadpool::Executor& executor_;
+
+  /*!
+   * \brief The number of events an instance handles before it is rescheduled.
+   */
+  std::size_t const batch_size_;
+
+  /*!
+   * \brief The instances. A deque keeps their addresses stable.
+   */
+  std::deque<Slot> slots_;
+
+  /*!
+   * \brief The number of tasks passed to the executor that have not completed yet.
+   */
+  std::atomic<std::size_t> scheduled_tasks_;
+};
+
+}  // namespace statemachine
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATE_MACHINE_DRIVER_H_
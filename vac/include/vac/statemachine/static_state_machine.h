@@ -0,0 +1,447 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  static_state_machine.h
+ *        \brief  State machine with compile-time states and transition table.
+ *
+ *      \details  Alternative to State/StatePool/StateOwner without virtual functions and without heap memory. The
+ *                states are types, the valid transitions are a constexpr matrix, and entering and leaving a state
+ *                dispatches through a switch over the state index that the compiler can inline.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATIC_STATE_MACHINE_H_
+#define LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATIC_STATE_MACHINE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vac/language/cpp14_backport.h"
+#include "vac/language/cpp17_backport.h"
+
+namespace vac {
+namespace statemachine {
+
+/*!
+ * \brief   Base class for the states of a StaticStateMachine.
+ * \details Counterpart of State. OnEnter() and OnLeave() are hidden, not overridden, by the derived state; the
+ *          defaults do nothing. Porting a State subclass means deriving from this class instead, removing the handle
+ *          from the constructor, dropping virtual/override and moving IsValidChange() into the transition table.
+ * \tparam  StateHandle The type identifying the states, e.g. an enum.
+ * \tparam  kStateHandle The handle of this state.
+ * \tparam  Context The context passed to OnEnter() and OnLeave().
+ */
+template <typename StateHandle, StateHandle kStateHandle, class Context>
+class StaticState {
+ public:
+  /*!
+   * \brief The Type of the StateHandle.
+   */
+  using HandleType = StateHandle;
+
+  /*!
+   * \brief The Type of the Context.
+   */
+  using ContextType = Context;
+
+  /*!
+   * \brief The handle for this State.
+   */
+  static constexpr StateHandle kHandle{kStateHandle};
+
+  /*!
+   * \brief Called when the state is entered. Hide this method to react on it.
+   */
+  void OnEnter(Context&) {}
+
+  /*!
+   * \brief Called when the state is left. Hide this method to react on it.
+   */
+  void OnLeave(Context&) {}
+
+  /*!
+   * \brief Returns the handle of this State.
+   */
+  constexpr StateHandle GetHandle() const { return kStateHandle; }
+};
+
+/*!
+ * \brief Definition of the handle of a StaticState.
+ */
+template <typename StateHandle, StateHandle kStateHandle, class Context>
+constexpr StateHandle StaticState<StateHandle, kStateHandle, Context>::kHandle;
+
+/*!
+ * \brief  Entry of a transition table: the change from state From to state To is valid.
+ * \tparam From The state that is left.
+ * \tparam To The state that is entered.
+ */
+template <typename From, typename To>
+struct Transition {};
+
+/*!
+ * \brief  The transition table of a StaticStateMachine. Changes not listed are invalid.
+ * \tparam Transitions Transition types.
+ */
+template <typename... Transitions>
+struct TransitionTable {};
+
+namespace detail {
+
+/*!
+ * \brief  Compile-time mapping between state handles and state indices.
+ * \tparam Handle The type identifying the states.
+ * \tparam kHandles The handles of the states, in the order of their indices.
+ */
+template <typename Handle, Handle... kHandles>
+class StaticStateIndex final {
+ public:
+  /*!
+   * \brief Number of states.
+   */
+  static constexpr std::size_t kCount{sizeof...(kHandles)};
+
+  /*!
+   * \brief The valid transitions as a matrix of state indices.
+   */
+  struct Matrix {
+    /*!
+     * \brief Whether the change from the first to the second index is valid.
+     */
+    bool valid[kCount][kCount];
+  };
+
+  /*!
+   * \brief  Returns the handle of the state with the given index.
+   * \param  index The index of the state, less than kCount.
+   * \return The handle.
+   */
+  static constexpr Handle HandleOf(std::size_t index) {
+    constexpr Handle kAll[kCount]{kHandles...};
+    return kAll[index];
+  }
+
+  /*!
+   * \brief  Checks whether the handles are 0, 1, ... in the order of the states.
+   * \return True if the value of every handle is its index.
+   */
+  static constexpr bool IsDense() {
+    bool result{true};
+    for (std::size_t index{0}; index < kCount; ++index) {
+      result = result && (static_cast<std::size_t>(HandleOf(index)) == index);
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Returns the index of the state with the given handle.
+   * \param  handle The state handle.
+   * \return The index, or kCount if no state has the handle.
+   */
+  static constexpr std::size_t IndexOf(Handle handle) {
+    std::size_t index{0};
+    if (IsDense()) {
+      // Handles enumerated in state order map to their index without a search.
+      index = static_cast<std::size_t>(handle);
+      if (index > kCount) {
+        index = kCount;
+      }
+    } else {
+      while ((index < kCount) && (HandleOf(index) != handle)) {
+        ++index;
+      }
+    }
+    return index;
+  }
+
+  /*!
+   * \brief  Checks whether every handle is used by exactly one state.
+   * \return True if the handles are distinct.
+   */
+  static constexpr bool IsDistinct() {
+    bool result{true};
+    for (std::size_t index{0}; index < kCount; ++index) {
+      result = result && (IndexOf(HandleOf(index)) == index);
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Builds the transition matrix from a transition table.
+   * \tparam From The source states of the valid transitions.
+   * \tparam To The target states of the valid transitions.
+   * \return The matrix.
+   */
+  template <typename... From, typename... To>
+  static constexpr Matrix MakeMatrix(TransitionTable<Transition<From, To>...>) {
+    // The leading element keeps the arrays non-empty for an empty transition table.
+    constexpr std::size_t kFrom[]{kCount, IndexOf(From::kHandle)...};
+    constexpr std::size_t kTo[]{kCount, IndexOf(To::kHandle)...};
+    Matrix matrix{};
+    for (std::size_t entry{1}; entry < (sizeof...(From) + 1); ++entry) {
+      matrix.valid[kFrom[entry]][kTo[entry]] = true;
+    }
+    return matrix;
+  }
+
+  /*!
+   * \brief  Checks whether all states of a transition table are known.
+   * \tparam From The source states of the valid transitions.
+   * \tparam To The target states of the valid transitions.
+   * \return True if all states have a handle of this index.
+   */
+  template <typename... From, typename... To>
+  static constexpr bool Contains(TransitionTable<Transition<From, To>...>) {
+    constexpr std::size_t kIndices[]{0, IndexOf(From::kHandle)..., IndexOf(To::kHandle)...};
+    bool result{true};
+    for (std::size_t index : kIndices) {
+      result = result && (index < kCount);
+    }
+    return result;
+  }
+};
+
+}  // namespace detail
+
+template <class Context, typename Table, typename... States>
+class StaticStateMachine;
+
+/*!
+ * \brief   State machine with compile-time states and transitions.
+ * \details Counterpart of StateOwner, StatePool and State::IsValidChange(). The state objects are members of the
+ *          machine. TryChangeState() performs one table lookup and one inlined call each of OnLeave() and OnEnter(),
+ *          instead of four virtual calls. As for StateOwner, the initial state is not entered on construction.
+ * \tparam  Context The context passed to the states.
+ * \tparam  From The source states of the valid transitions.
+ * \tparam  To The target states of the valid transitions.
+ * \tparam  States The states, default constructible and derived from StaticState with distinct handles.
+ * \trace   CREQ-158649, CREQ-158650, CREQ-158651
+ */
+template <class Context, typename... From, typename... To, typename... States>
+class StaticStateMachine<Context, TransitionTable<Transition<From, To>...>, States...> final {
+ public:
+  /*!
+   * \brief Number of states.
+   */
+  static constexpr std::size_t kStateCount{sizeof...(States)};
+
+  static_assert(kStateCount > 0, "A state machine needs at least one state");
+
+  /*!
+   * \brief Type of the State Handle.
+   */
+  using Handle = typename std::tuple_element<0, std::tuple<States...>>::type::HandleType;
+
+  static_assert(vac::language::conjunction<std::is_same<typename States::HandleType, Handle>...>::value,
+                "All states must use the same handle type");
+
+  static_assert(vac::language::conjunction<std::is_same<typename States::ContextType, Context>...>::value,
+                "All states must use the context of the state machine");
+
+  /*!
+   * \brief The mapping between state handles and state indices.
+   */
+  using Index = detail::StaticStateIndex<Handle, States::kHandle...>;
+
+  /*!
+   * \brief The transition table.
+   */
+  using Table = TransitionTable<Transition<From, To>...>;
+
+  static_assert(Index::IsDistinct(), "The handles of the states must be distinct");
+
+  static_assert(Index::Contains(Table{}), "The transition table refers to a state that is not part of the machine");
+
+  /*!
+   * \brief Constructor.
+   * \param context The context passed to the states. Must outlive the state machine.
+   * \param initial_state The handle of the initial state. Its OnEnter() is not called.
+   */
+  StaticStateMachine(Context& context, Handle initial_state)
+      : context_(context), states_(), current_(Index::IndexOf(initial_state)) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  StaticStateMachine(StaticStateMachine const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  StaticStateMachine& operator=(StaticStateMachine const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  StaticStateMachine(StaticStateMachine&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  StaticStateMachine& operator=(StaticStateMachine&&) = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~StaticStateMachine() = default;
+
+  /*!
+   * \brief  Checks if the change between the states with the given handles is listed in the transition table.
+   * \param  from The handle of the current state.
+   * \param  to The handle of the requested state.
+   * \return True if the change is valid, otherwise false.
+   */
+  static constexpr bool IsValidChange(Handle from, Handle to) {
+    return IsValidIndexChange(Index::IndexOf(from), Index::IndexOf(to));
+  }
+
+  /*!
+   * \brief  Checks if handle refers to a state of this machine.
+   * \param  state_handle The state handle.
+   * \return True if state exists with given handle, otherwise returns false.
+   */
+  static constexpr bool IsValid(Handle state_handle) { return Index::IndexOf(state_handle) < kStateCount; }
+
+  /*!
+   * \brief Returns the handle of the current state.
+   */
+  Handle GetHandle() const { return Index::HandleOf(current_); }
+
+  /*!
+   * \brief  Returns a state object.
+   * \tparam S The type of the state.
+   * \return The state object, whether it is the current state or not.
+   */
+  template <typename S>
+  S& GetState() {
+    return std::get<Index::IndexOf(S::kHandle)>(states_);
+  }
+
+  /*!
+   * \brief  Returns a state object.
+   * \tparam S The type of the state.
+   * \return The state object, whether it is the current state or not.
+   */
+  template <typename S>
+  S const& GetState() const {
+    return std::get<Index::IndexOf(S::kHandle)>(states_);
+  }
+
+  /*!
+   * \brief  Tries to change current state to state associated to given handle.
+   * \param  state_handle The handle of the state to which change is requested.
+   * \return True if state change was successful, otherwise returns false.
+   * \trace  CREQ-158650
+   */
+  bool TryChangeState(Handle state_handle) {
+    std::size_t const target{Index::IndexOf(state_handle)};
+    bool ret_value{false};
+    if (IsValidIndexChange(current_, target)) {
+      Dispatch<0>(current_, [this](auto& state) { state.OnLeave(context_); });
+      current_ = target;
+      Dispatch<0>(current_, [this](auto& state) { state.OnEnter(context_); });
+      ret_value = true;
+    }
+    return ret_value;
+  }
+
+  /*!
+   * \brief   Tries to change current state to the given state.
+   * \details The target state is entered without dispatching on its handle.
+   * \tparam  S The type of the state to which change is requested.
+   * \return  True if state change was successful, otherwise returns false.
+   */
+  template <typename S>
+  bool TryChangeState() {
+    constexpr std::size_t kTarget{Index::IndexOf(S::kHandle)};
+    static_assert(kTarget < kStateCount, "S is not a state of this state machine");
+    bool ret_value{false};
+    if (IsValidIndexChange(current_, kTarget)) {
+      Dispatch<0>(current_, [this](auto& state) { state.OnLeave(context_); });
+      current_ = kTarget;
+      std::get<kTarget>(states_).OnEnter(context_);
+      ret_value = true;
+    }
+    return ret_value;
+  }
+
+ private:
+  /*!
+   * \brief The valid transitions.
+   */
+  static constexpr typename Index::Matrix kTransitions{Index::MakeMatrix(Table{})};
+
+  /*!
+   * \brief  Checks if the change between the states with the given indices is valid.
+   * \param  from The index of the current state.
+   * \param  to The index of the requested state, kStateCount for an unknown state.
+   * \return True if the change is valid, otherwise false.
+   */
+  static constexpr bool IsValidIndexChange(std::size_t from, std::size_t to) {
+    return (from < kStateCount) && (to < kStateCount) && kTransitions.valid[from][to];
+  }
+
+  /*!
+   * \brief   Calls a visitor with the state of the given index.
+   * \details Expands to a chain of comparisons that the compiler turns into a switch.
+   * \tparam  kIndex The first index to compare with.
+   * \param   index The index of the state.
+   * \param   visitor A generic callable taking any state by reference.
+   */
+  template <std::size_t kIndex, typename Visitor>
+  vac::language::enable_if_t<(kIndex < kStateCount)> Dispatch(std::size_t index, Visitor&& visitor) {
+    if (index == kIndex) {
+      std::forward<Visitor>(visitor)(std::get<kIndex>(states_));
+    } else {
+      Dispatch<kIndex + 1>(index, std::forward<Visitor>(visitor));
+    }
+  }
+
+  /*!
+   * \brief End of the dispatch chain. Not reached for a valid index.
+   */
+  template <std::size_t kIndex, typename Visitor>
+  vac::language::enable_if_t<(kIndex >= kStateCount)> Dispatch(std::size_t, Visitor&&) {}
+
+  /*!
+   * \brief The context passed to the states.
+   */
+  Context& context_;
+
+  /*!
+   * \brief The state objects.
+   */
+  std::tuple<States...> states_;
+
+  /*!
+   * \brief The index of the current state.
+   */
+  std::size_t current_;
+};
+
+/*!
+ * \brief Definition of the transition matrix of a StaticStateMachine.
+ */
+template <class Context, typename... From, typename... To, typename... States>
+constexpr typename StaticStateMachine<Context, TransitionTable<Transition<From, To>...>, States...>::Index::Matrix
+    StaticStateMachine<Context, TransitionTable<Transition<From, To>...>, States...>::kTransitions;
+
+}  // namespace statemachine
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_STATEMACHINE_STATIC_STATE_MACHINE_H_
@@ -0,0 +1,166 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  futex.h
+ *        \brief  Blocking wait on a 32 bit atomic word until its value changes.
+ *
+ *      \details  On Linux the futex system call is used directly. On all other platforms waiters are parked on one of a
+ *                fixed number of mutex/condition variable buckets selected by the address of the atomic word.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_FUTEX_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_FUTEX_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <ctime>
+#else
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace vac {
+namespace sync {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex word must be a plain 32 bit word");
+
+namespace internal {
+
+#ifdef __linux__
+
+/* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
+/*!
+ * \brief  Issue a futex system call on the given atomic word.
+ * \param  word The futex word.
+ * \param  op The futex operation.
+ * \param  value The value argument of the operation.
+ * \param  timeout Optional relative timeout, nullptr for none.
+ * \return The return value of the system call.
+ */
+inline long FutexCall(std::atomic<std::uint32_t>& word, int op, std::uint32_t value,
+                      struct timespec const* timeout) noexcept {
+  return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), op | FUTEX_PRIVATE_FLAG, value, timeout,
+                   nullptr, 0);
+}
+
+#else
+
+/*!
+ * \brief A parking bucket for waiters on platforms without futex.
+ */
+struct ParkingBucket {
+  /*!
+   * \brief Mutex protecting the wait/notify handshake.
+   */
+  std::mutex mutex;
+  /*!
+   * \brief Condition variable waiters block on.
+   */
+  std::condition_variable condvar;
+};
+
+/*!
+ * \brief Number of parking buckets. Unrelated words sharing a bucket only cause spurious wakeups.
+ */
+constexpr std::size_t kNumberOfParkingBuckets{16};
+
+/* VECTOR Next Construct AutosarC++17_10-A5.2.4: MD_VAC_A5.2.4_reinterpretCast */
+/*!
+ * \brief  Returns the parking bucket for a given atomic word.
+ * \param  word The word to wait on.
+ * \return The bucket associated with the address of word.
+ */
+inline ParkingBucket& GetParkingBucket(std::atomic<std::uint32_t> const& word) noexcept {
+  static std::array<ParkingBucket, kNumberOfParkingBuckets> buckets;
+  std::uintptr_t const address{reinterpret_cast<std::uintptr_t>(&word)};
+  return buckets[(address >> 4U) % kNumberOfParkingBuckets];
+}
+
+#endif
+
+}  // namespace internal
+
+/*!
+ * \brief   Blocks as long as the word contains the expected value.
+ * \details May return spuriously. Callers must re-check their condition in a loop.
+ * \param   word The word to wait on.
+ * \param   expected The value for which the caller wants to keep waiting.
+ */
+inline void FutexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept {
+#ifdef __linux__
+  static_cast<void>(internal::FutexCall(word, FUTEX_WAIT, expected, nullptr));
+#else
+  internal::ParkingBucket& bucket{internal::GetParkingBucket(word)};
+  std::unique_lock<std::mutex> lock{bucket.mutex};
+  if (word.load(std::memory_order_acquire) == expected) {
+    bucket.condvar.wait(lock);
+  }
+#endif
+}
+
+/*!
+ * \brief   Blocks as long as the word contains the expected value, but at most for the given duration.
+ * \details May return spuriously. Callers must re-check their condition and the remaining time in a loop.
+ * \param   word The word to wait on.
+ * \param   expected The value for which the caller wants to keep waiting.
+ * \param   timeout The maximum time to block.
+ */
+inline void FutexWaitFor(std::atomic<std::uint32_t>& word, std::uint32_t expected,
+                         std::chrono::nanoseconds timeout) noexcept {
+  if (timeout > std::chrono::nanoseconds::zero()) {
+#ifdef __linux__
+    std::chrono::seconds const secs{std::chrono::duration_cast<std::chrono::seconds>(timeout)};
+    struct timespec ts {};
+    ts.tv_sec = static_cast<std::time_t>(secs.count());
+    ts.tv_nsec = static_cast<long>((timeout - secs).count());
+    static_cast<void>(internal::FutexCall(word, FUTEX_WAIT, expected, &ts));
+#else
+    internal::ParkingBucket& bucket{internal::GetParkingBucket(word)};
+    std::unique_lock<std::mutex> lock{bucket.mutex};
+    if (word.load(std::memory_order_acquire) == expected) {
+      static_cast<void>(bucket.condvar.wait_for(lock, timeout));
+    }
+#endif
+  }
+}
+
+/*!
+ * \brief Wakes all threads blocked on the word. The caller must have modified the word beforehand.
+ * \param word The word waited on.
+ */
+inline void FutexWakeAll(std::atomic<std::uint32_t>& word) noexcept {
+#ifdef __linux__
+  static_cast<void>(internal::FutexCall(word, FUTEX_WAKE, static_cast<std::uint32_t>(INT_MAX), nullptr));
+#else
+  internal::ParkingBucket& bucket{internal::GetParkingBucket(word)};
+  { std::lock_guard<std::mutex> const lock{bucket.mutex}; }
+  bucket.condvar.notify_all();
+#endif
+}
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_FUTEX_H_
@@ -0,0 +1,231 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  mpsc_queue.h
+ *        \brief  Intrusive lock-free multi-producer single-consumer queue.
+ *
+ *      \details  Producers enqueue with a single atomic exchange. The consumer dequeues without atomic
+ *                read-modify-write operations. Elements are linked through an embedded MpscQueueNode and are not
+ *                owned by the queue.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_MPSC_QUEUE_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_MPSC_QUEUE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+namespace vac {
+namespace sync {
+
+template <typename T>
+class MpscQueue;
+
+/*!
+ * \brief Link embedded in every element of an MpscQueue. Derive from this type to make an object enqueueable.
+ */
+class MpscQueueNode {
+ public:
+  /*!
+   * \brief Constructor for a node that is not enqueued.
+   */
+  MpscQueueNode() noexcept : next_(nullptr) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  MpscQueueNode(MpscQueueNode const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  MpscQueueNode(MpscQueueNode&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  MpscQueueNode& operator=(MpscQueueNode const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  MpscQueueNode& operator=(MpscQueueNode&&) & = delete;
+
+ protected:
+  /*!
+   * \brief Destructor. Nodes are not deleted through this type.
+   */
+  ~MpscQueueNode() = default;
+
+ private:
+  /*!
+   * \brief The element enqueued after this one.
+   */
+  std::atomic<MpscQueueNode*> next_;
+
+  /* VECTOR Next Line AutosarC++17_10-A11.3.1: MD_VAC_A11.3.1_doNotUseFriend */
+  template <typename T>
+  friend class MpscQueue;
+};
+
+/*!
+ * \brief   Intrusive lock-free multi-producer single-consumer FIFO queue.
+ * \details Push() may be called from any thread. Pop() and empty() must only be called from one thread at a time.
+ *          The order of elements pushed by the same thread is preserved.
+ * \tparam  T The element type, derived from MpscQueueNode.
+ */
+template <typename T>
+class MpscQueue final {
+  static_assert(std::is_base_of<MpscQueueNode, T>::value, "T must derive from MpscQueueNode");
+
+ public:
+  /*!
+   * \brief Constructor for an empty queue.
+   */
+  MpscQueue() noexcept : stub_(), tail_(&stub_), head_(&stub_) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  MpscQueue(MpscQueue const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  MpscQueue(MpscQueue&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  MpscQueue& operator=(MpscQueue const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  MpscQueue& operator=(MpscQueue&&) & = delete;
+
+  /*!
+   * \brief Destructor. Elements still enqueued are not touched.
+   */
+  ~MpscQueue() = default;
+
+  /*!
+   * \brief   Enqueue an element.
+   * \details Lock-free. The element must not be enqueued already.
+   * \param   element The element to enqueue.
+   */
+  void Push(T& element) noexcept { PushNode(element); }
+
+  /*!
+   * \brief   Dequeue the oldest element.
+   * \details If a producer has been preempted in the middle of Push(), the consumer yields until the element is
+   *          linked, so that the FIFO order is never violated.
+   * \return  The dequeued element, or nullptr if the queue is empty.
+   */
+  T* Pop() noexcept {
+    MpscQueueNode* head{head_};
+    MpscQueueNode* next{head->next_.load(std::memory_order_acquire)};
+    if (head == &stub_) {
+      if (next == nullptr) {
+        next = WaitForLink(head);
+      }
+      if (next != nullptr) {
+        // Skip the stub node.
+        head_ = next;
+        head = next;
+        next = next->next_.load(std::memory_order_acquire);
+      }
+    }
+    T* result{nullptr};
+    if (head != &stub_) {
+      if (next == nullptr) {
+        if (tail_.load(std::memory_order_seq_cst) == head) {
+          // head is the last element: re-insert the stub so that head can be handed out.
+          PushNode(stub_);
+        }
+        next = WaitForLink(head);
+      }
+      if (next != nullptr) {
+        head_ = next;
+        result = static_cast<T*>(head);
+      }
+    }
+    return result;
+  }
+
+  /*!
+   * \brief  Determine whether any element is enqueued, including elements whose Push() is still in progress.
+   * \return True if the queue is empty, false otherwise.
+   */
+  bool empty() const noexcept {
+    return (head_ == &stub_) && (tail_.load(std::memory_order_seq_cst) == &stub_);
+  }
+
+  /*!
+   * \brief   Determine whether an element may be enqueued, without touching the consumer side. Threadsafe.
+   * \details Returns true as soon as a Push() has started that the consumer has not dequeued yet. Returns false
+   *          only if the queue is empty or a consumer is inside Pop() at the same time.
+   * \return  False if the queue is empty, true if it may contain an element.
+   */
+  bool MaybeNonEmpty() const noexcept { return tail_.load(std::memory_order_seq_cst) != &stub_; }
+
+ private:
+  /*!
+   * \brief Link a node to the tail of the queue.
+   * \param node The node to link.
+   */
+  void PushNode(MpscQueueNode& node) noexcept {
+    node.next_.store(nullptr, std::memory_order_relaxed);
+    MpscQueueNode* const previous{tail_.exchange(&node, std::memory_order_seq_cst)};
+    previous->next_.store(&node, std::memory_order_release);
+  }
+
+  /*!
+   * \brief  Wait until the successor of a node is linked, if a producer has already claimed the tail after it.
+   * \param  node The node whose successor is awaited.
+   * \return The successor, or nullptr if node is the tail.
+   */
+  MpscQueueNode* WaitForLink(MpscQueueNode* node) noexcept {
+    MpscQueueNode* next{node->next_.load(std::memory_order_acquire)};
+    while ((next == nullptr) && (tail_.load(std::memory_order_seq_cst) != node)) {
+      std::this_thread::yield();
+      next = node->next_.load(std::memory_order_acquire);
+    }
+    return next;
+  }
+
+  /*!
+   * \brief Placeholder node that keeps the queue non-empty for the producers.
+   */
+  MpscQueueNode stub_;
+
+  /*!
+   * \brief Most recently enqueued node. Written by the producers.
+   */
+  std::atomic<MpscQueueNode*> tail_;
+
+  /*!
+   * \brief Oldest node. Only accessed by the consumer.
+   */
+  MpscQueueNode* head_;
+};
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_MPSC_QUEUE_H_
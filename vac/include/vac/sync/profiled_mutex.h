@@ -0,0 +1,607 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  profiled_mutex.h
+ *        \brief  Mutex wrapper recording contention statistics per named lock site.
+ *
+ *      \details  A ProfiledMutex counts its acquisitions, the acquisitions that had to wait, the wait times and the
+ *                longest hold time, and publishes them to the LockProfiler under the name of its lock site. The
+ *                uncontended path costs one try_lock() and a few plain increments made while holding the lock.
+ *                The vac components that own a mutex take its type as template parameter defaulting to DefaultMutex,
+ *                which is a ProfiledMutex if VAC_LOCK_PROFILING_ENABLED is defined to a non-zero value. The macro
+ *                changes the layout of these components and must be defined identically in all translation units.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_PROFILED_MUTEX_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_PROFILED_MUTEX_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "vac/trace/trace.h"
+
+namespace vac {
+namespace sync {
+
+/*!
+ * \brief Number of wait time buckets of a lock site. Bucket i counts waits shorter than 2^i nanoseconds.
+ */
+constexpr std::size_t kLockWaitBuckets{64};
+
+/*!
+ * \brief Statistics of a lock site at one point in time.
+ */
+struct LockSiteSample final {
+  /*!
+   * \brief The name of the lock site.
+   */
+  char const* name;
+
+  /*!
+   * \brief Number of acquisitions.
+   */
+  std::uint64_t acquisitions;
+
+  /*!
+   * \brief Number of acquisitions that found the mutex locked and had to wait.
+   */
+  std::uint64_t contended;
+
+  /*!
+   * \brief Sum of all wait times in nanoseconds.
+   */
+  std::uint64_t total_wait_ns;
+
+  /*!
+   * \brief Longest wait time in nanoseconds.
+   */
+  std::uint64_t max_wait_ns;
+
+  /*!
+   * \brief Longest sampled hold time in nanoseconds.
+   */
+  std::uint64_t max_hold_ns;
+
+  /*!
+   * \brief Histogram of the wait times of the contended acquisitions, see kLockWaitBuckets.
+   */
+  std::array<std::uint64_t, kLockWaitBuckets> wait_histogram;
+
+  /*!
+   * \brief  Upper bound of a percentile of the wait times of the contended acquisitions.
+   * \param  percentile The percentile in [0, 1].
+   * \return The upper bound of the histogram bucket containing the percentile in nanoseconds, 0 if no acquisition
+   *         was contended.
+   */
+  std::uint64_t WaitPercentile(double percentile) const noexcept {
+    std::uint64_t total{0};
+    for (std::uint64_t const count : wait_histogram) {
+      total += count;
+    }
+    std::uint64_t result{0};
+    if (total != 0U) {
+      double const clamped{std::min(std::max(percentile, 0.0), 1.0)};
+      std::uint64_t const rank{std::max<std::uint64_t>(
+          static_cast<std::uint64_t>(clamped * static_cast<double>(total) + 0.5), static_cast<std::uint64_t>(1))};
+      std::uint64_t seen{0};
+      std::size_t bucket{0};
+      while ((bucket < (kLockWaitBuckets - 1U)) && ((seen + wait_histogram[bucket]) < rank)) {
+        seen += wait_histogram[bucket];
+        ++bucket;
+      }
+      result = (bucket < (kLockWaitBuckets - 1U)) ? (static_cast<std::uint64_t>(1) << bucket)
+                                                   : std::numeric_limits<std::uint64_t>::max();
+    }
+    return result;
+  }
+};
+
+/*!
+ * \brief   Statistics of a lock site, shared by all mutexes of the same name.
+ * \details Updated with relaxed atomics: the values are independent counters and read only for reporting.
+ */
+class LockSiteStats final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param name The name, a string with static storage duration.
+   */
+  explicit LockSiteStats(char const* name) noexcept
+      : name_(name),
+        acquisitions_(0),
+        contended_(0),
+        total_wait_ns_(0),
+        max_wait_ns_(0),
+        max_hold_ns_(0),
+        wait_histogram_() {
+    for (std::atomic<std::uint64_t>& bucket : wait_histogram_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  LockSiteStats(LockSiteStats const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  LockSiteStats& operator=(LockSiteStats const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  LockSiteStats(LockSiteStats&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  LockSiteStats& operator=(LockSiteStats&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~LockSiteStats() = default;
+
+  /*!
+   * \brief  The name of the lock site.
+   * \return The name.
+   */
+  char const* GetName() const noexcept { return name_; }
+
+  /*!
+   * \brief Add uncontended acquisitions. Threadsafe.
+   * \param count The number of acquisitions.
+   */
+  void AddAcquisitions(std::uint64_t count) noexcept {
+    static_cast<void>(acquisitions_.fetch_add(count, std::memory_order_relaxed));
+  }
+
+  /*!
+   * \brief Add a contended acquisition. Threadsafe.
+   * \param wait_ns The time waited for the mutex in nanoseconds.
+   */
+  void AddContended(std::uint64_t wait_ns) noexcept {
+    static_cast<void>(acquisitions_.fetch_add(1, std::memory_order_relaxed));
+    static_cast<void>(contended_.fetch_add(1, std::memory_order_relaxed));
+    static_cast<void>(total_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed));
+    static_cast<void>(wait_histogram_[WaitBucket(wait_ns)].fetch_add(1, std::memory_order_relaxed));
+    UpdateMax(max_wait_ns_, wait_ns);
+  }
+
+  /*!
+   * \brief Record a hold time. Threadsafe.
+   * \param hold_ns The time the mutex was held in nanoseconds.
+   */
+  void RecordHold(std::uint64_t hold_ns) noexcept { UpdateMax(max_hold_ns_, hold_ns); }
+
+  /*!
+   * \brief  Read the statistics. Threadsafe.
+   * \return The sample.
+   */
+  LockSiteSample Sample() const noexcept {
+    LockSiteSample sample{name_,
+                          acquisitions_.load(std::memory_order_relaxed),
+                          contended_.load(std::memory_order_relaxed),
+                          total_wait_ns_.load(std::memory_order_relaxed),
+                          max_wait_ns_.load(std::memory_order_relaxed),
+                          max_hold_ns_.load(std::memory_order_relaxed),
+                          {}};
+    for (std::size_t i{0}; i < kLockWaitBuckets; ++i) {
+      sample.wait_histogram[i] = wait_histogram_[i].load(std::memory_order_relaxed);
+    }
+    return sample;
+  }
+
+  /*!
+   * \brief Reset all statistics to zero. Threadsafe, updates made concurrently may be lost.
+   */
+  void Reset() noexcept {
+    acquisitions_.store(0, std::memory_order_relaxed);
+    contended_.store(0, std::memory_order_relaxed);
+    total_wait_ns_.store(0, std::memory_order_relaxed);
+    max_wait_ns_.store(0, std::memory_order_relaxed);
+    max_hold_ns_.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint64_t>& bucket : wait_histogram_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  /*!
+   * \brief  The histogram bucket of a wait time.
+   * \param  wait_ns The wait time in nanoseconds.
+   * \return The smallest i with wait_ns < 2^i, limited to the last bucket.
+   */
+  static std::size_t WaitBucket(std::uint64_t wait_ns) noexcept {
+    std::size_t bucket{0};
+    while ((bucket < (kLockWaitBuckets - 1U)) && ((wait_ns >> bucket) != 0U)) {
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  /*!
+   * \brief Raise an atomic maximum.
+   * \param max The maximum.
+   * \param value The candidate value.
+   */
+  static void UpdateMax(std::atomic<std::uint64_t>& max, std::uint64_t value) noexcept {
+    std::uint64_t current{max.load(std::memory_order_relaxed)};
+    while ((value > current) && (!max.compare_exchange_weak(current, value, std::memory_order_relaxed))) {
+    }
+  }
+
+  /*!
+   * \brief The name of the lock site.
+   */
+  char const* const name_;
+
+  /*!
+   * \brief Number of acquisitions.
+   */
+  std::atomic<std::uint64_t> acquisitions_;
+
+  /*!
+   * \brief Number of contended acquisitions.
+   */
+  std::atomic<std::uint64_t> contended_;
+
+  /*!
+   * \brief Sum of all wait times in nanoseconds.
+   */
+  std::atomic<std::uint64_t> total_wait_ns_;
+
+  /*!
+   * \brief Longest wait time in nanoseconds.
+   */
+  std::atomic<std::uint64_t> max_wait_ns_;
+
+  /*!
+   * \brief Longest sampled hold time in nanoseconds.
+   */
+  std::atomic<std::uint64_t> max_hold_ns_;
+
+  /*!
+   * \brief Histogram of the wait times.
+   */
+  std::array<std::atomic<std::uint64_t>, kLockWaitBuckets> wait_histogram_;
+};
+
+/*!
+ * \brief Process-wide registry of the lock sites.
+ */
+class LockProfiler final {
+ public:
+  /*!
+   * \brief  The process-wide profiler.
+   * \return The profiler.
+   */
+  static LockProfiler& Instance() {
+    static LockProfiler profiler;
+    return profiler;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  LockProfiler(LockProfiler const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  LockProfiler& operator=(LockProfiler const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  LockProfiler(LockProfiler&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  LockProfiler& operator=(LockProfiler&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~LockProfiler() = default;
+
+  /*!
+   * \brief   Look up the statistics of a lock site, creating them on first use. Threadsafe.
+   * \details Sites are never removed, the returned reference stays valid for the lifetime of the profiler.
+   * \param   name The name, a string with static storage duration.
+   * \return  The statistics.
+   */
+  LockSiteStats& GetSite(char const* name) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    std::deque<LockSiteStats>::iterator const it{std::find_if(
+        sites_.begin(), sites_.end(), [name](LockSiteStats const& site) {
+          return std::strcmp(site.GetName(), name) == 0;
+        })};
+    LockSiteStats* site{nullptr};
+    if (it != sites_.end()) {
+      site = &*it;
+    } else {
+      sites_.emplace_back(name);
+      site = &sites_.back();
+    }
+    return *site;
+  }
+
+  /*!
+   * \brief   List the most contended lock sites. Threadsafe.
+   * \details Sites are ordered by the number of contended acquisitions, then by the total wait time. Uncontended
+   *          acquisitions of live mutexes are published in batches and may be missing from the counts.
+   * \param   max_sites The maximum number of sites to list.
+   * \return  The samples of the sites.
+   */
+  std::vector<LockSiteSample> Report(std::size_t max_sites = std::numeric_limits<std::size_t>::max()) const {
+    std::vector<LockSiteSample> samples{};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      samples.reserve(sites_.size());
+      for (LockSiteStats const& site : sites_) {
+        samples.push_back(site.Sample());
+      }
+    }
+    std::sort(samples.begin(), samples.end(), [](LockSiteSample const& lhs, LockSiteSample const& rhs) {
+      return (lhs.contended != rhs.contended) ? (lhs.contended > rhs.contended)
+                                              : (lhs.total_wait_ns > rhs.total_wait_ns);
+    });
+    if (samples.size() > max_sites) {
+      samples.erase(samples.begin() + static_cast<std::ptrdiff_t>(max_sites), samples.end());
+    }
+    return samples;
+  }
+
+  /*!
+   * \brief Reset the statistics of all lock sites. Threadsafe.
+   */
+  void Reset() noexcept {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    for (LockSiteStats& site : sites_) {
+      site.Reset();
+    }
+  }
+
+ private:
+  /*!
+   * \brief Constructor.
+   */
+  LockProfiler() : mutex_(), sites_() {}
+
+  /*!
+   * \brief Mutex protecting sites_.
+   */
+  mutable std::mutex mutex_;
+
+  /*!
+   * \brief The lock sites. A deque keeps their addresses stable.
+   */
+  std::deque<LockSiteStats> sites_;
+};
+
+/*!
+ * \brief   Mutex recording contention statistics for its lock site.
+ * \details Meets the Lockable requirements of the wrapped mutex, so it can be used with std::lock_guard,
+ *          std::unique_lock, std::lock and std::condition_variable_any. Acquisitions are counted in plain members
+ *          modified only while the mutex is held and published to the lock site every kPublishInterval acquisitions
+ *          and on destruction. Contended acquisitions are published immediately together with their wait time. The
+ *          hold time is measured for contended acquisitions and for every kHoldSampleInterval-th acquisition.
+ * \tparam  Mutex The wrapped mutex, e.g. std::mutex or std::recursive_mutex. Must provide try_lock().
+ */
+template <typename Mutex>
+class BasicProfiledMutex {
+ public:
+  /*!
+   * \brief Number of uncontended acquisitions counted locally before they are published.
+   */
+  static constexpr std::uint64_t kPublishInterval{256};
+
+  /*!
+   * \brief Every kHoldSampleInterval-th uncontended acquisition measures the hold time.
+   */
+  static constexpr std::uint64_t kHoldSampleInterval{64};
+
+  /*!
+   * \brief Constructor.
+   * \param name The name of the lock site, a string with static storage duration.
+   */
+  explicit BasicProfiledMutex(char const* name = "unnamed")
+      : mutex_(), site_(LockProfiler::Instance().GetSite(name)), pending_(0), depth_(0), hold_begin_(0) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  BasicProfiledMutex(BasicProfiledMutex const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  BasicProfiledMutex& operator=(BasicProfiledMutex const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  BasicProfiledMutex(BasicProfiledMutex&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  BasicProfiledMutex& operator=(BasicProfiledMutex&&) & = delete;
+
+  /*!
+   * \brief Destructor. Publishes the pending acquisitions. The mutex must not be locked.
+   */
+  ~BasicProfiledMutex() { site_.AddAcquisitions(pending_); }
+
+  /*!
+   * \brief Lock the mutex, blocking until it is available.
+   */
+  void lock() {
+    if (mutex_.try_lock()) {
+      OnAcquired();
+    } else {
+      std::uint64_t const begin{vac::trace::TraceClockNow()};
+      mutex_.lock();
+      std::uint64_t const end{vac::trace::TraceClockNow()};
+      site_.AddContended(end - begin);
+      if (depth_ == 0U) {
+        hold_begin_ = end;
+      }
+      ++depth_;
+    }
+  }
+
+  /*!
+   * \brief  Try to lock the mutex without blocking. A failed attempt is not counted.
+   * \return True if the mutex has been locked.
+   */
+  bool try_lock() {
+    bool const locked{mutex_.try_lock()};
+    if (locked) {
+      OnAcquired();
+    }
+    return locked;
+  }
+
+  /*!
+   * \brief Unlock the mutex. Must be called by the owning thread.
+   */
+  void unlock() {
+    --depth_;
+    if ((depth_ == 0U) && (hold_begin_ != 0U)) {
+      site_.RecordHold(vac::trace::TraceClockNow() - hold_begin_);
+      hold_begin_ = 0;
+    }
+    mutex_.unlock();
+  }
+
+  /*!
+   * \brief  The statistics of the lock site.
+   * \return The statistics.
+   */
+  LockSiteStats const& GetSite() const noexcept { return site_; }
+
+ private:
+  /*!
+   * \brief Count an uncontended acquisition. Called with the mutex held.
+   */
+  void OnAcquired() noexcept {
+    ++pending_;
+    if ((depth_ == 0U) && ((pending_ % kHoldSampleInterval) == 0U)) {
+      hold_begin_ = vac::trace::TraceClockNow();
+    }
+    ++depth_;
+    if (pending_ == kPublishInterval) {
+      site_.AddAcquisitions(pending_);
+      pending_ = 0;
+    }
+  }
+
+  /*!
+   * \brief The wrapped mutex.
+   */
+  Mutex mutex_;
+
+  /*!
+   * \brief The statistics of the lock site.
+   */
+  LockSiteStats& site_;
+
+  /*!
+   * \brief Uncontended acquisitions not yet published. Guarded by mutex_.
+   */
+  std::uint64_t pending_;
+
+  /*!
+   * \brief Recursion depth of the owning thread. Guarded by mutex_.
+   */
+  std::uint64_t depth_;
+
+  /*!
+   * \brief Begin of the measured hold time in nanoseconds of TraceClockNow(), 0 if not measured. Guarded by mutex_.
+   */
+  std::uint64_t hold_begin_;
+};
+
+/*!
+ * \brief Profiled std::mutex.
+ */
+using ProfiledMutex = BasicProfiledMutex<std::mutex>;
+
+/*!
+ * \brief Profiled std::recursive_mutex.
+ */
+using ProfiledRecursiveMutex = BasicProfiledMutex<std::recursive_mutex>;
+
+#if defined(VAC_LOCK_PROFILING_ENABLED) && (VAC_LOCK_PROFILING_ENABLED != 0)
+/*!
+ * \brief The mutex used by the vac components unless another one is requested, see VAC_LOCK_PROFILING_ENABLED.
+ */
+using DefaultMutex = ProfiledMutex;
+#else
+/*!
+ * \brief The mutex used by the vac components unless another one is requested, see VAC_LOCK_PROFILING_ENABLED.
+ */
+using DefaultMutex = std::mutex;
+#endif
+
+/*!
+ * \brief   A mutex that is given the name of its lock site if it accepts one.
+ * \details Lets components declare the lock site name once, independent of whether their mutex type is profiled.
+ * \tparam  Mutex The mutex.
+ */
+template <typename Mutex, bool = std::is_constructible<Mutex, char const*>::value>
+class NamedMutex final : public Mutex {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param name The name of the lock site, a string with static storage duration.
+   */
+  explicit NamedMutex(char const* name) : Mutex(name) {}
+};
+
+/*!
+ * \brief A mutex that does not accept a name.
+ * \tparam Mutex The mutex.
+ */
+template <typename Mutex>
+class NamedMutex<Mutex, false> final : public Mutex {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param name Ignored.
+   */
+  explicit NamedMutex(char const* name) : Mutex() { static_cast<void>(name); }
+};
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_PROFILED_MUTEX_H_
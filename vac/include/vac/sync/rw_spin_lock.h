@@ -0,0 +1,154 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  rw_spin_lock.h
+ *        \brief  Reader-writer spin lock in a single 32 bit word.
+ *
+ *      \details  Meant for short critical sections such as a lookup in a small table. Waiting threads spin on the
+ *                word and yield the processor between attempts instead of blocking in the kernel.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_RW_SPIN_LOCK_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_RW_SPIN_LOCK_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace vac {
+namespace sync {
+
+/*!
+ * \brief   Reader-writer spin lock.
+ * \details Meets the SharedMutex requirements, so it can be used with std::unique_lock and std::shared_lock. A waiting
+ *          writer keeps new readers out, so writers are not starved by a steady stream of readers. Not recursive.
+ */
+class RwSpinLock final {
+ public:
+  /*!
+   * \brief Constructor for an unlocked lock.
+   */
+  RwSpinLock() noexcept : state_(0) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  RwSpinLock(RwSpinLock const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  RwSpinLock& operator=(RwSpinLock const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  RwSpinLock(RwSpinLock&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  RwSpinLock& operator=(RwSpinLock&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~RwSpinLock() = default;
+
+  /*!
+   * \brief Acquire exclusive ownership.
+   */
+  void lock() noexcept {
+    while (!try_lock()) {
+      std::uint32_t const state{state_.load(std::memory_order_relaxed)};
+      if ((state & kWriterWaiting) == 0U) {
+        static_cast<void>(state_.fetch_or(kWriterWaiting, std::memory_order_relaxed));
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  /*!
+   * \brief  Try to acquire exclusive ownership without waiting.
+   * \return True if the lock was acquired.
+   */
+  bool try_lock() noexcept {
+    std::uint32_t state{state_.load(std::memory_order_relaxed)};
+    // Only the waiting flag may be set. Acquiring clears it; other waiting writers set it again.
+    return ((state & ~kWriterWaiting) == 0U) &&
+           state_.compare_exchange_strong(state, kWriter, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief Release exclusive ownership.
+   */
+  void unlock() noexcept { static_cast<void>(state_.fetch_sub(kWriter, std::memory_order_release)); }
+
+  /*!
+   * \brief Acquire shared ownership.
+   */
+  void lock_shared() noexcept {
+    while (!try_lock_shared()) {
+      std::this_thread::yield();
+    }
+  }
+
+  /*!
+   * \brief  Try to acquire shared ownership without waiting.
+   * \return True if the lock was acquired.
+   */
+  bool try_lock_shared() noexcept {
+    std::uint32_t state{state_.load(std::memory_order_relaxed)};
+    bool acquired{false};
+    while ((!acquired) && ((state & (kWriter | kWriterWaiting)) == 0U)) {
+      acquired = state_.compare_exchange_weak(state, state + kReader, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+    return acquired;
+  }
+
+  /*!
+   * \brief Release shared ownership.
+   */
+  void unlock_shared() noexcept { static_cast<void>(state_.fetch_sub(kReader, std::memory_order_release)); }
+
+ private:
+  /*!
+   * \brief Set while a writer owns the lock.
+   */
+  static constexpr std::uint32_t kWriter{1U};
+
+  /*!
+   * \brief Set while a writer waits. Keeps new readers out.
+   */
+  static constexpr std::uint32_t kWriterWaiting{2U};
+
+  /*!
+   * \brief Increment of the reader count in the upper bits.
+   */
+  static constexpr std::uint32_t kReader{4U};
+
+  /*!
+   * \brief The writer bit, the waiting bit and the number of readers.
+   */
+  std::atomic<std::uint32_t> state_;
+};
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_RW_SPIN_LOCK_H_
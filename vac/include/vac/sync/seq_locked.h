@@ -0,0 +1,191 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  seq_locked.h
+ *        \brief  Sequence lock protected value for one writer and many readers.
+ *
+ *      \details  The writer never waits. Readers copy the value optimistically and retry if the writer was active
+ *                meanwhile. The value is stored as an array of relaxed atomic words, so a torn read is detected by
+ *                the sequence check instead of being a data race.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_SEQ_LOCKED_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_SEQ_LOCKED_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "vac/language/cache_line.h"
+
+namespace vac {
+namespace sync {
+
+/*!
+ * \brief   Value of a trivially copyable type published by one writer thread to any number of reader threads.
+ * \details Store() is wait-free; concurrent calls of Store() must be serialized by the caller. Load() is lock-free and
+ *          retries while a Store() overlaps it. The value occupies its own cache lines, padded against neighbors.
+ * \tparam  T The value type. Must be trivially copyable.
+ */
+template <typename T>
+class SeqLocked final {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLocked requires a trivially copyable type");
+
+ public:
+  /*!
+   * \brief Default constructor. Holds a value-initialized T. Requires T to be default constructible.
+   */
+  SeqLocked() noexcept : SeqLocked(T{}) {}
+
+  /*!
+   * \brief Constructor.
+   * \param initial The initial value.
+   */
+  explicit SeqLocked(T const& initial) noexcept
+      : leading_padding_(), sequence_(0), words_(), trailing_padding_() {
+    std::array<Word, kWords> words{};
+    static_cast<void>(std::memcpy(words.data(), &initial, sizeof(T)));
+    for (std::size_t i{0}; i < kWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  SeqLocked(SeqLocked const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  SeqLocked& operator=(SeqLocked const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  SeqLocked(SeqLocked&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  SeqLocked& operator=(SeqLocked&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~SeqLocked() = default;
+
+  /*!
+   * \brief   Publish a new value. Wait-free. Must not be called concurrently with itself.
+   * \details The odd sequence number is made visible before any word of the value by the release fence; the even
+   *          sequence number is released after all words.
+   * \param   value The value.
+   */
+  void Store(T const& value) noexcept {
+    std::array<Word, kWords> words{};
+    static_cast<void>(std::memcpy(words.data(), &value, sizeof(T)));
+    std::uint64_t const sequence{sequence_.load(std::memory_order_relaxed)};
+    sequence_.store(sequence + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i{0}; i < kWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2U, std::memory_order_release);
+  }
+
+  /*!
+   * \brief  Try to read a consistent value once. Lock-free.
+   * \param  value Receives the value on success, unchanged otherwise.
+   * \return False if a Store() overlapped the read.
+   */
+  bool TryLoad(T& value) const noexcept {
+    std::uint64_t const before{sequence_.load(std::memory_order_acquire)};
+    bool consistent{(before & 1U) == 0U};
+    if (consistent) {
+      std::array<Word, kWords> words{};
+      for (std::size_t i{0}; i < kWords; ++i) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      consistent = sequence_.load(std::memory_order_relaxed) == before;
+      if (consistent) {
+        static_cast<void>(std::memcpy(&value, words.data(), sizeof(T)));
+      }
+    }
+    return consistent;
+  }
+
+  /*!
+   * \brief  Read a consistent value, retrying while a Store() overlaps. Lock-free.
+   * \details Requires T to be default constructible; use TryLoad() with an existing object otherwise.
+   * \return The value.
+   */
+  T Load() const noexcept {
+    static_assert(std::is_default_constructible<T>::value, "SeqLocked::Load() requires a default constructible type");
+    T value{};
+    while (!TryLoad(value)) {
+    }
+    return value;
+  }
+
+  /*!
+   * \brief  The number of completed Store() calls times two, plus one while a Store() is in progress.
+   * \return The sequence number.
+   */
+  std::uint64_t GetSequence() const noexcept { return sequence_.load(std::memory_order_acquire); }
+
+ private:
+  /*!
+   * \brief Unit of the atomic copy.
+   */
+  using Word = std::uint64_t;
+
+  /*!
+   * \brief Number of words holding a T.
+   */
+  static constexpr std::size_t kWords{(sizeof(T) + sizeof(Word) - 1U) / sizeof(Word)};
+
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "SeqLocked requires lock-free 64 bit atomics");
+
+  /*!
+   * \brief Keeps the sequence number off the cache line of the preceding object.
+   */
+  std::array<char, vac::language::kCacheLineSize> leading_padding_;
+
+  /*!
+   * \brief Even while the value is stable, odd while the writer modifies it.
+   */
+  std::atomic<std::uint64_t> sequence_;
+
+  /*!
+   * \brief The value, copied word by word.
+   */
+  std::array<std::atomic<Word>, kWords> words_;
+
+  /*!
+   * \brief Keeps the value off the cache line of the following object.
+   */
+  std::array<char, vac::language::kCacheLineSize> trailing_padding_;
+};
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_SEQ_LOCKED_H_
@@ -0,0 +1,558 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  snapshot.h
+ *        \brief  Read-copy-update holder for immutable versions of read-mostly data.
+ *
+ *      \details  Readers access the current version without locks or reference counts: they announce the epoch they
+ *                read in, in a slot owned by their thread. A writer swaps in a new version and reclaims an old one only
+ *                after every reader has left the epochs in which the old version was visible.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_SYNC_SNAPSHOT_H_
+#define LIB_VAC_INCLUDE_VAC_SYNC_SNAPSHOT_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "vac/language/cache_line.h"
+#include "vac/language/throw_or_terminate.h"
+
+namespace vac {
+namespace sync {
+
+/*!
+ * \brief The epoch announcement of one reader thread.
+ */
+class EpochSlot final {
+ public:
+  /*!
+   * \brief Epoch value of a thread that is not reading.
+   */
+  static constexpr std::uint64_t kQuiescent{0};
+
+  /*!
+   * \brief Constructor.
+   */
+  EpochSlot() noexcept : leading_padding_(), epoch_(kQuiescent), depth_(0), in_use_(true), trailing_padding_() {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  EpochSlot(EpochSlot const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  EpochSlot& operator=(EpochSlot const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  EpochSlot(EpochSlot&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  EpochSlot& operator=(EpochSlot&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~EpochSlot() = default;
+
+  /*!
+   * \brief   Begin a read-side critical section. Called by the owning thread only, may be nested.
+   * \details The sequentially consistent store orders the announcement before the load of the protected pointer.
+   * \param   global_epoch The current global epoch.
+   */
+  void Enter(std::atomic<std::uint64_t> const& global_epoch) noexcept {
+    if (depth_ == 0U) {
+      epoch_.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+    }
+    ++depth_;
+  }
+
+  /*!
+   * \brief End a read-side critical section. Called by the owning thread only.
+   */
+  void Exit() noexcept {
+    --depth_;
+    if (depth_ == 0U) {
+      epoch_.store(kQuiescent, std::memory_order_release);
+    }
+  }
+
+  /*!
+   * \brief  The announced epoch.
+   * \return The epoch, kQuiescent if the thread is not reading.
+   */
+  std::uint64_t GetEpoch() const noexcept { return epoch_.load(std::memory_order_seq_cst); }
+
+  /*!
+   * \brief  Claim the slot for a thread if it is unused.
+   * \return True if the slot has been claimed.
+   */
+  bool TryClaim() noexcept {
+    bool expected{false};
+    return in_use_.compare_exchange_strong(expected, true, std::memory_order_acquire);
+  }
+
+  /*!
+   * \brief Return the slot on thread exit.
+   */
+  void Release() noexcept { in_use_.store(false, std::memory_order_release); }
+
+ private:
+  /*!
+   * \brief Keeps the slot off the cache line of the preceding allocation.
+   */
+  std::array<char, vac::language::kCacheLineSize> leading_padding_;
+
+  /*!
+   * \brief The announced epoch.
+   */
+  std::atomic<std::uint64_t> epoch_;
+
+  /*!
+   * \brief Nesting depth of the read-side critical sections. Owning thread only.
+   */
+  std::uint32_t depth_;
+
+  /*!
+   * \brief Whether a thread owns the slot.
+   */
+  std::atomic<bool> in_use_;
+
+  /*!
+   * \brief Keeps the slot off the cache line of the following allocation.
+   */
+  std::array<char, vac::language::kCacheLineSize> trailing_padding_;
+};
+
+/*!
+ * \brief   Process-wide epoch and the reader slots of all threads.
+ * \details Shared by all Snapshot instances: a reader of any snapshot delays reclamation in all of them.
+ */
+class EpochDomain final {
+ public:
+  /*!
+   * \brief  The process-wide domain.
+   * \return The domain.
+   */
+  static EpochDomain& Instance() {
+    static EpochDomain domain;
+    return domain;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  EpochDomain(EpochDomain const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  EpochDomain& operator=(EpochDomain const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  EpochDomain(EpochDomain&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  EpochDomain& operator=(EpochDomain&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~EpochDomain() = default;
+
+  /*!
+   * \brief  The global epoch.
+   * \return The epoch counter.
+   */
+  std::atomic<std::uint64_t> const& GetGlobalEpoch() const noexcept { return global_epoch_; }
+
+  /*!
+   * \brief  Start a new epoch.
+   * \return The epoch that has ended.
+   */
+  std::uint64_t Advance() noexcept { return global_epoch_.fetch_add(1, std::memory_order_seq_cst); }
+
+  /*!
+   * \brief  The oldest epoch a reader is still in. Threadsafe.
+   * \return The epoch, std::numeric_limits<std::uint64_t>::max() if no thread is reading.
+   */
+  std::uint64_t GetOldestActiveEpoch() const {
+    std::uint64_t oldest{std::numeric_limits<std::uint64_t>::max()};
+    std::lock_guard<std::mutex> const lock{mutex_};
+    for (std::unique_ptr<EpochSlot> const& slot : slots_) {
+      std::uint64_t const epoch{slot->GetEpoch()};
+      if (epoch != EpochSlot::kQuiescent) {
+        oldest = std::min(oldest, epoch);
+      }
+    }
+    return oldest;
+  }
+
+  /*!
+   * \brief  The slot of the calling thread, acquired on first use.
+   * \return The slot.
+   */
+  EpochSlot& GetThreadSlot() {
+    EpochSlot*& slot{ThreadSlot()};
+    if (slot == nullptr) {
+      slot = &AcquireSlot();
+    }
+    return *slot;
+  }
+
+ private:
+  /*!
+   * \brief Returns the slot of a thread to the domain when the thread exits.
+   */
+  class SlotReleaser final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param slot The slot of the calling thread.
+     */
+    explicit SlotReleaser(EpochSlot& slot) noexcept : slot_(slot) {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    SlotReleaser(SlotReleaser const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    SlotReleaser& operator=(SlotReleaser const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    SlotReleaser(SlotReleaser&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    SlotReleaser& operator=(SlotReleaser&&) & = delete;
+
+    /*!
+     * \brief Destructor. Releases the slot.
+     */
+    ~SlotReleaser() noexcept {
+      ThreadSlot() = nullptr;
+      slot_.Release();
+    }
+
+   private:
+    /*!
+     * \brief The slot of the thread.
+     */
+    EpochSlot& slot_;
+  };
+
+  /*!
+   * \brief Constructor. Epochs start at 1, 0 is EpochSlot::kQuiescent.
+   */
+  EpochDomain() : global_epoch_(1), mutex_(), slots_() {}
+
+  /*!
+   * \brief  The cached slot pointer of the calling thread.
+   * \return Reference to the pointer, nullptr if the thread has no slot.
+   */
+  static EpochSlot*& ThreadSlot() noexcept {
+    thread_local EpochSlot* slot{nullptr};
+    return slot;
+  }
+
+  /*!
+   * \brief  Reuse the slot of an exited thread or create a new one.
+   * \return The slot of the calling thread.
+   */
+  EpochSlot& AcquireSlot() {
+    EpochSlot* slot{nullptr};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      for (std::unique_ptr<EpochSlot> const& candidate : slots_) {
+        if ((slot == nullptr) && candidate->TryClaim()) {
+          slot = candidate.get();
+        }
+      }
+      if (slot == nullptr) {
+        slots_.emplace_back(new EpochSlot());
+        slot = slots_.back().get();
+      }
+    }
+    thread_local SlotReleaser const releaser{*slot};
+    static_cast<void>(releaser);
+    return *slot;
+  }
+
+  /*!
+   * \brief The global epoch.
+   */
+  std::atomic<std::uint64_t> global_epoch_;
+
+  /*!
+   * \brief Protects slots_.
+   */
+  mutable std::mutex mutex_;
+
+  /*!
+   * \brief The slots of all threads that ever read.
+   */
+  std::vector<std::unique_ptr<EpochSlot>> slots_;
+};
+
+/*!
+ * \brief   Holder of the current immutable version of a value, with lock-free and reference count free readers.
+ * \details Read() announces the calling thread in the EpochDomain and returns a guard giving access to the version that
+ *          was current at that time; the version stays alive as long as the guard exists. Publish() swaps in a new
+ *          version and retires the old one, which is destroyed with the deleter once no reader can access it anymore.
+ *          Reclamation is attempted on every Publish() and by Reclaim() and Synchronize().
+ * \tparam  T The value type.
+ * \tparam  Deleter The deleter destroying a version, e.g. vac::memory::SmartObjectPoolDeleter<T> for pooled versions.
+ */
+template <typename T, typename Deleter = std::default_delete<T>>
+class Snapshot final {
+ public:
+  /*!
+   * \brief Owning pointer to a version.
+   */
+  using Pointer = std::unique_ptr<T, Deleter>;
+
+  /*!
+   * \brief Read access to the version that was current when the guard was created.
+   */
+  class ReadGuard final {
+   public:
+    /*!
+     * \brief Constructor. Enters the read-side critical section of the calling thread.
+     * \param slot The slot of the calling thread.
+     * \param global_epoch The global epoch.
+     * \param current The current version pointer.
+     */
+    ReadGuard(EpochSlot& slot, std::atomic<std::uint64_t> const& global_epoch, std::atomic<T*> const& current) noexcept
+        : slot_(&slot), value_(nullptr) {
+      slot.Enter(global_epoch);
+      value_ = current.load(std::memory_order_seq_cst);
+    }
+
+    /*!
+     * \brief Copy constructor.
+     */
+    ReadGuard(ReadGuard const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    ReadGuard& operator=(ReadGuard const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     * \param other The guard to take over.
+     */
+    ReadGuard(ReadGuard&& other) noexcept : slot_(other.slot_), value_(other.value_) { other.slot_ = nullptr; }
+
+    /*!
+     * \brief Move assignment.
+     */
+    ReadGuard& operator=(ReadGuard&&) & = delete;
+
+    /*!
+     * \brief Destructor. Leaves the read-side critical section.
+     */
+    ~ReadGuard() noexcept {
+      if (slot_ != nullptr) {
+        slot_->Exit();
+      }
+    }
+
+    /*!
+     * \brief  The version.
+     * \return Reference to the version.
+     */
+    T const& operator*() const noexcept { return *value_; }
+
+    /*!
+     * \brief  The version.
+     * \return Pointer to the version.
+     */
+    T const* operator->() const noexcept { return value_; }
+
+    /*!
+     * \brief  The version.
+     * \return Pointer to the version.
+     */
+    T const* Get() const noexcept { return value_; }
+
+   private:
+    /*!
+     * \brief The slot of the reading thread, nullptr if moved from.
+     */
+    EpochSlot* slot_;
+
+    /*!
+     * \brief The version.
+     */
+    T* value_;
+  };
+
+  /*!
+   * \brief  Constructor.
+   * \param  initial The initial version.
+   * \throws std::invalid_argument If initial is empty.
+   */
+  explicit Snapshot(Pointer initial)
+      : domain_(EpochDomain::Instance()), current_(initial.get()), owner_(std::move(initial)), mutex_(), retired_() {
+    if (owner_ == nullptr) {
+      vac::language::ThrowOrTerminate<std::invalid_argument>("Snapshot requires an initial version");
+    }
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  Snapshot(Snapshot const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  Snapshot& operator=(Snapshot const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  Snapshot(Snapshot&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  Snapshot& operator=(Snapshot&&) & = delete;
+
+  /*!
+   * \brief Destructor. Destroys all versions. No reader must access the snapshot anymore.
+   */
+  ~Snapshot() = default;
+
+  /*!
+   * \brief  Access the current version. Threadsafe, lock-free and wait-free after the first call of a thread.
+   * \return The guard, which must be destroyed by the calling thread.
+   */
+  ReadGuard Read() const { return ReadGuard{domain_.GetThreadSlot(), domain_.GetGlobalEpoch(), current_}; }
+
+  /*!
+   * \brief  Make a new version current and retire the previous one. Threadsafe, writers are serialized.
+   * \details Must not be called by a thread holding a ReadGuard if it is followed by Synchronize().
+   * \param  version The new version.
+   * \throws std::invalid_argument If version is empty.
+   */
+  void Publish(Pointer version) {
+    if (version == nullptr) {
+      vac::language::ThrowOrTerminate<std::invalid_argument>("Snapshot cannot publish an empty version");
+    }
+    std::lock_guard<std::mutex> const lock{mutex_};
+    static_cast<void>(current_.exchange(version.get(), std::memory_order_seq_cst));
+    std::swap(owner_, version);
+    retired_.emplace_back(domain_.Advance(), std::move(version));
+    ReclaimLocked();
+  }
+
+  /*!
+   * \brief  Destroy the retired versions no reader can access anymore. Threadsafe.
+   * \return The number of retired versions that are still alive.
+   */
+  std::size_t Reclaim() {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    ReclaimLocked();
+    return retired_.size();
+  }
+
+  /*!
+   * \brief   Block until all retired versions have been destroyed. Threadsafe.
+   * \details Waits for every reader that may access a retired version. Must not be called while holding a ReadGuard.
+   */
+  void Synchronize() {
+    while (Reclaim() != 0U) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  /*!
+   * \brief A retired version with the epoch in which it was replaced.
+   */
+  using Retired = std::pair<std::uint64_t, Pointer>;
+
+  /*!
+   * \brief Destroy the retired versions replaced before the oldest active epoch. Called with mutex_ held.
+   */
+  void ReclaimLocked() {
+    if (!retired_.empty()) {
+      std::uint64_t const oldest{domain_.GetOldestActiveEpoch()};
+      typename std::vector<Retired>::iterator const reclaimable{std::partition(
+          retired_.begin(), retired_.end(), [oldest](Retired const& retired) { return retired.first >= oldest; })};
+      retired_.erase(reclaimable, retired_.end());
+    }
+  }
+
+  /*!
+   * \brief The epoch domain of the readers.
+   */
+  EpochDomain& domain_;
+
+  /*!
+   * \brief The current version, read by the readers.
+   */
+  std::atomic<T*> current_;
+
+  /*!
+   * \brief Owner of the current version.
+   */
+  Pointer owner_;
+
+  /*!
+   * \brief Serializes the writers.
+   */
+  std::mutex mutex_;
+
+  /*!
+   * \brief Retired versions not yet destroyed. Guarded by mutex_.
+   */
+  std::vector<Retired> retired_;
+};
+
+}  // namespace sync
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_SYNC_SNAPSHOT_H_
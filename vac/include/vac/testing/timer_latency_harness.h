@@ -0,0 +1,611 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  timer_latency_harness.h
+ *        \brief  Latency, jitter and throughput measurement for timer managers and reactors.
+ *
+ *      \details  Schedules a configurable population of periodic and one-shot timers on any TimerManager, drives it
+ *                through a caller-supplied event loop and records how late every timer fires relative to its expiry
+ *                point. Also measures the start/stop throughput of a TimerManager.
+ *                THIS FILE MUST NOT BE USED IN PRODUCTION CODE.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_TESTING_TIMER_LATENCY_HARNESS_H_
+#define LIB_VAC_INCLUDE_VAC_TESTING_TIMER_LATENCY_HARNESS_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "vac/metrics/log_linear_buckets.h"
+#include "vac/timer/timer.h"
+#include "vac/timer/timer_manager.h"
+#include "vac/timer/timer_reactor_interface.h"
+
+namespace vac {
+namespace testing {
+
+/*!
+ * \brief   Histogram of durations with a bounded relative error.
+ * \details Values are counted in the buckets of vac::metrics::LogLinearBuckets, so that reported percentiles are at
+ *          most 1/Buckets::kSubBuckets above the recorded value. Minimum and maximum are exact. Not threadsafe.
+ */
+class LatencyHistogram final {
+ public:
+  /*!
+   * \brief The bucket layout.
+   */
+  using Buckets = vac::metrics::LogLinearBuckets;
+
+  /*!
+   * \brief Constructor for an empty histogram.
+   */
+  LatencyHistogram() noexcept
+      : buckets_(), count_(0), sum_(0), min_(std::numeric_limits<std::uint64_t>::max()), max_(0) {}
+
+  /*!
+   * \brief Record one value. Negative durations are recorded as zero.
+   * \param value The value.
+   */
+  void Record(std::chrono::nanoseconds value) noexcept {
+    std::uint64_t const nanos{(value.count() > 0) ? static_cast<std::uint64_t>(value.count()) : std::uint64_t{0}};
+    ++buckets_[Buckets::ToBucket(nanos)];
+    ++count_;
+    sum_ += nanos;
+    min_ = std::min(min_, nanos);
+    max_ = std::max(max_, nanos);
+  }
+
+  /*!
+   * \brief Add all values of another histogram.
+   * \param other The other histogram.
+   */
+  void Merge(LatencyHistogram const& other) noexcept {
+    for (std::size_t index{0}; index < Buckets::kBuckets; ++index) {
+      buckets_[index] += other.buckets_[index];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  /*!
+   * \brief Remove all values.
+   */
+  void Reset() noexcept { *this = LatencyHistogram{}; }
+
+  /*!
+   * \brief  Number of recorded values.
+   * \return The count.
+   */
+  std::uint64_t Count() const noexcept { return count_; }
+
+  /*!
+   * \brief  Smallest recorded value.
+   * \return The minimum, or zero if the histogram is empty.
+   */
+  std::chrono::nanoseconds Min() const noexcept { return ToDuration((count_ == 0U) ? 0U : min_); }
+
+  /*!
+   * \brief  Largest recorded value.
+   * \return The maximum, or zero if the histogram is empty.
+   */
+  std::chrono::nanoseconds Max() const noexcept { return ToDuration(max_); }
+
+  /*!
+   * \brief  Arithmetic mean of the recorded values.
+   * \return The mean, or zero if the histogram is empty.
+   */
+  std::chrono::nanoseconds Mean() const noexcept { return ToDuration((count_ == 0U) ? 0U : (sum_ / count_)); }
+
+  /*!
+   * \brief  Determine the value below or at which the given fraction of the recorded values lies.
+   * \param  fraction The fraction in [0, 1], e.g. 0.99 for the 99th percentile.
+   * \return The upper bound of the bucket containing the percentile, limited to Max(). Zero if the histogram is empty.
+   */
+  std::chrono::nanoseconds Percentile(double fraction) const noexcept {
+    std::uint64_t result{0};
+    if (count_ != 0U) {
+      result = std::min(Buckets::Percentile(buckets_, count_, fraction), max_);
+    }
+    return ToDuration(result);
+  }
+
+  /*!
+   * \brief Write count, mean, p50, p99, p99.9 and maximum in microseconds as one line.
+   * \param out The stream to write to.
+   * \param label Name of the row.
+   */
+  void WriteSummary(std::ostream& out, char const* label) const {
+    out << label << ": n=" << count_ << " mean=" << ToMicros(Mean()) << "us p50=" << ToMicros(Percentile(0.5))
+        << "us p99=" << ToMicros(Percentile(0.99)) << "us p99.9=" << ToMicros(Percentile(0.999))
+        << "us max=" << ToMicros(Max()) << "us\n";
+  }
+
+ private:
+  /*!
+   * \brief  Convert a number of nanoseconds to a duration.
+   * \param  nanos The number of nanoseconds.
+   * \return The duration.
+   */
+  static std::chrono::nanoseconds ToDuration(std::uint64_t nanos) noexcept {
+    return std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(
+        std::min(nanos, static_cast<std::uint64_t>(std::numeric_limits<std::chrono::nanoseconds::rep>::max())))};
+  }
+
+  /*!
+   * \brief  Convert a duration to fractional microseconds for printing.
+   * \param  value The duration.
+   * \return The number of microseconds.
+   */
+  static double ToMicros(std::chrono::nanoseconds value) noexcept { return static_cast<double>(value.count()) / 1e3; }
+
+  /*!
+   * \brief The number of values per bucket.
+   */
+  std::array<std::uint64_t, Buckets::kBuckets> buckets_;
+
+  /*!
+   * \brief The number of values.
+   */
+  std::uint64_t count_;
+
+  /*!
+   * \brief The sum of all values in nanoseconds.
+   */
+  std::uint64_t sum_;
+
+  /*!
+   * \brief The smallest value in nanoseconds.
+   */
+  std::uint64_t min_;
+
+  /*!
+   * \brief The largest value in nanoseconds.
+   */
+  std::uint64_t max_;
+};
+
+/*!
+ * \brief   Minimal reactor that sleeps on a condition variable until the next timer expiry.
+ * \details Used to drive a TimerManager that is not attached to an I/O reactor. Unblock() is threadsafe.
+ */
+class ConditionVariableTimerReactor final : public vac::timer::TimerReactorInterface {
+ public:
+  /*!
+   * \brief Constructor.
+   */
+  ConditionVariableTimerReactor() : mutex_(), condition_(), unblocked_(false), wakeups_(0) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  ConditionVariableTimerReactor(ConditionVariableTimerReactor const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  ConditionVariableTimerReactor& operator=(ConditionVariableTimerReactor const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  ConditionVariableTimerReactor(ConditionVariableTimerReactor&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  ConditionVariableTimerReactor& operator=(ConditionVariableTimerReactor&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~ConditionVariableTimerReactor() override = default;
+
+  /*!
+   * \brief Wake up RunUntil() to recompute the next expiry.
+   */
+  void Unblock() override {
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      unblocked_ = true;
+    }
+    condition_.notify_one();
+  }
+
+  /*!
+   * \brief Handle the timers of a manager until the given point in time.
+   * \param manager The manager, constructed with this reactor.
+   * \param end The point in time to return at.
+   */
+  void RunUntil(vac::timer::TimerManager& manager, vac::timer::Timer::Clock::time_point end) {
+    vac::timer::Timer::Clock::time_point now{vac::timer::Timer::Clock::now()};
+    while (now < end) {
+      std::pair<bool, struct timeval> const next{manager.GetNextExpiry()};
+      vac::timer::Timer::Clock::time_point deadline{end};
+      if (next.first) {
+        deadline = std::min(deadline, now + std::chrono::seconds{next.second.tv_sec} +
+                                          std::chrono::microseconds{next.second.tv_usec});
+      }
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        static_cast<void>(condition_.wait_until(lock, deadline, [this]() { return unblocked_; }));
+        unblocked_ = false;
+      }
+      ++wakeups_;
+      manager.HandleTimerExpiry();
+      now = vac::timer::Timer::Clock::now();
+    }
+  }
+
+  /*!
+   * \brief  Number of times RunUntil() has handled the timers.
+   * \return The number of wake-ups.
+   */
+  std::uint64_t GetWakeups() const noexcept { return wakeups_; }
+
+ private:
+  /*!
+   * \brief Mutex protecting unblocked_.
+   */
+  std::mutex mutex_;
+
+  /*!
+   * \brief Signalled by Unblock().
+   */
+  std::condition_variable condition_;
+
+  /*!
+   * \brief Whether Unblock() has been called since the last wake-up.
+   */
+  bool unblocked_;
+
+  /*!
+   * \brief The number of wake-ups.
+   */
+  std::uint64_t wakeups_;
+};
+
+/*!
+ * \brief Configuration of a TimerLatencyHarness run.
+ */
+struct TimerLatencyConfig {
+  /*!
+   * \brief Number of periodic timers. Their phases are spread evenly over one period.
+   */
+  std::size_t periodic_timers{100};
+
+  /*!
+   * \brief Period of the periodic timers.
+   */
+  vac::timer::Timer::Clock::duration period{std::chrono::milliseconds{10}};
+
+  /*!
+   * \brief Number of one-shot timers. Each is re-armed with a new random timeout after it has fired.
+   */
+  std::size_t one_shot_timers{100};
+
+  /*!
+   * \brief Shortest timeout of the one-shot timers.
+   */
+  vac::timer::Timer::Clock::duration min_timeout{std::chrono::milliseconds{1}};
+
+  /*!
+   * \brief Longest timeout of the one-shot timers.
+   */
+  vac::timer::Timer::Clock::duration max_timeout{std::chrono::milliseconds{50}};
+
+  /*!
+   * \brief Time to run the event loop.
+   */
+  vac::timer::Timer::Clock::duration duration{std::chrono::seconds{1}};
+
+  /*!
+   * \brief Seed of the random timeouts, so that runs against different managers are comparable.
+   */
+  std::uint32_t seed{1};
+};
+
+/*!
+ * \brief Lateness measured by a TimerLatencyHarness run.
+ */
+struct TimerLatencyReport {
+  /*!
+   * \brief Lateness of the periodic timers.
+   */
+  LatencyHistogram periodic;
+
+  /*!
+   * \brief Lateness of the one-shot timers.
+   */
+  LatencyHistogram one_shot;
+
+  /*!
+   * \brief Write one summary line per histogram.
+   * \param out The stream to write to.
+   */
+  void WriteSummary(std::ostream& out) const {
+    periodic.WriteSummary(out, "periodic");
+    one_shot.WriteSummary(out, "one-shot");
+  }
+};
+
+/*!
+ * \brief   Measures how late timers fire relative to their expiry point.
+ * \details The timers are started on the calling thread before the event loop is entered and stopped after it has
+ *          returned. Everything in between happens in the handlers, i.e. on the thread running the event loop.
+ *          Timers expiring after the end of the run are not re-armed, so that the event loop terminates even if the
+ *          manager cannot keep up with the population.
+ */
+class TimerLatencyHarness final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param config The population of timers and the duration of a run.
+   */
+  explicit TimerLatencyHarness(TimerLatencyConfig const& config) : config_(config), random_(config.seed), end_() {}
+
+  /*!
+   * \brief   Run the timer population on a manager.
+   * \tparam  EventLoop Callable with the signature void(vac::timer::Timer::Clock::time_point end) that handles the
+   *          timers of the manager until end, e.g. ConditionVariableTimerReactor::RunUntil() or a loop around
+   *          vac::reactor::EpollReactor::HandleEvents().
+   * \param   manager The manager to schedule the timers on.
+   * \param   event_loop The event loop driving the manager.
+   * \return  The lateness of all fired timers.
+   */
+  template <typename EventLoop>
+  TimerLatencyReport Run(vac::timer::TimerManager& manager, EventLoop&& event_loop) {
+    TimerLatencyReport report{};
+    std::vector<std::unique_ptr<ProbeTimer>> timers{};
+    timers.reserve(config_.periodic_timers + config_.one_shot_timers);
+    vac::timer::Timer::Clock::time_point const start{vac::timer::Timer::Clock::now()};
+    end_ = start + config_.duration;
+    for (std::size_t index{0}; index < config_.periodic_timers; ++index) {
+      timers.emplace_back(std::make_unique<ProbeTimer>(&manager, *this, report.periodic, true));
+      // Spread the first expiries over one period, then continue periodically.
+      timers.back()->SetOneShot(start + ((config_.period * static_cast<vac::timer::Timer::Clock::rep>(index + 1)) /
+                                         static_cast<vac::timer::Timer::Clock::rep>(config_.periodic_timers)));
+      timers.back()->Start();
+    }
+    for (std::size_t index{0}; index < config_.one_shot_timers; ++index) {
+      timers.emplace_back(std::make_unique<ProbeTimer>(&manager, *this, report.one_shot, false));
+      timers.back()->SetOneShot(start + NextTimeout());
+      timers.back()->Start();
+    }
+    std::forward<EventLoop>(event_loop)(end_);
+    for (std::unique_ptr<ProbeTimer>& timer : timers) {
+      timer->Stop();
+    }
+    return report;
+  }
+
+ private:
+  /*!
+   * \brief Timer recording its lateness on every expiry.
+   */
+  class ProbeTimer final : public vac::timer::Timer {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param manager The manager of the timer.
+     * \param harness The harness providing the timeouts.
+     * \param histogram The histogram to record the lateness into.
+     * \param periodic Whether the timer switches to periodic mode after its first expiry.
+     */
+    ProbeTimer(vac::timer::TimerManager* manager, TimerLatencyHarness& harness, LatencyHistogram& histogram,
+               bool periodic)
+        : vac::timer::Timer(manager), harness_(harness), histogram_(histogram), periodic_(periodic), started_(false) {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    ProbeTimer(ProbeTimer const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    ProbeTimer& operator=(ProbeTimer const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    ProbeTimer(ProbeTimer&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    ProbeTimer& operator=(ProbeTimer&&) & = delete;
+
+    /*!
+     * \brief Destructor.
+     */
+    ~ProbeTimer() override = default;
+
+    /*!
+     * \brief  Record the lateness and re-arm the timer.
+     * \return True to keep a periodic timer running.
+     */
+    bool HandleTimer() override {
+      Clock::time_point const now{Clock::now()};
+      histogram_.Record(now - GetNextExpiry());
+      bool restart{true};
+      if (now >= harness_.end_) {
+        restart = false;
+      } else if (!periodic_) {
+        SetOneShot(now + harness_.NextTimeout());
+        Start();
+      } else if (!started_) {
+        // The first expiry has set the phase. The period counts from the actual expiry.
+        started_ = true;
+        SetPeriod(harness_.config_.period);
+        Start();
+        restart = false;
+      } else {
+        // Periodic timers are restarted by the caller.
+      }
+      return restart;
+    }
+
+   private:
+    /*!
+     * \brief The harness providing the timeouts.
+     */
+    TimerLatencyHarness& harness_;
+
+    /*!
+     * \brief The histogram to record the lateness into.
+     */
+    LatencyHistogram& histogram_;
+
+    /*!
+     * \brief Whether the timer switches to periodic mode after its first expiry.
+     */
+    bool const periodic_;
+
+    /*!
+     * \brief Whether the periodic mode has been entered.
+     */
+    bool started_;
+  };
+
+  /*!
+   * \brief  Draw a random one-shot timeout.
+   * \return A timeout between TimerLatencyConfig::min_timeout and TimerLatencyConfig::max_timeout.
+   */
+  vac::timer::Timer::Clock::duration NextTimeout() {
+    std::uniform_int_distribution<vac::timer::Timer::Clock::rep> distribution{
+        config_.min_timeout.count(), std::max(config_.min_timeout, config_.max_timeout).count()};
+    return vac::timer::Timer::Clock::duration{distribution(random_)};
+  }
+
+  /*!
+   * \brief The population of timers and the duration of a run.
+   */
+  TimerLatencyConfig const config_;
+
+  /*!
+   * \brief Generator of the one-shot timeouts.
+   */
+  std::minstd_rand random_;
+
+  /*!
+   * \brief End of the current run.
+   */
+  vac::timer::Timer::Clock::time_point end_;
+};
+
+/*!
+ * \brief Throughput measured by MeasureStartStopThroughput().
+ */
+struct TimerThroughputResult {
+  /*!
+   * \brief Number of Timer::Start() and Timer::Stop() calls.
+   */
+  std::uint64_t operations{0};
+
+  /*!
+   * \brief Wall-clock time of all calls.
+   */
+  std::chrono::nanoseconds elapsed{0};
+
+  /*!
+   * \brief  Average rate of the calls.
+   * \return Operations per second.
+   */
+  double OperationsPerSecond() const noexcept {
+    return (elapsed.count() > 0) ? ((static_cast<double>(operations) * 1e9) / static_cast<double>(elapsed.count()))
+                                 : 0.0;
+  }
+};
+
+/*!
+ * \brief   Measure how fast timers can be started and stopped on a manager.
+ * \details Every thread owns timers_per_thread timers. In each round it starts all of them with random timeouts of
+ *          one to two seconds, so that none fires during the measurement, and then stops all of them. More than one
+ *          thread requires a threadsafe manager.
+ * \param   manager The manager to measure.
+ * \param   timers_per_thread The number of timers per thread.
+ * \param   rounds The number of start/stop rounds.
+ * \param   threads The number of threads.
+ * \return  The number of calls and the time taken.
+ */
+inline TimerThroughputResult MeasureStartStopThroughput(vac::timer::TimerManager& manager,
+                                                        std::size_t timers_per_thread, std::size_t rounds,
+                                                        std::size_t threads = 1) {
+  /*!
+   * \brief Timer that is never expected to fire.
+   */
+  class IdleTimer final : public vac::timer::Timer {
+   public:
+    using vac::timer::Timer::Timer;
+
+    /*!
+     * \brief  Does nothing.
+     * \return False.
+     */
+    bool HandleTimer() override { return false; }
+  };
+
+  vac::timer::Timer::Clock::time_point const start{vac::timer::Timer::Clock::now()};
+  std::vector<std::thread> workers{};
+  workers.reserve(threads);
+  for (std::size_t thread{0}; thread < threads; ++thread) {
+    workers.emplace_back([&manager, timers_per_thread, rounds, thread]() {
+      std::minstd_rand random{static_cast<std::minstd_rand::result_type>(thread + 1)};
+      std::uniform_int_distribution<std::int64_t> distribution{1000, 2000};
+      std::vector<std::unique_ptr<IdleTimer>> timers{};
+      timers.reserve(timers_per_thread);
+      for (std::size_t index{0}; index < timers_per_thread; ++index) {
+        timers.emplace_back(std::make_unique<IdleTimer>(&manager));
+      }
+      for (std::size_t round{0}; round < rounds; ++round) {
+        for (std::unique_ptr<IdleTimer>& timer : timers) {
+          timer->SetOneShot(std::chrono::milliseconds{distribution(random)});
+          timer->Start();
+        }
+        for (std::unique_ptr<IdleTimer>& timer : timers) {
+          timer->Stop();
+        }
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  TimerThroughputResult result{};
+  result.operations = static_cast<std::uint64_t>(threads * timers_per_thread * rounds * 2U);
+  result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(vac::timer::Timer::Clock::now() - start);
+  return result;
+}
+
+}  // namespace testing
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_TESTING_TIMER_LATENCY_HARNESS_H_
@@ -0,0 +1,93 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  executor.h
+ *        \brief  Executor interface to dispatch tasks to an execution context, and an inline implementation.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_THREADPOOL_EXECUTOR_H_
+#define LIB_VAC_INCLUDE_VAC_THREADPOOL_EXECUTOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <functional>
+
+namespace vac {
+namespace threadpool {
+
+/*!
+ * \brief An execution context tasks can be dispatched to.
+ */
+class Executor {
+ public:
+  /*!
+   * \brief Type of the tasks accepted by an Executor.
+   */
+  using Task = std::function<void()>;
+
+  /*!
+   * \brief Default constructor.
+   */
+  Executor() = default;
+
+  /*!
+   * \brief Destructor.
+   */
+  virtual ~Executor() = default;
+
+  /*!
+   * \brief Copy constructor.
+   */
+  Executor(Executor const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  Executor(Executor&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  Executor& operator=(Executor const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  Executor& operator=(Executor&&) & = delete;
+
+  /*!
+   * \brief   Dispatch a task to this execution context.
+   * \details The task is executed exactly once, either in the context of this call or later in the execution context.
+   * \param   task The task to execute.
+   */
+  virtual void Execute(Task task) = 0;
+};
+
+/*!
+ * \brief Executor that runs every task in the context of Execute().
+ */
+class InlineExecutor final : public Executor {
+ public:
+  /*!
+   * \brief Runs the task immediately.
+   * \param task The task to execute.
+   */
+  void Execute(Task task) override { task(); }
+};
+
+}  // namespace threadpool
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_THREADPOOL_EXECUTOR_H_
@@ -31,17 +31,22 @@
 
 #include "vac/container/static_list.h"
 #include "vac/memory/phase_managed_allocator.h"
+#include "vac/metrics/metrics_registry.h"
+#include "vac/sync/profiled_mutex.h"
 #include "vac/testing/test_adapter.h"
 #include "vac/threadpool/work_unit.h"
+#include "vac/trace/trace.h"
 
 namespace vac {
 namespace threadpool {
 
 /*!
- * \brief Implements a thread pool with a given capacity.
- * \trace CREQ-158635
+ * \brief  Implements a thread pool with a given capacity.
+ * \tparam W The work unit type.
+ * \tparam Mutex The mutex protecting the work queue, e.g. vac::sync::ProfiledMutex to profile its contention.
+ * \trace  CREQ-158635
  */
-template <class W>
+template <class W, typename Mutex = vac::sync::DefaultMutex>
 class ThreadPool {
   static_assert(std::is_base_of<WorkUnit, W>::value, "W must inherit from WorkUnit");
 
@@ -51,6 +56,12 @@ class ThreadPool {
    */
   using WorkQueueType = vac::container::StaticList<W>;
 
+  /*!
+   * \brief Typedef for the condition variable, std::condition_variable_any unless Mutex is a std::mutex.
+   */
+  using ConditionVariableType = typename std::conditional<std::is_same<Mutex, std::mutex>::value,
+                                                          std::condition_variable, std::condition_variable_any>::type;
+
   /*!
    * \brief Builds a new thread pool and starts the worker threads.
    * \param number_threads The number of worker threads to start.
@@ -99,16 +110,18 @@ class ThreadPool {
   /*!
    * \brief  Submit a WorkUnit to the Thread Pool.
    * \param  args Arguments used to instantiate a new workUnit.
-   * \return True if the workUnit has been submitted successfully.
+   * \return True if the workUnit has been submitted successfully, false if the queue is full or Stop() was called.
    */
   template <typename... Args>
   bool SubmitWork(Args&&... args) {
     bool ret_value{false};
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
-    if (!work_queue_.full()) {
+    std::unique_lock<Mutex> lock(work_queue_mutex_);
+    if (running_ && (!work_queue_.full())) {
       work_queue_.emplace_back(std::forward<Args>(args)...);
       work_queue_condvar_.notify_one();
       ret_value = true;
+    } else {
+      VAC_METRICS_COUNTER_ADD("vac.threadpool.rejected", 1U);
     }
     return ret_value;
   }
@@ -119,16 +132,33 @@ class ThreadPool {
    */
   inline void Stop() {
     running_ = false;
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
+    std::unique_lock<Mutex> lock(work_queue_mutex_);
     work_queue_condvar_.notify_all();
   }
 
+  /*!
+   * \brief   Run the work units still in the queue in the calling thread.
+   * \details Call after Stop(), so that queued work is not lost. Work units that workers are running at the same time
+   *          are not waited for.
+   */
+  void RunRemainingWork() {
+    std::unique_lock<Mutex> lock(work_queue_mutex_);
+    while (!work_queue_.empty()) {
+      W work_unit{work_queue_.front()};
+      work_queue_.pop_front();
+      lock.unlock();
+      work_unit.Run();
+      VAC_METRICS_COUNTER_ADD("vac.threadpool.work_units", 1U);
+      lock.lock();
+    }
+  }
+
   /*!
    * \brief  Check if the queue is full or not.
    * \return True if the queue is full. The queue is full and no other work can be submitted.
    */
   inline bool IsQueueFull() {
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
+    std::unique_lock<Mutex> lock(work_queue_mutex_);
     return work_queue_.full();
   }
 
@@ -149,7 +179,7 @@ class ThreadPool {
    * \trace   CREQ-158637
    */
   void WorkOne() {
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
+    std::unique_lock<Mutex> lock(work_queue_mutex_);
     while (running_ && work_queue_.empty()) {
       work_queue_condvar_.wait(lock);
     }
@@ -159,7 +189,9 @@ class ThreadPool {
       lock.unlock();
 
       // execute the task in front of the queue
+      VAC_TRACE_SCOPE("vac::threadpool::ThreadPool::WorkOne");
       work_unit.Run();
+      VAC_METRICS_COUNTER_ADD("vac.threadpool.work_units", 1U);
     }
   }
 
@@ -171,12 +203,12 @@ class ThreadPool {
   /*!
    * \brief Mutex to protect concurrent access to the work queue.
    */
-  std::mutex work_queue_mutex_{};
+  vac::sync::NamedMutex<Mutex> work_queue_mutex_{"vac::threadpool::ThreadPool"};
 
   /*!
    * \brief Condition Variable to protect concurrent access to the work queue.
    */
-  std::condition_variable work_queue_condvar_{};
+  ConditionVariableType work_queue_condvar_{};
 
   /*!
    * \brief The work queue.
@@ -0,0 +1,128 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  thread_pool_executor.h
+ *        \brief  Executor running tasks on the worker threads of a ThreadPool.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_THREADPOOL_THREAD_POOL_EXECUTOR_H_
+#define LIB_VAC_INCLUDE_VAC_THREADPOOL_THREAD_POOL_EXECUTOR_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+#include "vac/threadpool/executor.h"
+#include "vac/threadpool/thread_pool.h"
+#include "vac/threadpool/work_unit.h"
+
+namespace vac {
+namespace threadpool {
+
+/*!
+ * \brief WorkUnit running an Executor::Task.
+ */
+class TaskWorkUnit final : public WorkUnit {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param task The task to run.
+   */
+  explicit TaskWorkUnit(Executor::Task task) : WorkUnit(), task_(std::move(task)) {}
+
+  /*!
+   * \brief Runs the task.
+   */
+  void Run() noexcept override { task_(); }
+
+  /*!
+   * \brief Print identifying information about this WorkUnit.
+   * \param stream Output stream.
+   */
+  void PrintToStream(std::ostream& stream) const override { stream << "TaskWorkUnit"; }
+
+ private:
+  /*!
+   * \brief The task to run.
+   */
+  Executor::Task task_;
+};
+
+/*!
+ * \brief   Executor that runs tasks on the worker threads of a ThreadPool.
+ * \details Tasks must not throw, since they are run as WorkUnit::Run(). If the work queue is full or the executor is
+ *          being destroyed, the task is run in the context of Execute() instead, so that no task is ever dropped.
+ */
+class ThreadPoolExecutor final : public Executor {
+ public:
+  /*!
+   * \brief Constructor. Starts the worker threads.
+   * \param number_threads The number of worker threads.
+   * \param queue_length The maximum number of tasks waiting for a worker.
+   */
+  ThreadPoolExecutor(std::size_t number_threads, std::size_t queue_length)
+      : Executor(), thread_pool_(number_threads, queue_length) {}
+
+  /*!
+   * \brief Destructor. Stops the worker threads and runs the tasks still in the queue in the calling thread.
+   */
+  ~ThreadPoolExecutor() override {
+    thread_pool_.Stop();
+    thread_pool_.RunRemainingWork();
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  ThreadPoolExecutor(ThreadPoolExecutor const&) = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  ThreadPoolExecutor(ThreadPoolExecutor&&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  ThreadPoolExecutor& operator=(ThreadPoolExecutor const&) & = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  ThreadPoolExecutor& operator=(ThreadPoolExecutor&&) & = delete;
+
+  /*!
+   * \brief Queues the task for a worker thread, or runs it immediately if the queue is full or the pool is stopped.
+   * \param task The task to execute.
+   */
+  void Execute(Task task) override {
+    if (!thread_pool_.SubmitWork(task)) {
+      task();
+    }
+  }
+
+ private:
+  /*!
+   * \brief The thread pool the tasks are run on.
+   */
+  ThreadPool<TaskWorkUnit> thread_pool_;
+};
+
+}  // namespace threadpool
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_THREADPOOL_THREAD_POOL_EXECUTOR_H_
@@ -0,0 +1,353 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  threadsafe_timing_wheel_timer_manager.h
+ *        \brief  Header file for the ThreadSafeTimingWheelTimerManager class.
+ *
+ *      \details  A thread-safe version of the TimingWheelTimerManager class that does not lock. Threads other than
+ *                the reactor thread post their operations into a lock-free queue, which the reactor thread applies
+ *                before it computes the next expiry or fires timers.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_TIMER_THREADSAFE_TIMING_WHEEL_TIMER_MANAGER_H_
+#define LIB_VAC_INCLUDE_VAC_TIMER_THREADSAFE_TIMING_WHEEL_TIMER_MANAGER_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <sys/time.h>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "vac/memory/generated_memory_config.h"
+#include "vac/memory/thread_local_block_pool.h"
+#include "vac/sync/mpsc_queue.h"
+#include "vac/timer/timer.h"
+#include "vac/timer/timer_reactor_interface.h"
+#include "vac/timer/timing_wheel_timer_manager.h"
+
+namespace vac {
+namespace timer {
+
+/*!
+ * \brief   A thread-safe timer manager that does not block the reactor thread.
+ * \details The reactor thread is the thread that calls GetNextExpiry() and HandleTimerExpiry(); only one thread may
+ *          do so. On the reactor thread, AddTimer() and RemoveTimer() are applied directly. On all other threads they
+ *          post a command into a lock-free MPSC queue and return without waiting for the reactor, except that
+ *          RemoveTimer() waits for the handler of the removed timer to return if it is running at that moment.
+ *          Therefore a timer may be destroyed by any thread once Timer::Stop() has returned.
+ *          TimerReactorInterface::Unblock() is only called if a posted timer expires before the deadline the reactor
+ *          currently waits for.
+ *          A running timer must only be reconfigured with Timer::SetOneShot() or Timer::SetPeriod() if it is
+ *          restarted with Timer::Start() afterwards, which samples its expiry point in the calling thread.
+ */
+class ThreadSafeTimingWheelTimerManager final : public TimingWheelTimerManager {
+ public:
+  /*!
+   * \brief Constructor for a ThreadSafeTimingWheelTimerManager linked to a given reactor.
+   * \param reactor The reactor to unblock when a new earliest timer is added.
+   * \param config The configuration of the wheel.
+   */
+  explicit ThreadSafeTimingWheelTimerManager(TimerReactorInterface* reactor, TimingWheelConfig const& config = {})
+      : TimingWheelTimerManager(reactor, config),
+        reactor_(reactor),
+        commands_(),
+        reactor_thread_(std::thread::id{}),
+        firing_(nullptr),
+        deadline_(kNoDeadline) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  ThreadSafeTimingWheelTimerManager(ThreadSafeTimingWheelTimerManager const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  ThreadSafeTimingWheelTimerManager& operator=(ThreadSafeTimingWheelTimerManager const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  ThreadSafeTimingWheelTimerManager(ThreadSafeTimingWheelTimerManager&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  ThreadSafeTimingWheelTimerManager& operator=(ThreadSafeTimingWheelTimerManager&&) & = delete;
+
+  /*!
+   * \brief Destructor. Discards all commands that have not been applied.
+   */
+  ~ThreadSafeTimingWheelTimerManager() override {
+    for (Command* command{commands_.Pop()}; command != nullptr; command = commands_.Pop()) {
+      Dispose(command);
+    }
+  }
+
+  /*!
+   * \brief   Add a timer to be considered when computing the next expiry.
+   * \details Lock-free on threads other than the reactor thread. Must not call the expiry handler in its context.
+   * \param   timer Pointer to a Timer object.
+   */
+  void AddTimer(Timer* const timer) override {
+    if (IsReactorThread()) {
+      ApplyCommands();
+      TimingWheelTimerManager::AddTimer(timer);
+    } else {
+      Timer::Clock::time_point const expiry{timer->GetNextExpiry()};
+      PostSettled(Command::Kind::kSchedule, timer, timer, expiry);
+      if (LowerDeadline(expiry) && (reactor_ != nullptr)) {
+        reactor_->Unblock();
+      }
+    }
+  }
+
+  /*!
+   * \brief   No longer consider a timer when computing the next expiry.
+   * \details Lock-free on threads other than the reactor thread, unless the handler of the timer is running. Must not
+   *          call the expiry handler in its context.
+   * \param   timer Pointer to a Timer object.
+   */
+  void RemoveTimer(Timer const* timer) override {
+    if (IsReactorThread()) {
+      ApplyCommands();
+      TimingWheelTimerManager::RemoveTimer(timer);
+    } else {
+      PostSettled(Command::Kind::kUnschedule, timer, nullptr, Timer::Clock::time_point{});
+    }
+  }
+
+  /* VECTOR Next Construct AutosarC++17_10-A5.2.3: MD_VAC_A5.2.3_constCastReducesCodeDuplication */
+  /*!
+   * \brief   Return a pair of bool and timeval struct for the next expiring timer.
+   * \details Must be called by the reactor thread. Applies all posted commands first.
+   * \return  A pair of bool (if valid NextExpiry) and timeval (relative to the current time representing the next
+   *          expiring timer if valid).
+   */
+  std::pair<bool, struct timeval> const GetNextExpiry() const override {
+    // The reactor thread owns the wheel; GetNextExpiry() is only const because of the TimerManager interface.
+    ThreadSafeTimingWheelTimerManager& self{const_cast<ThreadSafeTimingWheelTimerManager&>(*this)};
+    self.EnterReactorThread();
+    std::pair<bool, Timer::Clock::time_point> const deadline{GetNextDeadline()};
+    deadline_.store(deadline.first ? deadline.second.time_since_epoch().count() : kNoDeadline,
+                    std::memory_order_seq_cst);
+    return TimingWheelTimerManager::GetNextExpiry();
+  }
+
+  /*!
+   * \brief   Callback to trigger firing timers.
+   * \details Must be called by the reactor thread. Applies all posted commands first, and again before each handler,
+   *          so that a timer stopped by another thread is not fired.
+   */
+  void HandleTimerExpiry() override {
+    EnterReactorThread();
+    std::uint64_t const target{AdvanceToNow()};
+    for (Timer* timer{PopExpired()}; timer != nullptr; timer = PopExpired()) {
+      firing_.store(timer, std::memory_order_seq_cst);
+      ApplyCommands();
+      ExpireTimer(timer, target);
+      firing_.store(nullptr, std::memory_order_seq_cst);
+    }
+  }
+
+ private:
+  /*!
+   * \brief Value of deadline_ while the reactor does not wait for a deadline.
+   */
+  static constexpr Timer::Clock::rep kNoDeadline{std::numeric_limits<Timer::Clock::rep>::max()};
+
+  /*!
+   * \brief An operation posted by a thread other than the reactor thread.
+   */
+  class Command final : public vac::sync::MpscQueueNode {
+   public:
+    /*!
+     * \brief Kinds of operations.
+     */
+    enum class Kind : std::uint8_t {
+      /*!
+       * \brief Schedule or reschedule a timer.
+       */
+      kSchedule,
+      /*!
+       * \brief Remove a timer.
+       */
+      kUnschedule
+    };
+
+    /*!
+     * \brief Constructor.
+     * \param kind The operation.
+     * \param key The timer. It is not dereferenced.
+     * \param timer The timer for kSchedule, nullptr otherwise.
+     * \param expiry The expiry point, sampled by the posting thread.
+     */
+    Command(Kind kind, Timer const* key, Timer* timer, Timer::Clock::time_point expiry) noexcept
+        : vac::sync::MpscQueueNode(), kind_(kind), key_(key), timer_(timer), expiry_(expiry) {}
+
+    /*!
+     * \brief The operation.
+     */
+    Kind const kind_;
+
+    /*!
+     * \brief The timer the operation applies to.
+     */
+    Timer const* const key_;
+
+    /*!
+     * \brief The timer for kSchedule, nullptr otherwise.
+     */
+    Timer* const timer_;
+
+    /*!
+     * \brief The expiry point for kSchedule.
+     */
+    Timer::Clock::time_point const expiry_;
+  };
+
+  /*!
+   * \brief   Pool the commands are allocated from.
+   * \details Commands are allocated by the posting threads and freed by the reactor thread, which passes them back
+   *          to the posting threads through the depot of the pool.
+   */
+  using CommandPool = vac::memory::ThreadLocalBlockPool<vac::memory::BlockSizeClass(sizeof(Command)),
+                                                        vac::memory::kTimerCommandPoolCacheSize>;
+
+  /*!
+   * \brief  Determine whether the calling thread is the reactor thread.
+   * \return True if the calling thread is the reactor thread, false otherwise.
+   */
+  bool IsReactorThread() const noexcept {
+    return reactor_thread_.load(std::memory_order_acquire) == std::this_thread::get_id();
+  }
+
+  /*!
+   * \brief Register the calling thread as reactor thread and apply the posted commands.
+   */
+  void EnterReactorThread() {
+    reactor_thread_.store(std::this_thread::get_id(), std::memory_order_release);
+    // Posting threads unblock the reactor while its deadline is being recomputed.
+    deadline_.store(kNoDeadline, std::memory_order_seq_cst);
+    ApplyCommands();
+  }
+
+  /*!
+   * \brief Post a command to the reactor thread.
+   * \param kind The operation.
+   * \param key The timer the operation applies to.
+   * \param timer The timer for kSchedule, nullptr otherwise.
+   * \param expiry The expiry point for kSchedule.
+   */
+  void Post(Command::Kind kind, Timer const* key, Timer* timer, Timer::Clock::time_point expiry) {
+    Command* const command{::new (CommandPool::Allocate()) Command(kind, key, timer, expiry)};
+    commands_.Push(*command);
+  }
+
+  /*!
+   * \brief   Post a command to the reactor thread, so that it is not overridden by a running handler of the timer.
+   * \details Pairs with the store of firing_ in HandleTimerExpiry(): either the reactor applies the command before it
+   *          fires the timer, or this thread sees that the handler is running. In the latter case the handler may
+   *          restart the timer after the command has been applied, so the command is posted again once the handler
+   *          has returned.
+   * \param   kind The operation.
+   * \param   key The timer the operation applies to.
+   * \param   timer The timer for kSchedule, nullptr otherwise.
+   * \param   expiry The expiry point for kSchedule.
+   */
+  void PostSettled(Command::Kind kind, Timer const* key, Timer* timer, Timer::Clock::time_point expiry) {
+    bool overlapped{true};
+    while (overlapped) {
+      Post(kind, key, timer, expiry);
+      overlapped = false;
+      while (firing_.load(std::memory_order_seq_cst) == key) {
+        overlapped = true;
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /*!
+   * \brief Apply all posted commands in the order they have been posted. Must be called by the reactor thread.
+   */
+  void ApplyCommands() {
+    for (Command* command{commands_.Pop()}; command != nullptr; command = commands_.Pop()) {
+      if (command->kind_ == Command::Kind::kSchedule) {
+        static_cast<void>(ScheduleTimer(command->timer_, command->expiry_));
+      } else {
+        UnscheduleTimer(command->key_);
+      }
+      Dispose(command);
+    }
+  }
+
+  /*!
+   * \brief Destroy a command and return its memory to the pool.
+   * \param command The command.
+   */
+  static void Dispose(Command* command) noexcept {
+    command->~Command();
+    CommandPool::Deallocate(command);
+  }
+
+  /*!
+   * \brief  Lower the deadline the reactor waits for to the given expiry point.
+   * \param  expiry The expiry point of a posted timer.
+   * \return True if the deadline has been lowered and the reactor has to be unblocked, false otherwise.
+   */
+  bool LowerDeadline(Timer::Clock::time_point expiry) noexcept {
+    Timer::Clock::rep const wanted{expiry.time_since_epoch().count()};
+    Timer::Clock::rep current{deadline_.load(std::memory_order_seq_cst)};
+    bool lowered{false};
+    while ((!lowered) && (wanted < current)) {
+      lowered = deadline_.compare_exchange_weak(current, wanted, std::memory_order_seq_cst);
+    }
+    return lowered;
+  }
+
+  /*!
+   * \brief The reactor which is linked to the timer manager.
+   */
+  TimerReactorInterface* reactor_;
+
+  /*!
+   * \brief Commands posted by threads other than the reactor thread.
+   */
+  vac::sync::MpscQueue<Command> commands_;
+
+  /*!
+   * \brief The thread that calls GetNextExpiry() and HandleTimerExpiry().
+   */
+  std::atomic<std::thread::id> reactor_thread_;
+
+  /*!
+   * \brief The timer whose handler is currently called by the reactor thread.
+   */
+  std::atomic<Timer const*> firing_;
+
+  /*!
+   * \brief The deadline the reactor waits for, as count of Timer::Clock ticks since the epoch.
+   */
+  mutable std::atomic<Timer::Clock::rep> deadline_;
+};
+
+}  // namespace timer
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_TIMER_THREADSAFE_TIMING_WHEEL_TIMER_MANAGER_H_
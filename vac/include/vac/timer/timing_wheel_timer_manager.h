@@ -0,0 +1,869 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  timing_wheel_timer_manager.h
+ *        \brief  Header file for the TimingWheelTimerManager class.
+ *
+ *      \details  A TimerManager backend that stores timers in a hierarchical hashed timing wheel. Starting,
+ *                stopping and restarting a timer is O(1), independent of the number of running timers.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_TIMER_TIMING_WHEEL_TIMER_MANAGER_H_
+#define LIB_VAC_INCLUDE_VAC_TIMER_TIMING_WHEEL_TIMER_MANAGER_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <sys/time.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "vac/container/intrusive_list.h"
+#include "vac/timer/timer.h"
+#include "vac/timer/timer_manager.h"
+#include "vac/timer/timer_reactor_interface.h"
+
+namespace vac {
+namespace timer {
+
+/*!
+ * \brief Configuration of a TimingWheelTimerManager.
+ */
+struct TimingWheelConfig {
+  /*!
+   * \brief   Resolution of the wheel.
+   * \details Timers never fire early, but may fire up to one tick late. All timers expiring within the same tick are
+   *          handled as one batch.
+   */
+  Timer::Clock::duration tick_resolution{std::chrono::milliseconds{1}};
+
+  /*!
+   * \brief   Slack of timers without an individual setting, see TimingWheelTimerManager::SetTimerSlack().
+   * \details Zero keeps all timers precise up to the tick resolution.
+   */
+  Timer::Clock::duration default_slack{Timer::Clock::duration::zero()};
+
+  /*!
+   * \brief   Number of running timers for which memory is reserved at construction.
+   * \details More timers are supported. Memory is then allocated whenever the number of running timers exceeds every
+   *          earlier peak, and kept for reuse.
+   */
+  std::size_t timer_capacity{64};
+};
+
+/*!
+ * \brief   An event queue for Timer objects based on a hierarchical hashed timing wheel.
+ * \details Drop-in replacement for TimerManager: Timers are bound to it through the TimerManager interface, the
+ *          backend is selected by constructing this class instead of TimerManager.
+ *          The wheel consists of kLevels levels of kSlotsPerLevel slots each. Level n covers timers expiring within
+ *          kSlotsPerLevel^(n+1) ticks; when the lower level wraps around, the next slot of the upper level is
+ *          cascaded down. Timers beyond the range of the top level are parked in its last slot and re-sorted on
+ *          cascade.
+ *          The expiry point of a running timer is sampled by Timer::Start(). A timer that is moved to a later point
+ *          with Timer::SetOneShot() without being restarted is re-sorted when its old expiry point is reached;
+ *          moving it to an earlier point requires Timer::Start(). TimerManager::Update() is not required.
+ *          Timers with a slack may fire up to the slack later than their expiry point. Their expiry is aligned to
+ *          the coarsest tick boundary within that window, so that timers with overlapping windows share one tick
+ *          and are handled by one HandleTimerExpiry() call instead of waking up the reactor once per timer.
+ *          Not threadsafe.
+ */
+class TimingWheelTimerManager : public TimerManager {
+ public:
+  /*!
+   * \brief Number of slots per level. Must be a power of two.
+   */
+  static constexpr std::size_t kSlotsPerLevel{64};
+
+  /*!
+   * \brief Number of levels.
+   */
+  static constexpr std::size_t kLevels{4};
+
+  /*!
+   * \brief Constructor for a TimingWheelTimerManager linked to a given reactor.
+   * \param reactor The reactor to unblock when a new earliest timer is added.
+   * \param config The configuration of the wheel.
+   */
+  explicit TimingWheelTimerManager(TimerReactorInterface* reactor, TimingWheelConfig const& config = {})
+      : TimerManager(reactor),
+        reactor_(reactor),
+        tick_resolution_(config.tick_resolution.count() > 0 ? config.tick_resolution : Timer::Clock::duration{1}),
+        default_slack_(std::max(config.default_slack, Timer::Clock::duration::zero())),
+        origin_(Timer::Clock::now()),
+        current_tick_(0),
+        occupied_(),
+        wheel_(),
+        expired_(),
+        entries_(),
+        running_timers_(0),
+        expiring_(nullptr) {
+    entries_.Reserve(config.timer_capacity);
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  TimingWheelTimerManager(TimingWheelTimerManager const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  TimingWheelTimerManager& operator=(TimingWheelTimerManager const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  TimingWheelTimerManager(TimingWheelTimerManager&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  TimingWheelTimerManager& operator=(TimingWheelTimerManager&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~TimingWheelTimerManager() override = default;
+
+  /*!
+   * \brief   Add a timer to be considered when computing the next expiry.
+   * \details Adding a timer that is already running reschedules it to its current expiry point. O(1).
+   * \param   timer Pointer to a Timer object.
+   */
+  void AddTimer(Timer* const timer) override {
+    if (ScheduleTimer(timer, timer->GetNextExpiry()) && (reactor_ != nullptr)) {
+      reactor_->Unblock();
+    }
+  }
+
+  /*!
+   * \brief   No longer consider a timer when computing the next expiry.
+   * \details O(1).
+   * \param   timer Pointer to a Timer object.
+   */
+  void RemoveTimer(Timer const* timer) override { UnscheduleTimer(timer); }
+
+  /*!
+   * \brief   Return a pair of bool and timeval struct for the next expiring timer.
+   * \details The reported point is rounded up to the tick resolution. If the earliest timer is stored in an upper
+   *          level, the point at which its slot is cascaded is reported, which may be earlier than its expiry.
+   * \return  A pair of bool (if valid NextExpiry) and timeval (relative to the current time representing the next
+   *          expiring timer if valid).
+   */
+  std::pair<bool, struct timeval> const GetNextExpiry() const override {
+    std::pair<bool, struct timeval> result{false, {0, 0}};
+    std::pair<bool, Timer::Clock::time_point> const deadline{GetNextDeadline()};
+    if (deadline.first) {
+      Timer::Clock::duration remaining{deadline.second - Timer::Clock::now()};
+      if (remaining < Timer::Clock::duration::zero()) {
+        remaining = Timer::Clock::duration::zero();
+      }
+      // Round up so that the reactor does not wake up before the tick is reached.
+      std::chrono::microseconds const micros{std::chrono::duration_cast<std::chrono::microseconds>(
+          remaining + (std::chrono::microseconds{1} - Timer::Clock::duration{1}))};
+      std::chrono::seconds const seconds{std::chrono::duration_cast<std::chrono::seconds>(micros)};
+      result.first = true;
+      result.second.tv_sec = static_cast<decltype(result.second.tv_sec)>(seconds.count());
+      result.second.tv_usec = static_cast<decltype(result.second.tv_usec)>((micros - seconds).count());
+    }
+    return result;
+  }
+
+  /*!
+   * \brief   Callback to trigger firing timers.
+   * \details Advances the wheel to the current time, skipping empty slots, and then fires all collected timers in
+   *          expiry order. Timers may be stopped or restarted from within the handlers.
+   */
+  void HandleTimerExpiry() override {
+    std::uint64_t const target{AdvanceToNow()};
+    for (Timer* timer{PopExpired()}; timer != nullptr; timer = PopExpired()) {
+      ExpireTimer(timer, target);
+    }
+  }
+
+  /*!
+   * \brief   Determine whether there are any timers currently running on this TimerManager.
+   * \details Hides TimerManager::empty(), which does not see the timers of this backend.
+   * \return  True if there are no active timers, false otherwise.
+   */
+  bool empty() const { return running_timers_ == 0U; }
+
+  /*!
+   * \brief   Determine the number of timers currently running on this TimerManager.
+   * \details Hides TimerManager::size(), which does not see the timers of this backend.
+   * \return  The number of active timers.
+   */
+  std::size_t size() const { return running_timers_; }
+
+  /*!
+   * \brief   Allow a timer to fire up to the given duration after its expiry point.
+   * \details The setting overrides TimingWheelConfig::default_slack and takes effect the next time the timer is
+   *          started or restarted. A slack of zero makes the timer precise. The setting is kept in the entry of the
+   *          timer in the wheel: it survives expiries and restarts, and is discarded when the timer is stopped with
+   *          Timer::Stop(), which the destructor of Timer calls as well. It therefore never applies to another timer.
+   *          For ThreadSafeTimingWheelTimerManager, only call this from the thread calling HandleTimerExpiry() or
+   *          before the reactor is running.
+   * \param   timer Pointer to a Timer object. It is not dereferenced.
+   * \param   slack The tolerated delay. Negative values are treated as zero.
+   */
+  void SetTimerSlack(Timer* timer, Timer::Clock::duration slack) {
+    Entry* entry{entries_.Find(timer)};
+    if (entry == nullptr) {
+      entry = &entries_.Insert(timer);
+    }
+    entry->slack_ = std::max(slack, Timer::Clock::duration::zero());
+    entry->has_slack_ = true;
+  }
+
+  /*!
+   * \brief Remove the individual slack setting of a timer, so that TimingWheelConfig::default_slack applies again.
+   * \param timer Pointer to a Timer object. It is not dereferenced.
+   */
+  void ClearTimerSlack(Timer const* timer) {
+    Entry* const entry{entries_.Find(timer)};
+    if (entry != nullptr) {
+      entry->has_slack_ = false;
+      if (!entry->running_) {
+        entries_.Erase(*entry);
+      }
+    }
+  }
+
+ protected:
+  /*!
+   * \brief  Schedule a timer at the given expiry point, rescheduling it if it is already running.
+   * \param  timer Pointer to a Timer object.
+   * \param  expiry The expiry point of the timer.
+   * \return True if the timer has become the earliest timer, false otherwise.
+   */
+  bool ScheduleTimer(Timer* timer, Timer::Clock::time_point expiry) {
+    Entry* found{entries_.Find(timer)};
+    if (found == nullptr) {
+      found = &entries_.Insert(timer);
+    }
+    Entry& entry{*found};
+    if (!entry.running_) {
+      entry.running_ = true;
+      ++running_timers_;
+    }
+    Unlink(entry);
+    entry.tick_ = ToSlackTick(entry, expiry);
+    std::pair<bool, std::uint64_t> const next{GetNextTick()};
+    Link(entry);
+    return (!next.first) || (entry.tick_ < next.second);
+  }
+
+  /*!
+   * \brief   Remove a timer from the wheel. Does nothing if the timer is not running.
+   * \details The entry and with it the slack setting of the timer is discarded, unless this is the removal by
+   *          Timer::DoHandleTimer() of a timer fired by ExpireTimer(), which adds a periodic timer again right away.
+   * \param   timer Pointer to a Timer object. It is not dereferenced.
+   */
+  void UnscheduleTimer(Timer const* timer) {
+    Entry* const entry{entries_.Find(timer)};
+    if (entry != nullptr) {
+      Unlink(*entry);
+      if (entry->running_) {
+        entry->running_ = false;
+        --running_timers_;
+      }
+      bool keep{false};
+      if (timer == expiring_) {
+        expiring_ = nullptr;
+        keep = entry->has_slack_;
+      }
+      if (!keep) {
+        entries_.Erase(*entry);
+      }
+    }
+  }
+
+  /*!
+   * \brief  Determine the point in time at which HandleTimerExpiry() has to be called next.
+   * \return A pair of bool (if any timer is running) and the point in time.
+   */
+  std::pair<bool, Timer::Clock::time_point> GetNextDeadline() const {
+    std::pair<bool, std::uint64_t> const next{GetNextTick()};
+    return {next.first, origin_ + (tick_resolution_ * static_cast<Timer::Clock::rep>(next.second))};
+  }
+
+  /*!
+   * \brief  Advance the wheel to the current time and collect all due timers.
+   * \return The current tick, to be passed to ExpireTimer().
+   */
+  std::uint64_t AdvanceToNow() {
+    std::uint64_t const target{ToCurrentTick(Timer::Clock::now())};
+    Advance(target);
+    return target;
+  }
+
+  /*!
+   * \brief  Take the next collected due timer.
+   * \return The timer, or nullptr if no more timers are due. The timer is not dereferenced.
+   */
+  Timer* PopExpired() {
+    Timer* timer{nullptr};
+    if (!expired_.empty()) {
+      Entry& entry{*expired_.pop_front()->GetSelf()};
+      entry.level_ = kNoLevel;
+      timer = entry.timer_;
+    }
+    return timer;
+  }
+
+  /*!
+   * \brief   Fire a timer taken by PopExpired().
+   * \details Does nothing if the timer has been removed or rescheduled since it was taken. A timer that has been
+   *          moved to a later point since it was scheduled is rescheduled instead of being fired.
+   * \param   timer The timer.
+   * \param   target The tick returned by AdvanceToNow().
+   */
+  void ExpireTimer(Timer* timer, std::uint64_t target) {
+    Entry* const found{entries_.Find(timer)};
+    if ((found != nullptr) && found->running_ && (found->level_ == kNoLevel)) {
+      Entry& entry{*found};
+      if (ToExpiryTick(timer->GetNextExpiry()) > target) {
+        entry.tick_ = ToSlackTick(entry, timer->GetNextExpiry());
+        Link(entry);
+      } else {
+        // Removes the entry, and adds it again if the timer is periodic.
+        expiring_ = timer;
+        timer->DoHandleTimer();
+        expiring_ = nullptr;
+      }
+    }
+  }
+
+ private:
+  /*!
+   * \brief Number of bits to index a slot of one level.
+   */
+  static constexpr std::uint64_t kSlotBits{6};
+
+  static_assert((std::uint64_t{1} << kSlotBits) == kSlotsPerLevel, "kSlotBits must match kSlotsPerLevel");
+
+  /*!
+   * \brief Mask to extract the slot index.
+   */
+  static constexpr std::uint64_t kSlotMask{kSlotsPerLevel - 1};
+
+  /*!
+   * \brief Number of ticks covered by all levels of the wheel.
+   */
+  static constexpr std::uint64_t kWheelRange{std::uint64_t{1} << (kSlotBits * kLevels)};
+
+  /*!
+   * \brief Level value of an entry that is not stored in a slot.
+   */
+  static constexpr std::uint8_t kNoLevel{0xFF};
+
+  /*!
+   * \brief Bookkeeping of a running timer.
+   */
+  class Entry final : public vac::container::IntrusiveListNode<Entry> {
+   public:
+    /*!
+     * \brief Constructor for an unused entry.
+     */
+    Entry() : vac::container::IntrusiveListNode<Entry>(), timer_(nullptr) {}
+
+    /*!
+     * \brief The timer.
+     */
+    Timer* timer_;
+
+    /*!
+     * \brief The tick at which the timer expires.
+     */
+    std::uint64_t tick_{0};
+
+    /*!
+     * \brief The level of the slot the entry is linked into.
+     */
+    std::uint8_t level_{kNoLevel};
+
+    /*!
+     * \brief The index of the slot the entry is linked into.
+     */
+    std::uint8_t slot_{0};
+
+    /*!
+     * \brief Whether the timer is running. An entry of a stopped timer only holds its slack setting.
+     */
+    bool running_{false};
+
+    /*!
+     * \brief Whether slack_ overrides the default slack.
+     */
+    bool has_slack_{false};
+
+    /*!
+     * \brief The individual slack of the timer.
+     */
+    Timer::Clock::duration slack_{Timer::Clock::duration::zero()};
+  };
+
+  /*!
+   * \brief Type of a slot.
+   */
+  using Slot = vac::container::IntrusiveList<Entry>;
+
+  /*!
+   * \brief   Map from timers to their entries without an allocation per started timer.
+   * \details Entries live in chunks that are kept until the map is destroyed and are recycled through a free list, so
+   *          they stay at their address while linked into the wheel. The index is an open addressing hash table with
+   *          linear probing that is kept at most half full. Memory is only allocated when the number of entries
+   *          exceeds every earlier peak.
+   */
+  class EntryMap final {
+   public:
+    /*!
+     * \brief Constructor for an empty map without memory.
+     */
+    EntryMap() : chunks_(), capacity_(0), buckets_(), size_(0), free_() {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    EntryMap(EntryMap const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    EntryMap& operator=(EntryMap const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    EntryMap(EntryMap&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    EntryMap& operator=(EntryMap&&) & = delete;
+
+    /*!
+     * \brief   Destructor.
+     * \details Destroys the chunks after the free list. The destructor of IntrusiveListNode unlinks every entry from
+     *          the slot it is still linked into, so the slots of the wheel may outlive the map.
+     */
+    ~EntryMap() = default;
+
+    /*!
+     * \brief Make room for the given number of entries.
+     * \param count The number of entries.
+     */
+    void Reserve(std::size_t count) {
+      if (count > capacity_) {
+        AddChunk(std::max(std::max(count - capacity_, capacity_), std::size_t{kMinimumChunkSize}));
+      }
+      if ((count * 2U) > buckets_.size()) {
+        std::size_t bucket_count{std::max(buckets_.size() * 2U, std::size_t{kMinimumBucketCount})};
+        while ((count * 2U) > bucket_count) {
+          bucket_count *= 2U;
+        }
+        Rehash(bucket_count);
+      }
+    }
+
+    /*!
+     * \brief  Look up the entry of a timer.
+     * \param  timer The timer. It is not dereferenced.
+     * \return The entry, or nullptr if the timer has none.
+     */
+    Entry* Find(Timer const* timer) const {
+      Entry* result{nullptr};
+      if (size_ != 0U) {
+        for (std::size_t i{Home(timer)}; buckets_[i] != nullptr; i = Next(i)) {
+          if (buckets_[i]->timer_ == timer) {
+            result = buckets_[i];
+            break;
+          }
+        }
+      }
+      return result;
+    }
+
+    /*!
+     * \brief  Add an entry for a timer that has none.
+     * \param  timer The timer.
+     * \return The new entry, not linked into any list.
+     */
+    Entry& Insert(Timer* timer) {
+      Reserve(size_ + 1U);
+      Entry& entry{*free_.pop_front()->GetSelf()};
+      entry.timer_ = timer;
+      entry.running_ = false;
+      entry.has_slack_ = false;
+      entry.tick_ = 0;
+      entry.level_ = kNoLevel;
+      entry.slot_ = 0;
+      std::size_t i{Home(timer)};
+      while (buckets_[i] != nullptr) {
+        i = Next(i);
+      }
+      buckets_[i] = &entry;
+      ++size_;
+      return entry;
+    }
+
+    /*!
+     * \brief Remove an entry and keep it for reuse.
+     * \param entry An entry returned by Find(), not linked into any list.
+     */
+    void Erase(Entry& entry) {
+      std::size_t hole{Home(entry.timer_)};
+      while (buckets_[hole] != &entry) {
+        hole = Next(hole);
+      }
+      buckets_[hole] = nullptr;
+      // Close the gap: move back every following entry of the cluster whose home is not between the hole and itself.
+      std::size_t const mask{buckets_.size() - 1U};
+      for (std::size_t i{Next(hole)}; buckets_[i] != nullptr; i = Next(i)) {
+        if (((i - Home(buckets_[i]->timer_)) & mask) >= ((i - hole) & mask)) {
+          buckets_[hole] = buckets_[i];
+          buckets_[i] = nullptr;
+          hole = i;
+        }
+      }
+      entry.timer_ = nullptr;
+      free_.push_back(entry);
+      --size_;
+    }
+
+    /*!
+     * \brief  The number of entries.
+     * \return The number of entries.
+     */
+    std::size_t size() const noexcept { return size_; }
+
+   private:
+    /*!
+     * \brief The smallest number of entries allocated at once.
+     */
+    static constexpr std::size_t kMinimumChunkSize{16};
+
+    /*!
+     * \brief The smallest number of buckets of the index. Must be a power of two.
+     */
+    static constexpr std::size_t kMinimumBucketCount{32};
+
+    /*!
+     * \brief  The bucket at which the lookup of a timer starts.
+     * \param  timer The timer.
+     * \return The index of the bucket.
+     */
+    std::size_t Home(Timer const* timer) const noexcept {
+      // Spread the aligned pointer values over the high bits before masking.
+      std::uint64_t const mixed{static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(timer)) *
+                                0x9E3779B97F4A7C15U};
+      return static_cast<std::size_t>(mixed >> 32U) & (buckets_.size() - 1U);
+    }
+
+    /*!
+     * \brief  The bucket following a bucket, wrapping around at the end.
+     * \param  bucket The index of a bucket.
+     * \return The index of the next bucket.
+     */
+    std::size_t Next(std::size_t bucket) const noexcept { return (bucket + 1U) & (buckets_.size() - 1U); }
+
+    /*!
+     * \brief Allocate entries and put them on the free list.
+     * \param count The number of entries.
+     */
+    void AddChunk(std::size_t count) {
+      chunks_.emplace_back(new Entry[count]);
+      Entry* const chunk{chunks_.back().get()};
+      for (std::size_t i{0}; i < count; ++i) {
+        free_.push_back(chunk[i]);
+      }
+      capacity_ += count;
+    }
+
+    /*!
+     * \brief Rebuild the index with a new number of buckets.
+     * \param bucket_count The number of buckets, a power of two.
+     */
+    void Rehash(std::size_t bucket_count) {
+      std::vector<Entry*> old_buckets(bucket_count, nullptr);
+      old_buckets.swap(buckets_);
+      for (Entry* const entry : old_buckets) {
+        if (entry != nullptr) {
+          std::size_t i{Home(entry->timer_)};
+          while (buckets_[i] != nullptr) {
+            i = Next(i);
+          }
+          buckets_[i] = entry;
+        }
+      }
+    }
+
+    /*!
+     * \brief The memory of all entries.
+     */
+    std::vector<std::unique_ptr<Entry[]>> chunks_;
+
+    /*!
+     * \brief The number of entries in all chunks.
+     */
+    std::size_t capacity_;
+
+    /*!
+     * \brief The index from timers to their entries. Empty buckets are nullptr.
+     */
+    std::vector<Entry*> buckets_;
+
+    /*!
+     * \brief The number of entries in use.
+     */
+    std::size_t size_;
+
+    /*!
+     * \brief The unused entries. Destroyed before the chunks.
+     */
+    vac::container::IntrusiveList<Entry> free_;
+  };
+
+  /*!
+   * \brief  Convert an expiry point to a tick, rounding up so that timers never fire early.
+   * \param  time_point The expiry point.
+   * \return The tick at which a timer with this expiry point is due.
+   */
+  std::uint64_t ToExpiryTick(Timer::Clock::time_point time_point) const {
+    Timer::Clock::duration const offset{time_point - origin_};
+    std::uint64_t tick{0};
+    if (offset > Timer::Clock::duration::zero()) {
+      tick = static_cast<std::uint64_t>((offset.count() + (tick_resolution_.count() - 1)) / tick_resolution_.count());
+    }
+    return tick;
+  }
+
+  /*!
+   * \brief   Convert an expiry point to the tick at which a timer is scheduled, taking its slack into account.
+   * \details Within the window from the expiry tick to the last tick before the slack runs out, the tick with the
+   *          most trailing zero bits is chosen, as done for the Linux timer_slack. Timers whose windows overlap thereby
+   *          tend to be aligned to the same tick.
+   * \param   entry The entry of the timer.
+   * \param   time_point The expiry point.
+   * \return  The tick at which the timer is handled.
+   */
+  std::uint64_t ToSlackTick(Entry const& entry, Timer::Clock::time_point time_point) const {
+    Timer::Clock::duration const slack{entry.has_slack_ ? entry.slack_ : default_slack_};
+    std::uint64_t tick{ToExpiryTick(time_point)};
+    if (slack > Timer::Clock::duration::zero()) {
+      std::uint64_t const limit{ToCurrentTick(time_point + slack)};
+      if ((limit > tick) && (tick > 0U)) {
+        // The highest bit in which limit differs from (tick - 1) is the coarsest boundary within the window.
+        std::uint64_t const highest_bit{
+            static_cast<std::uint64_t>(63 - __builtin_clzll(static_cast<unsigned long long>((tick - 1U) ^ limit)))};
+        tick = limit & ~((std::uint64_t{1} << highest_bit) - 1U);
+      }
+    }
+    return tick;
+  }
+
+  /*!
+   * \brief  Convert the current time to a tick, rounding down.
+   * \param  now The current time.
+   * \return The last tick that has been reached.
+   */
+  std::uint64_t ToCurrentTick(Timer::Clock::time_point now) const {
+    Timer::Clock::duration const offset{now - origin_};
+    return (offset > Timer::Clock::duration::zero())
+               ? static_cast<std::uint64_t>(offset.count() / tick_resolution_.count())
+               : std::uint64_t{0};
+  }
+
+  /*!
+   * \brief Link an entry into the slot matching its tick, relative to the current tick.
+   * \param entry The entry to link.
+   */
+  void Link(Entry& entry) {
+    std::uint64_t const due{(entry.tick_ > current_tick_) ? entry.tick_ : current_tick_};
+    std::uint64_t delta{due - current_tick_};
+    std::uint64_t position{due};
+    if (delta >= kWheelRange) {
+      delta = kWheelRange - 1;
+      position = current_tick_ + delta;
+    }
+    std::size_t level{0};
+    while ((level < (kLevels - 1)) && (delta >= (std::uint64_t{1} << (kSlotBits * (level + 1))))) {
+      ++level;
+    }
+    std::size_t const slot{static_cast<std::size_t>((position >> (kSlotBits * level)) & kSlotMask)};
+    wheel_[level][slot].push_back(entry);
+    occupied_[level] |= (std::uint64_t{1} << slot);
+    entry.level_ = static_cast<std::uint8_t>(level);
+    entry.slot_ = static_cast<std::uint8_t>(slot);
+  }
+
+  /*!
+   * \brief Unlink an entry from the slot or batch it is linked into.
+   * \param entry The entry to unlink.
+   */
+  void Unlink(Entry& entry) {
+    entry.EraseFromList();
+    if ((entry.level_ != kNoLevel) && wheel_[entry.level_][entry.slot_].empty()) {
+      occupied_[entry.level_] &= ~(std::uint64_t{1} << entry.slot_);
+    }
+    entry.level_ = kNoLevel;
+  }
+
+  /*!
+   * \brief  Determine the next tick at which a slot becomes due or is cascaded.
+   * \return A pair of bool (if any timer is running) and the tick.
+   */
+  std::pair<bool, std::uint64_t> GetNextTick() const {
+    std::pair<bool, std::uint64_t> result{false, 0};
+    for (std::size_t level{0}; level < kLevels; ++level) {
+      std::uint64_t const bits{occupied_[level]};
+      if (bits != 0U) {
+        std::uint64_t const shift{kSlotBits * level};
+        std::uint64_t const round{current_tick_ >> shift};
+        std::uint64_t const position{round & kSlotMask};
+        // The slot at the current position has already been cascaded unless the level is exactly at its boundary.
+        bool const at_boundary{(current_tick_ & ((std::uint64_t{1} << shift) - 1)) == 0U};
+        std::uint64_t const rotated{(position == 0U) ? bits
+                                                     : ((bits >> position) | (bits << (kSlotsPerLevel - position)))};
+        std::uint64_t const candidates{at_boundary ? rotated : (rotated & ~std::uint64_t{1})};
+        std::uint64_t distance{kSlotsPerLevel};
+        if (candidates != 0U) {
+          distance = static_cast<std::uint64_t>(__builtin_ctzll(candidates));
+        }
+        std::uint64_t const tick{std::max((round + distance) << shift, current_tick_)};
+        if ((!result.first) || (tick < result.second)) {
+          result = {true, tick};
+        }
+      }
+    }
+    return result;
+  }
+
+  /*!
+   * \brief Move all entries of one list to the end of another list, preserving their order.
+   * \param from The list to take the entries from.
+   * \param to The list to append the entries to.
+   */
+  static void MoveEntries(Slot& from, Slot& to) {
+    while (!from.empty()) {
+      to.push_back(*from.pop_front()->GetSelf());
+    }
+  }
+
+  /*!
+   * \brief Re-sort the entries of an upper level slot into the lower levels.
+   * \param level The level of the slot.
+   * \param slot The index of the slot.
+   */
+  void Cascade(std::size_t level, std::size_t slot) {
+    Slot pending;
+    MoveEntries(wheel_[level][slot], pending);
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+    while (!pending.empty()) {
+      Entry& entry{*pending.pop_front()->GetSelf()};
+      Link(entry);
+    }
+  }
+
+  /*!
+   * \brief Advance the wheel up to and including the given tick and collect all due entries.
+   * \param target The last tick to process.
+   */
+  void Advance(std::uint64_t target) {
+    std::pair<bool, std::uint64_t> next{GetNextTick()};
+    while (next.first && (next.second <= target)) {
+      current_tick_ = next.second;
+      for (std::size_t level{kLevels - 1}; level > 0; --level) {
+        std::uint64_t const shift{kSlotBits * level};
+        if ((current_tick_ & ((std::uint64_t{1} << shift) - 1)) == 0U) {
+          Cascade(level, static_cast<std::size_t>((current_tick_ >> shift) & kSlotMask));
+        }
+      }
+      std::size_t const slot{static_cast<std::size_t>(current_tick_ & kSlotMask)};
+      MoveEntries(wheel_[0][slot], expired_);
+      occupied_[0] &= ~(std::uint64_t{1} << slot);
+      ++current_tick_;
+      next = GetNextTick();
+    }
+    if (current_tick_ <= target) {
+      current_tick_ = target + 1;
+    }
+  }
+
+  /*!
+   * \brief The reactor which is linked to the timer manager.
+   */
+  TimerReactorInterface* reactor_;
+
+  /*!
+   * \brief Duration of one tick.
+   */
+  Timer::Clock::duration const tick_resolution_;
+
+  /*!
+   * \brief Slack of timers without an individual setting.
+   */
+  Timer::Clock::duration const default_slack_;
+
+  /*!
+   * \brief Point in time of tick 0.
+   */
+  Timer::Clock::time_point const origin_;
+
+  /*!
+   * \brief The next tick to process. All earlier ticks have been processed.
+   */
+  std::uint64_t current_tick_;
+
+  /*!
+   * \brief Bitmap per level of the slots that contain entries.
+   */
+  std::array<std::uint64_t, kLevels> occupied_;
+
+  /*!
+   * \brief The slots of all levels.
+   */
+  std::array<std::array<Slot, kSlotsPerLevel>, kLevels> wheel_;
+
+  /*!
+   * \brief The entries that are due and have not been handled yet.
+   */
+  Slot expired_;
+
+  /*!
+   * \brief The entries of all running timers.
+   */
+  EntryMap entries_;
+
+  /*!
+   * \brief The number of running timers.
+   */
+  std::size_t running_timers_;
+
+  /*!
+   * \brief The timer whose Timer::DoHandleTimer() is called by ExpireTimer(), until it removes itself.
+   */
+  Timer const* expiring_;
+};
+
+}  // namespace timer
+}  // namespace vac
+
+#endif  // LIB_VAC_INCLUDE_VAC_TIMER_TIMING_WHEEL_TIMER_MANAGER_H_
@@ -0,0 +1,661 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  trace.h
+ *        \brief  Low-overhead scoped tracing into per-thread ring buffers.
+ *
+ *      \details  VAC_TRACE_SCOPE("name") records the begin and end time of the enclosing scope as one event into a
+ *                lock-free ring buffer owned by the calling thread. The macros compile to nothing unless
+ *                VAC_TRACE_ENABLED is defined to a non-zero value. The buffers can be read at any time from any thread,
+ *                e.g. to export them with vajson::writer::WriteChromeTrace(). The buffer of an exited thread is reused
+ *                by a new thread once it has been exported.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAC_INCLUDE_VAC_TRACE_TRACE_H_
+#define LIB_VAC_INCLUDE_VAC_TRACE_TRACE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vac {
+namespace trace {
+
+/*!
+ * \brief  Read the trace clock.
+ * \return CLOCK_MONOTONIC_RAW in nanoseconds. Not slewed by NTP, read through the vDSO without a system call.
+ */
+inline std::uint64_t TraceClockNow() noexcept {
+  struct timespec now {};
+  static_cast<void>(::clock_gettime(CLOCK_MONOTONIC_RAW, &now));
+  return (static_cast<std::uint64_t>(now.tv_sec) * 1000000000U) + static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+/*!
+ * \brief A completed scope.
+ */
+struct TraceEvent {
+  /*!
+   * \brief The name of the scope, a string with static storage duration.
+   */
+  char const* name;
+
+  /*!
+   * \brief Begin of the scope in nanoseconds of TraceClockNow().
+   */
+  std::uint64_t begin;
+
+  /*!
+   * \brief End of the scope in nanoseconds of TraceClockNow().
+   */
+  std::uint64_t end;
+};
+
+/*!
+ * \brief   Ring buffer of the events of one thread.
+ * \details Written by its thread only, without locks or read-modify-write operations. The oldest events are
+ *          overwritten when the buffer is full. Readers copy the events optimistically and drop those that may have
+ *          been overwritten during the copy, like a sequence lock.
+ */
+class TraceBuffer final {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param capacity The number of events kept, rounded up to a power of two.
+   * \param thread_id The identifier of the owning thread.
+   */
+  TraceBuffer(std::size_t capacity, std::uint32_t thread_id)
+      : slots_(RoundUpToPowerOfTwo(capacity)),
+        mask_(slots_.size() - 1U),
+        head_(0),
+        thread_id_(thread_id),
+        thread_name_(nullptr),
+        released_(false),
+        exported_(false) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  TraceBuffer(TraceBuffer const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  TraceBuffer& operator=(TraceBuffer const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  TraceBuffer(TraceBuffer&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  TraceBuffer& operator=(TraceBuffer&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~TraceBuffer() = default;
+
+  /*!
+   * \brief Append an event. Must only be called by the owning thread.
+   * \param name The name of the scope, a string with static storage duration.
+   * \param begin Begin of the scope.
+   * \param end End of the scope.
+   */
+  void Record(char const* name, std::uint64_t begin, std::uint64_t end) noexcept {
+    std::uint64_t const index{head_.load(std::memory_order_relaxed)};
+    // Orders the publication of index before the overwrite of the slot for readers that observe the new contents.
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot{slots_[static_cast<std::size_t>(index) & mask_]};
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    head_.store(index + 1U, std::memory_order_release);
+  }
+
+  /*!
+   * \brief   Copy the retained events, oldest first. Threadsafe.
+   * \details Events being overwritten concurrently are not copied.
+   * \param   events Output. The events are appended.
+   */
+  void Snapshot(std::vector<TraceEvent>& events) const {
+    std::uint64_t const capacity{slots_.size()};
+    std::uint64_t const head{head_.load(std::memory_order_acquire)};
+    std::uint64_t const first{(head > capacity) ? (head - capacity) : 0U};
+    std::size_t const offset{events.size()};
+    for (std::uint64_t index{first}; index < head; ++index) {
+      Slot const& slot{slots_[static_cast<std::size_t>(index) & mask_]};
+      events.push_back(TraceEvent{slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+                                  slot.end.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The writer may be overwriting the slot of index head_ - capacity or any older one.
+    std::uint64_t const valid{head_.load(std::memory_order_relaxed) + 1U};
+    if (valid > (first + capacity)) {
+      std::uint64_t const stale{valid - (first + capacity)};
+      std::size_t const drop{static_cast<std::size_t>((stale < (head - first)) ? stale : (head - first))};
+      static_cast<void>(events.erase(events.begin() + static_cast<std::ptrdiff_t>(offset),
+                                     events.begin() + static_cast<std::ptrdiff_t>(offset + drop)));
+    }
+  }
+
+  /*!
+   * \brief  Number of events recorded since the buffer was handed to its thread, including overwritten ones.
+   * \return The number of events.
+   */
+  std::uint64_t GetRecordedCount() const noexcept { return head_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief  The number of events kept.
+   * \return The capacity.
+   */
+  std::size_t GetCapacity() const noexcept { return slots_.size(); }
+
+  /*!
+   * \brief  The identifier of the owning thread, the Linux thread id.
+   * \return The thread identifier.
+   */
+  std::uint32_t GetThreadId() const noexcept { return thread_id_; }
+
+  /*!
+   * \brief  The name of the owning thread.
+   * \return The name, or nullptr if none has been set.
+   */
+  char const* GetThreadName() const noexcept { return thread_name_.load(std::memory_order_acquire); }
+
+  /*!
+   * \brief Set the name of the owning thread.
+   * \param name The name, a string with static storage duration.
+   */
+  void SetThreadName(char const* name) noexcept { thread_name_.store(name, std::memory_order_release); }
+
+  /*!
+   * \brief Mark the buffer as no longer used by its thread. Called on thread exit.
+   */
+  void Release() noexcept { released_.store(true, std::memory_order_release); }
+
+  /*!
+   * \brief  Whether the buffer is no longer used by its thread.
+   * \return True if released.
+   */
+  bool IsReleased() const noexcept { return released_.load(std::memory_order_acquire); }
+
+  /*!
+   * \brief Note that the events of a released buffer have been read, so that it may be reused.
+   */
+  void MarkExported() const noexcept { exported_.store(true, std::memory_order_relaxed); }
+
+  /*!
+   * \brief  Whether the events have been read after the buffer was released.
+   * \return True if exported.
+   */
+  bool IsExported() const noexcept { return exported_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Hand a released buffer to a new thread, discarding its events. Must not race with Snapshot().
+   * \param thread_id The identifier of the new owning thread.
+   */
+  void Reuse(std::uint32_t thread_id) noexcept {
+    head_.store(0, std::memory_order_relaxed);
+    thread_id_ = thread_id;
+    thread_name_.store(nullptr, std::memory_order_relaxed);
+    exported_.store(false, std::memory_order_relaxed);
+    released_.store(false, std::memory_order_relaxed);
+  }
+
+ private:
+  /*!
+   * \brief  Round up to a power of two.
+   * \param  value The value.
+   * \return The smallest power of two not less than value, at least 1.
+   */
+  static std::size_t RoundUpToPowerOfTwo(std::size_t value) noexcept {
+    std::size_t result{1};
+    while (result < value) {
+      result <<= 1U;
+    }
+    return result;
+  }
+
+  /*!
+   * \brief Storage of one event. The fields are atomic so that readers may race with the writer.
+   */
+  struct Slot {
+    /*!
+     * \brief The name of the scope.
+     */
+    std::atomic<char const*> name{nullptr};
+
+    /*!
+     * \brief Begin of the scope.
+     */
+    std::atomic<std::uint64_t> begin{0};
+
+    /*!
+     * \brief End of the scope.
+     */
+    std::atomic<std::uint64_t> end{0};
+  };
+
+  /*!
+   * \brief The ring of events.
+   */
+  std::vector<Slot> slots_;
+
+  /*!
+   * \brief slots_.size() - 1.
+   */
+  std::size_t const mask_;
+
+  /*!
+   * \brief Number of events recorded. The next event is stored at head_ & mask_.
+   */
+  std::atomic<std::uint64_t> head_;
+
+  /*!
+   * \brief The identifier of the owning thread.
+   */
+  std::uint32_t thread_id_;
+
+  /*!
+   * \brief The name of the owning thread.
+   */
+  std::atomic<char const*> thread_name_;
+
+  /*!
+   * \brief Whether the owning thread has exited.
+   */
+  std::atomic<bool> released_;
+
+  /*!
+   * \brief Whether the events have been read since the owning thread exited.
+   */
+  mutable std::atomic<bool> exported_;
+};
+
+/*!
+ * \brief   Process-wide set of trace buffers.
+ * \details Each thread gets a buffer on its first traced scope. Buffers are kept after their thread has exited, so
+ *          that its events can still be exported. Once exported, such a buffer is handed to the next new thread. If
+ *          no exported buffer is available and the registry already holds the maximum number of buffers, the oldest
+ *          buffer of an exited thread is reused anyway and its events are counted as dropped. Buffers of running
+ *          threads are never taken away, so more buffers than the maximum exist while more threads trace.
+ */
+class TraceRegistry final {
+ public:
+  /*!
+   * \brief Default number of events kept per thread.
+   */
+  static constexpr std::size_t kDefaultBufferCapacity{16384};
+
+  /*!
+   * \brief Default number of buffers kept before buffers of exited threads are reused without having been exported.
+   */
+  static constexpr std::size_t kDefaultMaxBuffers{64};
+
+  /*!
+   * \brief  The process-wide registry.
+   * \return The registry.
+   */
+  static TraceRegistry& Instance() {
+    static TraceRegistry registry;
+    return registry;
+  }
+
+  /*!
+   * \brief Copy constructor.
+   */
+  TraceRegistry(TraceRegistry const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  TraceRegistry& operator=(TraceRegistry const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  TraceRegistry(TraceRegistry&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  TraceRegistry& operator=(TraceRegistry&&) & = delete;
+
+  /*!
+   * \brief Destructor.
+   */
+  ~TraceRegistry() = default;
+
+  /*!
+   * \brief  Whether scopes are recorded. Enabled by default.
+   * \return True if enabled.
+   */
+  bool IsEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Pause or resume recording. Threadsafe.
+   * \param enabled True to record scopes entered from now on.
+   */
+  void SetEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+  /*!
+   * \brief Set the number of events kept per thread for buffers created from now on. Reused buffers keep their
+   *        capacity. Threadsafe.
+   * \param capacity The number of events, rounded up to a power of two.
+   */
+  void SetBufferCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    buffer_capacity_ = capacity;
+  }
+
+  /*!
+   * \brief Set the number of buffers kept before buffers of exited threads are reused without having been exported.
+   *        Threadsafe.
+   * \param max_buffers The number of buffers.
+   */
+  void SetMaxBuffers(std::size_t max_buffers) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    max_buffers_ = max_buffers;
+  }
+
+  /*!
+   * \brief  Number of events discarded because the buffer of an exited thread was reused before it was exported.
+   *         Threadsafe.
+   * \return The number of events.
+   */
+  std::uint64_t GetDroppedEventCount() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    return dropped_events_;
+  }
+
+  /*!
+   * \brief  The buffer of the calling thread, acquired on first use.
+   * \return The buffer.
+   */
+  TraceBuffer& GetThreadBuffer() {
+    TraceBuffer*& buffer{ThreadBuffer()};
+    if (buffer == nullptr) {
+      buffer = &AcquireBuffer();
+    }
+    return *buffer;
+  }
+
+  /*!
+   * \brief   Call a function for each buffer, in order of creation. Threadsafe.
+   * \details Buffers of exited threads count as exported once visited and are reused by new threads afterwards.
+   * \param   fn The function, called with TraceBuffer const&. Must not create buffers.
+   */
+  template <typename Fn>
+  void ForEachBuffer(Fn&& fn) const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    for (std::unique_ptr<TraceBuffer> const& buffer : buffers_) {
+      // Checked before reading, so that the events recorded before the release are included.
+      bool const released{buffer->IsReleased()};
+      fn(static_cast<TraceBuffer const&>(*buffer));
+      if (released) {
+        buffer->MarkExported();
+      }
+    }
+  }
+
+ private:
+  /*!
+   * \brief Releases the buffer of a thread when the thread exits.
+   */
+  class BufferReleaser final {
+   public:
+    /*!
+     * \brief Constructor.
+     * \param buffer The buffer of the calling thread.
+     */
+    explicit BufferReleaser(TraceBuffer& buffer) noexcept : buffer_(buffer) {}
+
+    /*!
+     * \brief Copy constructor.
+     */
+    BufferReleaser(BufferReleaser const&) = delete;
+
+    /*!
+     * \brief Copy assignment.
+     */
+    BufferReleaser& operator=(BufferReleaser const&) & = delete;
+
+    /*!
+     * \brief Move constructor.
+     */
+    BufferReleaser(BufferReleaser&&) = delete;
+
+    /*!
+     * \brief Move assignment.
+     */
+    BufferReleaser& operator=(BufferReleaser&&) & = delete;
+
+    /*!
+     * \brief Destructor. Releases the buffer.
+     */
+    ~BufferReleaser() noexcept {
+      ThreadBuffer() = nullptr;
+      buffer_.Release();
+    }
+
+   private:
+    /*!
+     * \brief The buffer of the thread.
+     */
+    TraceBuffer& buffer_;
+  };
+
+  /*!
+   * \brief Constructor.
+   */
+  TraceRegistry()
+      : mutex_(),
+        buffers_(),
+        buffer_capacity_(kDefaultBufferCapacity),
+        max_buffers_(kDefaultMaxBuffers),
+        dropped_events_(0),
+        enabled_(true) {}
+
+  /*!
+   * \brief  The cached buffer pointer of the calling thread.
+   * \return Reference to the pointer, nullptr if the thread has no buffer.
+   */
+  static TraceBuffer*& ThreadBuffer() noexcept {
+    thread_local TraceBuffer* buffer{nullptr};
+    return buffer;
+  }
+
+  /*!
+   * \brief  Reuse the buffer of an exited thread or create a new one.
+   * \return The buffer of the calling thread.
+   */
+  TraceBuffer& AcquireBuffer() {
+    std::uint32_t const thread_id{static_cast<std::uint32_t>(::syscall(SYS_gettid))};
+    TraceBuffer* buffer{nullptr};
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      std::deque<std::unique_ptr<TraceBuffer>>::iterator it{
+          std::find_if(buffers_.begin(), buffers_.end(), [](std::unique_ptr<TraceBuffer> const& candidate) {
+            return candidate->IsReleased() && candidate->IsExported();
+          })};
+      if ((it == buffers_.end()) && (buffers_.size() >= max_buffers_)) {
+        it = std::find_if(buffers_.begin(), buffers_.end(),
+                          [](std::unique_ptr<TraceBuffer> const& candidate) { return candidate->IsReleased(); });
+        if (it != buffers_.end()) {
+          std::uint64_t const recorded{(*it)->GetRecordedCount()};
+          std::uint64_t const capacity{(*it)->GetCapacity()};
+          dropped_events_ += std::min(recorded, capacity);
+        }
+      }
+      if (it != buffers_.end()) {
+        buffer = it->get();
+        buffer->Reuse(thread_id);
+      } else {
+        buffers_.emplace_back(new TraceBuffer(buffer_capacity_, thread_id));
+        buffer = buffers_.back().get();
+      }
+    }
+    thread_local BufferReleaser const releaser{*buffer};
+    static_cast<void>(releaser);
+    return *buffer;
+  }
+
+  /*!
+   * \brief Protects buffers_, buffer_capacity_, max_buffers_ and dropped_events_.
+   */
+  mutable std::mutex mutex_;
+
+  /*!
+   * \brief The buffers of running threads and of exited threads that have traced.
+   */
+  std::deque<std::unique_ptr<TraceBuffer>> buffers_;
+
+  /*!
+   * \brief Number of events kept per thread for new buffers.
+   */
+  std::size_t buffer_capacity_;
+
+  /*!
+   * \brief Number of buffers kept before buffers of exited threads are reused without having been exported.
+   */
+  std::size_t max_buffers_;
+
+  /*!
+   * \brief Number of events discarded by reusing buffers that have not been exported.
+   */
+  std::uint64_t dropped_events_;
+
+  /*!
+   * \brief Whether scopes are recorded.
+   */
+  std::atomic<bool> enabled_;
+};
+
+/*!
+ * \brief Records the lifetime of a scope into the buffer of the calling thread. Use via VAC_TRACE_SCOPE.
+ */
+class TraceScope final {
+ public:
+  /*!
+   * \brief Constructor. Records the begin time if tracing is enabled.
+   * \param name The name of the scope, a string with static storage duration.
+   */
+  explicit TraceScope(char const* name)
+      : buffer_(TraceRegistry::Instance().IsEnabled() ? &TraceRegistry::Instance().GetThreadBuffer() : nullptr),
+        name_(name),
+        begin_((buffer_ != nullptr) ? TraceClockNow() : 0U) {}
+
+  /*!
+   * \brief Copy constructor.
+   */
+  TraceScope(TraceScope const&) = delete;
+
+  /*!
+   * \brief Copy assignment.
+   */
+  TraceScope& operator=(TraceScope const&) & = delete;
+
+  /*!
+   * \brief Move constructor.
+   */
+  TraceScope(TraceScope&&) = delete;
+
+  /*!
+   * \brief Move assignment.
+   */
+  TraceScope& operator=(TraceScope&&) & = delete;
+
+  /*!
+   * \brief Destructor. Records the event.
+   */
+  ~TraceScope() noexcept {
+    if (buffer_ != nullptr) {
+      buffer_->Record(name_, begin_, TraceClockNow());
+    }
+  }
+
+ private:
+  /*!
+   * \brief The buffer of the calling thread, or nullptr if tracing was disabled on entry.
+   */
+  TraceBuffer* const buffer_;
+
+  /*!
+   * \brief The name of the scope.
+   */
+  char const* const name_;
+
+  /*!
+   * \brief Begin of the scope.
+   */
+  std::uint64_t const begin_;
+};
+
+/*!
+ * \brief Name the calling thread in exported traces.
+ * \param name The name, a string with static storage duration.
+ */
+inline void SetThreadName(char const* name) { TraceRegistry::Instance().GetThreadBuffer().SetThreadName(name); }
+
+}  // namespace trace
+}  // namespace vac
+
+/*!
+ * \brief Helper to create a unique variable name per line.
+ */
+#define VAC_TRACE_CONCAT_IMPL(a, b) a##b
+
+/*!
+ * \brief Helper to create a unique variable name per line.
+ */
+#define VAC_TRACE_CONCAT(a, b) VAC_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(VAC_TRACE_ENABLED) && (VAC_TRACE_ENABLED != 0)
+/*!
+ * \brief Trace the rest of the enclosing scope under a name with static storage duration, e.g. a string literal.
+ */
+#define VAC_TRACE_SCOPE(name) \
+  ::vac::trace::TraceScope const VAC_TRACE_CONCAT(vac_trace_scope_, __LINE__) { name }
+
+/*!
+ * \brief Name the calling thread in exported traces.
+ */
+#define VAC_TRACE_THREAD_NAME(name) ::vac::trace::SetThreadName(name)
+#else
+/*!
+ * \brief Tracing disabled, see VAC_TRACE_ENABLED.
+ */
+#define VAC_TRACE_SCOPE(name) static_cast<void>(0)
+
+/*!
+ * \brief Tracing disabled, see VAC_TRACE_ENABLED.
+ */
+#define VAC_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+#endif  // LIB_VAC_INCLUDE_VAC_TRACE_TRACE_H_
@@ -34,6 +34,8 @@
 #include "ara/core/string_view.h"
 #include "vac/container/string_literals.h"
 #include "vac/iterators/range.h"
+#include "vac/metrics/metrics_registry.h"
+#include "vac/trace/trace.h"
 
 #include "vajson/reader/internal/json_ops.h"
 #include "vajson/reader/json_document.h"
@@ -132,6 +134,8 @@ class Parser {
    * \error{JsonErrorDomain, JsonErrc::kUnicodeEscape, if a unicode escape was encountered}
    */
   auto Parse() -> ParserResult {
+    VAC_TRACE_SCOPE("vajson::reader::Parser::Parse");
+    VAC_METRICS_COUNTER_ADD("vajson.parser.parses", 1U);
     // Detect if the passed document is empty
     this->GetJsonOps().SkipWhitespace();
 
@@ -143,6 +147,7 @@ class Parser {
 
     // In case of an error, add the current location to the support data
     return result.MapError([this](ErrorCode ec) {
+      VAC_METRICS_COUNTER_ADD("vajson.parser.errors", 1U);
       ec.SetSupportData(static_cast<vajson::ErrorDomain::SupportDataType>(this->json_ops_.Tell()));
       return ec;
     });
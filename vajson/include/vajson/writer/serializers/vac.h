@@ -24,8 +24,12 @@
 /**********************************************************************************************************************
  *  INCLUDES
  *********************************************************************************************************************/
+#include "vajson/writer/serializers/vac/lock_profile.h"
+#include "vajson/writer/serializers/vac/log.h"
+#include "vajson/writer/serializers/vac/metrics.h"
 #include "vajson/writer/serializers/vac/primitives.h"
 #include "vajson/writer/serializers/vac/sequence_containers.h"
+#include "vajson/writer/serializers/vac/trace.h"
 #include "vajson/writer/serializers/vac/variant.h"
 
 #endif  // LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_H_
@@ -0,0 +1,92 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  serializers/vac/lock_profile.h
+ *        \brief  Export of the vac::sync lock profile as JSON.
+ *      \details  Writes [{"name":..,"acquisitions":..,"contended":..,"wait_p99_ns":..,..},..], most contended first.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOCK_PROFILE_H_
+#define LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOCK_PROFILE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "ara/core/string_view.h"
+#include "vac/sync/profiled_mutex.h"
+
+#include "vajson/writer/serializers/structures/generic_value_serializer.h"
+#include "vajson/writer/serializers/structures/key_serializer.h"
+#include "vajson/writer/serializers/util/literals.h"
+#include "vajson/writer/types/array_type.h"
+#include "vajson/writer/types/basic_types.h"
+#include "vajson/writer/types/object_type.h"
+
+namespace vajson {
+namespace writer {
+inline namespace serializers {
+namespace internal {
+
+/*!
+ * \brief Serializes the statistics of a lock site as object
+ * \param as The array serializer
+ * \param sample The statistics
+ * \returns the array serializer
+ */
+inline auto SerializeLockSite(ArraySerializer as, ::vac::sync::LockSiteSample const& sample) -> ArraySerializer {
+  return std::move(as) << JObject([&sample](ObjectStart os) {
+           return std::move(os) << JKey("name"_sv) << JString(ara::core::StringView{sample.name})
+                                << JKey("acquisitions"_sv) << JNumber(sample.acquisitions) << JKey("contended"_sv)
+                                << JNumber(sample.contended) << JKey("total_wait_ns"_sv)
+                                << JNumber(sample.total_wait_ns) << JKey("max_wait_ns"_sv)
+                                << JNumber(sample.max_wait_ns) << JKey("wait_p50_ns"_sv)
+                                << JNumber(sample.WaitPercentile(0.5)) << JKey("wait_p99_ns"_sv)
+                                << JNumber(sample.WaitPercentile(0.99)) << JKey("max_hold_ns"_sv)
+                                << JNumber(sample.max_hold_ns);
+         });
+}
+
+}  // namespace internal
+
+/*!
+ * \brief Writes the most contended lock sites of the process-wide lock profiler as JSON array
+ * \details Sites are ordered as by vac::sync::LockProfiler::Report(). Wait percentiles are upper bounds of power of two
+ *          buckets.
+ * \param os The output stream to write into
+ * \param max_sites The maximum number of sites to write
+ *
+ * \vpublic
+ */
+inline auto WriteLockProfile(std::ostream& os, std::size_t max_sites = std::numeric_limits<std::size_t>::max())
+    -> void {
+  std::vector<::vac::sync::LockSiteSample> const samples{::vac::sync::LockProfiler::Instance().Report(max_sites)};
+  static_cast<void>(DocumentSerializer{os} << JArray([&samples](ArrayStart as) {
+    for (::vac::sync::LockSiteSample const& sample : samples) {
+      as = internal::SerializeLockSite(std::move(as), sample);
+    }
+    return as;
+  }));
+}
+
+}  // namespace serializers
+}  // namespace writer
+}  // namespace vajson
+
+#endif  // LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOCK_PROFILE_H_
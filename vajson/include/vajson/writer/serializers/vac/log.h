@@ -0,0 +1,184 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  serializers/vac/log.h
+ *        \brief  JSON lines sink for vac::log.
+ *      \details  Writes one {"ts":..,"level":..,"tid":..,"file":..,"line":..,"msg":..,"args":[..]} object per line.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOG_H_
+#define LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOG_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "ara/core/string_view.h"
+#include "vac/log/logger.h"
+
+#include "vajson/writer/serializers/structures/generic_value_serializer.h"
+#include "vajson/writer/serializers/structures/key_serializer.h"
+#include "vajson/writer/serializers/util/literals.h"
+#include "vajson/writer/types/array_type.h"
+#include "vajson/writer/types/basic_types.h"
+#include "vajson/writer/types/object_type.h"
+
+namespace vajson {
+namespace writer {
+inline namespace serializers {
+namespace internal {
+
+/*!
+ * \brief Serializes the arguments of a log record as array elements
+ */
+class LogArgSerializer final {
+ public:
+  /*!
+   * \brief Constructs the serializer
+   * \param as The array serializer, updated with every argument
+   */
+  explicit LogArgSerializer(ArraySerializer& as) noexcept : as_{as} {}
+
+  /*!
+   * \brief Serializes a boolean argument
+   * \param value The argument
+   */
+  auto operator()(bool value) const -> void { this->as_.get() = std::move(this->as_.get()) << JBool(value); }
+
+  /*!
+   * \brief Serializes a numeric argument
+   * \param value The argument
+   */
+  template <typename N>
+  auto operator()(N value) const -> void {
+    this->as_.get() = std::move(this->as_.get()) << JNumber(value);
+  }
+
+  /*!
+   * \brief Serializes a string argument
+   * \param value The argument
+   */
+  auto operator()(ara::core::StringView value) const -> void {
+    this->as_.get() = std::move(this->as_.get()) << JString(value);
+  }
+
+ private:
+  /*!
+   * \brief The array serializer
+   */
+  std::reference_wrapper<ArraySerializer> as_;
+};
+
+}  // namespace internal
+
+/*!
+ * \brief Log sink writing every record as JSON object on its own line
+ * \details Lines are collected in memory and written to the output stream in one batch per drain of the logger.
+ *
+ * \vpublic
+ */
+class JsonLinesLogSink final : public ::vac::log::LogSink {
+ public:
+  /*!
+   * \brief Constructs the sink
+   * \param os The output stream to write into, must outlive the sink
+   */
+  explicit JsonLinesLogSink(std::ostream& os) : os_{os}, batch_{}, message_{} {
+    static_cast<void>(this->batch_.precision(std::numeric_limits<double>::max_digits10));
+  }
+
+  /*!
+   * \brief Serializes a record into the current batch
+   * \param record The record
+   */
+  auto Write(::vac::log::LogRecord const& record) -> void final {
+    using internal::operator""_sv;
+    ::vac::log::LogSite const& site{record.GetSite()};
+    this->message_.clear();
+    record.AppendMessage(this->message_);
+    std::string const& message{this->message_};
+    static_cast<void>(DocumentSerializer{this->batch_} << JObject([&record, &site, &message](ObjectStart os) {
+      return std::move(os) << JKey("ts"_sv) << JNumber(record.GetTimestamp()) << JKey("level"_sv)
+                           << JString(ara::core::StringView{::vac::log::GetLevelName(site.level)}) << JKey("tid"_sv)
+                           << JNumber(record.GetThreadId()) << JKey("file"_sv)
+                           << JString(ara::core::StringView{site.file}) << JKey("line"_sv) << JNumber(site.line)
+                           << JKey("msg"_sv) << JString(ara::core::StringView{message.data(), message.size()})
+                           << JKey("args"_sv) << JArray([&record](ArrayStart args) {
+                                record.ForEachArg(internal::LogArgSerializer{args});
+                                return args;
+                              });
+    }));
+    this->batch_ << '\n';
+  }
+
+  /*!
+   * \brief Writes a warning line about dropped records into the current batch
+   * \param thread_id The thread whose records were dropped
+   * \param count The number of dropped records
+   */
+  auto OnDropped(std::uint32_t thread_id, std::uint64_t count) -> void final {
+    using internal::operator""_sv;
+    std::uint64_t const now{static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count())};
+    static_cast<void>(DocumentSerializer{this->batch_} << JObject([now, thread_id, count](ObjectStart os) {
+      return std::move(os) << JKey("ts"_sv) << JNumber(now) << JKey("level"_sv) << JString("warn"_sv)
+                           << JKey("tid"_sv) << JNumber(thread_id) << JKey("msg"_sv)
+                           << JString("log records dropped"_sv) << JKey("dropped"_sv) << JNumber(count);
+    }));
+    this->batch_ << '\n';
+  }
+
+  /*!
+   * \brief Writes the current batch to the output stream and flushes it
+   */
+  auto Flush() -> void final {
+    std::string const batch{this->batch_.str()};
+    if (!batch.empty()) {
+      static_cast<void>(this->os_.get().write(batch.data(), static_cast<std::streamsize>(batch.size())));
+      static_cast<void>(this->os_.get().flush());
+      this->batch_.str(std::string{});
+    }
+  }
+
+ private:
+  /*!
+   * \brief The output stream
+   */
+  std::reference_wrapper<std::ostream> os_;
+
+  /*!
+   * \brief The lines not yet written
+   */
+  std::ostringstream batch_;
+
+  /*!
+   * \brief The message of the current record, reused between records
+   */
+  std::string message_;
+};
+
+}  // namespace serializers
+}  // namespace writer
+}  // namespace vajson
+
+#endif  // LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_LOG_H_
@@ -0,0 +1,168 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  serializers/vac/metrics.h
+ *        \brief  Export of vac::metrics snapshots as JSON.
+ *      \details  Writes {"counters":{..},"gauges":{..},"histograms":{"name":{"count":..,"p99":..,..}}}.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_METRICS_H_
+#define LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_METRICS_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <ostream>
+#include <utility>
+
+#include "ara/core/string_view.h"
+#include "vac/metrics/metrics_registry.h"
+
+#include "vajson/writer/serializers/structures/generic_value_serializer.h"
+#include "vajson/writer/serializers/structures/key_serializer.h"
+#include "vajson/writer/serializers/util/literals.h"
+#include "vajson/writer/types/basic_types.h"
+#include "vajson/writer/types/object_type.h"
+
+namespace vajson {
+namespace writer {
+inline namespace serializers {
+namespace internal {
+
+/*!
+ * \brief Serializes the summary of a histogram
+ * \param os The object serializer
+ * \param histogram The histogram
+ * \returns the object serializer
+ */
+inline auto SerializeHistogram(KeySerializer os, ::vac::metrics::HistogramSnapshot const& histogram)
+    -> KeySerializer {
+  return std::move(os) << JKey("count"_sv) << JNumber(histogram.Count()) << JKey("sum"_sv)
+                       << JNumber(histogram.Sum()) << JKey("min"_sv) << JNumber(histogram.Min()) << JKey("max"_sv)
+                       << JNumber(histogram.Max()) << JKey("mean"_sv) << JNumber(histogram.Mean()) << JKey("p50"_sv)
+                       << JNumber(histogram.Percentile(0.5)) << JKey("p90"_sv) << JNumber(histogram.Percentile(0.9))
+                       << JKey("p99"_sv) << JNumber(histogram.Percentile(0.99)) << JKey("p999"_sv)
+                       << JNumber(histogram.Percentile(0.999));
+}
+
+/*!
+ * \brief Serializes the counters of a snapshot as members
+ * \param os The object serializer
+ * \param snapshot The snapshot
+ * \returns the object serializer
+ */
+inline auto SerializeCounters(KeySerializer os, ::vac::metrics::MetricsSnapshot const& snapshot) -> KeySerializer {
+  for (::vac::metrics::CounterSample const& sample : snapshot.counters) {
+    os = std::move(os) << JKey(ara::core::StringView{sample.name}) << JNumber(sample.value);
+  }
+  return os;
+}
+
+/*!
+ * \brief Serializes the gauges of a snapshot as members
+ * \param os The object serializer
+ * \param snapshot The snapshot
+ * \returns the object serializer
+ */
+inline auto SerializeGauges(KeySerializer os, ::vac::metrics::MetricsSnapshot const& snapshot) -> KeySerializer {
+  for (::vac::metrics::GaugeSample const& sample : snapshot.gauges) {
+    os = std::move(os) << JKey(ara::core::StringView{sample.name}) << JNumber(sample.value);
+  }
+  return os;
+}
+
+/*!
+ * \brief Serializes the histograms of a snapshot as members
+ * \param os The object serializer
+ * \param snapshot The snapshot
+ * \returns the object serializer
+ */
+inline auto SerializeHistograms(KeySerializer os, ::vac::metrics::MetricsSnapshot const& snapshot)
+    -> KeySerializer {
+  for (::vac::metrics::HistogramSample const& sample : snapshot.histograms) {
+    os = std::move(os) << JKey(ara::core::StringView{sample.name}) << JObject([&sample](KeySerializer histogram) {
+           return SerializeHistogram(std::move(histogram), sample.value);
+         });
+  }
+  return os;
+}
+
+}  // namespace internal
+
+/*!
+ * \brief Serializes a metrics snapshot as JSON object
+ * \details Counters and gauges map their name to the aggregated value, histograms their name to count, sum, min,
+ *          max, mean and the 50th, 90th, 99th and 99.9th percentile.
+ *
+ * \vpublic
+ */
+class JMetrics final {
+ public:
+  /*!
+   * \brief Constructs the serializer
+   * \param snapshot The snapshot to serialize, must outlive the serializer
+   */
+  explicit JMetrics(::vac::metrics::MetricsSnapshot const& snapshot) noexcept : snapshot_{snapshot} {}
+
+  /*!
+   * \brief Serializes the members of the object
+   * \param os The object serializer
+   * \returns the object serializer
+   */
+  auto operator()(KeySerializer os) const -> KeySerializer {
+    using internal::operator""_sv;
+    ::vac::metrics::MetricsSnapshot const& snapshot{this->snapshot_.get()};
+    return std::move(os) << JKey("counters"_sv) << JObject([&snapshot](KeySerializer counters) {
+             return internal::SerializeCounters(std::move(counters), snapshot);
+           }) << JKey("gauges"_sv) << JObject([&snapshot](KeySerializer gauges) {
+             return internal::SerializeGauges(std::move(gauges), snapshot);
+           }) << JKey("histograms"_sv) << JObject([&snapshot](KeySerializer histograms) {
+             return internal::SerializeHistograms(std::move(histograms), snapshot);
+           });
+  }
+
+ private:
+  /*!
+   * \brief The snapshot to serialize
+   */
+  std::reference_wrapper<::vac::metrics::MetricsSnapshot const> snapshot_;
+};
+
+/*!
+ * \brief Writes a metrics snapshot as JSON object
+ * \param os The output stream to write into
+ * \param snapshot The snapshot
+ *
+ * \vpublic
+ */
+inline auto WriteMetrics(std::ostream& os, ::vac::metrics::MetricsSnapshot const& snapshot) -> void {
+  static_cast<void>(DocumentSerializer{os} << JObjectType<JMetrics>{JMetrics{snapshot}});
+}
+
+/*!
+ * \brief Writes a snapshot of the process-wide metrics registry as JSON object
+ * \param os The output stream to write into
+ *
+ * \vpublic
+ */
+inline auto WriteMetrics(std::ostream& os) -> void {
+  ::vac::metrics::MetricsSnapshot const snapshot{::vac::metrics::MetricsRegistry::Instance().Snapshot()};
+  WriteMetrics(os, snapshot);
+}
+
+}  // namespace serializers
+}  // namespace writer
+}  // namespace vajson
+
+#endif  // LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_METRICS_H_
@@ -0,0 +1,141 @@
+/**********************************************************************************************************************
+ *  COPYRIGHT
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  \verbatim
+ *  Copyright (c) 2019 by Vector Informatik GmbH. All rights reserved.
+ *
+ *                This software is copyright protected and proprietary to Vector Informatik GmbH.
+ *                Vector Informatik GmbH grants to you only those rights as set out in the license conditions.
+ *                All other rights remain with Vector Informatik GmbH.
+ *  \endverbatim
+ *  -------------------------------------------------------------------------------------------------------------------
+ *  FILE DESCRIPTION
+ *  -----------------------------------------------------------------------------------------------------------------*/
+/*!        \file  serializers/vac/trace.h
+ *        \brief  Export of vac::trace events as Chrome trace_event JSON.
+ *      \details  The document can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ *********************************************************************************************************************/
+
+#ifndef LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_TRACE_H_
+#define LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_TRACE_H_
+
+/**********************************************************************************************************************
+ *  INCLUDES
+ *********************************************************************************************************************/
+#include <unistd.h>
+#include <cstdint>
+#include <ios>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "ara/core/string_view.h"
+#include "vac/trace/trace.h"
+
+#include "vajson/writer/serializers/structures/generic_value_serializer.h"
+#include "vajson/writer/serializers/structures/key_serializer.h"
+#include "vajson/writer/serializers/util/literals.h"
+#include "vajson/writer/types/array_type.h"
+#include "vajson/writer/types/basic_types.h"
+#include "vajson/writer/types/object_type.h"
+
+namespace vajson {
+namespace writer {
+inline namespace serializers {
+namespace internal {
+
+/*!
+ * \brief Converts a trace clock value to the microseconds used by the trace_event format
+ * \param ns The value in nanoseconds
+ * \returns the value in microseconds
+ */
+inline auto TraceMicroseconds(std::uint64_t ns) noexcept -> double { return static_cast<double>(ns) / 1000.0; }
+
+/*!
+ * \brief Serializes the metadata event naming a thread
+ * \param as The array serializer
+ * \param pid The process id
+ * \param buffer The buffer of the thread
+ * \returns the array serializer
+ */
+inline auto SerializeThreadName(ArraySerializer as, std::uint32_t pid, ::vac::trace::TraceBuffer const& buffer)
+    -> ArraySerializer {
+  return std::move(as) << JObject([pid, &buffer](ObjectStart os) {
+           return std::move(os) << JKey("name"_sv) << JString("thread_name"_sv) << JKey("ph"_sv) << JString("M"_sv)
+                                << JKey("pid"_sv) << JNumber(pid) << JKey("tid"_sv) << JNumber(buffer.GetThreadId())
+                                << JKey("args"_sv) << JObject([&buffer](ObjectStart args) {
+                                     return std::move(args) << JKey("name"_sv)
+                                                            << JString(ara::core::StringView{buffer.GetThreadName()});
+                                   });
+         });
+}
+
+/*!
+ * \brief Serializes a completed scope as complete event
+ * \param as The array serializer
+ * \param pid The process id
+ * \param tid The thread id
+ * \param event The event
+ * \returns the array serializer
+ */
+inline auto SerializeTraceEvent(ArraySerializer as, std::uint32_t pid, std::uint32_t tid,
+                                ::vac::trace::TraceEvent const& event) -> ArraySerializer {
+  return std::move(as) << JObject([pid, tid, &event](ObjectStart os) {
+           return std::move(os) << JKey("name"_sv) << JString(ara::core::StringView{event.name}) << JKey("cat"_sv)
+                                << JString("vac"_sv) << JKey("ph"_sv) << JString("X"_sv) << JKey("ts"_sv)
+                                << JNumber(TraceMicroseconds(event.begin)) << JKey("dur"_sv)
+                                << JNumber(TraceMicroseconds(event.end - event.begin)) << JKey("pid"_sv)
+                                << JNumber(pid) << JKey("tid"_sv) << JNumber(tid);
+         });
+}
+
+}  // namespace internal
+
+/*!
+ * \brief Writes the events of all threads recorded by vac::trace as Chrome trace_event JSON object
+ * \details Each traced scope becomes a complete ("X") event and each named thread a "thread_name" metadata event.
+ *          Timestamps are written in microseconds with nanosecond resolution; the formatting flags of the stream are
+ *          restored afterwards. Threads may keep tracing while the events are written.
+ * \param os The output stream to write into
+ * \param registry The registry whose buffers are exported
+ *
+ * \vpublic
+ */
+inline auto WriteChromeTrace(std::ostream& os,
+                             ::vac::trace::TraceRegistry const& registry = ::vac::trace::TraceRegistry::Instance())
+    -> void {
+  using internal::operator""_sv;
+  std::uint32_t const pid{static_cast<std::uint32_t>(::getpid())};
+  std::ios::fmtflags const flags{os.flags()};
+  std::streamsize const precision{os.precision()};
+  static_cast<void>(os.setf(std::ios::fixed, std::ios::floatfield));
+  static_cast<void>(os.precision(3));
+
+  std::vector<::vac::trace::TraceEvent> events{};
+  static_cast<void>(DocumentSerializer{os} << JObject([pid, &registry, &events](ObjectStart object) {
+    return std::move(object) << JKey("displayTimeUnit"_sv) << JString("ns"_sv) << JKey("traceEvents"_sv)
+                             << JArray([pid, &registry, &events](ArrayStart as) {
+                                  registry.ForEachBuffer([pid, &events, &as](::vac::trace::TraceBuffer const& buffer) {
+                                    if (buffer.GetThreadName() != nullptr) {
+                                      as = internal::SerializeThreadName(std::move(as), pid, buffer);
+                                    }
+                                    events.clear();
+                                    buffer.Snapshot(events);
+                                    for (::vac::trace::TraceEvent const& event : events) {
+                                      as = internal::SerializeTraceEvent(std::move(as), pid, buffer.GetThreadId(),
+                                                                         event);
+                                    }
+                                  });
+                                });
+  }));
+
+  static_cast<void>(os.flags(flags));
+  static_cast<void>(os.precision(precision));
+}
+
+}  // namespace serializers
+}  // namespace writer
+}  // namespace vajson
+
+#endif  // LIB_VAJSON_INCLUDE_VAJSON_WRITER_SERIALIZERS_VAC_TRACE_H_